@@ -40,6 +40,10 @@ foreach(_BUILD_TYPE ${KINARA_BUILD_TYPES})
     set_target_properties(${_TARGET_NAME} PROPERTIES COMPILE_OPTIONS
       "-ggdb3;-O0;-fno-inline;-DKINARA_CFG_DEBUG_MODE_BUILD_")
   endif()
+  if(_TARGET_NAME MATCHES "\\.log")
+    set_property(TARGET ${_TARGET_NAME} APPEND PROPERTY COMPILE_OPTIONS
+      "-DKINARA_CFG_LOGGING_BUILD_")
+  endif()
 
   set_target_properties(${_TARGET_NAME} PROPERTIES
     RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/bin/tests"
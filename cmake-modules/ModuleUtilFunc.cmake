@@ -24,6 +24,10 @@ function(define_lib_module module-name)
       set_target_properties(${_TARGET_NAME} PROPERTIES COMPILE_OPTIONS
         "-ggdb3;-O0;-fno-inline;-DKINARA_CFG_DEBUG_MODE_BUILD_")
     endif()
+    if(_TARGET_NAME MATCHES "\\.log")
+      set_property(TARGET ${_TARGET_NAME} APPEND PROPERTY COMPILE_OPTIONS
+        "-DKINARA_CFG_LOGGING_BUILD_")
+    endif()
   endforeach(BUILD_SUFFIX)
 
 endfunction(define_lib_module)
@@ -0,0 +1,463 @@
+// AddressableMultiWayHeap.hpp ---
+//
+// Filename: AddressableMultiWayHeap.hpp
+// Author: Abhishek Udupa
+// Created: Mon Oct 19 03:20:18 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// A K-ary heap whose elements can be reached through handles, to
+// change their priority or erase them in place, instead of pushing
+// duplicates and discarding them when they surface. As with
+// MultiWayHeap and std::priority_queue, top() is a greatest element
+// under Comparator. The heap array stores the elements along with
+// their handles, and a table maps each handle to the position of its
+// element, so that sifting compares elements in the K-ary layout
+// and only the moved elements' entries in the table are touched.
+//
+// push_range() and pop_n() move many elements at once: a large batch
+// of pushes is appended and heapified bottom up, in time linear in
+// the size of the heap, and popping everything sorts the array in
+// place instead of sifting down once per element.
+
+#if !defined KINARA_COMMON_CONTAINERS_ADDRESSABLE_MULTI_WAY_HEAP_HPP_
+#define KINARA_COMMON_CONTAINERS_ADDRESSABLE_MULTI_WAY_HEAP_HPP_
+
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+namespace addressable_multi_way_heap_detail_ {
+
+template <typename T>
+class HeapNode
+{
+public:
+    T m_value;
+    u64 m_handle;
+
+    template <typename... ArgTypes>
+    inline HeapNode(u64 handle, ArgTypes&&... args)
+        : m_value(std::forward<ArgTypes>(args)...), m_handle(handle)
+    {
+        // Nothing here
+    }
+};
+
+// swallows the handles of push_range() when nobody wants them
+class DiscardingIterator
+{
+public:
+    inline DiscardingIterator& operator * ()
+    {
+        return *this;
+    }
+
+    inline DiscardingIterator& operator ++ ()
+    {
+        return *this;
+    }
+
+    template <typename T>
+    inline DiscardingIterator& operator = (const T& value)
+    {
+        return *this;
+    }
+};
+
+} /* end namespace addressable_multi_way_heap_detail_ */
+
+// Handles stay valid while their element is in the heap, and may
+// be reused for new elements once it has been popped or erased
+template <typename T, typename Comparator = std::less<T>, u32 K = 4>
+class AddressableMultiWayHeap
+{
+    static_assert(K >= 2, "AddressableMultiWayHeap needs at least two children per node");
+
+public:
+    typedef u64 Handle;
+
+private:
+    typedef addressable_multi_way_heap_detail_::HeapNode<T> NodeType;
+
+    // the position of the elements of free handles
+    static const u64 sc_no_position = ~((u64)0);
+
+    std::vector<NodeType> m_heap;
+    std::vector<u64> m_positions;
+    std::vector<Handle> m_free_handles;
+    Comparator m_comparator;
+
+    inline void place(u64 index, NodeType&& node)
+    {
+        m_positions[node.m_handle] = index;
+        m_heap[index] = std::move(node);
+    }
+
+    inline void sift_up(u64 index)
+    {
+        NodeType node = std::move(m_heap[index]);
+        while (index > 0) {
+            const u64 parent = (index - 1) / K;
+            if (!m_comparator(m_heap[parent].m_value, node.m_value)) {
+                break;
+            }
+            place(index, std::move(m_heap[parent]));
+            index = parent;
+        }
+        place(index, std::move(node));
+    }
+
+    inline void sift_down(u64 index)
+    {
+        const u64 size = m_heap.size();
+        NodeType node = std::move(m_heap[index]);
+        while (true) {
+            const u64 first_child = index * K + 1;
+            if (first_child >= size) {
+                break;
+            }
+            const u64 last_child = (first_child + K < size ? first_child + K : size);
+            u64 best_child = first_child;
+            for (u64 child = first_child + 1; child < last_child; ++child) {
+                if (m_comparator(m_heap[best_child].m_value, m_heap[child].m_value)) {
+                    best_child = child;
+                }
+            }
+            if (!m_comparator(node.m_value, m_heap[best_child].m_value)) {
+                break;
+            }
+            place(index, std::move(m_heap[best_child]));
+            index = best_child;
+        }
+        place(index, std::move(node));
+    }
+
+    // Floyd's construction: sifts down every parent, from the
+    // last one up to the root
+    inline void heapify()
+    {
+        const u64 size = m_heap.size();
+        if (size < 2) {
+            return;
+        }
+        for (u64 index = (size - 2) / K + 1; index > 0; --index) {
+            sift_down(index - 1);
+        }
+    }
+
+    inline void free_handle(Handle handle)
+    {
+        m_positions[handle] = sc_no_position;
+        m_free_handles.push_back(handle);
+    }
+
+    inline Handle allocate_handle()
+    {
+        if (!m_free_handles.empty()) {
+            auto retval = m_free_handles.back();
+            m_free_handles.pop_back();
+            return retval;
+        }
+        m_positions.push_back((u64)sc_no_position);
+        return m_positions.size() - 1;
+    }
+
+    // moves the hole left by the top down to a leaf, along the best
+    // children, and fills it with the last element, which is then
+    // sifted up. The last element nearly always belongs near the
+    // bottom, so this saves comparing it at every level on the way
+    // down, as remove_at() would
+    inline void remove_top()
+    {
+        free_handle(m_heap[0].m_handle);
+
+        const u64 last = m_heap.size() - 1;
+        u64 index = 0;
+        while (true) {
+            const u64 first_child = index * K + 1;
+            if (first_child >= last) {
+                break;
+            }
+            const u64 last_child = (first_child + K < last ? first_child + K : last);
+            u64 best_child = first_child;
+            for (u64 child = first_child + 1; child < last_child; ++child) {
+                if (m_comparator(m_heap[best_child].m_value, m_heap[child].m_value)) {
+                    best_child = child;
+                }
+            }
+            place(index, std::move(m_heap[best_child]));
+            index = best_child;
+        }
+        if (index != last) {
+            place(index, std::move(m_heap[last]));
+            m_heap.pop_back();
+            sift_up(index);
+        } else {
+            m_heap.pop_back();
+        }
+    }
+
+    inline void remove_at(u64 index)
+    {
+        free_handle(m_heap[index].m_handle);
+
+        const u64 last = m_heap.size() - 1;
+        if (index != last) {
+            place(index, std::move(m_heap[last]));
+            m_heap.pop_back();
+            // the moved element may belong above or below index
+            if (index > 0 && m_comparator(m_heap[(index - 1) / K].m_value, m_heap[index].m_value)) {
+                sift_up(index);
+            } else {
+                sift_down(index);
+            }
+        } else {
+            m_heap.pop_back();
+        }
+    }
+
+public:
+    inline AddressableMultiWayHeap()
+    {
+        // Nothing here
+    }
+
+    inline AddressableMultiWayHeap(const Comparator& comparator)
+        : m_comparator(comparator)
+    {
+        // Nothing here
+    }
+
+    inline AddressableMultiWayHeap(const AddressableMultiWayHeap& other) = default;
+    inline AddressableMultiWayHeap(AddressableMultiWayHeap&& other) = default;
+    inline AddressableMultiWayHeap& operator = (const AddressableMultiWayHeap& other) = default;
+    inline AddressableMultiWayHeap& operator = (AddressableMultiWayHeap&& other) = default;
+
+    inline u64 size() const
+    {
+        return m_heap.size();
+    }
+
+    inline bool empty() const
+    {
+        return m_heap.empty();
+    }
+
+    inline void reserve(u64 num_elements)
+    {
+        m_heap.reserve(num_elements);
+        m_positions.reserve(num_elements);
+    }
+
+    inline void clear()
+    {
+        m_heap.clear();
+        m_positions.clear();
+        m_free_handles.clear();
+    }
+
+    inline Handle push(const T& value)
+    {
+        return emplace(value);
+    }
+
+    inline Handle push(T&& value)
+    {
+        return emplace(std::move(value));
+    }
+
+    template <typename... ArgTypes>
+    inline Handle emplace(ArgTypes&&... args)
+    {
+        const Handle handle = allocate_handle();
+        m_heap.emplace_back(handle, std::forward<ArgTypes>(args)...);
+        sift_up(m_heap.size() - 1);
+        return handle;
+    }
+
+    // pushes the values in [first, last), writing their handles to
+    // handles. When the batch is at least as large as the heap, it
+    // is cheaper to heapify everything than to sift up each value
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator push_range(InputIterator first, InputIterator last,
+                                     OutputIterator handles)
+    {
+        const u64 old_size = m_heap.size();
+        for (auto it = first; it != last; ++it) {
+            const Handle handle = allocate_handle();
+            m_positions[handle] = m_heap.size();
+            m_heap.emplace_back(handle, *it);
+            *handles = handle;
+            ++handles;
+        }
+
+        const u64 new_size = m_heap.size();
+        if (new_size - old_size >= old_size) {
+            heapify();
+        } else {
+            for (u64 index = old_size; index < new_size; ++index) {
+                sift_up(index);
+            }
+        }
+        return handles;
+    }
+
+    template <typename InputIterator>
+    inline void push_range(InputIterator first, InputIterator last)
+    {
+        push_range(first, last, addressable_multi_way_heap_detail_::DiscardingIterator());
+    }
+
+    inline const T& top() const
+    {
+        return m_heap[0].m_value;
+    }
+
+    inline Handle top_handle() const
+    {
+        return m_heap[0].m_handle;
+    }
+
+    inline void pop()
+    {
+        remove_top();
+    }
+
+    // pops the num_elements greatest elements, or all of them if
+    // there are fewer, writing them to values from the top down
+    template <typename OutputIterator>
+    inline OutputIterator pop_n(u64 num_elements, OutputIterator values)
+    {
+        if (num_elements < m_heap.size()) {
+            for (u64 i = 0; i < num_elements; ++i) {
+                *values = std::move(m_heap[0].m_value);
+                ++values;
+                remove_top();
+            }
+            return values;
+        }
+
+        auto const& comparator = m_comparator;
+        std::sort(m_heap.begin(), m_heap.end(),
+                  [&] (const NodeType& node1, const NodeType& node2) -> bool
+                  {
+                      return comparator(node2.m_value, node1.m_value);
+                  });
+        for (auto& node : m_heap) {
+            *values = std::move(node.m_value);
+            ++values;
+            free_handle(node.m_handle);
+        }
+        m_heap.clear();
+        return values;
+    }
+
+    // whether the element of handle is still in the heap
+    inline bool contains(Handle handle) const
+    {
+        return (handle < m_positions.size() && m_positions[handle] != sc_no_position);
+    }
+
+    inline const T& value(Handle handle) const
+    {
+        return m_heap[m_positions[handle]].m_value;
+    }
+
+    inline void erase(Handle handle)
+    {
+        remove_at(m_positions[handle]);
+    }
+
+    // value must not be less than the current value of
+    // handle, the element moves toward the top. Use update()
+    // when the direction of the change is not known
+    inline void increase_key(Handle handle, const T& value)
+    {
+        const u64 index = m_positions[handle];
+#if defined KINARA_CFG_DEBUG_MODE_BUILD_
+        assert(!m_comparator(value, m_heap[index].m_value));
+#endif /* KINARA_CFG_DEBUG_MODE_BUILD_ */
+        m_heap[index].m_value = value;
+        sift_up(index);
+    }
+
+    // value must not be greater than the current value of
+    // handle, the element moves away from the top
+    inline void decrease_key(Handle handle, const T& value)
+    {
+        const u64 index = m_positions[handle];
+#if defined KINARA_CFG_DEBUG_MODE_BUILD_
+        assert(!m_comparator(m_heap[index].m_value, value));
+#endif /* KINARA_CFG_DEBUG_MODE_BUILD_ */
+        m_heap[index].m_value = value;
+        sift_down(index);
+    }
+
+    // changes the value of handle in either direction
+    inline void update(Handle handle, const T& value)
+    {
+        const u64 index = m_positions[handle];
+        const bool increased = m_comparator(m_heap[index].m_value, value);
+        m_heap[index].m_value = value;
+        if (increased) {
+            sift_up(index);
+        } else {
+            sift_down(index);
+        }
+    }
+};
+
+template <typename T, typename Comparator = std::less<T>>
+using AddressableBinaryHeap = AddressableMultiWayHeap<T, Comparator, 2>;
+
+template <typename T, typename Comparator = std::less<T>>
+using AddressableTernaryHeap = AddressableMultiWayHeap<T, Comparator, 3>;
+
+template <typename T, typename Comparator = std::less<T>>
+using AddressableQuaternaryHeap = AddressableMultiWayHeap<T, Comparator, 4>;
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_ADDRESSABLE_MULTI_WAY_HEAP_HPP_ */
+
+//
+// AddressableMultiWayHeap.hpp ends here
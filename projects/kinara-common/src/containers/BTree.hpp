@@ -0,0 +1,1182 @@
+// BTree.hpp ---
+//
+// Filename: BTree.hpp
+// Author: Abhishek Udupa
+// Created: Mon Oct 19 01:12:40 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// A B+-tree, with the elements in the leaves, which are linked to
+// each other in order. Nodes hold sixteen keys, so that a node is
+// searched within a few cache lines rather than with a miss per
+// level as in a binary tree, and the leaves keep a copy of the keys
+// of their elements apart from the elements. For 64 bit integer keys
+// in their natural order, nodes are searched by counting the keys
+// below the searched key, two keys per compare with SSE4.2.
+
+#if !defined KINARA_COMMON_CONTAINERS_BTREE_HPP_
+#define KINARA_COMMON_CONTAINERS_BTREE_HPP_
+
+#include <new>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#if defined __SSE4_2__
+#include <nmmintrin.h>
+#endif /* __SSE4_2__ */
+
+#include "../basetypes/KinaraTypes.hpp"
+#include "RadixSort.hpp"
+
+namespace kinara {
+namespace containers {
+namespace btree_detail_ {
+
+// keys per node, each node has room for one more while it is split
+static const u32 sc_node_capacity = 16;
+// nodes other than the root are rebalanced below this
+static const u32 sc_min_node_count = sc_node_capacity / 2;
+
+template <typename KeyType, typename LessFunction>
+class NodeSearch
+{
+public:
+    // the number of keys less than key
+    static inline u32 lower_bound(const KeyType* keys, u32 count, const KeyType& key,
+                                  const LessFunction& less)
+    {
+        u32 low = 0;
+        u32 high = count;
+        while (low < high) {
+            const u32 mid = (low + high) / 2;
+            if (less(keys[mid], key)) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    // the number of keys not greater than key
+    static inline u32 upper_bound(const KeyType* keys, u32 count, const KeyType& key,
+                                  const LessFunction& less)
+    {
+        u32 low = 0;
+        u32 high = count;
+        while (low < high) {
+            const u32 mid = (low + high) / 2;
+            if (less(key, keys[mid])) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        return low;
+    }
+};
+
+template <typename IntType>
+class IntegerNodeSearch
+{
+private:
+#if defined __SSE4_2__
+    // pcmpgtq compares signed values, unsigned ones have their top bit flipped
+    static inline __m128i bias()
+    {
+        return (std::is_signed<IntType>::value ? _mm_setzero_si128() :
+                _mm_set1_epi64x((long long)((u64)1 << 63)));
+    }
+#endif /* __SSE4_2__ */
+
+    static inline u32 count_less(const IntType* keys, u32 count, IntType key)
+    {
+        u32 retval = 0;
+        u32 i = 0;
+#if defined __SSE4_2__
+        const __m128i flip = bias();
+        const __m128i target = _mm_xor_si128(_mm_set1_epi64x((long long)key), flip);
+        for (; i + 2 <= count; i += 2) {
+            auto values = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(keys + i)), flip);
+            auto less = _mm_cmpgt_epi64(target, values);
+            retval += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(less)));
+        }
+#endif /* __SSE4_2__ */
+        for (; i < count; ++i) {
+            retval += (keys[i] < key ? 1 : 0);
+        }
+        return retval;
+    }
+
+    static inline u32 count_greater(const IntType* keys, u32 count, IntType key)
+    {
+        u32 retval = 0;
+        u32 i = 0;
+#if defined __SSE4_2__
+        const __m128i flip = bias();
+        const __m128i target = _mm_xor_si128(_mm_set1_epi64x((long long)key), flip);
+        for (; i + 2 <= count; i += 2) {
+            auto values = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(keys + i)), flip);
+            auto greater = _mm_cmpgt_epi64(values, target);
+            retval += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(greater)));
+        }
+#endif /* __SSE4_2__ */
+        for (; i < count; ++i) {
+            retval += (keys[i] > key ? 1 : 0);
+        }
+        return retval;
+    }
+
+public:
+    // the comparator is only here to match the interface of NodeSearch
+    static inline u32 lower_bound(const IntType* keys, u32 count, IntType key,
+                                  const std::less<IntType>&)
+    {
+        return count_less(keys, count, key);
+    }
+
+    static inline u32 upper_bound(const IntType* keys, u32 count, IntType key,
+                                  const std::less<IntType>&)
+    {
+        return count - count_greater(keys, count, key);
+    }
+};
+
+template <>
+class NodeSearch<u64, std::less<u64>> : public IntegerNodeSearch<u64>
+{
+    // Nothing here
+};
+
+template <>
+class NodeSearch<i64, std::less<i64>> : public IntegerNodeSearch<i64>
+{
+    // Nothing here
+};
+
+template <typename KeyType>
+class Node
+{
+public:
+    u32 m_count;
+    bool m_is_leaf;
+
+    inline Node(bool is_leaf)
+        : m_count(0), m_is_leaf(is_leaf)
+    {
+        // Nothing here
+    }
+};
+
+// m_count keys separating m_count + 1 children, the keys in
+// m_children[i] are at least m_keys[i - 1] and less than m_keys[i]
+template <typename KeyType>
+class InnerNode : public Node<KeyType>
+{
+public:
+    KeyType m_keys[sc_node_capacity + 1];
+    Node<KeyType>* m_children[sc_node_capacity + 2];
+
+    inline InnerNode()
+        : Node<KeyType>(false)
+    {
+        // Nothing here
+    }
+};
+
+template <typename KeyType, typename StorageType>
+class LeafNode : public Node<KeyType>
+{
+public:
+    typedef typename std::aligned_storage<sizeof(StorageType),
+                                          alignof(StorageType)>::type EntryStorage;
+
+    LeafNode* m_prev;
+    LeafNode* m_next;
+    KeyType m_keys[sc_node_capacity + 1];
+    EntryStorage m_entries[sc_node_capacity + 1];
+
+    inline LeafNode()
+        : Node<KeyType>(true), m_prev(nullptr), m_next(nullptr)
+    {
+        // Nothing here
+    }
+
+    inline StorageType& entry(u32 index)
+    {
+        return *reinterpret_cast<StorageType*>(&m_entries[index]);
+    }
+
+    inline const StorageType& entry(u32 index) const
+    {
+        return *reinterpret_cast<const StorageType*>(&m_entries[index]);
+    }
+
+    // moves the entry at from_index in from to to_index here,
+    // the entry at to_index must not be constructed
+    inline void move_entry(u32 to_index, LeafNode* from, u32 from_index)
+    {
+        new (&m_entries[to_index]) StorageType(std::move(from->entry(from_index)));
+        from->entry(from_index).~StorageType();
+        m_keys[to_index] = from->m_keys[from_index];
+    }
+};
+
+// a position in a leaf, the end iterator is one past the
+// last element of the last leaf
+template <typename TreeType, bool ISCONST>
+class IteratorBase
+{
+    friend TreeType;
+    template <typename, bool> friend class IteratorBase;
+
+public:
+    typedef typename TreeType::ValueType ValueType;
+    typedef typename std::conditional<ISCONST, const ValueType, ValueType>::type
+    QualifiedValueType;
+
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef ValueType value_type;
+    typedef i64 difference_type;
+    typedef QualifiedValueType* pointer;
+    typedef QualifiedValueType& reference;
+
+private:
+    typedef typename TreeType::LeafType LeafType;
+
+    LeafType* m_leaf;
+    u32 m_index;
+
+    inline IteratorBase(LeafType* leaf, u32 index)
+        : m_leaf(leaf), m_index(index)
+    {
+        // Nothing here
+    }
+
+public:
+    inline IteratorBase()
+        : m_leaf(nullptr), m_index(0)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase(const IteratorBase& other) = default;
+
+    // conversion from a mutable iterator to a const one
+    template <bool OTHERCONST,
+              typename = typename std::enable_if<ISCONST && !OTHERCONST>::type>
+    inline IteratorBase(const IteratorBase<TreeType, OTHERCONST>& other)
+        : m_leaf(other.m_leaf), m_index(other.m_index)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase& operator = (const IteratorBase& other) = default;
+
+    inline reference operator * () const
+    {
+        return m_leaf->entry(m_index);
+    }
+
+    inline pointer operator -> () const
+    {
+        return &(m_leaf->entry(m_index));
+    }
+
+    inline IteratorBase& operator ++ ()
+    {
+        if (++m_index == m_leaf->m_count && m_leaf->m_next != nullptr) {
+            m_leaf = m_leaf->m_next;
+            m_index = 0;
+        }
+        return *this;
+    }
+
+    inline IteratorBase operator ++ (int)
+    {
+        auto retval = *this;
+        ++(*this);
+        return retval;
+    }
+
+    inline IteratorBase& operator -- ()
+    {
+        if (m_index == 0) {
+            m_leaf = m_leaf->m_prev;
+            m_index = m_leaf->m_count;
+        }
+        --m_index;
+        return *this;
+    }
+
+    inline IteratorBase operator -- (int)
+    {
+        auto retval = *this;
+        --(*this);
+        return retval;
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator == (const IteratorBase<TreeType, OTHERCONST>& other) const
+    {
+        return (m_leaf == other.m_leaf && m_index == other.m_index);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator != (const IteratorBase<TreeType, OTHERCONST>& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+} /* end namespace btree_detail_ */
+
+// T is the type of the elements, KeyExtractor extracts the key
+// (of type KeyType) from an element, and LessFunction orders keys.
+// Insertions and erasures invalidate iterators.
+template <typename T, typename KeyType, typename KeyExtractor, typename LessFunction>
+class BTree
+{
+    template <typename, bool> friend class btree_detail_::IteratorBase;
+
+public:
+    typedef T ValueType;
+    typedef btree_detail_::IteratorBase<BTree, false> Iterator;
+    typedef btree_detail_::IteratorBase<BTree, true> ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+private:
+    // sets store their elements as const T
+    typedef typename std::remove_const<T>::type StorageType;
+    typedef btree_detail_::Node<KeyType> NodeType;
+    typedef btree_detail_::InnerNode<KeyType> InnerType;
+    typedef btree_detail_::LeafNode<KeyType, StorageType> LeafType;
+    typedef btree_detail_::NodeSearch<KeyType, LessFunction> Search;
+
+    static const u32 sc_node_capacity = btree_detail_::sc_node_capacity;
+    static const u32 sc_min_node_count = btree_detail_::sc_min_node_count;
+    // insert_range() rebuilds the tree when the range is at least
+    // this fraction of the tree, and inserts one by one otherwise
+    static const u64 sc_bulk_insert_divisor = 16;
+    static const bool sc_radix_sortable =
+        (std::is_integral<KeyType>::value && std::is_same<LessFunction, std::less<KeyType>>::value);
+
+    NodeType* m_root;
+    LeafType* m_first_leaf;
+    LeafType* m_last_leaf;
+    u64 m_size;
+
+    KeyExtractor m_key_extractor;
+    LessFunction m_less;
+
+    class InsertResult
+    {
+    public:
+        LeafType* m_leaf;
+        u32 m_index;
+        bool m_inserted;
+        KeyType m_split_key;
+        NodeType* m_split_node;
+    };
+
+    static inline InnerType* as_inner(NodeType* node)
+    {
+        return static_cast<InnerType*>(node);
+    }
+
+    static inline LeafType* as_leaf(NodeType* node)
+    {
+        return static_cast<LeafType*>(node);
+    }
+
+    inline bool equals(const KeyType& key1, const KeyType& key2) const
+    {
+        return (!m_less(key1, key2) && !m_less(key2, key1));
+    }
+
+    inline void destroy_subtree(NodeType* node)
+    {
+        if (node->m_is_leaf) {
+            auto leaf = as_leaf(node);
+            for (u32 i = 0; i < leaf->m_count; ++i) {
+                leaf->entry(i).~StorageType();
+            }
+            delete leaf;
+            return;
+        }
+        auto inner = as_inner(node);
+        for (u32 i = 0; i <= inner->m_count; ++i) {
+            destroy_subtree(inner->m_children[i]);
+        }
+        delete inner;
+    }
+
+    inline void destroy()
+    {
+        if (m_root != nullptr) {
+            destroy_subtree(m_root);
+        }
+        m_root = nullptr;
+        m_first_leaf = nullptr;
+        m_last_leaf = nullptr;
+        m_size = 0;
+    }
+
+    inline LeafType* find_leaf(const KeyType& key) const
+    {
+        auto node = m_root;
+        while (!node->m_is_leaf) {
+            auto inner = as_inner(node);
+            node = inner->m_children[Search::upper_bound(inner->m_keys, inner->m_count,
+                                                         key, m_less)];
+        }
+        return as_leaf(node);
+    }
+
+    // the position of the first element not less than key
+    inline std::pair<LeafType*, u32> lower_bound_position(const KeyType& key) const
+    {
+        if (m_root == nullptr) {
+            return std::make_pair(m_last_leaf, 0u);
+        }
+        auto leaf = find_leaf(key);
+        auto index = Search::lower_bound(leaf->m_keys, leaf->m_count, key, m_less);
+        if (index == leaf->m_count && leaf->m_next != nullptr) {
+            return std::make_pair(leaf->m_next, 0u);
+        }
+        return std::make_pair(leaf, index);
+    }
+
+    inline std::pair<LeafType*, u32> upper_bound_position(const KeyType& key) const
+    {
+        if (m_root == nullptr) {
+            return std::make_pair(m_last_leaf, 0u);
+        }
+        auto leaf = find_leaf(key);
+        auto index = Search::upper_bound(leaf->m_keys, leaf->m_count, key, m_less);
+        if (index == leaf->m_count && leaf->m_next != nullptr) {
+            return std::make_pair(leaf->m_next, 0u);
+        }
+        return std::make_pair(leaf, index);
+    }
+
+    inline std::pair<LeafType*, u32> find_position(const KeyType& key) const
+    {
+        if (m_root == nullptr) {
+            return std::make_pair(m_last_leaf, 0u);
+        }
+        auto leaf = find_leaf(key);
+        auto index = Search::lower_bound(leaf->m_keys, leaf->m_count, key, m_less);
+        if (index < leaf->m_count && !m_less(key, leaf->m_keys[index])) {
+            return std::make_pair(leaf, index);
+        }
+        return std::make_pair(m_last_leaf, m_last_leaf->m_count);
+    }
+
+    // Splits leave both halves half full, except when the element
+    // went to the end of the rightmost leaf, where they leave the
+    // left half full, so that ascending insertions fill the leaves
+    template <typename... ArgTypes>
+    inline bool insert_into_leaf(LeafType* leaf, bool rightmost, const KeyType& key,
+                                 InsertResult& result, ArgTypes&&... args)
+    {
+        const u32 index = Search::lower_bound(leaf->m_keys, leaf->m_count, key, m_less);
+        result.m_leaf = leaf;
+        result.m_index = index;
+        if (index < leaf->m_count && !m_less(key, leaf->m_keys[index])) {
+            result.m_inserted = false;
+            return false;
+        }
+
+        // key and args may refer to elements of this leaf, so the
+        // new element is built before any entries are shifted, and
+        // key is copied first, since it may refer to an argument
+        // that is moved from
+        KeyType new_key(key);
+        StorageType new_entry(std::forward<ArgTypes>(args)...);
+        for (u32 i = leaf->m_count; i > index; --i) {
+            leaf->move_entry(i, leaf, i - 1);
+        }
+        leaf->m_keys[index] = std::move(new_key);
+        new (&leaf->m_entries[index]) StorageType(std::move(new_entry));
+        ++leaf->m_count;
+        ++m_size;
+        result.m_inserted = true;
+
+        if (leaf->m_count <= sc_node_capacity) {
+            return false;
+        }
+
+        const u32 left_count = ((rightmost && index == sc_node_capacity) ?
+                                sc_node_capacity : leaf->m_count / 2);
+        auto right = new LeafType();
+        for (u32 i = left_count; i < leaf->m_count; ++i) {
+            right->move_entry(i - left_count, leaf, i);
+        }
+        right->m_count = leaf->m_count - left_count;
+        leaf->m_count = left_count;
+
+        right->m_next = leaf->m_next;
+        right->m_prev = leaf;
+        if (leaf->m_next != nullptr) {
+            leaf->m_next->m_prev = right;
+        } else {
+            m_last_leaf = right;
+        }
+        leaf->m_next = right;
+
+        if (index >= left_count) {
+            result.m_leaf = right;
+            result.m_index = index - left_count;
+        }
+        result.m_split_key = right->m_keys[0];
+        result.m_split_node = right;
+        return true;
+    }
+
+    // returns true if node was split, with the new node to its
+    // right and the key separating them in result
+    template <typename... ArgTypes>
+    inline bool insert_into(NodeType* node, bool rightmost, const KeyType& key,
+                            InsertResult& result, ArgTypes&&... args)
+    {
+        if (node->m_is_leaf) {
+            return insert_into_leaf(as_leaf(node), rightmost, key, result,
+                                    std::forward<ArgTypes>(args)...);
+        }
+
+        auto inner = as_inner(node);
+        const u32 index = Search::upper_bound(inner->m_keys, inner->m_count, key, m_less);
+        if (!insert_into(inner->m_children[index], rightmost && index == inner->m_count,
+                         key, result, std::forward<ArgTypes>(args)...)) {
+            return false;
+        }
+
+        for (u32 i = inner->m_count; i > index; --i) {
+            inner->m_keys[i] = inner->m_keys[i - 1];
+            inner->m_children[i + 1] = inner->m_children[i];
+        }
+        inner->m_keys[index] = result.m_split_key;
+        inner->m_children[index + 1] = result.m_split_node;
+        ++inner->m_count;
+
+        if (inner->m_count <= sc_node_capacity) {
+            return false;
+        }
+
+        // the key at left_count moves up, the right node keeps
+        // at least one key
+        const u32 left_count = ((rightmost && index == sc_node_capacity) ?
+                                sc_node_capacity - 1 : inner->m_count / 2);
+        auto right = new InnerType();
+        right->m_count = inner->m_count - left_count - 1;
+        for (u32 i = 0; i < right->m_count; ++i) {
+            right->m_keys[i] = inner->m_keys[left_count + 1 + i];
+        }
+        for (u32 i = 0; i <= right->m_count; ++i) {
+            right->m_children[i] = inner->m_children[left_count + 1 + i];
+        }
+        inner->m_count = left_count;
+        result.m_split_key = inner->m_keys[left_count];
+        result.m_split_node = right;
+        return true;
+    }
+
+    inline void remove_from_parent(InnerType* parent, u32 index)
+    {
+        for (u32 i = index; i + 1 < parent->m_count; ++i) {
+            parent->m_keys[i] = parent->m_keys[i + 1];
+            parent->m_children[i + 1] = parent->m_children[i + 2];
+        }
+        --parent->m_count;
+    }
+
+    // merges or evens out the leaves at index and index + 1 of parent
+    inline void rebalance_leaves(InnerType* parent, u32 index)
+    {
+        auto left = as_leaf(parent->m_children[index]);
+        auto right = as_leaf(parent->m_children[index + 1]);
+
+        if (left->m_count + right->m_count <= sc_node_capacity) {
+            for (u32 i = 0; i < right->m_count; ++i) {
+                left->move_entry(left->m_count + i, right, i);
+            }
+            left->m_count += right->m_count;
+            left->m_next = right->m_next;
+            if (right->m_next != nullptr) {
+                right->m_next->m_prev = left;
+            } else {
+                m_last_leaf = left;
+            }
+            delete right;
+            remove_from_parent(parent, index);
+            return;
+        }
+
+        const u32 left_count = (left->m_count + right->m_count) / 2;
+        if (left->m_count < left_count) {
+            const u32 num_moved = left_count - left->m_count;
+            for (u32 i = 0; i < num_moved; ++i) {
+                left->move_entry(left->m_count + i, right, i);
+            }
+            for (u32 i = num_moved; i < right->m_count; ++i) {
+                right->move_entry(i - num_moved, right, i);
+            }
+            left->m_count += num_moved;
+            right->m_count -= num_moved;
+        } else {
+            const u32 num_moved = left->m_count - left_count;
+            for (u32 i = right->m_count; i > 0; --i) {
+                right->move_entry(i - 1 + num_moved, right, i - 1);
+            }
+            for (u32 i = 0; i < num_moved; ++i) {
+                right->move_entry(i, left, left_count + i);
+            }
+            left->m_count -= num_moved;
+            right->m_count += num_moved;
+        }
+        parent->m_keys[index] = right->m_keys[0];
+    }
+
+    // merges or evens out the inner nodes at index and index + 1 of
+    // parent, moving keys through the separator in parent
+    inline void rebalance_inner(InnerType* parent, u32 index)
+    {
+        auto left = as_inner(parent->m_children[index]);
+        auto right = as_inner(parent->m_children[index + 1]);
+
+        if (left->m_count + right->m_count + 1 <= sc_node_capacity) {
+            left->m_keys[left->m_count] = parent->m_keys[index];
+            for (u32 i = 0; i < right->m_count; ++i) {
+                left->m_keys[left->m_count + 1 + i] = right->m_keys[i];
+            }
+            for (u32 i = 0; i <= right->m_count; ++i) {
+                left->m_children[left->m_count + 1 + i] = right->m_children[i];
+            }
+            left->m_count += right->m_count + 1;
+            delete right;
+            remove_from_parent(parent, index);
+            return;
+        }
+
+        while (left->m_count + 1 < right->m_count) {
+            left->m_keys[left->m_count] = parent->m_keys[index];
+            left->m_children[left->m_count + 1] = right->m_children[0];
+            ++left->m_count;
+            parent->m_keys[index] = right->m_keys[0];
+            for (u32 i = 0; i + 1 < right->m_count; ++i) {
+                right->m_keys[i] = right->m_keys[i + 1];
+            }
+            for (u32 i = 0; i < right->m_count; ++i) {
+                right->m_children[i] = right->m_children[i + 1];
+            }
+            --right->m_count;
+        }
+        while (right->m_count + 1 < left->m_count) {
+            for (u32 i = right->m_count; i > 0; --i) {
+                right->m_keys[i] = right->m_keys[i - 1];
+            }
+            for (u32 i = right->m_count + 1; i > 0; --i) {
+                right->m_children[i] = right->m_children[i - 1];
+            }
+            right->m_keys[0] = parent->m_keys[index];
+            right->m_children[0] = left->m_children[left->m_count];
+            ++right->m_count;
+            parent->m_keys[index] = left->m_keys[left->m_count - 1];
+            --left->m_count;
+        }
+    }
+
+    // returns true if an element was erased
+    inline bool erase_from(NodeType* node, const KeyType& key)
+    {
+        if (node->m_is_leaf) {
+            auto leaf = as_leaf(node);
+            const u32 index = Search::lower_bound(leaf->m_keys, leaf->m_count, key, m_less);
+            if (index == leaf->m_count || m_less(key, leaf->m_keys[index])) {
+                return false;
+            }
+            leaf->entry(index).~StorageType();
+            for (u32 i = index + 1; i < leaf->m_count; ++i) {
+                leaf->move_entry(i - 1, leaf, i);
+            }
+            --leaf->m_count;
+            --m_size;
+            return true;
+        }
+
+        auto inner = as_inner(node);
+        const u32 index = Search::upper_bound(inner->m_keys, inner->m_count, key, m_less);
+        auto child = inner->m_children[index];
+        if (!erase_from(child, key)) {
+            return false;
+        }
+        if (child->m_count < sc_min_node_count) {
+            // every inner node has a key, so the child has a sibling
+            const u32 left_index = (index == inner->m_count ? index - 1 : index);
+            if (child->m_is_leaf) {
+                rebalance_leaves(inner, left_index);
+            } else {
+                rebalance_inner(inner, left_index);
+            }
+        }
+        return true;
+    }
+
+    // Builds the tree bottom up from num_elements elements, which
+    // emit constructs in order of strictly increasing keys. The
+    // elements are spread evenly over as few leaves as possible, and
+    // the leaves over as few inner nodes as possible
+    template <typename EmitFunction>
+    inline void build(u64 num_elements, const EmitFunction& emit)
+    {
+        destroy();
+        if (num_elements == 0) {
+            return;
+        }
+
+        std::vector<NodeType*> nodes;
+        std::vector<KeyType> first_keys;
+        const u64 num_leaves = (num_elements + sc_node_capacity - 1) / sc_node_capacity;
+        nodes.reserve(num_leaves);
+        first_keys.reserve(num_leaves);
+        LeafType* previous = nullptr;
+        for (u64 i = 0; i < num_leaves; ++i) {
+            auto leaf = new LeafType();
+            leaf->m_count = (num_elements / num_leaves) + (i < num_elements % num_leaves ? 1 : 0);
+            for (u32 j = 0; j < leaf->m_count; ++j) {
+                emit(&leaf->m_entries[j]);
+                leaf->m_keys[j] = m_key_extractor(leaf->entry(j));
+            }
+            leaf->m_prev = previous;
+            if (previous != nullptr) {
+                previous->m_next = leaf;
+            } else {
+                m_first_leaf = leaf;
+            }
+            previous = leaf;
+            nodes.push_back(leaf);
+            first_keys.push_back(leaf->m_keys[0]);
+        }
+        m_last_leaf = previous;
+        m_size = num_elements;
+
+        while (nodes.size() > 1) {
+            const u64 num_children = nodes.size();
+            const u64 num_inner = (num_children + sc_node_capacity) / (sc_node_capacity + 1);
+            std::vector<NodeType*> parents;
+            std::vector<KeyType> parent_first_keys;
+            parents.reserve(num_inner);
+            parent_first_keys.reserve(num_inner);
+            u64 child = 0;
+            for (u64 i = 0; i < num_inner; ++i) {
+                auto inner = new InnerType();
+                const u64 count = (num_children / num_inner) + (i < num_children % num_inner ? 1 : 0);
+                inner->m_count = count - 1;
+                parent_first_keys.push_back(first_keys[child]);
+                for (u64 j = 0; j < count; ++j, ++child) {
+                    inner->m_children[j] = nodes[child];
+                    if (j > 0) {
+                        inner->m_keys[j - 1] = first_keys[child];
+                    }
+                }
+                parents.push_back(inner);
+            }
+            nodes.swap(parents);
+            first_keys.swap(parent_first_keys);
+        }
+        m_root = nodes[0];
+    }
+
+    // builds the tree from elements, whose keys are strictly increasing
+    inline void build_from(std::vector<StorageType>& elements)
+    {
+        u64 next = 0;
+        build(elements.size(), [&] (void* place) -> void
+              {
+                  new (place) StorageType(std::move(elements[next++]));
+              });
+    }
+
+    inline void copy_from(const BTree& other)
+    {
+        auto it = other.begin();
+        build(other.m_size, [&] (void* place) -> void
+              {
+                  new (place) StorageType(*it);
+                  ++it;
+              });
+    }
+
+    inline void steal_from(BTree& other)
+    {
+        m_root = other.m_root;
+        m_first_leaf = other.m_first_leaf;
+        m_last_leaf = other.m_last_leaf;
+        m_size = other.m_size;
+        other.m_root = nullptr;
+        other.m_first_leaf = nullptr;
+        other.m_last_leaf = nullptr;
+        other.m_size = 0;
+    }
+
+    // moves the elements out of the tree, in order
+    inline void move_elements_to(std::vector<StorageType>& elements)
+    {
+        elements.reserve(elements.size() + m_size);
+        for (auto leaf = m_first_leaf; leaf != nullptr; leaf = leaf->m_next) {
+            for (u32 i = 0; i < leaf->m_count; ++i) {
+                elements.push_back(std::move(leaf->entry(i)));
+            }
+        }
+        destroy();
+    }
+
+    // sorts the (key, position) pairs by key, keeping the first
+    // of each key, with a radix sort on integral keys
+    inline void sort_order(std::vector<std::pair<KeyType, u64>>& order, std::true_type) const
+    {
+        auto key = [] (const std::pair<KeyType, u64>& entry) -> KeyType { return entry.first; };
+        order.erase(radix_sort_unique(order.begin(), order.end(), key), order.end());
+    }
+
+    inline void sort_order(std::vector<std::pair<KeyType, u64>>& order, std::false_type) const
+    {
+        auto less = [&] (const std::pair<KeyType, u64>& a, const std::pair<KeyType, u64>& b) -> bool
+            {
+                return m_less(a.first, b.first);
+            };
+        std::stable_sort(order.begin(), order.end(), less);
+        auto equal = [&] (const std::pair<KeyType, u64>& a, const std::pair<KeyType, u64>& b) -> bool
+            {
+                return equals(a.first, b.first);
+            };
+        order.erase(std::unique(order.begin(), order.end(), equal), order.end());
+    }
+
+    // merges incoming, restricted to the positions in order, into
+    // the elements of the tree and rebuilds it, the elements already
+    // in the tree win over incoming ones with the same key
+    inline void merge_and_build(std::vector<StorageType>& incoming,
+                                const std::vector<std::pair<KeyType, u64>>& order)
+    {
+        std::vector<StorageType> existing;
+        move_elements_to(existing);
+        std::vector<StorageType> merged;
+        merged.reserve(existing.size() + order.size());
+
+        u64 i = 0;
+        u64 j = 0;
+        while (i < existing.size() || j < order.size()) {
+            if (j == order.size() ||
+                (i < existing.size() && !m_less(order[j].first, m_key_extractor(existing[i])))) {
+                if (j < order.size() && equals(order[j].first, m_key_extractor(existing[i]))) {
+                    ++j;
+                }
+                merged.push_back(std::move(existing[i++]));
+            } else {
+                merged.push_back(std::move(incoming[order[j++].second]));
+            }
+        }
+        existing.clear();
+        build_from(merged);
+    }
+
+protected:
+    // constructs a new element from args if no element with
+    // the same key exists, returns an iterator to the element
+    // with the key and whether it was inserted
+    template <typename... ArgTypes>
+    inline std::pair<Iterator, bool> emplace_unique(const KeyType& key, ArgTypes&&... args)
+    {
+        if (m_root == nullptr) {
+            auto leaf = new LeafType();
+            m_root = leaf;
+            m_first_leaf = leaf;
+            m_last_leaf = leaf;
+        }
+
+        InsertResult result;
+        if (insert_into(m_root, true, key, result, std::forward<ArgTypes>(args)...)) {
+            auto root = new InnerType();
+            root->m_count = 1;
+            root->m_keys[0] = result.m_split_key;
+            root->m_children[0] = m_root;
+            root->m_children[1] = result.m_split_node;
+            m_root = root;
+        }
+        return std::make_pair(Iterator(result.m_leaf, result.m_index), result.m_inserted);
+    }
+
+public:
+    inline BTree()
+        : m_root(nullptr), m_first_leaf(nullptr), m_last_leaf(nullptr), m_size(0)
+    {
+        // Nothing here
+    }
+
+    inline BTree(const BTree& other)
+        : BTree()
+    {
+        copy_from(other);
+    }
+
+    inline BTree(BTree&& other)
+        : BTree()
+    {
+        steal_from(other);
+    }
+
+    inline ~BTree()
+    {
+        destroy();
+    }
+
+    inline BTree& operator = (const BTree& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        copy_from(other);
+        return *this;
+    }
+
+    inline BTree& operator = (BTree&& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        destroy();
+        steal_from(other);
+        return *this;
+    }
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    inline void clear()
+    {
+        destroy();
+    }
+
+    // repacks the elements into full nodes
+    inline void shrink_to_fit()
+    {
+        std::vector<StorageType> elements;
+        move_elements_to(elements);
+        build_from(elements);
+    }
+
+    inline Iterator begin()
+    {
+        return Iterator(m_first_leaf, 0);
+    }
+
+    inline Iterator end()
+    {
+        return Iterator(m_last_leaf, m_last_leaf == nullptr ? 0 : m_last_leaf->m_count);
+    }
+
+    inline ConstIterator begin() const
+    {
+        return ConstIterator(m_first_leaf, 0);
+    }
+
+    inline ConstIterator end() const
+    {
+        return ConstIterator(m_last_leaf, m_last_leaf == nullptr ? 0 : m_last_leaf->m_count);
+    }
+
+    inline ConstIterator cbegin() const
+    {
+        return begin();
+    }
+
+    inline ConstIterator cend() const
+    {
+        return end();
+    }
+
+    inline Iterator find(const KeyType& key)
+    {
+        auto position = find_position(key);
+        return Iterator(position.first, position.second);
+    }
+
+    inline ConstIterator find(const KeyType& key) const
+    {
+        auto position = find_position(key);
+        return ConstIterator(position.first, position.second);
+    }
+
+    inline u64 count(const KeyType& key) const
+    {
+        return (find(key) != end() ? 1 : 0);
+    }
+
+    inline Iterator lower_bound(const KeyType& key)
+    {
+        auto position = lower_bound_position(key);
+        return Iterator(position.first, position.second);
+    }
+
+    inline ConstIterator lower_bound(const KeyType& key) const
+    {
+        auto position = lower_bound_position(key);
+        return ConstIterator(position.first, position.second);
+    }
+
+    inline Iterator upper_bound(const KeyType& key)
+    {
+        auto position = upper_bound_position(key);
+        return Iterator(position.first, position.second);
+    }
+
+    inline ConstIterator upper_bound(const KeyType& key) const
+    {
+        auto position = upper_bound_position(key);
+        return ConstIterator(position.first, position.second);
+    }
+
+    // calls function on the elements with keys from low up to but
+    // excluding high, in order, walking the leaves directly
+    template <typename FunctionType>
+    inline void for_each_in_range(const KeyType& low, const KeyType& high,
+                                  const FunctionType& function) const
+    {
+        auto position = lower_bound_position(low);
+        for (auto leaf = position.first; leaf != nullptr; leaf = leaf->m_next) {
+            for (u32 i = position.second; i < leaf->m_count; ++i) {
+                if (!m_less(leaf->m_keys[i], high)) {
+                    return;
+                }
+                function(leaf->entry(i));
+            }
+            position.second = 0;
+        }
+    }
+
+    inline u64 erase(const KeyType& key)
+    {
+        if (m_root == nullptr || !erase_from(m_root, key)) {
+            return 0;
+        }
+        if (!m_root->m_is_leaf && m_root->m_count == 0) {
+            auto old_root = as_inner(m_root);
+            m_root = old_root->m_children[0];
+            delete old_root;
+        } else if (m_size == 0) {
+            destroy();
+        }
+        return 1;
+    }
+
+    inline Iterator erase(const ConstIterator& position)
+    {
+        const KeyType key = position.m_leaf->m_keys[position.m_index];
+        erase(key);
+        return lower_bound(key);
+    }
+
+    // replaces the contents with the elements in [first, last),
+    // which should be sorted by key, in O(n) if they are; of
+    // elements with equal keys, only the first is kept
+    template <typename InputIterator>
+    inline void assign_sorted(const InputIterator& first, const InputIterator& last)
+    {
+        std::vector<StorageType> incoming(first, last);
+        bool sorted = true;
+        for (u64 i = 1; i < incoming.size() && sorted; ++i) {
+            sorted = !m_less(m_key_extractor(incoming[i]), m_key_extractor(incoming[i - 1]));
+        }
+
+        destroy();
+        if (!sorted) {
+            insert_range(incoming.begin(), incoming.end());
+            return;
+        }
+        std::vector<std::pair<KeyType, u64>> order;
+        order.reserve(incoming.size());
+        for (u64 i = 0; i < incoming.size(); ++i) {
+            if (order.empty() || m_less(order.back().first, m_key_extractor(incoming[i]))) {
+                order.push_back(std::make_pair(m_key_extractor(incoming[i]), i));
+            }
+        }
+        merge_and_build(incoming, order);
+    }
+
+    // inserts the elements in [first, last) whose keys are not
+    // present, sorting them (with a radix sort on integral keys) and
+    // rebuilding the tree in one pass when the range is large
+    template <typename InputIterator>
+    inline void insert_range(const InputIterator& first, const InputIterator& last)
+    {
+        std::vector<StorageType> incoming(first, last);
+        if (incoming.size() * sc_bulk_insert_divisor < m_size) {
+            for (auto& element : incoming) {
+                const KeyType key = m_key_extractor(element);
+                emplace_unique(key, std::move(element));
+            }
+            return;
+        }
+
+        std::vector<std::pair<KeyType, u64>> order;
+        order.reserve(incoming.size());
+        for (u64 i = 0; i < incoming.size(); ++i) {
+            order.push_back(std::make_pair(m_key_extractor(incoming[i]), i));
+        }
+        sort_order(order, std::integral_constant<bool, sc_radix_sortable>());
+        merge_and_build(incoming, order);
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_BTREE_HPP_ */
+
+//
+// BTree.hpp ends here
@@ -0,0 +1,166 @@
+// BTreeOrderedMap.hpp ---
+//
+// Filename: BTreeOrderedMap.hpp
+// Author: Abhishek Udupa
+// Created: Mon Oct 19 02:05:31 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// Ordered maps on top of BTree. These have the interface of
+// OrderedMap, along with lower_bound(), upper_bound(), range scans
+// and bulk construction from (sorted) ranges.
+
+#if !defined KINARA_COMMON_CONTAINERS_BTREE_ORDERED_MAP_HPP_
+#define KINARA_COMMON_CONTAINERS_BTREE_ORDERED_MAP_HPP_
+
+#include <tuple>
+#include <utility>
+#include <functional>
+#include <initializer_list>
+
+#include "BTree.hpp"
+
+namespace kinara {
+namespace containers {
+namespace btree_ordered_map_detail_ {
+
+template <typename KeyType, typename ValueType>
+class KeyExtractor
+{
+public:
+    inline const KeyType& operator () (const std::pair<const KeyType, ValueType>& entry) const
+    {
+        return entry.first;
+    }
+};
+
+} /* end namespace btree_ordered_map_detail_ */
+
+template <typename KeyType, typename ValueType,
+          typename LessFunction = std::less<KeyType>>
+class BTreeOrderedMap
+    : public BTree<std::pair<const KeyType, ValueType>, KeyType,
+                   btree_ordered_map_detail_::KeyExtractor<KeyType, ValueType>,
+                   LessFunction>
+{
+private:
+    typedef BTree<std::pair<const KeyType, ValueType>, KeyType,
+                  btree_ordered_map_detail_::KeyExtractor<KeyType, ValueType>,
+                  LessFunction> BaseType;
+
+public:
+    typedef std::pair<const KeyType, ValueType> EntryType;
+    typedef typename BaseType::Iterator Iterator;
+    typedef typename BaseType::ConstIterator ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+    inline BTreeOrderedMap()
+        : BaseType()
+    {
+        // Nothing here
+    }
+
+    inline BTreeOrderedMap(std::initializer_list<EntryType> init_list)
+        : BaseType()
+    {
+        insert(init_list);
+    }
+
+    template <typename InputIterator>
+    inline BTreeOrderedMap(const InputIterator& first, const InputIterator& last)
+        : BaseType()
+    {
+        insert(first, last);
+    }
+
+    inline BTreeOrderedMap(const BTreeOrderedMap& other) = default;
+    inline BTreeOrderedMap(BTreeOrderedMap&& other) = default;
+
+    inline BTreeOrderedMap& operator = (const BTreeOrderedMap& other) = default;
+    inline BTreeOrderedMap& operator = (BTreeOrderedMap&& other) = default;
+
+    inline BTreeOrderedMap& operator = (std::initializer_list<EntryType> init_list)
+    {
+        this->clear();
+        insert(init_list);
+        return *this;
+    }
+
+    inline ValueType& operator [] (const KeyType& key)
+    {
+        auto result = this->emplace_unique(key, std::piecewise_construct,
+                                           std::forward_as_tuple(key),
+                                           std::tuple<>());
+        return result.first->second;
+    }
+
+    inline std::pair<Iterator, bool> insert(const EntryType& entry)
+    {
+        return this->emplace_unique(entry.first, entry);
+    }
+
+    inline std::pair<Iterator, bool> insert(EntryType&& entry)
+    {
+        const KeyType& key = entry.first;
+        return this->emplace_unique(key, std::move(entry));
+    }
+
+    template <typename InputIterator>
+    inline void insert(const InputIterator& first, const InputIterator& last)
+    {
+        this->insert_range(first, last);
+    }
+
+    inline void insert(std::initializer_list<EntryType> init_list)
+    {
+        insert(init_list.begin(), init_list.end());
+    }
+
+    template <typename... ArgTypes>
+    inline std::pair<Iterator, bool> emplace(const KeyType& key, ArgTypes&&... args)
+    {
+        return this->emplace_unique(key, std::piecewise_construct,
+                                    std::forward_as_tuple(key),
+                                    std::forward_as_tuple(std::forward<ArgTypes>(args)...));
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_BTREE_ORDERED_MAP_HPP_ */
+
+//
+// BTreeOrderedMap.hpp ends here
@@ -0,0 +1,151 @@
+// BTreeOrderedSet.hpp ---
+//
+// Filename: BTreeOrderedSet.hpp
+// Author: Abhishek Udupa
+// Created: Mon Oct 19 02:11:02 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// Ordered sets on top of BTree. These have the interface of
+// OrderedSet, along with lower_bound(), upper_bound(), range scans
+// and bulk construction from (sorted) ranges.
+
+#if !defined KINARA_COMMON_CONTAINERS_BTREE_ORDERED_SET_HPP_
+#define KINARA_COMMON_CONTAINERS_BTREE_ORDERED_SET_HPP_
+
+#include <utility>
+#include <functional>
+#include <initializer_list>
+
+#include "BTree.hpp"
+
+namespace kinara {
+namespace containers {
+namespace btree_ordered_set_detail_ {
+
+template <typename T>
+class KeyExtractor
+{
+public:
+    inline const T& operator () (const T& element) const
+    {
+        return element;
+    }
+};
+
+} /* end namespace btree_ordered_set_detail_ */
+
+template <typename T, typename LessFunction = std::less<T>>
+class BTreeOrderedSet
+    : public BTree<const T, T, btree_ordered_set_detail_::KeyExtractor<T>, LessFunction>
+{
+private:
+    typedef BTree<const T, T, btree_ordered_set_detail_::KeyExtractor<T>,
+                  LessFunction> BaseType;
+
+public:
+    typedef typename BaseType::Iterator Iterator;
+    typedef typename BaseType::ConstIterator ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+    inline BTreeOrderedSet()
+        : BaseType()
+    {
+        // Nothing here
+    }
+
+    inline BTreeOrderedSet(std::initializer_list<T> init_list)
+        : BaseType()
+    {
+        insert(init_list);
+    }
+
+    template <typename InputIterator>
+    inline BTreeOrderedSet(const InputIterator& first, const InputIterator& last)
+        : BaseType()
+    {
+        insert(first, last);
+    }
+
+    inline BTreeOrderedSet(const BTreeOrderedSet& other) = default;
+    inline BTreeOrderedSet(BTreeOrderedSet&& other) = default;
+
+    inline BTreeOrderedSet& operator = (const BTreeOrderedSet& other) = default;
+    inline BTreeOrderedSet& operator = (BTreeOrderedSet&& other) = default;
+
+    inline BTreeOrderedSet& operator = (std::initializer_list<T> init_list)
+    {
+        this->clear();
+        insert(init_list);
+        return *this;
+    }
+
+    inline std::pair<Iterator, bool> insert(const T& element)
+    {
+        return this->emplace_unique(element, element);
+    }
+
+    inline std::pair<Iterator, bool> insert(T&& element)
+    {
+        return this->emplace_unique(element, std::move(element));
+    }
+
+    template <typename InputIterator>
+    inline void insert(const InputIterator& first, const InputIterator& last)
+    {
+        this->insert_range(first, last);
+    }
+
+    inline void insert(std::initializer_list<T> init_list)
+    {
+        insert(init_list.begin(), init_list.end());
+    }
+
+    template <typename... ArgTypes>
+    inline std::pair<Iterator, bool> emplace(ArgTypes&&... args)
+    {
+        return insert(T(std::forward<ArgTypes>(args)...));
+    }
+};
+
+typedef BTreeOrderedSet<u64> u64BTreeOrderedSet;
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_BTREE_ORDERED_SET_HPP_ */
+
+//
+// BTreeOrderedSet.hpp ends here
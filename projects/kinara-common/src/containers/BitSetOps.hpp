@@ -0,0 +1,377 @@
+// BitSetOps.hpp ---
+//
+// Filename: BitSetOps.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 22:52:31 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// Bulk operations on bitsets stored as arrays of 64 bit words, as
+// BitSet stores them, with bit i in bit (i % 64) of word (i / 64).
+// Bits past the last valid bit of the last word are expected to be
+// zero. The word-wise boolean operations and the population count
+// are selected at run time: AVX2 if the processor has it, otherwise
+// SSE2 and (for counting) POPCNT, otherwise plain C++.
+
+#if !defined KINARA_COMMON_CONTAINERS_BITSET_OPS_HPP_
+#define KINARA_COMMON_CONTAINERS_BITSET_OPS_HPP_
+
+#include "../basetypes/KinaraTypes.hpp"
+
+#if defined __x86_64__ && defined __GNUC__
+#define KINARA_BITSET_OPS_X86_
+#include <immintrin.h>
+#endif /* __x86_64__ && __GNUC__ */
+
+namespace kinara {
+namespace containers {
+namespace bitset_ops_detail_ {
+
+typedef void (*BinaryKernel)(u64* destination, const u64* source, u64 num_words);
+typedef u64 (*CountKernel)(const u64* words, u64 num_words);
+
+class AndOp
+{
+public:
+    static inline u64 apply(u64 destination, u64 source)
+    {
+        return destination & source;
+    }
+
+#if defined KINARA_BITSET_OPS_X86_
+    static inline __m128i apply(__m128i destination, __m128i source)
+    {
+        return _mm_and_si128(destination, source);
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i apply(__m256i destination, __m256i source)
+    {
+        return _mm256_and_si256(destination, source);
+    }
+#endif /* KINARA_BITSET_OPS_X86_ */
+};
+
+class OrOp
+{
+public:
+    static inline u64 apply(u64 destination, u64 source)
+    {
+        return destination | source;
+    }
+
+#if defined KINARA_BITSET_OPS_X86_
+    static inline __m128i apply(__m128i destination, __m128i source)
+    {
+        return _mm_or_si128(destination, source);
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i apply(__m256i destination, __m256i source)
+    {
+        return _mm256_or_si256(destination, source);
+    }
+#endif /* KINARA_BITSET_OPS_X86_ */
+};
+
+class XorOp
+{
+public:
+    static inline u64 apply(u64 destination, u64 source)
+    {
+        return destination ^ source;
+    }
+
+#if defined KINARA_BITSET_OPS_X86_
+    static inline __m128i apply(__m128i destination, __m128i source)
+    {
+        return _mm_xor_si128(destination, source);
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i apply(__m256i destination, __m256i source)
+    {
+        return _mm256_xor_si256(destination, source);
+    }
+#endif /* KINARA_BITSET_OPS_X86_ */
+};
+
+// destination & ~source
+class AndNotOp
+{
+public:
+    static inline u64 apply(u64 destination, u64 source)
+    {
+        return destination & ~source;
+    }
+
+#if defined KINARA_BITSET_OPS_X86_
+    static inline __m128i apply(__m128i destination, __m128i source)
+    {
+        return _mm_andnot_si128(source, destination);
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i apply(__m256i destination, __m256i source)
+    {
+        return _mm256_andnot_si256(source, destination);
+    }
+#endif /* KINARA_BITSET_OPS_X86_ */
+};
+
+template <typename Op>
+static inline void binary_scalar(u64* destination, const u64* source, u64 num_words)
+{
+    for (u64 i = 0; i < num_words; ++i) {
+        destination[i] = Op::apply(destination[i], source[i]);
+    }
+}
+
+static inline u64 count_scalar(const u64* words, u64 num_words)
+{
+    u64 retval = 0;
+    for (u64 i = 0; i < num_words; ++i) {
+        retval += __builtin_popcountll(words[i]);
+    }
+    return retval;
+}
+
+#if defined KINARA_BITSET_OPS_X86_
+
+template <typename Op>
+static inline void binary_sse2(u64* destination, const u64* source, u64 num_words)
+{
+    u64 i = 0;
+    for (; i + 2 <= num_words; i += 2) {
+        auto dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i));
+        auto src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), Op::apply(dst, src));
+    }
+    binary_scalar<Op>(destination + i, source + i, num_words - i);
+}
+
+template <typename Op>
+__attribute__((target("avx2")))
+static void binary_avx2(u64* destination, const u64* source, u64 num_words)
+{
+    u64 i = 0;
+    for (; i + 4 <= num_words; i += 4) {
+        auto dst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destination + i));
+        auto src = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), Op::apply(dst, src));
+    }
+    binary_scalar<Op>(destination + i, source + i, num_words - i);
+}
+
+__attribute__((target("popcnt")))
+static u64 count_popcnt(const u64* words, u64 num_words)
+{
+    // independent accumulators, to keep the popcnt unit busy
+    u64 counts[4] = { 0, 0, 0, 0 };
+    u64 i = 0;
+    for (; i + 4 <= num_words; i += 4) {
+        counts[0] += __builtin_popcountll(words[i]);
+        counts[1] += __builtin_popcountll(words[i + 1]);
+        counts[2] += __builtin_popcountll(words[i + 2]);
+        counts[3] += __builtin_popcountll(words[i + 3]);
+    }
+    for (; i < num_words; ++i) {
+        counts[0] += __builtin_popcountll(words[i]);
+    }
+    return counts[0] + counts[1] + counts[2] + counts[3];
+}
+
+// Counts the bits of each nibble with a table lookup through
+// vpshufb, and sums the byte counts into 64 bit lanes with vpsadbw
+__attribute__((target("avx2,popcnt")))
+static u64 count_avx2(const u64* words, u64 num_words)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    __m256i totals = _mm256_setzero_si256();
+
+    u64 i = 0;
+    while (i + 4 <= num_words) {
+        // a byte can count at most 8 bits in each of 31 iterations
+        __m256i byte_counts = _mm256_setzero_si256();
+        for (u64 j = 0; j < 31 && i + 4 <= num_words; ++j, i += 4) {
+            auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+            auto low = _mm256_and_si256(v, low_nibbles);
+            auto high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+            byte_counts = _mm256_add_epi8(byte_counts, _mm256_shuffle_epi8(lookup, low));
+            byte_counts = _mm256_add_epi8(byte_counts, _mm256_shuffle_epi8(lookup, high));
+        }
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(byte_counts,
+                                                         _mm256_setzero_si256()));
+    }
+
+    u64 retval = ((u64)_mm256_extract_epi64(totals, 0) + (u64)_mm256_extract_epi64(totals, 1) +
+                  (u64)_mm256_extract_epi64(totals, 2) + (u64)_mm256_extract_epi64(totals, 3));
+    for (; i < num_words; ++i) {
+        retval += __builtin_popcountll(words[i]);
+    }
+    return retval;
+}
+
+#endif /* KINARA_BITSET_OPS_X86_ */
+
+class Kernels
+{
+public:
+    BinaryKernel and_kernel;
+    BinaryKernel or_kernel;
+    BinaryKernel xor_kernel;
+    BinaryKernel and_not_kernel;
+    CountKernel count_kernel;
+
+    inline Kernels()
+        : and_kernel(binary_scalar<AndOp>), or_kernel(binary_scalar<OrOp>),
+          xor_kernel(binary_scalar<XorOp>), and_not_kernel(binary_scalar<AndNotOp>),
+          count_kernel(count_scalar)
+    {
+#if defined KINARA_BITSET_OPS_X86_
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            and_kernel = binary_avx2<AndOp>;
+            or_kernel = binary_avx2<OrOp>;
+            xor_kernel = binary_avx2<XorOp>;
+            and_not_kernel = binary_avx2<AndNotOp>;
+        } else {
+            and_kernel = binary_sse2<AndOp>;
+            or_kernel = binary_sse2<OrOp>;
+            xor_kernel = binary_sse2<XorOp>;
+            and_not_kernel = binary_sse2<AndNotOp>;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+            count_kernel = count_avx2;
+        } else if (__builtin_cpu_supports("popcnt")) {
+            count_kernel = count_popcnt;
+        }
+#endif /* KINARA_BITSET_OPS_X86_ */
+    }
+};
+
+// selected once, on first use
+static inline const Kernels& get_kernels()
+{
+    static const Kernels kernels;
+    return kernels;
+}
+
+} /* end namespace bitset_ops_detail_ */
+
+namespace bitset_ops {
+
+static inline u64 num_words(u64 num_bits)
+{
+    return (num_bits + 63) / 64;
+}
+
+// destination &= source, and so on, over num_words words
+static inline void and_with(u64* destination, const u64* source, u64 num_words)
+{
+    bitset_ops_detail_::get_kernels().and_kernel(destination, source, num_words);
+}
+
+static inline void or_with(u64* destination, const u64* source, u64 num_words)
+{
+    bitset_ops_detail_::get_kernels().or_kernel(destination, source, num_words);
+}
+
+static inline void xor_with(u64* destination, const u64* source, u64 num_words)
+{
+    bitset_ops_detail_::get_kernels().xor_kernel(destination, source, num_words);
+}
+
+// destination &= ~source
+static inline void and_not_with(u64* destination, const u64* source, u64 num_words)
+{
+    bitset_ops_detail_::get_kernels().and_not_kernel(destination, source, num_words);
+}
+
+// the number of set bits
+static inline u64 count(const u64* words, u64 num_words)
+{
+    return bitset_ops_detail_::get_kernels().count_kernel(words, num_words);
+}
+
+// the index of the first set bit at or after from, or num_bits if none
+static inline u64 find_next(const u64* words, u64 num_bits, u64 from)
+{
+    if (from >= num_bits) {
+        return num_bits;
+    }
+    const u64 last_word = num_words(num_bits);
+    u64 word_index = from / 64;
+    u64 word = words[word_index] & (~((u64)0) << (from % 64));
+    while (word == 0) {
+        if (++word_index == last_word) {
+            return num_bits;
+        }
+        word = words[word_index];
+    }
+    const u64 retval = word_index * 64 + __builtin_ctzll(word);
+    return (retval < num_bits ? retval : num_bits);
+}
+
+static inline u64 find_first(const u64* words, u64 num_bits)
+{
+    return find_next(words, num_bits, 0);
+}
+
+// calls function with the index of every set bit, in increasing order
+template <typename FunctionType>
+static inline void for_each_set_bit(const u64* words, u64 num_words,
+                                    const FunctionType& function)
+{
+    for (u64 i = 0; i < num_words; ++i) {
+        u64 word = words[i];
+        while (word != 0) {
+            function(i * 64 + __builtin_ctzll(word));
+            word &= (word - 1);
+        }
+    }
+}
+
+} /* end namespace bitset_ops */
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#undef KINARA_BITSET_OPS_X86_
+
+#endif /* KINARA_COMMON_CONTAINERS_BITSET_OPS_HPP_ */
+
+//
+// BitSetOps.hpp ends here
@@ -0,0 +1,770 @@
+// ChunkedDeque.hpp ---
+//
+// Filename: ChunkedDeque.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 19:04:37 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+
+// Code:
+
+// A deque made of fixed size blocks, reached through a map of block
+// pointers, with the interface of Deque. Element i is found with a
+// shift and a mask, so random access costs two loads, and growing
+// the deque only ever reallocates the map, never the elements, which
+// stay where they were constructed. Memory use is thus predictable
+// for very large queues: at most one partly used block at each end,
+// plus a few spare blocks.
+//
+// Blocks emptied by pop_front() and pop_back() are kept, up to
+// sc_max_spare_blocks of them, and reused by the next pushes, so
+// that a queue which is pushed at one end and popped at the other
+// moves blocks from front to back instead of going through the
+// allocator. Any blocks beyond that are released at once.
+//
+// BLOCK_SIZE is the number of elements per block, and must be a
+// power of two. Insertions and erasures invalidate iterators.
+
+#if !defined KINARA_COMMON_CONTAINERS_CHUNKED_DEQUE_HPP_
+#define KINARA_COMMON_CONTAINERS_CHUNKED_DEQUE_HPP_
+
+#include <new>
+#include <vector>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+namespace chunked_deque_detail_ {
+
+// the number of elements that fit in about 4 KB, rounded
+// down to a power of two, and no fewer than 16
+constexpr u32 default_block_size(u64 element_size, u32 block_size = 4096)
+{
+    return ((block_size <= 16 || element_size * block_size <= 4096) ?
+            block_size : default_block_size(element_size, block_size / 2));
+}
+
+constexpr u32 log2(u32 power_of_two)
+{
+    return (power_of_two <= 1 ? 0 : 1 + log2(power_of_two / 2));
+}
+
+template <typename DequeType, bool ISCONST>
+class IteratorBase
+{
+    friend DequeType;
+    template <typename, bool> friend class IteratorBase;
+
+public:
+    typedef typename DequeType::ValueType ValueType;
+    typedef typename std::conditional<ISCONST, const ValueType, ValueType>::type
+    QualifiedValueType;
+
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef ValueType value_type;
+    typedef i64 difference_type;
+    typedef QualifiedValueType* pointer;
+    typedef QualifiedValueType& reference;
+
+private:
+    const DequeType* m_deque;
+    u64 m_index;
+
+    inline IteratorBase(const DequeType* deque, u64 index)
+        : m_deque(deque), m_index(index)
+    {
+        // Nothing here
+    }
+
+public:
+    inline IteratorBase()
+        : m_deque(nullptr), m_index(0)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase(const IteratorBase& other) = default;
+
+    // conversion from a mutable iterator to a const one
+    template <bool OTHERCONST,
+              typename = typename std::enable_if<ISCONST && !OTHERCONST>::type>
+    inline IteratorBase(const IteratorBase<DequeType, OTHERCONST>& other)
+        : m_deque(other.m_deque), m_index(other.m_index)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase& operator = (const IteratorBase& other) = default;
+
+    inline reference operator * () const
+    {
+        return m_deque->slot(m_index);
+    }
+
+    inline pointer operator -> () const
+    {
+        return &(m_deque->slot(m_index));
+    }
+
+    inline reference operator [] (difference_type offset) const
+    {
+        return m_deque->slot(m_index + offset);
+    }
+
+    inline IteratorBase& operator ++ ()
+    {
+        ++m_index;
+        return *this;
+    }
+
+    inline IteratorBase operator ++ (int)
+    {
+        auto retval = *this;
+        ++m_index;
+        return retval;
+    }
+
+    inline IteratorBase& operator -- ()
+    {
+        --m_index;
+        return *this;
+    }
+
+    inline IteratorBase operator -- (int)
+    {
+        auto retval = *this;
+        --m_index;
+        return retval;
+    }
+
+    inline IteratorBase& operator += (difference_type offset)
+    {
+        m_index += offset;
+        return *this;
+    }
+
+    inline IteratorBase& operator -= (difference_type offset)
+    {
+        m_index -= offset;
+        return *this;
+    }
+
+    inline IteratorBase operator + (difference_type offset) const
+    {
+        return IteratorBase(m_deque, m_index + offset);
+    }
+
+    inline IteratorBase operator - (difference_type offset) const
+    {
+        return IteratorBase(m_deque, m_index - offset);
+    }
+
+    template <bool OTHERCONST>
+    inline difference_type operator - (const IteratorBase<DequeType, OTHERCONST>& other) const
+    {
+        return ((difference_type)m_index - (difference_type)other.m_index);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator == (const IteratorBase<DequeType, OTHERCONST>& other) const
+    {
+        return (m_deque == other.m_deque && m_index == other.m_index);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator != (const IteratorBase<DequeType, OTHERCONST>& other) const
+    {
+        return !(*this == other);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator < (const IteratorBase<DequeType, OTHERCONST>& other) const
+    {
+        return (m_index < other.m_index);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator > (const IteratorBase<DequeType, OTHERCONST>& other) const
+    {
+        return (m_index > other.m_index);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator <= (const IteratorBase<DequeType, OTHERCONST>& other) const
+    {
+        return (m_index <= other.m_index);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator >= (const IteratorBase<DequeType, OTHERCONST>& other) const
+    {
+        return (m_index >= other.m_index);
+    }
+};
+
+template <typename DequeType, bool ISCONST>
+inline IteratorBase<DequeType, ISCONST>
+operator + (i64 offset, const IteratorBase<DequeType, ISCONST>& iterator)
+{
+    return (iterator + offset);
+}
+
+} /* end namespace chunked_deque_detail_ */
+
+template <typename T, u32 BLOCK_SIZE = chunked_deque_detail_::default_block_size(sizeof(T))>
+class ChunkedDeque
+{
+    static_assert(BLOCK_SIZE > 0 && (BLOCK_SIZE & (BLOCK_SIZE - 1)) == 0,
+                  "ChunkedDeque needs a block size that is a power of two");
+
+    friend class chunked_deque_detail_::IteratorBase<ChunkedDeque, true>;
+    friend class chunked_deque_detail_::IteratorBase<ChunkedDeque, false>;
+
+public:
+    typedef T ValueType;
+    typedef chunked_deque_detail_::IteratorBase<ChunkedDeque, false> Iterator;
+    typedef chunked_deque_detail_::IteratorBase<ChunkedDeque, true> ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+private:
+    static const u64 sc_block_mask = BLOCK_SIZE - 1;
+    static const u32 sc_block_shift = chunked_deque_detail_::log2(BLOCK_SIZE);
+    static const u64 sc_max_spare_blocks = 4;
+    static const u64 sc_initial_map_capacity = 8;
+
+    // the blocks in use are m_map[m_first_block] to
+    // m_map[m_first_block + m_num_blocks - 1], and they hold
+    // exactly the slots m_begin to m_begin + m_size - 1,
+    // counted from the start of the first block
+    T** m_map;
+    u64 m_map_capacity;
+    u64 m_first_block;
+    u64 m_num_blocks;
+    u64 m_begin;
+    u64 m_size;
+    std::vector<T*> m_spare_blocks;
+
+    inline T& slot(u64 index) const
+    {
+        const u64 position = m_begin + index;
+        return m_map[m_first_block + (position >> sc_block_shift)][position & sc_block_mask];
+    }
+
+    inline T* acquire_block()
+    {
+        if (!m_spare_blocks.empty()) {
+            auto retval = m_spare_blocks.back();
+            m_spare_blocks.pop_back();
+            return retval;
+        }
+        return static_cast<T*>(::operator new(sizeof(T) * BLOCK_SIZE));
+    }
+
+    inline void release_block(T* block)
+    {
+        if (m_spare_blocks.size() < sc_max_spare_blocks) {
+            m_spare_blocks.push_back(block);
+        } else {
+            ::operator delete(block);
+        }
+    }
+
+    // makes room in the map for one more block at the front or
+    // at the back, by recentering the blocks in use if the map
+    // is at most half full, and by doubling it otherwise
+    inline void grow_map()
+    {
+        if (m_map_capacity >= 2 * (m_num_blocks + 1)) {
+            const u64 new_first_block = (m_map_capacity - m_num_blocks) / 2;
+            std::memmove(m_map + new_first_block, m_map + m_first_block,
+                         sizeof(T*) * m_num_blocks);
+            m_first_block = new_first_block;
+            return;
+        }
+
+        const u64 new_capacity = std::max((u64)sc_initial_map_capacity, 2 * m_map_capacity);
+        T** new_map = new T*[new_capacity];
+        const u64 new_first_block = (new_capacity - m_num_blocks) / 2;
+        if (m_num_blocks > 0) {
+            std::memcpy(new_map + new_first_block, m_map + m_first_block,
+                        sizeof(T*) * m_num_blocks);
+        }
+        delete[] m_map;
+        m_map = new_map;
+        m_map_capacity = new_capacity;
+        m_first_block = new_first_block;
+    }
+
+    // makes sure that slot m_begin + m_size is in a block
+    inline void reserve_back_slot()
+    {
+        if (((m_begin + m_size) >> sc_block_shift) < m_num_blocks) {
+            return;
+        }
+        if (m_first_block + m_num_blocks == m_map_capacity) {
+            grow_map();
+        }
+        m_map[m_first_block + m_num_blocks] = acquire_block();
+        ++m_num_blocks;
+    }
+
+    // makes sure that the slot before m_begin is in a block
+    inline void reserve_front_slot()
+    {
+        // an empty deque gets a single block, filled from its end
+        if (m_num_blocks == 0) {
+            reserve_back_slot();
+            m_begin = BLOCK_SIZE;
+            return;
+        }
+        if (m_begin > 0) {
+            return;
+        }
+        if (m_first_block == 0) {
+            grow_map();
+        }
+        --m_first_block;
+        m_map[m_first_block] = acquire_block();
+        ++m_num_blocks;
+        m_begin = BLOCK_SIZE;
+    }
+
+    // releases the blocks at the back which hold no elements
+    inline void trim_back()
+    {
+        const u64 num_blocks_needed =
+            (m_size == 0 ? 0 : ((m_begin + m_size - 1) >> sc_block_shift) + 1);
+        while (m_num_blocks > num_blocks_needed) {
+            --m_num_blocks;
+            release_block(m_map[m_first_block + m_num_blocks]);
+        }
+        if (m_size == 0) {
+            m_begin = 0;
+        }
+    }
+
+    inline void destroy_all()
+    {
+        if (!std::is_trivially_destructible<T>::value) {
+            for (u64 i = 0; i < m_size; ++i) {
+                slot(i).~T();
+            }
+        }
+        m_size = 0;
+        trim_back();
+    }
+
+public:
+    inline ChunkedDeque()
+        : m_map(nullptr), m_map_capacity(0), m_first_block(0),
+          m_num_blocks(0), m_begin(0), m_size(0)
+    {
+        // Nothing here
+    }
+
+    inline explicit ChunkedDeque(u64 size)
+        : ChunkedDeque()
+    {
+        resize(size);
+    }
+
+    inline ChunkedDeque(u64 size, const T& value)
+        : ChunkedDeque()
+    {
+        resize(size, value);
+    }
+
+    template <typename InputIterator,
+              typename = typename std::enable_if<
+                  !std::is_integral<InputIterator>::value>::type>
+    inline ChunkedDeque(InputIterator first, InputIterator last)
+        : ChunkedDeque()
+    {
+        append_range(first, last);
+    }
+
+    inline ChunkedDeque(std::initializer_list<T> init_list)
+        : ChunkedDeque()
+    {
+        append_range(init_list.begin(), init_list.end());
+    }
+
+    inline ChunkedDeque(const ChunkedDeque& other)
+        : ChunkedDeque()
+    {
+        append_range(other.begin(), other.end());
+    }
+
+    inline ChunkedDeque(ChunkedDeque&& other)
+        : m_map(other.m_map), m_map_capacity(other.m_map_capacity),
+          m_first_block(other.m_first_block), m_num_blocks(other.m_num_blocks),
+          m_begin(other.m_begin), m_size(other.m_size),
+          m_spare_blocks(std::move(other.m_spare_blocks))
+    {
+        other.m_map = nullptr;
+        other.m_map_capacity = 0;
+        other.m_first_block = 0;
+        other.m_num_blocks = 0;
+        other.m_begin = 0;
+        other.m_size = 0;
+        other.m_spare_blocks.clear();
+    }
+
+    inline ~ChunkedDeque()
+    {
+        destroy_all();
+        shrink_to_fit();
+        delete[] m_map;
+    }
+
+    inline ChunkedDeque& operator = (const ChunkedDeque& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        clear();
+        append_range(other.begin(), other.end());
+        return *this;
+    }
+
+    inline ChunkedDeque& operator = (ChunkedDeque&& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        std::swap(m_map, other.m_map);
+        std::swap(m_map_capacity, other.m_map_capacity);
+        std::swap(m_first_block, other.m_first_block);
+        std::swap(m_num_blocks, other.m_num_blocks);
+        std::swap(m_begin, other.m_begin);
+        std::swap(m_size, other.m_size);
+        std::swap(m_spare_blocks, other.m_spare_blocks);
+        return *this;
+    }
+
+    inline ChunkedDeque& operator = (std::initializer_list<T> init_list)
+    {
+        clear();
+        append_range(init_list.begin(), init_list.end());
+        return *this;
+    }
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    inline T& operator [] (u64 index)
+    {
+        return slot(index);
+    }
+
+    inline const T& operator [] (u64 index) const
+    {
+        return slot(index);
+    }
+
+    inline T& front()
+    {
+        return slot(0);
+    }
+
+    inline const T& front() const
+    {
+        return slot(0);
+    }
+
+    inline T& back()
+    {
+        return slot(m_size - 1);
+    }
+
+    inline const T& back() const
+    {
+        return slot(m_size - 1);
+    }
+
+    inline Iterator begin()
+    {
+        return Iterator(this, 0);
+    }
+
+    inline Iterator end()
+    {
+        return Iterator(this, m_size);
+    }
+
+    inline ConstIterator begin() const
+    {
+        return ConstIterator(this, 0);
+    }
+
+    inline ConstIterator end() const
+    {
+        return ConstIterator(this, m_size);
+    }
+
+    inline ConstIterator cbegin() const
+    {
+        return begin();
+    }
+
+    inline ConstIterator cend() const
+    {
+        return end();
+    }
+
+    template <typename... ArgTypes>
+    inline void emplace_back(ArgTypes&&... args)
+    {
+        reserve_back_slot();
+        new (&slot(m_size)) T(std::forward<ArgTypes>(args)...);
+        ++m_size;
+    }
+
+    template <typename... ArgTypes>
+    inline void emplace_front(ArgTypes&&... args)
+    {
+        reserve_front_slot();
+        new (&(m_map[m_first_block][m_begin - 1])) T(std::forward<ArgTypes>(args)...);
+        --m_begin;
+        ++m_size;
+    }
+
+    inline void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    inline void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    inline void push_front(const T& value)
+    {
+        emplace_front(value);
+    }
+
+    inline void push_front(T&& value)
+    {
+        emplace_front(std::move(value));
+    }
+
+    inline void pop_back()
+    {
+        slot(m_size - 1).~T();
+        --m_size;
+        if (((m_begin + m_size) & sc_block_mask) == 0 || m_size == 0) {
+            trim_back();
+        }
+    }
+
+    inline void pop_front()
+    {
+        slot(0).~T();
+        --m_size;
+        if (m_size == 0) {
+            trim_back();
+            return;
+        }
+        if (++m_begin == BLOCK_SIZE) {
+            release_block(m_map[m_first_block]);
+            ++m_first_block;
+            --m_num_blocks;
+            m_begin = 0;
+        }
+    }
+
+    // appends the elements of [first, last), filling a block at a
+    // time rather than checking for a full block at every element
+    template <typename InputIterator>
+    inline void append_range(InputIterator first, InputIterator last)
+    {
+        while (first != last) {
+            reserve_back_slot();
+            const u64 position = m_begin + m_size;
+            T* block = m_map[m_first_block + (position >> sc_block_shift)];
+            u64 offset = position & sc_block_mask;
+            const u64 start_offset = offset;
+            for (; first != last && offset < BLOCK_SIZE; ++first, ++offset) {
+                new (block + offset) T(*first);
+            }
+            m_size += (offset - start_offset);
+        }
+    }
+
+    inline Iterator insert(ConstIterator position, const T& value)
+    {
+        const u64 index = position.m_index;
+        if (index == 0) {
+            push_front(value);
+        } else {
+            push_back(value);
+            std::rotate(begin() + index, end() - 1, end());
+        }
+        return begin() + index;
+    }
+
+    // appends the elements and rotates them into place
+    template <typename InputIterator>
+    inline Iterator insert(ConstIterator position, InputIterator first, InputIterator last)
+    {
+        const u64 index = position.m_index;
+        const u64 old_size = m_size;
+        append_range(first, last);
+        std::rotate(begin() + index, begin() + old_size, end());
+        return begin() + index;
+    }
+
+    inline Iterator erase(ConstIterator position)
+    {
+        return erase(position, position + 1);
+    }
+
+    // moves whichever of the two sides is shorter over the hole
+    inline Iterator erase(ConstIterator first, ConstIterator last)
+    {
+        const u64 first_index = first.m_index;
+        const u64 last_index = last.m_index;
+        const u64 num_erased = last_index - first_index;
+        if (num_erased == 0) {
+            return begin() + first_index;
+        }
+        if (first_index < m_size - last_index) {
+            std::move_backward(begin(), begin() + first_index, begin() + last_index);
+            for (u64 i = 0; i < num_erased; ++i) {
+                pop_front();
+            }
+        } else {
+            std::move(begin() + last_index, end(), begin() + first_index);
+            for (u64 i = 0; i < num_erased; ++i) {
+                pop_back();
+            }
+        }
+        return begin() + first_index;
+    }
+
+    inline void resize(u64 new_size)
+    {
+        while (m_size > new_size) {
+            pop_back();
+        }
+        while (m_size < new_size) {
+            emplace_back();
+        }
+    }
+
+    inline void resize(u64 new_size, const T& value)
+    {
+        while (m_size > new_size) {
+            pop_back();
+        }
+        while (m_size < new_size) {
+            emplace_back(value);
+        }
+    }
+
+    inline void clear()
+    {
+        destroy_all();
+    }
+
+    // releases the spare blocks, and the map if nothing is in use
+    inline void shrink_to_fit()
+    {
+        for (auto block : m_spare_blocks) {
+            ::operator delete(block);
+        }
+        m_spare_blocks.clear();
+        m_spare_blocks.shrink_to_fit();
+        if (m_num_blocks == 0) {
+            delete[] m_map;
+            m_map = nullptr;
+            m_map_capacity = 0;
+            m_first_block = 0;
+        }
+    }
+
+    // the bytes held by the blocks and the map, spares included
+    inline u64 memory_bytes() const
+    {
+        return ((m_num_blocks + m_spare_blocks.size()) * BLOCK_SIZE * sizeof(T) +
+                m_map_capacity * sizeof(T*));
+    }
+
+    inline void sort()
+    {
+        std::sort(begin(), end());
+    }
+
+    template <typename Comparator>
+    inline void sort(const Comparator& comparator)
+    {
+        std::sort(begin(), end(), comparator);
+    }
+
+    inline bool operator == (const ChunkedDeque& other) const
+    {
+        return (m_size == other.m_size && std::equal(begin(), end(), other.begin()));
+    }
+
+    inline bool operator != (const ChunkedDeque& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+typedef ChunkedDeque<u32> u32ChunkedDeque;
+typedef ChunkedDeque<u64> u64ChunkedDeque;
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_CHUNKED_DEQUE_HPP_ */
+
+//
+// ChunkedDeque.hpp ends here
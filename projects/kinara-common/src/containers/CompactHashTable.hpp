@@ -0,0 +1,700 @@
+// CompactHashTable.hpp ---
+//
+// Filename: CompactHashTable.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 20:05:13 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// A hash table for keys of a limited number of bits, which stores
+// keys (and values) bit-packed. The keys are first put through a
+// bijective scramble of KEYBITS bits. The high bits of a scrambled
+// key select its home slot and only the remaining low bits are
+// stored, along with the displacement of the entry from its home
+// slot, so that a slot takes 8 + KEYBITS - log2(capacity) + VALUEBITS
+// bits. Collisions are resolved by robin hood linear probing, and
+// erasure shifts the entries that follow back towards their homes,
+// so no key values are reserved and no tombstones are left behind.
+
+#if !defined KINARA_COMMON_CONTAINERS_COMPACT_HASH_TABLE_HPP_
+#define KINARA_COMMON_CONTAINERS_COMPACT_HASH_TABLE_HPP_
+
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+#include <iterator>
+#include <type_traits>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+namespace compact_hash_table_detail_ {
+
+static inline u64 low_mask(u32 num_bits)
+{
+    return (num_bits >= 64 ? ~((u64)0) : (((u64)1 << num_bits) - 1));
+}
+
+template <typename TableType>
+class IteratorBase
+{
+    friend TableType;
+
+public:
+    typedef typename TableType::ValueType ValueType;
+
+    typedef std::forward_iterator_tag iterator_category;
+    typedef ValueType value_type;
+    typedef i64 difference_type;
+    typedef const ValueType* pointer;
+    typedef ValueType reference;
+
+private:
+    const TableType* m_table;
+    u64 m_index;
+
+    inline IteratorBase(const TableType* table, u64 index)
+        : m_table(table), m_index(index)
+    {
+        // Nothing here
+    }
+
+public:
+    inline IteratorBase()
+        : m_table(nullptr), m_index(0)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase(const IteratorBase& other) = default;
+    inline IteratorBase& operator = (const IteratorBase& other) = default;
+
+    // the elements are not stored as such, so they
+    // are decoded and returned by value
+    inline ValueType operator * () const
+    {
+        return m_table->element_at(m_index);
+    }
+
+    inline u64 key() const
+    {
+        return m_table->key_at(m_index);
+    }
+
+    inline u64 value() const
+    {
+        return m_table->value_at(m_index);
+    }
+
+    inline IteratorBase& operator ++ ()
+    {
+        m_index = m_table->next_full_slot(m_index + 1);
+        return *this;
+    }
+
+    inline IteratorBase operator ++ (int)
+    {
+        auto retval = *this;
+        ++(*this);
+        return retval;
+    }
+
+    inline bool operator == (const IteratorBase& other) const
+    {
+        return (m_index == other.m_index);
+    }
+
+    inline bool operator != (const IteratorBase& other) const
+    {
+        return (m_index != other.m_index);
+    }
+};
+
+} /* end namespace compact_hash_table_detail_ */
+
+// Keys must be less than 2^KEYBITS and values less than 2^VALUEBITS,
+// inserting any others throws std::out_of_range. A VALUEBITS of zero
+// gives a set
+template <u32 KEYBITS, u32 VALUEBITS>
+class CompactHashTable
+{
+    friend class compact_hash_table_detail_::IteratorBase<CompactHashTable>;
+
+    static_assert(KEYBITS >= 1 && KEYBITS <= 60,
+                  "CompactHashTable keys must be between 1 and 60 bits wide");
+    static_assert(KEYBITS + VALUEBITS <= 60,
+                  "CompactHashTable keys and values must be at most 60 bits wide together");
+
+public:
+    typedef typename std::conditional<VALUEBITS == 0, u64, std::pair<u64, u64>>::type
+    ValueType;
+    typedef compact_hash_table_detail_::IteratorBase<CompactHashTable> ConstIterator;
+    typedef ConstIterator Iterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+private:
+    // a slot holds the displacement of its entry plus one (zero for
+    // an empty slot), then the remainder of the key, then the value
+    static const u32 sc_displacement_bits = 8;
+    static const u64 sc_max_displacement = ((u64)1 << sc_displacement_bits) - 2;
+    static const u32 sc_min_log_capacity = (KEYBITS < 4 ? KEYBITS : 4);
+    static const u32 sc_scramble_shift = (KEYBITS + 1) / 2;
+    static const u64 sc_scramble_multiplier = 0x9E3779B97F4A7C15ULL;
+
+    // slots are widest at the smallest capacity, and a slot is read
+    // and written as a single word, so it must fit in 64 bits
+    static_assert(sc_displacement_bits + KEYBITS - sc_min_log_capacity + VALUEBITS <= 64,
+                  "CompactHashTable slots must be at most 64 bits wide, keys of fewer "
+                  "than 4 bits leave room for at most 56 bits of value");
+
+    u64* m_words;
+    u32 m_log_capacity;
+    u64 m_size;
+
+    static inline u64 key_mask()
+    {
+        return compact_hash_table_detail_::low_mask(KEYBITS);
+    }
+
+    // the inverse of the (odd) multiplier modulo 2^64, by newton's method
+    static inline u64 scramble_inverse()
+    {
+        u64 retval = sc_scramble_multiplier;
+        for (u32 i = 0; i < 5; ++i) {
+            retval *= 2 - sc_scramble_multiplier * retval;
+        }
+        return retval;
+    }
+
+    // Both steps are bijections on KEYBITS bits: multiplication by
+    // an odd number, and an xorshift by at least half the width,
+    // which is its own inverse
+    static inline u64 scramble(u64 key)
+    {
+        u64 retval = (key * sc_scramble_multiplier) & key_mask();
+        return retval ^ (retval >> sc_scramble_shift);
+    }
+
+    static inline u64 unscramble(u64 scrambled_key)
+    {
+        scrambled_key ^= (scrambled_key >> sc_scramble_shift);
+        return (scrambled_key * scramble_inverse()) & key_mask();
+    }
+
+    static inline u32 remainder_bits(u32 log_capacity)
+    {
+        return KEYBITS - log_capacity;
+    }
+
+    static inline u32 slot_bits(u32 log_capacity)
+    {
+        return sc_displacement_bits + remainder_bits(log_capacity) + VALUEBITS;
+    }
+
+    // one word of padding so that a slot can always be read two words at a time
+    static inline u64 num_words(u32 log_capacity)
+    {
+        return ((((u64)1 << log_capacity) * slot_bits(log_capacity) + 63) / 64) + 1;
+    }
+
+    static inline u64 max_load(u64 capacity)
+    {
+        return capacity - (capacity / 8);
+    }
+
+    inline u64 capacity_mask() const
+    {
+        return (capacity() - 1);
+    }
+
+    static inline u64 read_slot(const u64* words, u32 log_capacity, u64 index)
+    {
+        const u32 width = slot_bits(log_capacity);
+        const u64 position = index * width;
+        const u64 word = position / 64;
+        const u32 offset = position % 64;
+
+        u64 retval = words[word] >> offset;
+        if (offset + width > 64) {
+            retval |= (words[word + 1] << (64 - offset));
+        }
+        return retval & compact_hash_table_detail_::low_mask(width);
+    }
+
+    static inline void write_slot(u64* words, u32 log_capacity, u64 index, u64 slot)
+    {
+        const u32 width = slot_bits(log_capacity);
+        const u64 position = index * width;
+        const u64 word = position / 64;
+        const u32 offset = position % 64;
+        const u64 mask = compact_hash_table_detail_::low_mask(width);
+
+        slot &= mask;
+        words[word] = (words[word] & ~(mask << offset)) | (slot << offset);
+        if (offset + width > 64) {
+            const u32 shift = 64 - offset;
+            words[word + 1] = (words[word + 1] & ~(mask >> shift)) | (slot >> shift);
+        }
+    }
+
+    static inline u64 slot_displacement(u64 slot)
+    {
+        return slot & compact_hash_table_detail_::low_mask(sc_displacement_bits);
+    }
+
+    static inline u64 slot_remainder(u64 slot, u32 log_capacity)
+    {
+        return ((slot >> sc_displacement_bits) &
+                compact_hash_table_detail_::low_mask(remainder_bits(log_capacity)));
+    }
+
+    static inline u64 slot_value(u64 slot, u32 log_capacity)
+    {
+        if (VALUEBITS == 0) {
+            return 0;
+        }
+        return ((slot >> (sc_displacement_bits + remainder_bits(log_capacity))) &
+                compact_hash_table_detail_::low_mask(VALUEBITS));
+    }
+
+    static inline u64 scrambled_key_at(u64 index, u64 slot, u32 log_capacity)
+    {
+        const u64 capacity_mask = ((u64)1 << log_capacity) - 1;
+        const u64 home = (index - (slot_displacement(slot) - 1)) & capacity_mask;
+        return (home << remainder_bits(log_capacity)) | slot_remainder(slot, log_capacity);
+    }
+
+    inline u64 read_slot(u64 index) const
+    {
+        return read_slot(m_words, m_log_capacity, index);
+    }
+
+    inline void write_slot(u64 index, u64 slot)
+    {
+        write_slot(m_words, m_log_capacity, index, slot);
+    }
+
+    inline u64 slot_remainder(u64 slot) const
+    {
+        return slot_remainder(slot, m_log_capacity);
+    }
+
+    inline u64 slot_value(u64 slot) const
+    {
+        return slot_value(slot, m_log_capacity);
+    }
+
+    inline u64 scrambled_key_at(u64 index, u64 slot) const
+    {
+        return scrambled_key_at(index, slot, m_log_capacity);
+    }
+
+    inline u64 make_slot(u64 displacement, u64 remainder, u64 value) const
+    {
+        u64 retval = (displacement + 1) | (remainder << sc_displacement_bits);
+        if (VALUEBITS != 0) {
+            retval |= ((value & compact_hash_table_detail_::low_mask(VALUEBITS)) <<
+                       (sc_displacement_bits + remainder_bits(m_log_capacity)));
+        }
+        return retval;
+    }
+
+    inline u64 home_slot(u64 scrambled_key) const
+    {
+        return (scrambled_key >> remainder_bits(m_log_capacity));
+    }
+
+    inline u64 next_full_slot(u64 index) const
+    {
+        const u64 num_slots = capacity();
+        while (index < num_slots && slot_displacement(read_slot(index)) == 0) {
+            ++index;
+        }
+        return index;
+    }
+
+    inline u64 key_at(u64 index) const
+    {
+        return unscramble(scrambled_key_at(index, read_slot(index)));
+    }
+
+    inline u64 value_at(u64 index) const
+    {
+        return slot_value(read_slot(index));
+    }
+
+    template <u32 OTHERVALUEBITS = VALUEBITS>
+    inline typename std::enable_if<OTHERVALUEBITS == 0, ValueType>::type
+    element_at(u64 index) const
+    {
+        return key_at(index);
+    }
+
+    template <u32 OTHERVALUEBITS = VALUEBITS>
+    inline typename std::enable_if<OTHERVALUEBITS != 0, ValueType>::type
+    element_at(u64 index) const
+    {
+        const u64 slot = read_slot(index);
+        return ValueType(unscramble(scrambled_key_at(index, slot)), slot_value(slot));
+    }
+
+    // returns the capacity if the key is not present
+    inline u64 find_index(u64 key) const
+    {
+        // a wider key would be truncated into one that may be present
+        if (m_words == nullptr || (key & ~key_mask()) != 0) {
+            return capacity();
+        }
+        const u64 scrambled_key = scramble(key);
+        const u64 remainder = (scrambled_key &
+                               compact_hash_table_detail_::low_mask(remainder_bits(m_log_capacity)));
+        u64 index = home_slot(scrambled_key);
+
+        // an entry further from its home than the probe is
+        // from the home of the key would have been displaced
+        for (u64 displacement = 0; ; ++displacement) {
+            const u64 slot = read_slot(index);
+            const u64 slot_displacement_plus_one = slot_displacement(slot);
+            if (slot_displacement_plus_one == 0 ||
+                slot_displacement_plus_one - 1 < displacement) {
+                return capacity();
+            }
+            if (slot_displacement_plus_one - 1 == displacement &&
+                slot_remainder(slot) == remainder) {
+                return index;
+            }
+            index = (index + 1) & capacity_mask();
+        }
+    }
+
+    // places an entry whose key is known not to be present, returns
+    // false if some entry would end up too far from its home, in
+    // which case that entry is returned in scrambled_key and value
+    inline bool try_place(u64& scrambled_key, u64& value)
+    {
+        const u32 remainder_width = remainder_bits(m_log_capacity);
+        u64 remainder = scrambled_key & compact_hash_table_detail_::low_mask(remainder_width);
+        u64 index = home_slot(scrambled_key);
+
+        for (u64 displacement = 0; ; ++displacement) {
+            if (displacement > sc_max_displacement) {
+                const u64 home = (index - displacement) & capacity_mask();
+                scrambled_key = (home << remainder_width) | remainder;
+                return false;
+            }
+            const u64 slot = read_slot(index);
+            const u64 slot_displacement_plus_one = slot_displacement(slot);
+            if (slot_displacement_plus_one == 0) {
+                write_slot(index, make_slot(displacement, remainder, value));
+                return true;
+            }
+            // take the slot from an entry that is closer to its home
+            if (slot_displacement_plus_one - 1 < displacement) {
+                write_slot(index, make_slot(displacement, remainder, value));
+                remainder = slot_remainder(slot);
+                value = slot_value(slot);
+                displacement = slot_displacement_plus_one - 1;
+            }
+            index = (index + 1) & capacity_mask();
+        }
+    }
+
+    inline void place(u64 scrambled_key, u64 value)
+    {
+        while (!try_place(scrambled_key, value)) {
+            rehash(m_log_capacity + 1);
+        }
+    }
+
+    // rebuilds the table with 2^log_capacity slots, or more if
+    // displacements overflow at that size
+    inline void rehash(u32 log_capacity)
+    {
+        u64* old_words = m_words;
+        const u32 old_log_capacity = m_log_capacity;
+        const u64 old_capacity = capacity();
+
+        for (; ; ++log_capacity) {
+            const u64 new_num_words = num_words(log_capacity);
+            m_words = new u64[new_num_words];
+            memset(m_words, 0, new_num_words * sizeof(u64));
+            m_log_capacity = log_capacity;
+
+            bool placed_all = true;
+            for (u64 i = 0; i < old_capacity; ++i) {
+                const u64 slot = read_slot(old_words, old_log_capacity, i);
+                if (slot_displacement(slot) == 0) {
+                    continue;
+                }
+                u64 scrambled_key = scrambled_key_at(i, slot, old_log_capacity);
+                u64 value = slot_value(slot, old_log_capacity);
+                if (!try_place(scrambled_key, value)) {
+                    placed_all = false;
+                    break;
+                }
+            }
+            if (placed_all) {
+                break;
+            }
+            delete[] m_words;
+        }
+
+        if (old_words != nullptr) {
+            delete[] old_words;
+        }
+    }
+
+    inline void copy_from(const CompactHashTable& other)
+    {
+        m_log_capacity = other.m_log_capacity;
+        m_size = other.m_size;
+        if (other.m_words == nullptr) {
+            m_words = nullptr;
+            return;
+        }
+        const u64 other_num_words = num_words(m_log_capacity);
+        m_words = new u64[other_num_words];
+        memcpy(m_words, other.m_words, other_num_words * sizeof(u64));
+    }
+
+    inline void steal_from(CompactHashTable& other)
+    {
+        m_words = other.m_words;
+        m_log_capacity = other.m_log_capacity;
+        m_size = other.m_size;
+
+        other.m_words = nullptr;
+        other.m_log_capacity = 0;
+        other.m_size = 0;
+    }
+
+    inline void deallocate()
+    {
+        if (m_words != nullptr) {
+            delete[] m_words;
+        }
+        m_words = nullptr;
+        m_log_capacity = 0;
+        m_size = 0;
+    }
+
+protected:
+    // inserts the key if it is not present, and sets its value to
+    // value if it was inserted or if overwrite is true, returns true
+    // if the key was inserted
+    inline bool insert_key(u64 key, u64 value, bool overwrite)
+    {
+        // only the low bits of the key and value would be stored
+        if ((key & ~key_mask()) != 0 ||
+            (value & ~compact_hash_table_detail_::low_mask(VALUEBITS)) != 0) {
+            throw std::out_of_range("CompactHashTable: key or value is too wide");
+        }
+        const u64 index = find_index(key);
+        if (index != capacity()) {
+            if (overwrite) {
+                const u64 slot = read_slot(index);
+                write_slot(index, make_slot(slot_displacement(slot) - 1,
+                                            slot_remainder(slot), value));
+            }
+            return false;
+        }
+
+        if (m_words == nullptr) {
+            rehash(sc_min_log_capacity);
+        } else if (m_size + 1 > max_load(capacity()) && m_log_capacity < KEYBITS) {
+            rehash(m_log_capacity + 1);
+        }
+        place(scramble(key), value);
+        ++m_size;
+        return true;
+    }
+
+    // returns false if the key is not present
+    inline bool find_value(u64 key, u64& value) const
+    {
+        const u64 index = find_index(key);
+        if (index == capacity()) {
+            return false;
+        }
+        value = value_at(index);
+        return true;
+    }
+
+public:
+    inline CompactHashTable()
+        : m_words(nullptr), m_log_capacity(0), m_size(0)
+    {
+        // Nothing here
+    }
+
+    inline CompactHashTable(const CompactHashTable& other)
+        : m_words(nullptr), m_log_capacity(0), m_size(0)
+    {
+        copy_from(other);
+    }
+
+    inline CompactHashTable(CompactHashTable&& other)
+        : m_words(nullptr), m_log_capacity(0), m_size(0)
+    {
+        steal_from(other);
+    }
+
+    inline ~CompactHashTable()
+    {
+        deallocate();
+    }
+
+    inline CompactHashTable& operator = (const CompactHashTable& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        deallocate();
+        copy_from(other);
+        return *this;
+    }
+
+    inline CompactHashTable& operator = (CompactHashTable&& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        deallocate();
+        steal_from(other);
+        return *this;
+    }
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    inline u64 capacity() const
+    {
+        return (m_words == nullptr ? 0 : ((u64)1 << m_log_capacity));
+    }
+
+    // the number of bytes taken up by the slots
+    inline u64 storage_bytes() const
+    {
+        return (m_words == nullptr ? 0 : num_words(m_log_capacity) * sizeof(u64));
+    }
+
+    inline void clear()
+    {
+        if (m_words == nullptr) {
+            return;
+        }
+        memset(m_words, 0, num_words(m_log_capacity) * sizeof(u64));
+        m_size = 0;
+    }
+
+    inline void reserve(u64 num_elements)
+    {
+        u32 log_capacity = (m_words == nullptr ? sc_min_log_capacity : m_log_capacity);
+        while (log_capacity < KEYBITS && max_load((u64)1 << log_capacity) < num_elements) {
+            ++log_capacity;
+        }
+        if (m_words == nullptr || log_capacity != m_log_capacity) {
+            rehash(log_capacity);
+        }
+    }
+
+    inline ConstIterator begin() const
+    {
+        return ConstIterator(this, next_full_slot(0));
+    }
+
+    inline ConstIterator end() const
+    {
+        return ConstIterator(this, capacity());
+    }
+
+    inline ConstIterator cbegin() const
+    {
+        return begin();
+    }
+
+    inline ConstIterator cend() const
+    {
+        return end();
+    }
+
+    inline ConstIterator find(u64 key) const
+    {
+        return ConstIterator(this, find_index(key));
+    }
+
+    inline u64 count(u64 key) const
+    {
+        return (find_index(key) != capacity() ? 1 : 0);
+    }
+
+    // shifts the entries that follow back towards their
+    // homes, until an empty slot or an entry at its home
+    inline u64 erase(u64 key)
+    {
+        u64 index = find_index(key);
+        if (index == capacity()) {
+            return 0;
+        }
+        for (u64 next = (index + 1) & capacity_mask(); ;
+             index = next, next = (next + 1) & capacity_mask()) {
+            const u64 slot = read_slot(next);
+            if (slot_displacement(slot) <= 1) {
+                write_slot(index, 0);
+                break;
+            }
+            write_slot(index, make_slot(slot_displacement(slot) - 2,
+                                        slot_remainder(slot), slot_value(slot)));
+        }
+        --m_size;
+        return 1;
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_COMPACT_HASH_TABLE_HPP_ */
+
+//
+// CompactHashTable.hpp ends here
@@ -0,0 +1,146 @@
+// CompactUnorderedMap.hpp ---
+//
+// Filename: CompactUnorderedMap.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 20:41:52 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// Unordered maps from keys of KEYBITS bits to values of VALUEBITS
+// bits, stored bit-packed in a CompactHashTable. Elements are not
+// stored as such, so lookups hand out values rather than references.
+
+#if !defined KINARA_COMMON_CONTAINERS_COMPACT_UNORDERED_MAP_HPP_
+#define KINARA_COMMON_CONTAINERS_COMPACT_UNORDERED_MAP_HPP_
+
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+
+#include "CompactHashTable.hpp"
+
+namespace kinara {
+namespace containers {
+
+template <u32 KEYBITS, u32 VALUEBITS>
+class CompactUnorderedMap : public CompactHashTable<KEYBITS, VALUEBITS>
+{
+    static_assert(VALUEBITS > 0, "CompactUnorderedMap needs a value of at least one bit, "
+                  "use CompactUnorderedSet instead");
+
+private:
+    typedef CompactHashTable<KEYBITS, VALUEBITS> BaseType;
+
+public:
+    typedef std::pair<u64, u64> EntryType;
+    typedef typename BaseType::Iterator Iterator;
+    typedef typename BaseType::ConstIterator ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+    using BaseType::find;
+
+    inline CompactUnorderedMap()
+        : BaseType()
+    {
+        // Nothing here
+    }
+
+    inline CompactUnorderedMap(std::initializer_list<EntryType> init_list)
+        : BaseType()
+    {
+        insert(init_list);
+    }
+
+    template <typename InputIterator,
+              typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+    inline CompactUnorderedMap(const InputIterator& first, const InputIterator& last)
+        : BaseType()
+    {
+        insert(first, last);
+    }
+
+    inline CompactUnorderedMap(const CompactUnorderedMap& other) = default;
+    inline CompactUnorderedMap(CompactUnorderedMap&& other) = default;
+
+    inline CompactUnorderedMap& operator = (const CompactUnorderedMap& other) = default;
+    inline CompactUnorderedMap& operator = (CompactUnorderedMap&& other) = default;
+
+    // does not change the value of a key that is already present,
+    // returns true if the key was inserted
+    inline bool insert(u64 key, u64 value)
+    {
+        return this->insert_key(key, value, false);
+    }
+
+    inline bool insert(const EntryType& entry)
+    {
+        return this->insert_key(entry.first, entry.second, false);
+    }
+
+    // not to be mistaken for insert(key, value)
+    template <typename InputIterator,
+              typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+    inline void insert(const InputIterator& first, const InputIterator& last)
+    {
+        for (auto it = first; it != last; ++it) {
+            insert(*it);
+        }
+    }
+
+    inline void insert(std::initializer_list<EntryType> init_list)
+    {
+        insert(init_list.begin(), init_list.end());
+    }
+
+    // returns true if the key was inserted rather than updated
+    inline bool insert_or_assign(u64 key, u64 value)
+    {
+        return this->insert_key(key, value, true);
+    }
+
+    // returns false, leaving value alone, if the key is not present
+    inline bool find(u64 key, u64& value) const
+    {
+        return this->find_value(key, value);
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_COMPACT_UNORDERED_MAP_HPP_ */
+
+//
+// CompactUnorderedMap.hpp ends here
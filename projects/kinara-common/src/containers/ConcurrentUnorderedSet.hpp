@@ -0,0 +1,592 @@
+// ConcurrentUnorderedSet.hpp ---
+//
+// Filename: ConcurrentUnorderedSet.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 16:40:15 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// An insert only hash set of small, trivially copyable values
+// (such as state fingerprints), for use from many threads at once. Like UnifiedUnorderedSet, it reserves two values that may
+// never be inserted: the nonused value marks free slots, and the
+// deleted value marks free slots that have been sealed off while
+// the table is being migrated to a larger one. The two values must
+// differ, and there is no default for them, since no value of T is
+// safe to reserve in general.
+//
+// No operation takes a lock: insertion claims a free slot with a
+// compare-and-swap. When a table gets half full, a table of twice the
+// size is allocated, and every thread that touches the set helps copy
+// the old table over, a chunk of slots at a time, before retrying its
+// operation on the new table. A thread that runs out of chunks to
+// copy waits for the threads copying the others to finish, so the set
+// is not lock-free in the strict sense: a thread descheduled in the
+// middle of a chunk holds up the others until it runs again.
+//
+// A table that has been replaced may still be read by operations
+// that started before it was, so it is retired rather than freed.
+// Every operation registers in the current epoch on the way in, and
+// the epoch only advances once the operations registered in the one
+// before it are done. A table retired in some epoch is freed once
+// the epoch is two past it, which the thread that completes the next
+// migration usually finds to be the case.
+
+#if !defined KINARA_COMMON_CONTAINERS_CONCURRENT_UNORDERED_SET_HPP_
+#define KINARA_COMMON_CONTAINERS_CONCURRENT_UNORDERED_SET_HPP_
+
+#include <atomic>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+
+template <typename T, typename HashFunction = std::hash<T>>
+class ConcurrentUnorderedSet
+{
+private:
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "ConcurrentUnorderedSet can only hold trivially copyable values");
+
+    static const u64 sc_initial_capacity = 1024;
+    static const u64 sc_migration_chunk_size = 4096;
+    static const u64 sc_num_counter_stripes = 64;
+    static const u64 sc_not_retired = ~(u64)0;
+
+    // one count per cache line, to keep inserting
+    // threads from contending on a single counter
+    class PaddedCounter
+    {
+    public:
+        std::atomic<u64> m_count;
+        char m_padding[64 - sizeof(std::atomic<u64>)];
+
+        inline PaddedCounter()
+            : m_count(0)
+        {
+            // Nothing here
+        }
+    };
+
+    class Table
+    {
+    public:
+        const u64 m_capacity;
+        std::atomic<T>* m_slots;
+        PaddedCounter m_counters[sc_num_counter_stripes];
+        std::atomic<Table*> m_next;
+        std::atomic<u64> m_next_chunk;
+        std::atomic<u64> m_num_chunks_done;
+        // the epoch in which the table was replaced
+        std::atomic<u64> m_retired_epoch;
+
+        inline Table(u64 capacity, const T& nonused_value)
+            : m_capacity(capacity), m_slots(new std::atomic<T>[capacity]),
+              m_next(nullptr), m_next_chunk(0), m_num_chunks_done(0),
+              m_retired_epoch(sc_not_retired)
+        {
+            for (u64 i = 0; i < capacity; ++i) {
+                m_slots[i].store(nonused_value, std::memory_order_relaxed);
+            }
+        }
+
+        inline ~Table()
+        {
+            delete[] m_slots;
+        }
+
+        inline u64 num_chunks() const
+        {
+            return ((m_capacity + sc_migration_chunk_size - 1) / sc_migration_chunk_size);
+        }
+
+        // A table migrates once it is more than half full. Summing
+        // the stripes on every insertion would have the inserting
+        // threads contend on all of them, so a stripe only checks
+        // every this many of its insertions, by when the table can
+        // have grown by at most an eighth of its capacity
+        inline u64 check_mask() const
+        {
+            const u64 interval = m_capacity / (8 * sc_num_counter_stripes);
+            return (interval == 0 ? 0 : interval - 1);
+        }
+
+        inline bool is_over_loaded() const
+        {
+            return (size() > m_capacity / 2);
+        }
+
+        inline u64 size() const
+        {
+            u64 retval = 0;
+            for (u64 i = 0; i < sc_num_counter_stripes; ++i) {
+                retval += m_counters[i].m_count.load(std::memory_order_relaxed);
+            }
+            return retval;
+        }
+    };
+
+    enum class ProbeResult {
+        Inserted, Found, NotFound, Migrating
+    };
+
+    // tables are chained through m_next, from the oldest
+    // one not yet freed to the current one
+    Table* m_first_table;
+    std::atomic<Table*> m_current;
+    // the number of operations in progress that registered in an
+    // even and in an odd epoch, striped by the registering thread
+    mutable PaddedCounter m_num_readers[2][sc_num_counter_stripes];
+    std::atomic<u64> m_epoch;
+    std::atomic_flag m_reclaiming;
+    T m_deleted_value;
+    T m_nonused_value;
+    u64 m_initial_capacity;
+    HashFunction m_hash_function;
+
+    // as in SwissHashTable, the low bits pick the home slot, which
+    // keeps runs of consecutive values together, and the high bits
+    // are folded in so that values differing only there spread out
+    inline u64 hash_value(const T& value) const
+    {
+        u64 retval = m_hash_function(value);
+        return (retval ^ (retval >> 16) ^ (retval >> 32));
+    }
+
+    inline static bool bitwise_equal(const T& value1, const T& value2)
+    {
+        return (memcmp(&value1, &value2, sizeof(T)) == 0);
+    }
+
+    inline bool is_reserved(const T& value) const
+    {
+        return (bitwise_equal(value, m_deleted_value) ||
+                bitwise_equal(value, m_nonused_value));
+    }
+
+    inline static void check_distinct(const T& deleted_value, const T& nonused_value)
+    {
+        if (bitwise_equal(deleted_value, nonused_value)) {
+            throw std::invalid_argument("ConcurrentUnorderedSet: the deleted and nonused "
+                                        "values must be distinct");
+        }
+    }
+
+    inline ProbeResult probe(Table* table, const T& value, u64 hash, bool do_insert)
+    {
+        const u64 mask = table->m_capacity - 1;
+        u64 index = hash & mask;
+
+        for (u64 i = 0; i < table->m_capacity; ++i) {
+            T slot_value = table->m_slots[index].load(std::memory_order_acquire);
+
+            if (bitwise_equal(slot_value, value)) {
+                return ProbeResult::Found;
+            }
+            if (bitwise_equal(slot_value, m_deleted_value)) {
+                // the value cannot be further along, since
+                // free slots are only sealed by migration
+                return ProbeResult::Migrating;
+            }
+            if (bitwise_equal(slot_value, m_nonused_value)) {
+                if (!do_insert) {
+                    return (table->m_next.load(std::memory_order_acquire) != nullptr ?
+                            ProbeResult::Migrating : ProbeResult::NotFound);
+                }
+                if (table->m_slots[index].compare_exchange_strong(slot_value, value,
+                                                                  std::memory_order_acq_rel)) {
+                    auto& counter = table->m_counters[index % sc_num_counter_stripes];
+                    auto count = counter.m_count.fetch_add(1, std::memory_order_relaxed);
+                    if (((count + 1) & table->check_mask()) == 0 &&
+                        table->is_over_loaded()) {
+                        start_migration(table);
+                    }
+                    return ProbeResult::Inserted;
+                }
+                // lost the race for this slot, which now holds
+                // either another value or the seal
+                if (bitwise_equal(slot_value, value)) {
+                    return ProbeResult::Found;
+                }
+                if (bitwise_equal(slot_value, m_deleted_value)) {
+                    return ProbeResult::Migrating;
+                }
+            }
+            index = (index + 1) & mask;
+        }
+
+        start_migration(table);
+        return ProbeResult::Migrating;
+    }
+
+    inline void start_migration(Table* table)
+    {
+        if (table->m_next.load(std::memory_order_acquire) != nullptr) {
+            return;
+        }
+        Table* new_table = new Table(table->m_capacity * 2, m_nonused_value);
+        Table* expected = nullptr;
+        if (!table->m_next.compare_exchange_strong(expected, new_table,
+                                                   std::memory_order_acq_rel)) {
+            delete new_table;
+        }
+    }
+
+    // copies one slot of a table that is being migrated,
+    // sealing it off if it is free
+    inline void migrate_slot(Table* table, Table* new_table, u64 index)
+    {
+        T slot_value = table->m_slots[index].load(std::memory_order_acquire);
+        while (bitwise_equal(slot_value, m_nonused_value)) {
+            if (table->m_slots[index].compare_exchange_strong(slot_value, m_deleted_value,
+                                                              std::memory_order_acq_rel)) {
+                return;
+            }
+        }
+        if (bitwise_equal(slot_value, m_deleted_value)) {
+            return;
+        }
+        // nobody else inserts into the new table until
+        // the migration is complete, it cannot fill up
+        probe(new_table, slot_value, hash_value(slot_value), true);
+    }
+
+    // helps migrate the table, returning once the
+    // migration is complete and the new table is current
+    inline Table* help_migrate(Table* table)
+    {
+        Table* new_table = table->m_next.load(std::memory_order_acquire);
+        const u64 num_chunks = table->num_chunks();
+
+        while (true) {
+            const u64 chunk = table->m_next_chunk.fetch_add(1, std::memory_order_acq_rel);
+            if (chunk >= num_chunks) {
+                break;
+            }
+            const u64 first = chunk * sc_migration_chunk_size;
+            const u64 last = std::min(first + sc_migration_chunk_size, table->m_capacity);
+            for (u64 i = first; i < last; ++i) {
+                migrate_slot(table, new_table, i);
+            }
+            table->m_num_chunks_done.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        while (table->m_num_chunks_done.load(std::memory_order_acquire) < num_chunks) {
+            std::this_thread::yield();
+        }
+
+        Table* expected = table;
+        if (m_current.compare_exchange_strong(expected, new_table,
+                                              std::memory_order_acq_rel)) {
+            // operations that start from now on cannot see the table
+            table->m_retired_epoch.store(m_epoch.load(std::memory_order_seq_cst),
+                                         std::memory_order_release);
+        }
+        // the table that is current now may itself be migrating
+        return m_current.load(std::memory_order_acquire);
+    }
+
+    // threads are dealt the stripes of m_num_readers in turn, so
+    // that each mostly registers on a cache line of its own
+    static inline u64 thread_stripe()
+    {
+        static std::atomic<u64> next_stripe(0);
+        static thread_local u64 stripe =
+            next_stripe.fetch_add(1, std::memory_order_relaxed) % sc_num_counter_stripes;
+        return stripe;
+    }
+
+    // registers an operation in the current epoch,
+    // returns the epoch that it registered in
+    inline u64 enter(u64 stripe) const
+    {
+        while (true) {
+            const u64 epoch = m_epoch.load(std::memory_order_seq_cst);
+            auto& num_readers = m_num_readers[epoch & 1][stripe].m_count;
+            num_readers.fetch_add(1, std::memory_order_seq_cst);
+            if (m_epoch.load(std::memory_order_seq_cst) == epoch) {
+                return epoch;
+            }
+            // the epoch moved on before the registration
+            // was seen, it may not have been waited for
+            num_readers.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    inline void leave(u64 epoch, u64 stripe) const
+    {
+        m_num_readers[epoch & 1][stripe].m_count.fetch_sub(1, std::memory_order_release);
+    }
+
+    // the epoch can advance once no operation that registered
+    // in the epoch before the current one is still in progress
+    inline bool try_advance_epoch(u64& epoch)
+    {
+        u64 num_readers = 0;
+        for (u64 i = 0; i < sc_num_counter_stripes; ++i) {
+            num_readers += m_num_readers[(epoch + 1) & 1][i].m_count.load(
+                std::memory_order_seq_cst);
+        }
+        if (num_readers != 0) {
+            return false;
+        }
+        if (m_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst)) {
+            ++epoch;
+        }
+        return true;
+    }
+
+    // advances the epoch as far as it can go, by two at most,
+    // and frees the tables that were retired two or more epochs ago
+    inline void reclaim_tables()
+    {
+        if (m_reclaiming.test_and_set(std::memory_order_acquire)) {
+            return;
+        }
+        u64 epoch = m_epoch.load(std::memory_order_seq_cst);
+        if (try_advance_epoch(epoch)) {
+            try_advance_epoch(epoch);
+        }
+
+        Table* current = m_current.load(std::memory_order_acquire);
+        while (m_first_table != current) {
+            const u64 retired_epoch =
+                m_first_table->m_retired_epoch.load(std::memory_order_acquire);
+            if (retired_epoch == sc_not_retired || retired_epoch + 2 > epoch) {
+                break;
+            }
+            Table* next = m_first_table->m_next.load(std::memory_order_acquire);
+            delete m_first_table;
+            m_first_table = next;
+        }
+        m_reclaiming.clear(std::memory_order_release);
+    }
+
+    inline void reset_tables()
+    {
+        Table* table = m_first_table;
+        while (table != nullptr) {
+            Table* next = table->m_next.load(std::memory_order_acquire);
+            delete table;
+            table = next;
+        }
+        m_first_table = new Table(m_initial_capacity, m_nonused_value);
+        m_current.store(m_first_table, std::memory_order_release);
+    }
+
+public:
+    inline ConcurrentUnorderedSet(const T& deleted_value, const T& nonused_value,
+                                  u64 initial_capacity = sc_initial_capacity)
+        : m_first_table(nullptr), m_current(nullptr), m_epoch(0),
+          m_deleted_value(deleted_value), m_nonused_value(nonused_value),
+          m_initial_capacity(sc_initial_capacity)
+    {
+        m_reclaiming.clear();
+        check_distinct(deleted_value, nonused_value);
+        while (m_initial_capacity < initial_capacity) {
+            m_initial_capacity *= 2;
+        }
+        reset_tables();
+    }
+
+    ConcurrentUnorderedSet(const ConcurrentUnorderedSet& other) = delete;
+    ConcurrentUnorderedSet& operator = (const ConcurrentUnorderedSet& other) = delete;
+
+    inline ~ConcurrentUnorderedSet()
+    {
+        Table* table = m_first_table;
+        while (table != nullptr) {
+            Table* next = table->m_next.load(std::memory_order_acquire);
+            delete table;
+            table = next;
+        }
+    }
+
+    // These must be called before any insertions
+    inline void set_deleted_value(const T& deleted_value)
+    {
+        check_distinct(deleted_value, m_nonused_value);
+        m_deleted_value = deleted_value;
+    }
+
+    inline void set_nonused_value(const T& nonused_value)
+    {
+        check_distinct(m_deleted_value, nonused_value);
+        m_nonused_value = nonused_value;
+        reset_tables();
+    }
+
+    // returns true if the value was not already present,
+    // throws if the value is one of the reserved ones
+    inline bool insert(const T& value)
+    {
+        if (is_reserved(value)) {
+            throw std::invalid_argument("ConcurrentUnorderedSet: cannot insert the "
+                                        "deleted or nonused value");
+        }
+        const u64 hash = hash_value(value);
+        const u64 stripe = thread_stripe();
+        const u64 epoch = enter(stripe);
+        Table* table = m_current.load(std::memory_order_acquire);
+        bool migrated = false;
+        bool retval;
+
+        while (true) {
+            if (table->m_next.load(std::memory_order_acquire) != nullptr) {
+                table = help_migrate(table);
+                migrated = true;
+                continue;
+            }
+            const ProbeResult result = probe(table, value, hash, true);
+            if (result == ProbeResult::Inserted || result == ProbeResult::Found) {
+                retval = (result == ProbeResult::Inserted);
+                break;
+            }
+            table = help_migrate(table);
+            migrated = true;
+        }
+
+        leave(epoch, stripe);
+        if (migrated) {
+            reclaim_tables();
+        }
+        return retval;
+    }
+
+    inline bool contains(const T& value)
+    {
+        // the reserved values would match free slots
+        if (is_reserved(value)) {
+            return false;
+        }
+        const u64 hash = hash_value(value);
+        const u64 stripe = thread_stripe();
+        const u64 epoch = enter(stripe);
+        Table* table = m_current.load(std::memory_order_acquire);
+        bool migrated = false;
+        bool retval;
+
+        while (true) {
+            const ProbeResult result = probe(table, value, hash, false);
+            if (result == ProbeResult::Found || result == ProbeResult::NotFound) {
+                retval = (result == ProbeResult::Found);
+                break;
+            }
+            table = help_migrate(table);
+            migrated = true;
+        }
+
+        leave(epoch, stripe);
+        if (migrated) {
+            reclaim_tables();
+        }
+        return retval;
+    }
+
+    inline u64 count(const T& value)
+    {
+        return (contains(value) ? 1 : 0);
+    }
+
+    // exact only when no insertions are in progress
+    inline u64 size() const
+    {
+        const u64 stripe = thread_stripe();
+        const u64 epoch = enter(stripe);
+        const u64 retval = m_current.load(std::memory_order_acquire)->size();
+        leave(epoch, stripe);
+        return retval;
+    }
+
+    inline bool empty() const
+    {
+        return (size() == 0);
+    }
+
+    inline u64 capacity() const
+    {
+        const u64 stripe = thread_stripe();
+        const u64 epoch = enter(stripe);
+        const u64 retval = m_current.load(std::memory_order_acquire)->m_capacity;
+        leave(epoch, stripe);
+        return retval;
+    }
+
+    // not thread safe. Keeps the current table, emptied
+    // out, and releases the ones it has replaced
+    inline void clear()
+    {
+        Table* current = m_current.load(std::memory_order_acquire);
+        Table* table = m_first_table;
+        while (table != current) {
+            Table* next = table->m_next.load(std::memory_order_acquire);
+            delete table;
+            table = next;
+        }
+        m_first_table = current;
+
+        // a migration may have been started but not carried out
+        Table* pending = current->m_next.load(std::memory_order_acquire);
+        while (pending != nullptr) {
+            Table* next = pending->m_next.load(std::memory_order_acquire);
+            delete pending;
+            pending = next;
+        }
+        current->m_next.store(nullptr, std::memory_order_relaxed);
+        current->m_next_chunk.store(0, std::memory_order_relaxed);
+        current->m_num_chunks_done.store(0, std::memory_order_relaxed);
+
+        for (u64 i = 0; i < current->m_capacity; ++i) {
+            current->m_slots[i].store(m_nonused_value, std::memory_order_relaxed);
+        }
+        for (u64 i = 0; i < sc_num_counter_stripes; ++i) {
+            current->m_counters[i].m_count.store(0, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_CONCURRENT_UNORDERED_SET_HPP_ */
+
+//
+// ConcurrentUnorderedSet.hpp ends here
@@ -0,0 +1,839 @@
+// CuckooHashTable.hpp ---
+//
+// Filename: CuckooHashTable.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 21:36:20 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// A bucketized cuckoo hash table. Every element lives in one of
+// two buckets, determined by its hash, so a lookup examines at most
+// two buckets, whatever the load. An insertion into two full buckets
+// evicts an element from one of them into its alternate bucket, and
+// so on, along a random walk. The table only grows when the load
+// exceeds what its buckets can hold, or a walk gets too long.
+//
+// Each slot has a tag byte holding a few bits of the hash of its
+// element (zero for an empty slot), and keys are only compared on
+// matching tags. A bucket holds its tags followed by its slots, and
+// has as many slots as fit in a cache line along with their tags:
+// seven for 8 byte elements, three for 16 byte elements. Buckets
+// start on a cache line, so a lookup touches at most two lines. Only
+// elements too large for two of them to share a line with their
+// tags get buckets of two slots spanning more than one line.
+//
+// A bucket also counts the elements that it is the first bucket of,
+// but which were displaced into their second bucket, and the tag of
+// such an element says so. A lookup that misses in the first bucket
+// of its key only reads the second if that count is not zero, so
+// until the table is quite full, most misses touch a single line.
+
+#if !defined KINARA_COMMON_CONTAINERS_CUCKOO_HASH_TABLE_HPP_
+#define KINARA_COMMON_CONTAINERS_CUCKOO_HASH_TABLE_HPP_
+
+#include <new>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+namespace cuckoo_hash_table_detail_ {
+
+typedef std::uint8_t Tag;
+
+// set in the tag of an element that is in its second bucket
+static const Tag sc_second_bucket_tag = 0x80;
+static const std::uint8_t sc_max_num_displaced = 0xFF;
+
+static const u64 sc_cache_line_size = 64;
+static const u64 sc_min_bucket_width = 2;
+static const u64 sc_max_bucket_width = 8;
+
+// the tags of a bucket followed by its slots. m_num_displaced
+// counts the elements whose first bucket this is, but which are
+// in their second bucket. It sticks at sc_max_num_displaced
+template <typename T, u64 WIDTH>
+struct Bucket
+{
+    Tag m_tags[WIDTH];
+    std::uint8_t m_num_displaced;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type m_slots[WIDTH];
+};
+
+constexpr u64 bucket_size(u64 element_size, u64 element_alignment, u64 width)
+{
+    return (((width + 1 + element_alignment - 1) / element_alignment) * element_alignment +
+            width * element_size);
+}
+
+// the most slots that fit in a cache line along with their tags,
+// but no fewer than the narrowest bucket that still fills up well
+constexpr u64 bucket_width(u64 element_size, u64 element_alignment,
+                           u64 width = sc_max_bucket_width)
+{
+    return ((width <= sc_min_bucket_width ||
+             bucket_size(element_size, element_alignment, width) <= sc_cache_line_size) ?
+            width : bucket_width(element_size, element_alignment, width - 1));
+}
+
+template <typename TableType, bool ISCONST>
+class IteratorBase
+{
+    friend TableType;
+    template <typename, bool> friend class IteratorBase;
+
+public:
+    typedef typename TableType::ValueType ValueType;
+    typedef typename std::conditional<ISCONST, const ValueType, ValueType>::type
+    QualifiedValueType;
+
+    typedef std::forward_iterator_tag iterator_category;
+    typedef ValueType value_type;
+    typedef i64 difference_type;
+    typedef QualifiedValueType* pointer;
+    typedef QualifiedValueType& reference;
+
+private:
+    typedef typename std::conditional<ISCONST, const TableType, TableType>::type
+    QualifiedTableType;
+
+    QualifiedTableType* m_table;
+    u64 m_index;
+
+    inline IteratorBase(QualifiedTableType* table, u64 index)
+        : m_table(table), m_index(index)
+    {
+        // Nothing here
+    }
+
+public:
+    inline IteratorBase()
+        : m_table(nullptr), m_index(0)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase(const IteratorBase& other) = default;
+
+    // conversion from a mutable iterator to a const one
+    template <bool OTHERCONST,
+              typename = typename std::enable_if<ISCONST && !OTHERCONST>::type>
+    inline IteratorBase(const IteratorBase<TableType, OTHERCONST>& other)
+        : m_table(other.m_table), m_index(other.m_index)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase& operator = (const IteratorBase& other) = default;
+
+    inline reference operator * () const
+    {
+        return m_table->slot(m_index);
+    }
+
+    inline pointer operator -> () const
+    {
+        return &(m_table->slot(m_index));
+    }
+
+    inline IteratorBase& operator ++ ()
+    {
+        m_index = m_table->next_full_slot(m_index + 1);
+        return *this;
+    }
+
+    inline IteratorBase operator ++ (int)
+    {
+        auto retval = *this;
+        ++(*this);
+        return retval;
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator == (const IteratorBase<TableType, OTHERCONST>& other) const
+    {
+        return (m_index == other.m_index);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator != (const IteratorBase<TableType, OTHERCONST>& other) const
+    {
+        return (m_index != other.m_index);
+    }
+};
+
+} /* end namespace cuckoo_hash_table_detail_ */
+
+// T is the type of the elements, KeyExtractor extracts
+// the key (of type KeyType) from an element
+template <typename T, typename KeyType, typename KeyExtractor,
+          typename HashFunction, typename EqualsFunction>
+class CuckooHashTable
+{
+    template <typename, bool> friend class cuckoo_hash_table_detail_::IteratorBase;
+
+public:
+    typedef T ValueType;
+    typedef cuckoo_hash_table_detail_::IteratorBase<CuckooHashTable, false> Iterator;
+    typedef cuckoo_hash_table_detail_::IteratorBase<CuckooHashTable, true> ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+private:
+    typedef cuckoo_hash_table_detail_::Tag Tag;
+    static const Tag sc_second_bucket_tag = cuckoo_hash_table_detail_::sc_second_bucket_tag;
+    static const std::uint8_t sc_max_num_displaced =
+        cuckoo_hash_table_detail_::sc_max_num_displaced;
+    typedef typename std::remove_const<T>::type StorageType;
+    typedef typename std::aligned_storage<sizeof(StorageType),
+                                          std::alignment_of<StorageType>::value>::type
+    ElementBuffer;
+
+    static const u64 sc_bucket_width =
+        cuckoo_hash_table_detail_::bucket_width(sizeof(StorageType),
+                                                std::alignment_of<StorageType>::value);
+    typedef cuckoo_hash_table_detail_::Bucket<StorageType, sc_bucket_width> Bucket;
+    // buckets start on a cache line, so that a bucket
+    // that fits in one line does not straddle two
+    static const u64 sc_bucket_stride =
+        ((sizeof(Bucket) + cuckoo_hash_table_detail_::sc_cache_line_size - 1) /
+         cuckoo_hash_table_detail_::sc_cache_line_size) *
+        cuckoo_hash_table_detail_::sc_cache_line_size;
+    static const u64 sc_max_evictions = 512;
+    static const u64 sc_in_hand = ~(u64)0;
+    static const u64 sc_untracked = ~(u64)1;
+
+    char* m_buckets;
+    void* m_bucket_memory;
+    u64 m_num_buckets;
+    u32 m_log_num_buckets;
+    u64 m_size;
+    u64 m_random_state;
+    KeyExtractor m_key_extractor;
+    HashFunction m_hash_function;
+    EqualsFunction m_equals_function;
+
+    static inline u64 spread_hash(u64 hash_value)
+    {
+        return (hash_value ^ (hash_value >> 16) ^ (hash_value >> 32));
+    }
+
+    // never zero, and clear of sc_second_bucket_tag
+    static inline Tag hash_tag(u64 hash_value)
+    {
+        return (Tag)(((hash_value * 0xC2B2AE3D27D4EB4FULL) >> 58) + 1);
+    }
+
+    // two choices of bucket fill up to about 98% with four slots
+    // to a bucket, 96% with three and 90% with two, before walks
+    // start to fail
+    static inline u64 max_load(u64 capacity)
+    {
+        return (sc_bucket_width >= 4 ? capacity - (capacity / 20) :
+                (sc_bucket_width == 3 ? capacity - (capacity / 10) :
+                 capacity - (capacity / 5)));
+    }
+
+    inline Bucket& bucket_at(u64 bucket) const
+    {
+        return *reinterpret_cast<Bucket*>(m_buckets + bucket * sc_bucket_stride);
+    }
+
+    inline Tag& tag_at(u64 index) const
+    {
+        return bucket_at(index / sc_bucket_width).m_tags[index % sc_bucket_width];
+    }
+
+    inline StorageType& slot(u64 index) const
+    {
+        auto& bucket = bucket_at(index / sc_bucket_width);
+        return *reinterpret_cast<StorageType*>(&bucket.m_slots[index % sc_bucket_width]);
+    }
+
+    inline u64 capacity_of_buckets() const
+    {
+        return m_num_buckets * sc_bucket_width;
+    }
+
+    // As with SwissHashTable, the low bits of the spread hash pick a
+    // home slot, which is where an element goes if it is free, so that
+    // small integral keys under an identity hash iterate in order
+    inline u64 first_bucket(u64 hash_value) const
+    {
+        return (spread_hash(hash_value) / sc_bucket_width) & (m_num_buckets - 1);
+    }
+
+    inline u64 home_slot(u64 hash_value) const
+    {
+        return (first_bucket(hash_value) * sc_bucket_width +
+                spread_hash(hash_value) % sc_bucket_width);
+    }
+
+    // the two buckets of an element are always distinct
+    inline u64 second_bucket(u64 hash_value) const
+    {
+        const u64 first = first_bucket(hash_value);
+        if (m_log_num_buckets == 0) {
+            return first;
+        }
+        const u64 second = (hash_value * 0x9E3779B97F4A7C15ULL) >> (64 - m_log_num_buckets);
+        return (second == first ? first ^ 1 : second);
+    }
+
+    inline u64 alternate_bucket(u64 hash_value, u64 bucket) const
+    {
+        const u64 first = first_bucket(hash_value);
+        return (bucket == first ? second_bucket(hash_value) : first);
+    }
+
+    // xorshift, to pick the elements to evict
+    inline u64 next_random()
+    {
+        m_random_state ^= (m_random_state << 13);
+        m_random_state ^= (m_random_state >> 7);
+        m_random_state ^= (m_random_state << 17);
+        return m_random_state;
+    }
+
+    inline u64 next_full_slot(u64 index) const
+    {
+        const u64 capacity = capacity_of_buckets();
+        while (index < capacity && tag_at(index) == 0) {
+            ++index;
+        }
+        return index;
+    }
+
+    // returns the capacity if the bucket is full
+    inline u64 find_free_slot(u64 bucket) const
+    {
+        const Bucket& the_bucket = bucket_at(bucket);
+        for (u64 i = 0; i < sc_bucket_width; ++i) {
+            if (the_bucket.m_tags[i] == 0) {
+                return bucket * sc_bucket_width + i;
+            }
+        }
+        return capacity_of_buckets();
+    }
+
+    inline u64 find_in_bucket(u64 bucket, Tag tag, const KeyType& key) const
+    {
+        const Bucket& the_bucket = bucket_at(bucket);
+        for (u64 i = 0; i < sc_bucket_width; ++i) {
+            if (the_bucket.m_tags[i] != tag) {
+                continue;
+            }
+            auto element = reinterpret_cast<const StorageType*>(&the_bucket.m_slots[i]);
+            if (m_equals_function(m_key_extractor(*element), key)) {
+                return bucket * sc_bucket_width + i;
+            }
+        }
+        return capacity_of_buckets();
+    }
+
+    // returns the capacity if the key is not present
+    inline u64 find_index(const KeyType& key, u64 hash_value) const
+    {
+        if (m_num_buckets == 0) {
+            return 0;
+        }
+        const Tag tag = hash_tag(hash_value);
+        const u64 first = first_bucket(hash_value);
+        const u64 index = find_in_bucket(first, tag, key);
+        if (index != capacity_of_buckets() || bucket_at(first).m_num_displaced == 0) {
+            return index;
+        }
+        return find_in_bucket(second_bucket(hash_value),
+                              (Tag)(tag | sc_second_bucket_tag), key);
+    }
+
+    inline void allocate(u64 num_buckets)
+    {
+        m_num_buckets = num_buckets;
+        m_log_num_buckets = 0;
+        while (((u64)1 << m_log_num_buckets) < num_buckets) {
+            ++m_log_num_buckets;
+        }
+        if (num_buckets == 0) {
+            m_buckets = nullptr;
+            m_bucket_memory = nullptr;
+            return;
+        }
+
+        // align the buckets with the cache lines
+        const u64 line_size = cuckoo_hash_table_detail_::sc_cache_line_size;
+        m_bucket_memory = ::operator new(num_buckets * sc_bucket_stride + line_size);
+        const u64 address = (u64)(uintptr_t)m_bucket_memory;
+        m_buckets = reinterpret_cast<char*>((uintptr_t)((address + line_size - 1) &
+                                                        ~(line_size - 1)));
+        clear_tags();
+    }
+
+    inline void clear_tags()
+    {
+        for (u64 i = 0; i < m_num_buckets; ++i) {
+            memset(bucket_at(i).m_tags, 0, sizeof(bucket_at(i).m_tags));
+            bucket_at(i).m_num_displaced = 0;
+        }
+    }
+
+    inline void destroy_elements()
+    {
+        if (!std::is_trivially_destructible<StorageType>::value) {
+            const u64 capacity = capacity_of_buckets();
+            for (u64 i = next_full_slot(0); i < capacity; i = next_full_slot(i + 1)) {
+                slot(i).~StorageType();
+            }
+        }
+    }
+
+    inline void deallocate()
+    {
+        if (m_num_buckets == 0) {
+            return;
+        }
+        destroy_elements();
+        ::operator delete(m_bucket_memory);
+        m_buckets = nullptr;
+        m_bucket_memory = nullptr;
+        m_num_buckets = 0;
+        m_log_num_buckets = 0;
+    }
+
+    inline void move_into_slot(u64 index, StorageType* element, u64 hash_value)
+    {
+        new (&slot(index)) StorageType(std::move(*element));
+        element->~StorageType();
+        const u64 first = first_bucket(hash_value);
+        if (index / sc_bucket_width == first) {
+            tag_at(index) = hash_tag(hash_value);
+            return;
+        }
+        tag_at(index) = (Tag)(hash_tag(hash_value) | sc_second_bucket_tag);
+        std::uint8_t& num_displaced = bucket_at(first).m_num_displaced;
+        if (num_displaced != sc_max_num_displaced) {
+            ++num_displaced;
+        }
+    }
+
+    // to be called when the element with the given
+    // tag and hash leaves its slot
+    inline void leave_slot(Tag tag, u64 hash_value)
+    {
+        if ((tag & sc_second_bucket_tag) == 0) {
+            return;
+        }
+        std::uint8_t& num_displaced = bucket_at(first_bucket(hash_value)).m_num_displaced;
+        if (num_displaced != sc_max_num_displaced) {
+            --num_displaced;
+        }
+    }
+
+    // Places the element in hand, evicting elements into their
+    // alternate buckets as needed. Returns false if the walk got
+    // too long, with some element then in hand and its hash in
+    // hash_value. tracked follows one element through the walk: it
+    // is the index of its slot, sc_in_hand while it is in hand, or
+    // sc_untracked if no element is followed.
+    inline bool try_place(StorageType* hand, u64& hash_value, u64& tracked)
+    {
+        u64 bucket = first_bucket(hash_value);
+        u64 index = home_slot(hash_value);
+        if (tag_at(index) != 0) {
+            index = find_free_slot(bucket);
+        }
+        if (index == capacity_of_buckets()) {
+            bucket = second_bucket(hash_value);
+            index = find_free_slot(bucket);
+        }
+        if (index != capacity_of_buckets()) {
+            move_into_slot(index, hand, hash_value);
+            if (tracked == sc_in_hand) {
+                tracked = index;
+            }
+            return true;
+        }
+
+        for (u64 eviction = 0; eviction < sc_max_evictions; ++eviction) {
+            // swap the element in hand with a victim from the bucket
+            index = bucket * sc_bucket_width + (next_random() % sc_bucket_width);
+            ElementBuffer victim_buffer;
+            StorageType* victim = reinterpret_cast<StorageType*>(&victim_buffer);
+            const Tag victim_tag = tag_at(index);
+            new (victim) StorageType(std::move(slot(index)));
+            slot(index).~StorageType();
+            move_into_slot(index, hand, hash_value);
+            new (hand) StorageType(std::move(*victim));
+            victim->~StorageType();
+            if (tracked == sc_in_hand) {
+                tracked = index;
+            } else if (tracked == index) {
+                tracked = sc_in_hand;
+            }
+
+            hash_value = m_hash_function(m_key_extractor(*hand));
+            leave_slot(victim_tag, hash_value);
+            bucket = alternate_bucket(hash_value, bucket);
+            index = find_free_slot(bucket);
+            if (index != capacity_of_buckets()) {
+                move_into_slot(index, hand, hash_value);
+                if (tracked == sc_in_hand) {
+                    tracked = index;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // grows the table until the walk succeeds
+    inline void place(StorageType* hand, u64 hash_value, u64& tracked)
+    {
+        while (!try_place(hand, hash_value, tracked)) {
+            rehash(m_num_buckets * 2, tracked);
+        }
+    }
+
+    // tracked is as for try_place, a slot index is
+    // updated to the index of the element in the new table
+    inline void rehash(u64 new_num_buckets, u64& tracked)
+    {
+        char* old_buckets = m_buckets;
+        void* old_bucket_memory = m_bucket_memory;
+        const u64 old_capacity = capacity_of_buckets();
+
+        allocate(new_num_buckets);
+
+        // placing an element may grow the table again, which
+        // only moves what has been placed so far. The element
+        // in hand here is not the one in the hand of a walk
+        // that this rehash is part of, so it is tracked apart
+        ElementBuffer hand_buffer;
+        StorageType* hand = reinterpret_cast<StorageType*>(&hand_buffer);
+        u64 moved_tracked = sc_untracked;
+        for (u64 i = 0; i < old_capacity; ++i) {
+            Bucket& old_bucket =
+                *reinterpret_cast<Bucket*>(old_buckets +
+                                           (i / sc_bucket_width) * sc_bucket_stride);
+            if (old_bucket.m_tags[i % sc_bucket_width] == 0) {
+                continue;
+            }
+            StorageType* old_slot =
+                reinterpret_cast<StorageType*>(&old_bucket.m_slots[i % sc_bucket_width]);
+            new (hand) StorageType(std::move(*old_slot));
+            old_slot->~StorageType();
+            if (i == tracked) {
+                moved_tracked = sc_in_hand;
+            }
+            place(hand, m_hash_function(m_key_extractor(*hand)), moved_tracked);
+        }
+        if (tracked < old_capacity) {
+            tracked = moved_tracked;
+        }
+
+        if (old_capacity != 0) {
+            ::operator delete(old_bucket_memory);
+        }
+    }
+
+    inline void rehash(u64 new_num_buckets)
+    {
+        u64 tracked = sc_untracked;
+        rehash(new_num_buckets, tracked);
+    }
+
+    inline void copy_from(const CuckooHashTable& other)
+    {
+        allocate(other.m_num_buckets);
+        m_size = other.m_size;
+        const u64 capacity = capacity_of_buckets();
+        if (capacity == 0) {
+            return;
+        }
+        for (u64 i = 0; i < m_num_buckets; ++i) {
+            memcpy(bucket_at(i).m_tags, other.bucket_at(i).m_tags,
+                   sizeof(bucket_at(i).m_tags));
+            bucket_at(i).m_num_displaced = other.bucket_at(i).m_num_displaced;
+        }
+        for (u64 i = next_full_slot(0); i < capacity; i = next_full_slot(i + 1)) {
+            new (&slot(i)) StorageType(other.slot(i));
+        }
+    }
+
+    inline void steal_from(CuckooHashTable& other)
+    {
+        m_buckets = other.m_buckets;
+        m_bucket_memory = other.m_bucket_memory;
+        m_num_buckets = other.m_num_buckets;
+        m_log_num_buckets = other.m_log_num_buckets;
+        m_size = other.m_size;
+
+        other.m_buckets = nullptr;
+        other.m_bucket_memory = nullptr;
+        other.m_num_buckets = 0;
+        other.m_log_num_buckets = 0;
+        other.m_size = 0;
+    }
+
+protected:
+    // constructs a new element from args if no element with
+    // the same key exists, returns the index of the element
+    // with the key and whether it was inserted
+    template <typename... ArgTypes>
+    inline std::pair<u64, bool> emplace_unique(const KeyType& key, ArgTypes&&... args)
+    {
+        const u64 hash_value = m_hash_function(key);
+        auto index = find_index(key, hash_value);
+        if (index != capacity_of_buckets()) {
+            return std::make_pair(index, false);
+        }
+
+        // key and args may refer to an element of this table, or
+        // to an argument that is moved from, so the new element is
+        // built before the table can grow, and then followed through
+        // the walk rather than looked up by key
+        ElementBuffer hand_buffer;
+        StorageType* hand = reinterpret_cast<StorageType*>(&hand_buffer);
+        new (hand) StorageType(std::forward<ArgTypes>(args)...);
+        if (m_num_buckets == 0) {
+            rehash(1);
+        } else if (m_size + 1 > max_load(capacity_of_buckets())) {
+            rehash(m_num_buckets * 2);
+        }
+
+        index = sc_in_hand;
+        place(hand, hash_value, index);
+        ++m_size;
+        return std::make_pair(index, true);
+    }
+
+    inline T& slot_at(u64 index)
+    {
+        return slot(index);
+    }
+
+    inline Iterator make_iterator(u64 index)
+    {
+        return Iterator(this, index);
+    }
+
+    inline void erase_at(u64 index)
+    {
+        if ((tag_at(index) & sc_second_bucket_tag) != 0) {
+            leave_slot(tag_at(index), m_hash_function(m_key_extractor(slot(index))));
+        }
+        slot(index).~StorageType();
+        tag_at(index) = 0;
+        --m_size;
+    }
+
+public:
+    inline CuckooHashTable()
+        : m_buckets(nullptr), m_bucket_memory(nullptr),
+          m_num_buckets(0), m_log_num_buckets(0), m_size(0),
+          m_random_state(0x2545F4914F6CDD1DULL)
+    {
+        // Nothing here
+    }
+
+    inline CuckooHashTable(const CuckooHashTable& other)
+        : m_buckets(nullptr), m_bucket_memory(nullptr),
+          m_num_buckets(0), m_log_num_buckets(0), m_size(0),
+          m_random_state(other.m_random_state),
+          m_key_extractor(other.m_key_extractor),
+          m_hash_function(other.m_hash_function),
+          m_equals_function(other.m_equals_function)
+    {
+        copy_from(other);
+    }
+
+    inline CuckooHashTable(CuckooHashTable&& other)
+        : m_buckets(nullptr), m_bucket_memory(nullptr),
+          m_num_buckets(0), m_log_num_buckets(0), m_size(0),
+          m_random_state(other.m_random_state),
+          m_key_extractor(std::move(other.m_key_extractor)),
+          m_hash_function(std::move(other.m_hash_function)),
+          m_equals_function(std::move(other.m_equals_function))
+    {
+        steal_from(other);
+    }
+
+    inline ~CuckooHashTable()
+    {
+        deallocate();
+    }
+
+    inline CuckooHashTable& operator = (const CuckooHashTable& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        deallocate();
+        copy_from(other);
+        return *this;
+    }
+
+    inline CuckooHashTable& operator = (CuckooHashTable&& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        deallocate();
+        steal_from(other);
+        return *this;
+    }
+
+    // No values are reserved by this table, these are only
+    // here to keep the interface of the other unordered containers
+    inline void set_deleted_value(const KeyType&)
+    {
+        // Nothing here
+    }
+
+    inline void set_nonused_value(const KeyType&)
+    {
+        // Nothing here
+    }
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    inline u64 capacity() const
+    {
+        return capacity_of_buckets();
+    }
+
+    inline void clear()
+    {
+        if (m_num_buckets == 0) {
+            return;
+        }
+        destroy_elements();
+        clear_tags();
+        m_size = 0;
+    }
+
+    inline void reserve(u64 num_elements)
+    {
+        u64 new_num_buckets = (m_num_buckets == 0 ? 1 : m_num_buckets);
+        while (max_load(new_num_buckets * sc_bucket_width) < num_elements) {
+            new_num_buckets *= 2;
+        }
+        if (new_num_buckets != m_num_buckets) {
+            rehash(new_num_buckets);
+        }
+    }
+
+    inline Iterator begin()
+    {
+        return Iterator(this, next_full_slot(0));
+    }
+
+    inline Iterator end()
+    {
+        return Iterator(this, capacity_of_buckets());
+    }
+
+    inline ConstIterator begin() const
+    {
+        return ConstIterator(this, next_full_slot(0));
+    }
+
+    inline ConstIterator end() const
+    {
+        return ConstIterator(this, capacity_of_buckets());
+    }
+
+    inline ConstIterator cbegin() const
+    {
+        return begin();
+    }
+
+    inline ConstIterator cend() const
+    {
+        return end();
+    }
+
+    inline Iterator find(const KeyType& key)
+    {
+        return Iterator(this, find_index(key, m_hash_function(key)));
+    }
+
+    inline ConstIterator find(const KeyType& key) const
+    {
+        return ConstIterator(this, find_index(key, m_hash_function(key)));
+    }
+
+    inline u64 count(const KeyType& key) const
+    {
+        return (find_index(key, m_hash_function(key)) != capacity_of_buckets() ? 1 : 0);
+    }
+
+    inline u64 erase(const KeyType& key)
+    {
+        auto index = find_index(key, m_hash_function(key));
+        if (index == capacity_of_buckets()) {
+            return 0;
+        }
+        erase_at(index);
+        return 1;
+    }
+
+    inline Iterator erase(const ConstIterator& position)
+    {
+        const u64 index = position.m_index;
+        erase_at(index);
+        return Iterator(this, next_full_slot(index + 1));
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_CUCKOO_HASH_TABLE_HPP_ */
+
+//
+// CuckooHashTable.hpp ends here
@@ -0,0 +1,185 @@
+// CuckooUnorderedMap.hpp ---
+//
+// Filename: CuckooUnorderedMap.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 22:14:48 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// Unordered maps on top of CuckooHashTable. These have the interface
+// of UnifiedUnorderedMap, but do not need deleted or nonused values.
+
+#if !defined KINARA_COMMON_CONTAINERS_CUCKOO_UNORDERED_MAP_HPP_
+#define KINARA_COMMON_CONTAINERS_CUCKOO_UNORDERED_MAP_HPP_
+
+#include <tuple>
+#include <utility>
+#include <functional>
+#include <initializer_list>
+
+#include "CuckooHashTable.hpp"
+
+namespace kinara {
+namespace containers {
+namespace cuckoo_unordered_map_detail_ {
+
+template <typename KeyType, typename ValueType>
+class KeyExtractor
+{
+public:
+    inline const KeyType& operator () (const std::pair<const KeyType, ValueType>& entry) const
+    {
+        return entry.first;
+    }
+};
+
+} /* end namespace cuckoo_unordered_map_detail_ */
+
+template <typename KeyType, typename ValueType,
+          typename HashFunction = std::hash<KeyType>,
+          typename EqualsFunction = std::equal_to<KeyType>>
+class CuckooUnorderedMap
+    : public CuckooHashTable<std::pair<const KeyType, ValueType>, KeyType,
+                            cuckoo_unordered_map_detail_::KeyExtractor<KeyType, ValueType>,
+                            HashFunction, EqualsFunction>
+{
+private:
+    typedef CuckooHashTable<std::pair<const KeyType, ValueType>, KeyType,
+                           cuckoo_unordered_map_detail_::KeyExtractor<KeyType, ValueType>,
+                           HashFunction, EqualsFunction> BaseType;
+
+public:
+    typedef std::pair<const KeyType, ValueType> EntryType;
+    typedef typename BaseType::Iterator Iterator;
+    typedef typename BaseType::ConstIterator ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+    inline CuckooUnorderedMap()
+        : BaseType()
+    {
+        // Nothing here
+    }
+
+    // the table reserves no values, these are ignored
+    inline CuckooUnorderedMap(const KeyType&, const KeyType&)
+        : BaseType()
+    {
+        // Nothing here
+    }
+
+    inline CuckooUnorderedMap(std::initializer_list<EntryType> init_list)
+        : BaseType()
+    {
+        insert(init_list);
+    }
+
+    inline CuckooUnorderedMap(std::initializer_list<EntryType> init_list,
+                             const KeyType&, const KeyType&)
+        : BaseType()
+    {
+        insert(init_list);
+    }
+
+    template <typename InputIterator>
+    inline CuckooUnorderedMap(const InputIterator& first, const InputIterator& last)
+        : BaseType()
+    {
+        insert(first, last);
+    }
+
+    inline CuckooUnorderedMap(const CuckooUnorderedMap& other) = default;
+    inline CuckooUnorderedMap(CuckooUnorderedMap&& other) = default;
+
+    inline CuckooUnorderedMap& operator = (const CuckooUnorderedMap& other) = default;
+    inline CuckooUnorderedMap& operator = (CuckooUnorderedMap&& other) = default;
+
+    inline CuckooUnorderedMap& operator = (std::initializer_list<EntryType> init_list)
+    {
+        this->clear();
+        insert(init_list);
+        return *this;
+    }
+
+    inline ValueType& operator [] (const KeyType& key)
+    {
+        auto result = this->emplace_unique(key, std::piecewise_construct,
+                                           std::forward_as_tuple(key),
+                                           std::tuple<>());
+        return this->slot_at(result.first).second;
+    }
+
+    inline std::pair<Iterator, bool> insert(const EntryType& entry)
+    {
+        auto result = this->emplace_unique(entry.first, entry);
+        return std::make_pair(this->make_iterator(result.first), result.second);
+    }
+
+    inline std::pair<Iterator, bool> insert(EntryType&& entry)
+    {
+        const KeyType& key = entry.first;
+        auto result = this->emplace_unique(key, std::move(entry));
+        return std::make_pair(this->make_iterator(result.first), result.second);
+    }
+
+    template <typename InputIterator>
+    inline void insert(const InputIterator& first, const InputIterator& last)
+    {
+        for (auto it = first; it != last; ++it) {
+            insert(*it);
+        }
+    }
+
+    inline void insert(std::initializer_list<EntryType> init_list)
+    {
+        insert(init_list.begin(), init_list.end());
+    }
+
+    template <typename... ArgTypes>
+    inline std::pair<Iterator, bool> emplace(const KeyType& key, ArgTypes&&... args)
+    {
+        auto result = this->emplace_unique(key, std::piecewise_construct,
+                                           std::forward_as_tuple(key),
+                                           std::forward_as_tuple(std::forward<ArgTypes>(args)...));
+        return std::make_pair(this->make_iterator(result.first), result.second);
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_CUCKOO_UNORDERED_MAP_HPP_ */
+
+//
+// CuckooUnorderedMap.hpp ends here
@@ -0,0 +1,454 @@
+// ExternalDeque.hpp ---
+//
+// Filename: ExternalDeque.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 20:11:52 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+
+// Code:
+
+// A deque of trivially copyable values, such as the states of a
+// breadth first search frontier, that may grow far beyond memory.
+// Only the two ends live in memory, each in a ChunkedDeque of at most
+// about half of the memory budget. When an end grows past that, a
+// segment of its innermost elements is written out, in one large
+// sequential write, to an unlinked temporary file, and the middle of
+// the deque becomes the list of segments on disk.
+//
+// Popping the front reads the segments back in order. While the
+// front end is being consumed, the next segment is already being read
+// by a background task into a second buffer, so that a queue which is
+// pushed at the back and popped at the front streams through the file
+// at disk bandwidth. All segments are the same size, so the file is
+// a set of segment sized extents: the extent of a segment that has
+// been read back is reused, oldest first, by the next segment
+// written, and the file only grows when no extent is free. A queue
+// streaming through the file thus keeps it at the size of the most
+// segments ever on disk at once. The file is truncated whenever no
+// segment is left in it.
+//
+// The budgets are counted in elements. I/O errors are reported by
+// throwing std::system_error. There is no iteration, and the object
+// is meant to be used from one thread at a time.
+
+#if !defined KINARA_COMMON_CONTAINERS_EXTERNAL_DEQUE_HPP_
+#define KINARA_COMMON_CONTAINERS_EXTERNAL_DEQUE_HPP_
+
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+#include <type_traits>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+#include "ChunkedDeque.hpp"
+
+namespace kinara {
+namespace containers {
+namespace external_deque_detail_ {
+
+class Segment
+{
+public:
+    u64 m_offset;
+    u64 m_size;
+
+    inline Segment(u64 offset, u64 size)
+        : m_offset(offset), m_size(size)
+    {
+        // Nothing here
+    }
+};
+
+inline void write_fully(int fd, const void* buffer, u64 num_bytes, u64 offset)
+{
+    const char* position = static_cast<const char*>(buffer);
+    while (num_bytes > 0) {
+        const ssize_t written = ::pwrite(fd, position, num_bytes, (off_t)offset);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "ExternalDeque: could not write to the spill file");
+        }
+        position += written;
+        num_bytes -= written;
+        offset += written;
+    }
+}
+
+inline void read_fully(int fd, void* buffer, u64 num_bytes, u64 offset)
+{
+    char* position = static_cast<char*>(buffer);
+    while (num_bytes > 0) {
+        const ssize_t num_read = ::pread(fd, position, num_bytes, (off_t)offset);
+        if (num_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (num_read <= 0) {
+            throw std::system_error((num_read == 0 ? EIO : errno), std::generic_category(),
+                                    "ExternalDeque: could not read from the spill file");
+        }
+        position += num_read;
+        num_bytes -= num_read;
+        offset += num_read;
+    }
+}
+
+} /* end namespace external_deque_detail_ */
+
+template <typename T>
+class ExternalDeque
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "ExternalDeque can only hold trivially copyable values");
+
+private:
+    typedef external_deque_detail_::Segment Segment;
+
+    static const u64 sc_default_segment_bytes = ((u64)1 << 24);
+    static const u64 sc_default_segments_in_memory = 8;
+
+    const u64 m_segment_size;
+    // the most elements either end holds before spilling
+    const u64 m_max_end_size;
+    const std::string m_directory;
+
+    ChunkedDeque<T> m_head;
+    ChunkedDeque<T> m_tail;
+    // the segments on disk, in order, between m_head and m_tail,
+    // except for one that may be in flight into m_read_buffer
+    std::deque<Segment> m_segments;
+    u64 m_size;
+
+    int m_fd;
+    u64 m_file_size;
+    // the offsets of extents whose segments have been read back,
+    // in the order they were freed
+    std::deque<u64> m_free_offsets;
+    std::vector<T> m_read_buffer;
+    std::vector<T> m_write_buffer;
+    std::future<void> m_prefetch;
+    u64 m_prefetch_offset;
+    bool m_prefetching;
+
+    inline void open_file()
+    {
+        std::string path = m_directory;
+        if (path.empty()) {
+            const char* tmpdir = std::getenv("TMPDIR");
+            path = (tmpdir != nullptr && tmpdir[0] != '\0' ? tmpdir : "/tmp");
+        }
+        path += "/kinara-external-deque-XXXXXX";
+
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back('\0');
+        m_fd = ::mkstemp(name.data());
+        if (m_fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "ExternalDeque: could not create a spill file");
+        }
+        // nobody else needs to see the file, and it goes away
+        // with the descriptor, even if we crash
+        ::unlink(name.data());
+    }
+
+    // writes the elements [first, first + m_segment_size)
+    // of an end as a new segment, returning that segment
+    inline Segment write_segment(const ChunkedDeque<T>& end, u64 first)
+    {
+        if (m_fd < 0) {
+            open_file();
+        }
+        m_write_buffer.assign(end.begin() + first, end.begin() + first + m_segment_size);
+        const u64 num_bytes = m_segment_size * sizeof(T);
+        u64 offset = m_file_size;
+        if (!m_free_offsets.empty()) {
+            offset = m_free_offsets.front();
+        }
+        external_deque_detail_::write_fully(m_fd, m_write_buffer.data(), num_bytes, offset);
+        if (offset == m_file_size) {
+            m_file_size += num_bytes;
+        } else {
+            m_free_offsets.pop_front();
+        }
+        return Segment(offset, m_segment_size);
+    }
+
+    inline void start_prefetch()
+    {
+        if (m_prefetching || m_segments.empty()) {
+            return;
+        }
+        const Segment segment = m_segments.front();
+        m_segments.pop_front();
+        m_read_buffer.resize(segment.m_size);
+
+        T* buffer = m_read_buffer.data();
+        const int fd = m_fd;
+        m_prefetch = std::async(std::launch::async, [=] () -> void
+                                {
+                                    const u64 num_bytes = segment.m_size * sizeof(T);
+                                    external_deque_detail_::read_fully(fd, buffer, num_bytes,
+                                                                       segment.m_offset);
+                                    // the pages are not needed again
+                                    ::posix_fadvise(fd, (off_t)segment.m_offset,
+                                                    (off_t)num_bytes, POSIX_FADV_DONTNEED);
+                                });
+        m_prefetch_offset = segment.m_offset;
+        m_prefetching = true;
+    }
+
+    // waits for the segment in flight, which follows m_head,
+    // its extent is free once it has been read
+    inline void finish_prefetch()
+    {
+        m_prefetching = false;
+        m_prefetch.get();
+        m_free_offsets.push_back(m_prefetch_offset);
+    }
+
+    inline void reclaim_file()
+    {
+        if (m_segments.empty() && !m_prefetching && m_file_size > 0) {
+            if (::ftruncate(m_fd, 0) != 0) {
+                throw std::system_error(errno, std::generic_category(),
+                                        "ExternalDeque: could not truncate the spill file");
+            }
+            m_file_size = 0;
+            m_free_offsets.clear();
+        }
+    }
+
+    // refills an empty head with the next segment, and starts
+    // reading the one after it
+    inline void refill_head()
+    {
+        if (!m_prefetching && m_segments.empty()) {
+            return;
+        }
+        start_prefetch();
+        finish_prefetch();
+        m_head.append_range(m_read_buffer.begin(), m_read_buffer.end());
+        reclaim_file();
+        start_prefetch();
+    }
+
+    // refills an empty tail with the last segment
+    inline void refill_tail()
+    {
+        if (!m_segments.empty()) {
+            const Segment segment = m_segments.back();
+            m_segments.pop_back();
+            m_write_buffer.resize(segment.m_size);
+            external_deque_detail_::read_fully(m_fd, m_write_buffer.data(),
+                                               segment.m_size * sizeof(T), segment.m_offset);
+            m_free_offsets.push_back(segment.m_offset);
+            m_tail.append_range(m_write_buffer.begin(), m_write_buffer.end());
+        } else if (m_prefetching) {
+            finish_prefetch();
+            m_tail.append_range(m_read_buffer.begin(), m_read_buffer.end());
+        }
+        reclaim_file();
+    }
+
+    // the tail is over budget: its oldest elements go to the
+    // head if that is empty, and to the end of the file if not
+    inline void shrink_tail()
+    {
+        if (m_head.empty()) {
+            m_head.append_range(m_tail.begin(), m_tail.begin() + m_segment_size);
+        } else {
+            m_segments.push_back(write_segment(m_tail, 0));
+        }
+        m_tail.erase(m_tail.begin(), m_tail.begin() + m_segment_size);
+    }
+
+    // the head is over budget: its newest elements go to the
+    // tail if that is empty, and to the file if not. Since they
+    // precede whatever is in flight, that is taken in first
+    inline void shrink_head()
+    {
+        if (m_prefetching) {
+            finish_prefetch();
+            m_head.append_range(m_read_buffer.begin(), m_read_buffer.end());
+        }
+        while (m_head.size() > m_max_end_size) {
+            const u64 first = m_head.size() - m_segment_size;
+            if (m_tail.empty()) {
+                m_tail.append_range(m_head.begin() + first, m_head.end());
+            } else {
+                m_segments.push_front(write_segment(m_head, first));
+            }
+            m_head.erase(m_head.begin() + first, m_head.end());
+        }
+    }
+
+public:
+    // segment_size is the number of elements written or read at
+    // a time, and max_in_memory bounds the number of elements in
+    // memory, not counting a segment in flight
+    inline explicit ExternalDeque(u64 segment_size = std::max((u64)1,
+                                                              sc_default_segment_bytes / sizeof(T)),
+                                  u64 max_in_memory = 0,
+                                  const std::string& directory = "")
+        : m_segment_size(segment_size == 0 ? 1 : segment_size),
+          m_max_end_size(std::max(2 * m_segment_size,
+                                  (max_in_memory == 0 ?
+                                   sc_default_segments_in_memory * m_segment_size :
+                                   max_in_memory) / 2)),
+          m_directory(directory), m_size(0), m_fd(-1), m_file_size(0),
+          m_prefetch_offset(0), m_prefetching(false)
+    {
+        // Nothing here
+    }
+
+    ExternalDeque(const ExternalDeque& other) = delete;
+    ExternalDeque& operator = (const ExternalDeque& other) = delete;
+
+    inline ~ExternalDeque()
+    {
+        if (m_prefetching) {
+            m_prefetch.wait();
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    // the number of elements that are on disk
+    inline u64 spilled_size() const
+    {
+        return m_size - m_head.size() - m_tail.size();
+    }
+
+    // the size of the spill file, including the free extents
+    inline u64 file_bytes() const
+    {
+        return m_file_size;
+    }
+
+    inline const T& front() const
+    {
+        return (m_head.empty() ? m_tail.front() : m_head.front());
+    }
+
+    inline const T& back() const
+    {
+        return (m_tail.empty() ? m_head.back() : m_tail.back());
+    }
+
+    inline void push_back(const T& value)
+    {
+        m_tail.push_back(value);
+        ++m_size;
+        if (m_tail.size() > m_max_end_size) {
+            shrink_tail();
+        }
+    }
+
+    inline void push_front(const T& value)
+    {
+        m_head.push_front(value);
+        ++m_size;
+        if (m_head.size() > m_max_end_size) {
+            shrink_head();
+        }
+    }
+
+    inline void pop_front()
+    {
+        if (m_head.empty()) {
+            m_tail.pop_front();
+        } else {
+            m_head.pop_front();
+            if (m_head.empty()) {
+                refill_head();
+            }
+        }
+        --m_size;
+    }
+
+    inline void pop_back()
+    {
+        if (m_tail.empty()) {
+            m_head.pop_back();
+        } else {
+            m_tail.pop_back();
+            if (m_tail.empty()) {
+                refill_tail();
+            }
+        }
+        --m_size;
+    }
+
+    inline void clear()
+    {
+        if (m_prefetching) {
+            finish_prefetch();
+        }
+        m_head.clear();
+        m_tail.clear();
+        m_segments.clear();
+        m_size = 0;
+        reclaim_file();
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_EXTERNAL_DEQUE_HPP_ */
+
+//
+// ExternalDeque.hpp ends here
@@ -0,0 +1,415 @@
+// IntegerPriorityQueue.hpp ---
+//
+// Filename: IntegerPriorityQueue.hpp
+// Author: Abhishek Udupa
+// Created: Mon Oct 19 04:02:44 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// Priority queues of integers, as alternatives to PriorityQueue
+// over MultiWayHeap when the priorities are small integers or are
+// popped in order, as with BFS depths or Dijkstra distances. As
+// with PriorityQueue, top() is the greatest value under Comparator,
+// which must be std::less or std::greater.
+//
+// RadixHeap is a monotone queue: a pushed value must not be greater
+// (under Comparator) than the last value seen through top() or
+// pop() since the queue was last empty, which debug builds assert.
+// Values are kept in 65 buckets by the highest bit in which they
+// differ from that last value, and each value moves to a lower
+// bucket at most 64 times, so operations take O(1) amortized time.
+//
+// BucketQueue keeps a count per value, over the range of values
+// pushed since it was last empty, and is fastest when that range is
+// small. It needs no monotonicity, but it takes eight bytes for
+// every value in the range, so the counts never cover more than 2^24
+// values (128 MB), and pushing a value that far from the values in
+// the queue throws std::length_error. RadixHeap has no such limit.
+
+#if !defined KINARA_COMMON_CONTAINERS_INTEGER_PRIORITY_QUEUE_HPP_
+#define KINARA_COMMON_CONTAINERS_INTEGER_PRIORITY_QUEUE_HPP_
+
+#include <vector>
+#include <cassert>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+namespace integer_priority_queue_detail_ {
+
+// maps values to unsigned keys so that the top of the queue
+// is the value with the least key
+template <typename IntType, typename Comparator>
+class KeyMap;
+
+template <typename IntType>
+class OrderedKey
+{
+public:
+    // a signed value has its sign bit flipped, to order as unsigned
+    static const u64 sc_flip =
+        (std::is_signed<IntType>::value ? ((u64)1 << 63) : 0);
+
+    static inline u64 to_unsigned(IntType value)
+    {
+        return ((u64)(i64)value ^ sc_flip);
+    }
+
+    static inline IntType from_unsigned(u64 key)
+    {
+        return (IntType)(i64)(key ^ sc_flip);
+    }
+};
+
+template <typename IntType>
+class KeyMap<IntType, std::less<IntType>>
+{
+public:
+    static inline u64 to_key(IntType value)
+    {
+        return ~OrderedKey<IntType>::to_unsigned(value);
+    }
+
+    static inline IntType from_key(u64 key)
+    {
+        return OrderedKey<IntType>::from_unsigned(~key);
+    }
+};
+
+template <typename IntType>
+class KeyMap<IntType, std::greater<IntType>>
+{
+public:
+    static inline u64 to_key(IntType value)
+    {
+        return OrderedKey<IntType>::to_unsigned(value);
+    }
+
+    static inline IntType from_key(u64 key)
+    {
+        return OrderedKey<IntType>::from_unsigned(key);
+    }
+};
+
+} /* end namespace integer_priority_queue_detail_ */
+
+template <typename IntType = i64, typename Comparator = std::less<IntType>>
+class RadixHeap
+{
+    static_assert(std::is_integral<IntType>::value, "RadixHeap needs integral values");
+
+public:
+    typedef IntType ValueType;
+    typedef Comparator ComparatorType;
+
+private:
+    typedef integer_priority_queue_detail_::KeyMap<IntType, Comparator> KeyMapType;
+
+    static const u32 sc_num_buckets = 65;
+
+    // Bucket 0 holds the keys equal to m_last, and bucket i > 0 the
+    // keys whose highest bit differing from m_last is bit i - 1. The
+    // buckets are refilled, which is invisible from outside, by top()
+    mutable std::vector<u64> m_buckets[sc_num_buckets];
+    mutable u64 m_last;
+    u64 m_size;
+
+    static inline u32 bucket_index(u64 key, u64 last)
+    {
+        return (key == last ? 0 : 64 - __builtin_clzll(key ^ last));
+    }
+
+    // moves the least keys into bucket 0, when it is empty
+    inline void refill() const
+    {
+        if (!m_buckets[0].empty()) {
+            return;
+        }
+        u32 index = 1;
+        while (m_buckets[index].empty()) {
+            ++index;
+        }
+        auto& bucket = m_buckets[index];
+        m_last = *std::min_element(bucket.begin(), bucket.end());
+        for (auto key : bucket) {
+            m_buckets[bucket_index(key, m_last)].push_back(key);
+        }
+        bucket.clear();
+    }
+
+public:
+    inline RadixHeap()
+        : m_last(0), m_size(0)
+    {
+        // Nothing here
+    }
+
+    inline RadixHeap(const RadixHeap& other) = default;
+    inline RadixHeap(RadixHeap&& other) = default;
+    inline RadixHeap& operator = (const RadixHeap& other) = default;
+    inline RadixHeap& operator = (RadixHeap&& other) = default;
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    inline void clear()
+    {
+        for (u32 i = 0; i < sc_num_buckets; ++i) {
+            m_buckets[i].clear();
+        }
+        m_last = 0;
+        m_size = 0;
+    }
+
+    inline void push(IntType value)
+    {
+        const u64 key = KeyMapType::to_key(value);
+#if defined KINARA_CFG_DEBUG_MODE_BUILD_
+        assert(key >= m_last);
+#endif /* KINARA_CFG_DEBUG_MODE_BUILD_ */
+        m_buckets[bucket_index(key, m_last)].push_back(key);
+        ++m_size;
+    }
+
+    inline IntType top() const
+    {
+        refill();
+        return KeyMapType::from_key(m_last);
+    }
+
+    inline void pop()
+    {
+        refill();
+        m_buckets[0].pop_back();
+        // once empty, any value may be pushed again
+        if (--m_size == 0) {
+            m_last = 0;
+        }
+    }
+};
+
+template <typename IntType = i64, typename Comparator = std::less<IntType>>
+class BucketQueue
+{
+    static_assert(std::is_integral<IntType>::value, "BucketQueue needs integral values");
+
+public:
+    typedef IntType ValueType;
+    typedef Comparator ComparatorType;
+
+private:
+    typedef integer_priority_queue_detail_::KeyMap<IntType, Comparator> KeyMapType;
+
+    static const u64 sc_initial_num_buckets = 1024;
+    static const u64 sc_max_span = (u64)1 << 24;
+
+    // m_counts[i] is the number of copies of the value with key
+    // m_base + i, the nonzero counts lie between m_cursor, the
+    // least of them, and m_end
+    std::vector<u64> m_counts;
+    u64 m_base;
+    u64 m_cursor;
+    u64 m_end;
+    u64 m_size;
+
+    // the size of the counts when they must cover at least
+    // num_buckets, which is never more than sc_max_span
+    inline u64 grown_size(u64 num_buckets) const
+    {
+        const u64 doubled = 2 * m_counts.size();
+        const u64 grown = (doubled < sc_max_span ? doubled : (u64)sc_max_span);
+        return std::max(grown, num_buckets);
+    }
+
+    // moves the occupied counts up by shift buckets
+    inline void shift_up(u64 shift)
+    {
+        if (m_end + shift > m_counts.size()) {
+            m_counts.resize(grown_size(m_end + shift), 0);
+        }
+        std::copy_backward(m_counts.begin() + m_cursor, m_counts.begin() + m_end,
+                           m_counts.begin() + m_end + shift);
+        std::fill(m_counts.begin() + m_cursor, m_counts.begin() + m_cursor + shift, 0);
+        m_base -= shift;
+        m_cursor += shift;
+        m_end += shift;
+    }
+
+    // moves the occupied counts down to start at bucket 0
+    inline void shift_down()
+    {
+        std::copy(m_counts.begin() + m_cursor, m_counts.begin() + m_end, m_counts.begin());
+        std::fill(m_counts.begin() + std::max(m_cursor, m_end - m_cursor),
+                  m_counts.begin() + m_end, 0);
+        m_base += m_cursor;
+        m_end -= m_cursor;
+        m_cursor = 0;
+    }
+
+    // the counts would cover more values than sc_max_span
+    inline void check_span(u64 low_key, u64 high_key) const
+    {
+        if (high_key - low_key >= sc_max_span) {
+            throw std::length_error("BucketQueue: values are too far apart");
+        }
+    }
+
+    // makes room below m_base for key, with most of the free room
+    // above the counts if that is enough, and otherwise by growing
+    inline void grow_down(u64 key)
+    {
+        check_span(key, m_base + m_end - 1);
+        const u64 needed = m_base - key;
+        const u64 free_above = m_counts.size() - m_end;
+        u64 shift = std::max(needed, (free_above >= needed ? free_above - free_above / 4 :
+                                      m_end - m_cursor));
+        // needed + m_end is within sc_max_span, by check_span
+        if (shift > sc_max_span - m_end) {
+            shift = sc_max_span - m_end;
+        }
+        if (shift > m_base) {
+            shift = m_base;
+        }
+        shift_up(shift);
+    }
+
+    inline void grow_up(u64 key)
+    {
+        check_span(m_base + m_cursor, key);
+        // with the counts shifted down, key - m_base is
+        // within sc_max_span, by check_span
+        if (m_cursor != 0) {
+            shift_down();
+        }
+        if (key - m_base >= m_counts.size()) {
+            m_counts.resize(grown_size(key - m_base + 1), 0);
+        }
+    }
+
+public:
+    inline BucketQueue()
+        : m_base(0), m_cursor(0), m_end(0), m_size(0)
+    {
+        // Nothing here
+    }
+
+    inline BucketQueue(const BucketQueue& other) = default;
+    inline BucketQueue(BucketQueue&& other) = default;
+    inline BucketQueue& operator = (const BucketQueue& other) = default;
+    inline BucketQueue& operator = (BucketQueue&& other) = default;
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    inline void clear()
+    {
+        std::fill(m_counts.begin() + m_cursor, m_counts.begin() + m_end, 0);
+        m_cursor = 0;
+        m_end = 0;
+        m_size = 0;
+    }
+
+    inline void push(IntType value)
+    {
+        const u64 key = KeyMapType::to_key(value);
+        if (m_size == 0) {
+            // the counts are all zero, center the range on key
+            if (m_counts.empty()) {
+                m_counts.resize(sc_initial_num_buckets, 0);
+            }
+            m_base = key - std::min(key, (u64)m_counts.size() / 2);
+            m_cursor = key - m_base;
+            m_end = m_cursor;
+        } else if (key < m_base) {
+            grow_down(key);
+        } else if (key - m_base >= m_counts.size()) {
+            grow_up(key);
+        }
+
+        const u64 index = key - m_base;
+        ++m_counts[index];
+        if (index < m_cursor) {
+            m_cursor = index;
+        }
+        if (index >= m_end) {
+            m_end = index + 1;
+        }
+        ++m_size;
+    }
+
+    inline IntType top() const
+    {
+        return KeyMapType::from_key(m_base + m_cursor);
+    }
+
+    inline void pop()
+    {
+        --m_counts[m_cursor];
+        if (--m_size == 0) {
+            m_cursor = 0;
+            m_end = 0;
+            return;
+        }
+        while (m_counts[m_cursor] == 0) {
+            ++m_cursor;
+        }
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_INTEGER_PRIORITY_QUEUE_HPP_ */
+
+//
+// IntegerPriorityQueue.hpp ends here
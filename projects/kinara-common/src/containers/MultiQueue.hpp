@@ -0,0 +1,306 @@
+// MultiQueue.hpp ---
+//
+// Filename: MultiQueue.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 16:52:10 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+
+// Code:
+
+// A relaxed priority queue for use from many threads at once, made of
+// several independent priority queues, each guarded by its own spin
+// lock. A push goes to a random queue whose lock is free. A pop
+// samples two random queues, locks them if their locks are free, and
+// pops the better of their tops. Nobody ever waits on a lock, so
+// push and pop throughput grows with the number of threads.
+//
+// The price is that pop() returns an element close to the top rather
+// than the top itself: with n queues, the popped element is on
+// average within O(n) positions of the true top. That is good enough
+// for best-first searches, which only need to expand states in
+// roughly the right order. As with PriorityQueue, the top is the
+// greatest element under Comparator.
+//
+// size() and empty() are exact only when no other thread is using
+// the queue; clear() must not race with other operations.
+
+#if !defined KINARA_COMMON_CONTAINERS_MULTI_QUEUE_HPP_
+#define KINARA_COMMON_CONTAINERS_MULTI_QUEUE_HPP_
+
+#include <atomic>
+#include <thread>
+#include <functional>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+#include "PriorityQueue.hpp"
+#include "MultiWayHeap.hpp"
+
+namespace kinara {
+namespace containers {
+namespace multi_queue_detail_ {
+
+// xorshift64*, with per thread state, so that threads choosing
+// queues do not contend on a shared generator
+inline u64 next_random()
+{
+    static thread_local u64 state = 0;
+    if (state == 0) {
+        state = (std::hash<std::thread::id>()(std::this_thread::get_id()) |
+                 (u64)1) * 0x9E3779B97F4A7C15ULL;
+    }
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+} /* end namespace multi_queue_detail_ */
+
+template <typename T, typename Comparator = std::less<T>, u32 K = 4>
+class MultiQueue
+{
+private:
+    typedef PriorityQueue<T, Comparator, MultiWayHeap<T, Comparator, K>> QueueType;
+
+    static const u64 sc_default_queues_per_thread = 2;
+    static const u32 sc_num_pop_attempts = 16;
+
+    // one queue and its lock, padded so that the locks
+    // of neighbouring queues do not share a cache line
+    class LockedQueue
+    {
+    public:
+        std::atomic<bool> m_locked;
+        // readable without the lock, to skip over empty queues
+        std::atomic<u64> m_size;
+        QueueType m_queue;
+        char m_padding[64];
+
+        inline LockedQueue()
+            : m_locked(false), m_size(0), m_queue()
+        {
+            // Nothing here
+        }
+
+        inline bool try_lock()
+        {
+            return (!m_locked.load(std::memory_order_relaxed) &&
+                    !m_locked.exchange(true, std::memory_order_acquire));
+        }
+
+        inline void lock()
+        {
+            while (!try_lock()) {
+                std::this_thread::yield();
+            }
+        }
+
+        inline void unlock()
+        {
+            m_locked.store(false, std::memory_order_release);
+        }
+
+        inline bool empty() const
+        {
+            return (m_size.load(std::memory_order_relaxed) == 0);
+        }
+
+        inline void push(const T& value)
+        {
+            m_queue.push(value);
+            m_size.store(m_queue.size(), std::memory_order_relaxed);
+        }
+
+        inline void pop(T& value)
+        {
+            value = m_queue.top();
+            m_queue.pop();
+            m_size.store(m_queue.size(), std::memory_order_relaxed);
+        }
+    };
+
+    LockedQueue* m_queues;
+    u64 m_num_queues;
+    Comparator m_comparator;
+
+    inline LockedQueue* random_queue() const
+    {
+        return (m_queues + (multi_queue_detail_::next_random() % m_num_queues));
+    }
+
+    // pops from any queue that has something in it, waiting
+    // for locks; used when sampling keeps missing
+    inline bool pop_from_any(T& value)
+    {
+        const u64 start = multi_queue_detail_::next_random() % m_num_queues;
+        for (u64 i = 0; i < m_num_queues; ++i) {
+            LockedQueue* queue = m_queues + ((start + i) % m_num_queues);
+            if (queue->empty()) {
+                continue;
+            }
+            queue->lock();
+            if (!queue->m_queue.empty()) {
+                queue->pop(value);
+                queue->unlock();
+                return true;
+            }
+            queue->unlock();
+        }
+        return false;
+    }
+
+public:
+    // num_threads is the number of threads expected to use the
+    // queue; more queues per thread means less contention, but
+    // pops that stray further from the true top
+    inline explicit MultiQueue(u64 num_threads = std::thread::hardware_concurrency(),
+                               u64 queues_per_thread = sc_default_queues_per_thread)
+        : m_queues(nullptr),
+          m_num_queues((num_threads == 0 ? 1 : num_threads) *
+                       (queues_per_thread == 0 ? 1 : queues_per_thread)),
+          m_comparator()
+    {
+        m_queues = new LockedQueue[m_num_queues];
+    }
+
+    MultiQueue(const MultiQueue& other) = delete;
+    MultiQueue& operator = (const MultiQueue& other) = delete;
+
+    inline ~MultiQueue()
+    {
+        delete[] m_queues;
+    }
+
+    inline u64 get_num_queues() const
+    {
+        return m_num_queues;
+    }
+
+    inline void push(const T& value)
+    {
+        LockedQueue* queue = random_queue();
+        while (!queue->try_lock()) {
+            queue = random_queue();
+        }
+        queue->push(value);
+        queue->unlock();
+    }
+
+    // pops an element close to the top into value; returns false
+    // only if every queue was found empty
+    inline bool try_pop(T& value)
+    {
+        for (u32 i = 0; i < sc_num_pop_attempts; ++i) {
+            LockedQueue* first = random_queue();
+            LockedQueue* second = random_queue();
+            if (first->empty() && second->empty()) {
+                continue;
+            }
+            if (first->empty() || !first->try_lock()) {
+                first = nullptr;
+            }
+            if (second == first || second->empty() || !second->try_lock()) {
+                second = nullptr;
+            }
+
+            // the queues may have been emptied before we locked them
+            if (first != nullptr && first->m_queue.empty()) {
+                first->unlock();
+                first = nullptr;
+            }
+            if (second != nullptr && second->m_queue.empty()) {
+                second->unlock();
+                second = nullptr;
+            }
+            if (first == nullptr && second == nullptr) {
+                continue;
+            }
+
+            LockedQueue* better = first;
+            LockedQueue* other = second;
+            if (first == nullptr ||
+                (second != nullptr &&
+                 m_comparator(first->m_queue.top(), second->m_queue.top()))) {
+                better = second;
+                other = first;
+            }
+            better->pop(value);
+            better->unlock();
+            if (other != nullptr) {
+                other->unlock();
+            }
+            return true;
+        }
+        return pop_from_any(value);
+    }
+
+    inline u64 size() const
+    {
+        u64 retval = 0;
+        for (u64 i = 0; i < m_num_queues; ++i) {
+            retval += m_queues[i].m_size.load(std::memory_order_relaxed);
+        }
+        return retval;
+    }
+
+    inline bool empty() const
+    {
+        for (u64 i = 0; i < m_num_queues; ++i) {
+            if (!m_queues[i].empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // not thread safe
+    inline void clear()
+    {
+        for (u64 i = 0; i < m_num_queues; ++i) {
+            T value;
+            while (!m_queues[i].m_queue.empty()) {
+                m_queues[i].pop(value);
+            }
+        }
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_MULTI_QUEUE_HPP_ */
+
+//
+// MultiQueue.hpp ends here
@@ -0,0 +1,384 @@
+// NodePool.hpp ---
+//
+// Filename: NodePool.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 22:07:45 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+
+// Code:
+
+// Per thread pools of fixed size nodes, for linked containers used
+// from many threads. Each thread allocates from, and frees to, a pool
+// of its own without any synchronization. Nodes come from 64 KB slabs
+// whose header names the pool that carved them out. A node freed by
+// another thread is pushed onto a lock-free stack of its owning pool,
+// which the owner takes over in one exchange when its own free list
+// runs dry, so nodes that are built by one thread and consumed by
+// another do find their way back.
+//
+// deallocate_chain() gives back a whole list of nodes at once, in
+// constant time, when the nodes are linked through a pointer in their
+// first word, as the nodes of a singly linked list are, and the list
+// is released by the thread that built it.
+//
+// Slabs are never returned to the system. A pool outlives its thread,
+// since other threads may still hold its nodes, and is handed to the
+// next thread that starts using the pool for that node type.
+
+#if !defined KINARA_COMMON_CONTAINERS_NODE_POOL_HPP_
+#define KINARA_COMMON_CONTAINERS_NODE_POOL_HPP_
+
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+
+// counts of nodes, over one thread's pool or all of them; nodes
+// freed by other threads and not yet collected count as free. Nodes
+// given back with deallocate_chain() count as free in the pool that
+// took them, so only the totals over all pools are exact
+class NodePoolStatistics
+{
+public:
+    u64 m_num_pools;
+    u64 m_num_slabs;
+    u64 m_num_nodes;
+    u64 m_num_free;
+
+    inline NodePoolStatistics()
+        : m_num_pools(0), m_num_slabs(0), m_num_nodes(0), m_num_free(0)
+    {
+        // Nothing here
+    }
+
+    inline u64 get_num_in_use() const
+    {
+        return (m_num_nodes > m_num_free ? m_num_nodes - m_num_free : 0);
+    }
+
+    inline NodePoolStatistics& operator += (const NodePoolStatistics& other)
+    {
+        m_num_pools += other.m_num_pools;
+        m_num_slabs += other.m_num_slabs;
+        m_num_nodes += other.m_num_nodes;
+        m_num_free += other.m_num_free;
+        return *this;
+    }
+};
+
+namespace node_pool_detail_ {
+
+class FreeNode
+{
+public:
+    FreeNode* m_next;
+};
+
+static const u64 sc_slab_size = ((u64)1 << 16);
+
+class ThreadPool;
+
+class SlabHeader
+{
+public:
+    ThreadPool* m_owner;
+};
+
+// the pool of one thread, for nodes of one size; the counters are
+// only written by the owning thread, and atomic so that statistics
+// can be gathered from any thread
+class ThreadPool
+{
+private:
+    const u64 m_node_size;
+    const u64 m_first_node_offset;
+    FreeNode* m_free_list;
+    char* m_bump;
+    char* m_bump_end;
+    std::vector<void*> m_slabs;
+
+    std::atomic<FreeNode*> m_returned;
+    std::atomic<u64> m_num_returned;
+    std::atomic<u64> m_num_free;
+    std::atomic<u64> m_num_slabs;
+
+    inline void add_free(u64 count)
+    {
+        m_num_free.store(m_num_free.load(std::memory_order_relaxed) + count,
+                         std::memory_order_relaxed);
+    }
+
+    inline void new_slab()
+    {
+        void* slab = nullptr;
+        if (posix_memalign(&slab, sc_slab_size, sc_slab_size) != 0) {
+            throw std::bad_alloc();
+        }
+        static_cast<SlabHeader*>(slab)->m_owner = this;
+        m_slabs.push_back(slab);
+        m_bump = static_cast<char*>(slab) + m_first_node_offset;
+        m_bump_end = m_bump + get_nodes_per_slab() * m_node_size;
+        m_num_slabs.store(m_slabs.size(), std::memory_order_relaxed);
+        add_free(get_nodes_per_slab());
+    }
+
+public:
+    inline ThreadPool(u64 node_size, u64 node_alignment)
+        : m_node_size(((std::max(node_size, (u64)sizeof(FreeNode)) + node_alignment - 1) /
+                       node_alignment) * node_alignment),
+          m_first_node_offset(((sizeof(SlabHeader) + node_alignment - 1) /
+                               node_alignment) * node_alignment),
+          m_free_list(nullptr), m_bump(nullptr), m_bump_end(nullptr),
+          m_returned(nullptr), m_num_returned(0), m_num_free(0), m_num_slabs(0)
+    {
+        // Nothing here
+    }
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator = (const ThreadPool& other) = delete;
+
+    inline u64 get_nodes_per_slab() const
+    {
+        return ((sc_slab_size - m_first_node_offset) / m_node_size);
+    }
+
+    static inline ThreadPool* owner_of(void* node)
+    {
+        const std::uintptr_t slab = ((std::uintptr_t)node & ~((std::uintptr_t)sc_slab_size - 1));
+        return reinterpret_cast<SlabHeader*>(slab)->m_owner;
+    }
+
+    inline void* allocate()
+    {
+        if (m_free_list == nullptr && m_returned.load(std::memory_order_relaxed) != nullptr) {
+            m_free_list = m_returned.exchange(nullptr, std::memory_order_acquire);
+            add_free(m_num_returned.exchange(0, std::memory_order_relaxed));
+        }
+
+        void* retval;
+        if (m_free_list != nullptr) {
+            retval = m_free_list;
+            m_free_list = m_free_list->m_next;
+        } else {
+            if (m_bump == m_bump_end) {
+                new_slab();
+            }
+            retval = m_bump;
+            m_bump += m_node_size;
+        }
+        m_num_free.store(m_num_free.load(std::memory_order_relaxed) - 1,
+                         std::memory_order_relaxed);
+        return retval;
+    }
+
+    // node must have been allocated by the calling thread's pool
+    inline void deallocate_local(void* node)
+    {
+        FreeNode* free_node = static_cast<FreeNode*>(node);
+        free_node->m_next = m_free_list;
+        m_free_list = free_node;
+        add_free(1);
+    }
+
+    inline void deallocate_chain_local(void* first, void* last, u64 count)
+    {
+        static_cast<FreeNode*>(last)->m_next = m_free_list;
+        m_free_list = static_cast<FreeNode*>(first);
+        add_free(count);
+    }
+
+    // called from threads other than the owner
+    inline void deallocate_remote(void* node)
+    {
+        FreeNode* free_node = static_cast<FreeNode*>(node);
+        FreeNode* head = m_returned.load(std::memory_order_relaxed);
+        do {
+            free_node->m_next = head;
+        } while (!m_returned.compare_exchange_weak(head, free_node,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed));
+        m_num_returned.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline NodePoolStatistics get_statistics() const
+    {
+        NodePoolStatistics retval;
+        retval.m_num_pools = 1;
+        retval.m_num_slabs = m_num_slabs.load(std::memory_order_relaxed);
+        retval.m_num_nodes = retval.m_num_slabs * get_nodes_per_slab();
+        retval.m_num_free = (m_num_free.load(std::memory_order_relaxed) +
+                             m_num_returned.load(std::memory_order_relaxed));
+        return retval;
+    }
+};
+
+// all the pools for one node size, and the ones whose
+// threads have exited, waiting for a new thread to adopt them
+class PoolRegistry
+{
+private:
+    std::mutex m_mutex;
+    std::vector<ThreadPool*> m_all_pools;
+    std::vector<ThreadPool*> m_orphaned_pools;
+
+public:
+    inline ThreadPool* acquire(u64 node_size, u64 node_alignment)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (!m_orphaned_pools.empty()) {
+            auto retval = m_orphaned_pools.back();
+            m_orphaned_pools.pop_back();
+            return retval;
+        }
+        auto retval = new ThreadPool(node_size, node_alignment);
+        m_all_pools.push_back(retval);
+        return retval;
+    }
+
+    inline void release(ThreadPool* pool)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_orphaned_pools.push_back(pool);
+    }
+
+    inline NodePoolStatistics get_statistics()
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        NodePoolStatistics retval;
+        for (auto pool : m_all_pools) {
+            retval += pool->get_statistics();
+        }
+        return retval;
+    }
+};
+
+} /* end namespace node_pool_detail_ */
+
+// The pools for nodes of type NodeType; all members are static.
+// The memory returned is uninitialized, and aligned for NodeType
+template <typename NodeType>
+class NodePool
+{
+private:
+    typedef node_pool_detail_::ThreadPool ThreadPool;
+    typedef node_pool_detail_::PoolRegistry PoolRegistry;
+
+    // gives the thread's pool back to the registry on thread exit
+    class ThreadHandle
+    {
+    public:
+        ThreadPool* m_pool;
+
+        inline ThreadHandle()
+            : m_pool(registry().acquire(sizeof(NodeType), alignof(NodeType)))
+        {
+            // Nothing here
+        }
+
+        inline ~ThreadHandle()
+        {
+            registry().release(m_pool);
+        }
+    };
+
+    static inline PoolRegistry& registry()
+    {
+        // never destroyed, since nodes may be freed during
+        // the destruction of other static objects
+        static PoolRegistry* the_registry = new PoolRegistry();
+        return *the_registry;
+    }
+
+    static inline ThreadPool* local_pool()
+    {
+        static thread_local ThreadHandle handle;
+        return handle.m_pool;
+    }
+
+public:
+    NodePool() = delete;
+
+    static inline void* allocate()
+    {
+        return local_pool()->allocate();
+    }
+
+    static inline void deallocate(void* node)
+    {
+        ThreadPool* pool = local_pool();
+        ThreadPool* owner = ThreadPool::owner_of(node);
+        if (owner == pool) {
+            pool->deallocate_local(node);
+        } else {
+            owner->deallocate_remote(node);
+        }
+    }
+
+    // gives back count nodes, from first to last, each of which
+    // holds a pointer to the next one in its first word, to the
+    // calling thread's pool, which need not be the one that
+    // allocated them
+    static inline void deallocate_chain(void* first, void* last, u64 count)
+    {
+        if (count > 0) {
+            local_pool()->deallocate_chain_local(first, last, count);
+        }
+    }
+
+    static inline NodePoolStatistics get_thread_statistics()
+    {
+        return local_pool()->get_statistics();
+    }
+
+    static inline NodePoolStatistics get_statistics()
+    {
+        return registry().get_statistics();
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_NODE_POOL_HPP_ */
+
+//
+// NodePool.hpp ends here
@@ -0,0 +1,218 @@
+// RadixSort.hpp ---
+//
+// Filename: RadixSort.hpp
+// Author: Abhishek Udupa
+// Created: Mon Oct 19 00:41:09 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// Least significant digit first radix sorts, on integral keys, for
+// bulk building the ordered containers. The sorts are stable, skip the
+// digits on which all keys agree, and finish in one pass over input
+// that is already sorted. The values need only be move constructible
+// and move assignable.
+
+#if !defined KINARA_COMMON_CONTAINERS_RADIX_SORT_HPP_
+#define KINARA_COMMON_CONTAINERS_RADIX_SORT_HPP_
+
+#include <new>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+namespace radix_sort_detail_ {
+
+static const u32 sc_digit_bits = 11;
+static const u32 sc_num_buckets = 1 << sc_digit_bits;
+// below this, a comparison sort is faster than the histogram passes
+static const u64 sc_min_radix_sort_size = 256;
+
+class IdentityKey
+{
+public:
+    template <typename T>
+    inline const T& operator () (const T& value) const
+    {
+        return value;
+    }
+};
+
+// maps keys to unsigned values with the same order
+template <typename KeyType>
+static inline typename std::enable_if<std::is_unsigned<KeyType>::value, u64>::type
+to_radix(KeyType key)
+{
+    return (u64)key;
+}
+
+template <typename KeyType>
+static inline typename std::enable_if<std::is_signed<KeyType>::value, u64>::type
+to_radix(KeyType key)
+{
+    return ((u64)(i64)key ^ ((u64)1 << (sizeof(KeyType) * 8 - 1))) &
+        (~(u64)0 >> (64 - sizeof(KeyType) * 8));
+}
+
+} /* end namespace radix_sort_detail_ */
+
+template <typename RandomAccessIterator, typename KeyFunction>
+inline void radix_sort(const RandomAccessIterator& first, const RandomAccessIterator& last,
+                       const KeyFunction& key_function)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type ValueType;
+    typedef typename std::decay<decltype(key_function(*first))>::type KeyType;
+    static_assert(std::is_integral<KeyType>::value, "radix_sort() needs integral keys");
+    static const u32 num_digits = ((sizeof(KeyType) * 8 + radix_sort_detail_::sc_digit_bits - 1) /
+                                   radix_sort_detail_::sc_digit_bits);
+    using radix_sort_detail_::to_radix;
+    using radix_sort_detail_::sc_num_buckets;
+    using radix_sort_detail_::sc_digit_bits;
+
+    const u64 size = last - first;
+    auto less = [&] (const ValueType& a, const ValueType& b) -> bool
+        {
+            return key_function(a) < key_function(b);
+        };
+    if (std::is_sorted(first, last, less)) {
+        return;
+    }
+    if (size < radix_sort_detail_::sc_min_radix_sort_size) {
+        std::stable_sort(first, last, less);
+        return;
+    }
+
+    // the histograms of all the digits, in one pass
+    std::vector<u64> counts(num_digits * sc_num_buckets, 0);
+    for (auto it = first; it != last; ++it) {
+        const u64 radix = to_radix(key_function(*it));
+        for (u32 digit = 0; digit < num_digits; ++digit) {
+            ++counts[digit * sc_num_buckets + ((radix >> (digit * sc_digit_bits)) &
+                                               (sc_num_buckets - 1))];
+        }
+    }
+
+    std::vector<ValueType> buffer;
+    buffer.reserve(size);
+    for (auto it = first; it != last; ++it) {
+        buffer.push_back(std::move(*it));
+    }
+    // the scratch space is raw memory, whose elements are constructed
+    // by the first pass that scatters into it, so that ValueType need
+    // not be default constructible
+    ValueType* scratch = static_cast<ValueType*>(::operator new(size * sizeof(ValueType)));
+    bool scratch_constructed = false;
+    ValueType* source = buffer.data();
+    ValueType* destination = scratch;
+    std::vector<u64> offsets(sc_num_buckets);
+
+    for (u32 digit = 0; digit < num_digits; ++digit) {
+        const u64* digit_counts = counts.data() + digit * sc_num_buckets;
+        const u64 shift = digit * sc_digit_bits;
+        // all the keys agree on this digit
+        if (digit_counts[(to_radix(key_function(source[0])) >> shift) &
+                         (sc_num_buckets - 1)] == size) {
+            continue;
+        }
+
+        u64 offset = 0;
+        for (u32 bucket = 0; bucket < sc_num_buckets; ++bucket) {
+            offsets[bucket] = offset;
+            offset += digit_counts[bucket];
+        }
+        const bool construct = (destination == scratch && !scratch_constructed);
+        for (u64 i = 0; i < size; ++i) {
+            ValueType& value = source[i];
+            const u64 bucket = (to_radix(key_function(value)) >> shift) & (sc_num_buckets - 1);
+            ValueType* target = destination + offsets[bucket]++;
+            if (construct) {
+                new (target) ValueType(std::move(value));
+            } else {
+                *target = std::move(value);
+            }
+        }
+        scratch_constructed = scratch_constructed || construct;
+        std::swap(source, destination);
+    }
+
+    std::move(source, source + size, first);
+    if (scratch_constructed) {
+        for (u64 i = 0; i < size; ++i) {
+            scratch[i].~ValueType();
+        }
+    }
+    ::operator delete(scratch);
+}
+
+template <typename RandomAccessIterator>
+inline void radix_sort(const RandomAccessIterator& first, const RandomAccessIterator& last)
+{
+    radix_sort(first, last, radix_sort_detail_::IdentityKey());
+}
+
+// sorts, then keeps only the first of the values with equal keys,
+// returning the new end of the range
+template <typename RandomAccessIterator, typename KeyFunction>
+inline RandomAccessIterator radix_sort_unique(const RandomAccessIterator& first,
+                                              const RandomAccessIterator& last,
+                                              const KeyFunction& key_function)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type ValueType;
+    radix_sort(first, last, key_function);
+    return std::unique(first, last,
+                       [&] (const ValueType& a, const ValueType& b) -> bool
+                       {
+                           return key_function(a) == key_function(b);
+                       });
+}
+
+template <typename RandomAccessIterator>
+inline RandomAccessIterator radix_sort_unique(const RandomAccessIterator& first,
+                                              const RandomAccessIterator& last)
+{
+    return radix_sort_unique(first, last, radix_sort_detail_::IdentityKey());
+}
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_RADIX_SORT_HPP_ */
+
+//
+// RadixSort.hpp ends here
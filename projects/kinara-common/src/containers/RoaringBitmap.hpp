@@ -0,0 +1,843 @@
+// RoaringBitmap.hpp ---
+//
+// Filename: RoaringBitmap.hpp
+// Author: Abhishek Udupa
+// Created: Mon Oct 19 00:02:17 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// A compressed bitmap over the 32 bit unsigned integers, in the style
+// of Roaring bitmaps. The universe is split into chunks of 2^16 values,
+// by the high 16 bits of a value, and only the chunks with some value
+// in them are stored, each in one of three kinds of container:
+// a sorted array of the low 16 bits of the values in it, when there
+// are at most 4096 of them; a bitmap of 2^16 bits otherwise; or a
+// sorted array of runs of consecutive values, which run_optimize()
+// chooses when that is smaller. The interface matches the set, clear
+// and test of BitSet.
+
+#if !defined KINARA_COMMON_CONTAINERS_ROARING_BITMAP_HPP_
+#define KINARA_COMMON_CONTAINERS_ROARING_BITMAP_HPP_
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+
+#include "../basetypes/KinaraTypes.hpp"
+#include "BitSetOps.hpp"
+
+namespace kinara {
+namespace containers {
+namespace roaring_bitmap_detail_ {
+
+typedef std::uint16_t LowBits;
+
+static const u32 sc_max_array_cardinality = 4096;
+static const u64 sc_bitmap_num_words = (1 << 16) / 64;
+static const u32 sc_bitmap_bytes = sc_bitmap_num_words * sizeof(u64);
+
+// the values from start to start + length, inclusive
+class Run
+{
+public:
+    LowBits start;
+    LowBits length;
+
+    inline u32 last() const
+    {
+        return (u32)start + length;
+    }
+};
+
+enum class ContainerKind : std::uint8_t {
+    Array = 0,
+    Bitmap = 1,
+    Runs = 2
+};
+
+template <typename T>
+static inline void write_value(std::ostream& out, T value)
+{
+    for (u32 i = 0; i < sizeof(T); ++i) {
+        out.put((char)((u64)value >> (8 * i)));
+    }
+}
+
+template <typename T>
+static inline bool read_value(std::istream& in, T& value)
+{
+    u64 retval = 0;
+    for (u32 i = 0; i < sizeof(T); ++i) {
+        auto c = in.get();
+        if (c == std::istream::traits_type::eof()) {
+            return false;
+        }
+        retval |= ((u64)(unsigned char)c << (8 * i));
+    }
+    value = (T)retval;
+    return true;
+}
+
+// Only the vector for the kind of the container is in use,
+// and a container is never empty
+class Container
+{
+private:
+    ContainerKind m_kind;
+    u32 m_cardinality;
+    std::vector<LowBits> m_array;
+    std::vector<u64> m_bitmap;
+    std::vector<Run> m_runs;
+
+    inline void to_bitmap()
+    {
+        std::vector<u64> words(sc_bitmap_num_words, 0);
+        fill_words(words.data());
+        m_bitmap.swap(words);
+        m_array.clear();
+        m_array.shrink_to_fit();
+        m_runs.clear();
+        m_runs.shrink_to_fit();
+        m_kind = ContainerKind::Bitmap;
+    }
+
+    inline void to_array()
+    {
+        std::vector<LowBits> values;
+        values.reserve(m_cardinality);
+        for_each(0, [&] (u64 value) -> void { values.push_back((LowBits)value); });
+        m_array.swap(values);
+        m_bitmap.clear();
+        m_bitmap.shrink_to_fit();
+        m_runs.clear();
+        m_runs.shrink_to_fit();
+        m_kind = ContainerKind::Array;
+    }
+
+    // the smaller of an array or a bitmap, for the current cardinality
+    inline void to_array_or_bitmap()
+    {
+        if (m_cardinality <= sc_max_array_cardinality) {
+            if (m_kind != ContainerKind::Array) {
+                to_array();
+            }
+        } else if (m_kind != ContainerKind::Bitmap) {
+            to_bitmap();
+        }
+    }
+
+    inline u64 find_run(LowBits low_bits) const
+    {
+        // the last run starting at or before low_bits
+        auto it = std::upper_bound(m_runs.begin(), m_runs.end(), low_bits,
+                                   [] (LowBits value, const Run& run) -> bool
+                                   {
+                                       return value < run.start;
+                                   });
+        if (it == m_runs.begin()) {
+            return m_runs.size();
+        }
+        --it;
+        return (low_bits <= it->last() ? (u64)(it - m_runs.begin()) : m_runs.size());
+    }
+
+    inline u64 count_runs() const
+    {
+        u64 retval = 0;
+        u64 previous = 0;
+        bool first = true;
+        for_each(0, [&] (u64 value) -> void
+                 {
+                     if (first || value != previous + 1) {
+                         ++retval;
+                     }
+                     first = false;
+                     previous = value;
+                 });
+        return retval;
+    }
+
+public:
+    inline Container()
+        : m_kind(ContainerKind::Array), m_cardinality(0)
+    {
+        // Nothing here
+    }
+
+    inline ContainerKind kind() const
+    {
+        return m_kind;
+    }
+
+    inline u32 cardinality() const
+    {
+        return m_cardinality;
+    }
+
+    inline bool test(LowBits low_bits) const
+    {
+        switch (m_kind) {
+        case ContainerKind::Array:
+            return std::binary_search(m_array.begin(), m_array.end(), low_bits);
+        case ContainerKind::Bitmap:
+            return ((m_bitmap[low_bits / 64] >> (low_bits % 64)) & 1) != 0;
+        default:
+            return (find_run(low_bits) != m_runs.size());
+        }
+    }
+
+    // returns true if the value was not already present
+    inline bool set(LowBits low_bits)
+    {
+        if (m_kind == ContainerKind::Runs) {
+            if (test(low_bits)) {
+                return false;
+            }
+            to_array_or_bitmap();
+        }
+
+        if (m_kind == ContainerKind::Bitmap) {
+            u64& word = m_bitmap[low_bits / 64];
+            const u64 mask = (u64)1 << (low_bits % 64);
+            if ((word & mask) != 0) {
+                return false;
+            }
+            word |= mask;
+            ++m_cardinality;
+            return true;
+        }
+
+        auto it = std::lower_bound(m_array.begin(), m_array.end(), low_bits);
+        if (it != m_array.end() && *it == low_bits) {
+            return false;
+        }
+        m_array.insert(it, low_bits);
+        ++m_cardinality;
+        if (m_cardinality > sc_max_array_cardinality) {
+            to_bitmap();
+        }
+        return true;
+    }
+
+    // returns true if the value was present
+    inline bool clear(LowBits low_bits)
+    {
+        if (m_kind == ContainerKind::Runs) {
+            if (!test(low_bits)) {
+                return false;
+            }
+            to_array_or_bitmap();
+        }
+
+        if (m_kind == ContainerKind::Bitmap) {
+            u64& word = m_bitmap[low_bits / 64];
+            const u64 mask = (u64)1 << (low_bits % 64);
+            if ((word & mask) == 0) {
+                return false;
+            }
+            word &= ~mask;
+            --m_cardinality;
+            to_array_or_bitmap();
+            return true;
+        }
+
+        auto it = std::lower_bound(m_array.begin(), m_array.end(), low_bits);
+        if (it == m_array.end() || *it != low_bits) {
+            return false;
+        }
+        m_array.erase(it);
+        --m_cardinality;
+        return true;
+    }
+
+    // sets the bits of the values in the container in a zeroed
+    // array of sc_bitmap_num_words words
+    inline void fill_words(u64* words) const
+    {
+        switch (m_kind) {
+        case ContainerKind::Array:
+            for (auto value : m_array) {
+                words[value / 64] |= ((u64)1 << (value % 64));
+            }
+            break;
+        case ContainerKind::Bitmap:
+            std::copy(m_bitmap.begin(), m_bitmap.end(), words);
+            break;
+        default:
+            for (auto const& run : m_runs) {
+                for (u32 value = run.start; value <= run.last(); ++value) {
+                    words[value / 64] |= ((u64)1 << (value % 64));
+                }
+            }
+            break;
+        }
+    }
+
+    // calls function with base + each value, in increasing order
+    template <typename FunctionType>
+    inline void for_each(u64 base, const FunctionType& function) const
+    {
+        switch (m_kind) {
+        case ContainerKind::Array:
+            for (auto value : m_array) {
+                function(base + value);
+            }
+            break;
+        case ContainerKind::Bitmap:
+            bitset_ops::for_each_set_bit(m_bitmap.data(), sc_bitmap_num_words,
+                                         [&] (u64 value) -> void { function(base + value); });
+            break;
+        default:
+            for (auto const& run : m_runs) {
+                for (u32 value = run.start; value <= run.last(); ++value) {
+                    function(base + value);
+                }
+            }
+            break;
+        }
+    }
+
+    inline void unite(const Container& other)
+    {
+        // merge sorted arrays when the result can still be an array
+        if (m_kind == ContainerKind::Array && other.m_kind == ContainerKind::Array &&
+            m_cardinality + other.m_cardinality <= sc_max_array_cardinality) {
+            std::vector<LowBits> merged;
+            merged.reserve(m_cardinality + other.m_cardinality);
+            std::set_union(m_array.begin(), m_array.end(),
+                           other.m_array.begin(), other.m_array.end(),
+                           std::back_inserter(merged));
+            m_array.swap(merged);
+            m_cardinality = m_array.size();
+            return;
+        }
+
+        if (m_kind != ContainerKind::Bitmap) {
+            to_bitmap();
+        }
+        if (other.m_kind == ContainerKind::Bitmap) {
+            bitset_ops::or_with(m_bitmap.data(), other.m_bitmap.data(), sc_bitmap_num_words);
+        } else {
+            other.fill_words(m_bitmap.data());
+        }
+        m_cardinality = bitset_ops::count(m_bitmap.data(), sc_bitmap_num_words);
+        to_array_or_bitmap();
+    }
+
+    inline void intersect(const Container& other)
+    {
+        // filter the smaller side when either side is an array
+        if (m_kind == ContainerKind::Array || other.m_kind == ContainerKind::Array) {
+            const Container& small = (m_kind == ContainerKind::Array ? *this : other);
+            const Container& large = (m_kind == ContainerKind::Array ? other : *this);
+            std::vector<LowBits> values;
+            for (auto value : small.m_array) {
+                if (large.test(value)) {
+                    values.push_back(value);
+                }
+            }
+            m_array.swap(values);
+            m_bitmap.clear();
+            m_bitmap.shrink_to_fit();
+            m_runs.clear();
+            m_runs.shrink_to_fit();
+            m_kind = ContainerKind::Array;
+            m_cardinality = m_array.size();
+            return;
+        }
+
+        if (m_kind != ContainerKind::Bitmap) {
+            to_bitmap();
+        }
+        if (other.m_kind == ContainerKind::Bitmap) {
+            bitset_ops::and_with(m_bitmap.data(), other.m_bitmap.data(), sc_bitmap_num_words);
+        } else {
+            std::vector<u64> other_words(sc_bitmap_num_words, 0);
+            other.fill_words(other_words.data());
+            bitset_ops::and_with(m_bitmap.data(), other_words.data(), sc_bitmap_num_words);
+        }
+        m_cardinality = bitset_ops::count(m_bitmap.data(), sc_bitmap_num_words);
+        to_array_or_bitmap();
+    }
+
+    // switches to whichever of the three kinds takes the least space
+    inline void run_optimize()
+    {
+        const u64 num_runs = count_runs();
+        const u64 run_bytes = num_runs * sizeof(Run);
+        const u64 array_bytes = m_cardinality * sizeof(LowBits);
+        if (run_bytes >= std::min<u64>(array_bytes, sc_bitmap_bytes)) {
+            to_array_or_bitmap();
+            return;
+        }
+        if (m_kind == ContainerKind::Runs) {
+            return;
+        }
+
+        std::vector<Run> runs;
+        runs.reserve(num_runs);
+        for_each(0, [&] (u64 value) -> void
+                 {
+                     if (!runs.empty() && runs.back().last() + 1 == value) {
+                         ++runs.back().length;
+                     } else {
+                         runs.push_back(Run { (LowBits)value, 0 });
+                     }
+                 });
+        m_runs.swap(runs);
+        m_array.clear();
+        m_array.shrink_to_fit();
+        m_bitmap.clear();
+        m_bitmap.shrink_to_fit();
+        m_kind = ContainerKind::Runs;
+    }
+
+    inline u64 memory_bytes() const
+    {
+        return (m_array.capacity() * sizeof(LowBits) + m_bitmap.capacity() * sizeof(u64) +
+                m_runs.capacity() * sizeof(Run));
+    }
+
+    // Arrays and bitmaps are chosen by cardinality alone and runs
+    // are always maximal, so containers of the same kind are equal
+    // exactly when their contents are. Otherwise, with the same
+    // cardinality, it is enough that other has every value of the
+    // side that is not a bitmap
+    inline bool operator == (const Container& other) const
+    {
+        if (m_cardinality != other.m_cardinality) {
+            return false;
+        }
+        if (m_kind == other.m_kind) {
+            switch (m_kind) {
+            case ContainerKind::Array:
+                return (m_array == other.m_array);
+            case ContainerKind::Bitmap:
+                return (m_bitmap == other.m_bitmap);
+            default:
+                return (m_runs.size() == other.m_runs.size() &&
+                        std::equal(m_runs.begin(), m_runs.end(), other.m_runs.begin(),
+                                   [] (const Run& run1, const Run& run2) -> bool
+                                   {
+                                       return (run1.start == run2.start &&
+                                               run1.length == run2.length);
+                                   }));
+            }
+        }
+
+        const Container& scanned = (m_kind == ContainerKind::Bitmap ? other : *this);
+        const Container& tested = (m_kind == ContainerKind::Bitmap ? *this : other);
+        bool retval = true;
+        scanned.for_each(0, [&] (u64 value) -> void
+                         {
+                             retval = retval && tested.test((LowBits)value);
+                         });
+        return retval;
+    }
+
+    inline void serialize(std::ostream& out) const
+    {
+        write_value(out, (std::uint8_t)m_kind);
+        write_value(out, m_cardinality);
+        switch (m_kind) {
+        case ContainerKind::Array:
+            for (auto value : m_array) {
+                write_value(out, value);
+            }
+            break;
+        case ContainerKind::Bitmap:
+            for (auto word : m_bitmap) {
+                write_value(out, word);
+            }
+            break;
+        default:
+            write_value(out, (u32)m_runs.size());
+            for (auto const& run : m_runs) {
+                write_value(out, run.start);
+                write_value(out, run.length);
+            }
+            break;
+        }
+    }
+
+    inline bool deserialize(std::istream& in)
+    {
+        std::uint8_t kind;
+        if (!read_value(in, kind) || !read_value(in, m_cardinality) ||
+            m_cardinality == 0 || m_cardinality > (1 << 16)) {
+            return false;
+        }
+        m_array.clear();
+        m_bitmap.clear();
+        m_runs.clear();
+        m_kind = (ContainerKind)kind;
+
+        // arrays and bitmaps must be of the kind that their
+        // cardinality calls for, which the rest of the code assumes
+        switch (m_kind) {
+        case ContainerKind::Array:
+            if (m_cardinality > sc_max_array_cardinality) {
+                return false;
+            }
+            m_array.resize(m_cardinality);
+            for (auto& value : m_array) {
+                if (!read_value(in, value)) {
+                    return false;
+                }
+            }
+            return (std::adjacent_find(m_array.begin(), m_array.end(),
+                                       std::greater_equal<LowBits>()) == m_array.end());
+        case ContainerKind::Bitmap:
+            if (m_cardinality <= sc_max_array_cardinality) {
+                return false;
+            }
+            m_bitmap.resize(sc_bitmap_num_words);
+            for (auto& word : m_bitmap) {
+                if (!read_value(in, word)) {
+                    return false;
+                }
+            }
+            return (bitset_ops::count(m_bitmap.data(), sc_bitmap_num_words) == m_cardinality);
+        case ContainerKind::Runs: {
+            u32 num_runs;
+            if (!read_value(in, num_runs) || num_runs > (1 << 15)) {
+                return false;
+            }
+            m_runs.resize(num_runs);
+            u64 cardinality = 0;
+            for (u32 i = 0; i < num_runs; ++i) {
+                Run& run = m_runs[i];
+                if (!read_value(in, run.start) || !read_value(in, run.length) ||
+                    run.last() > UINT16_MAX ||
+                    (i > 0 && m_runs[i - 1].last() + 1 >= run.start)) {
+                    return false;
+                }
+                cardinality += (u64)run.length + 1;
+            }
+            return (cardinality == m_cardinality);
+        }
+        default:
+            return false;
+        }
+    }
+};
+
+} /* end namespace roaring_bitmap_detail_ */
+
+class RoaringBitmap
+{
+private:
+    typedef roaring_bitmap_detail_::Container Container;
+    typedef roaring_bitmap_detail_::LowBits LowBits;
+
+    // the high bits of the values in each chunk, sorted, and kept
+    // apart from the containers so that the search stays compact
+    std::vector<LowBits> m_keys;
+    std::vector<Container> m_containers;
+    u64 m_cardinality;
+
+    static inline LowBits high_bits(u64 value)
+    {
+        return (LowBits)(value >> 16);
+    }
+
+    static inline LowBits low_bits(u64 value)
+    {
+        return (LowBits)value;
+    }
+
+    inline u64 find_chunk(LowBits key) const
+    {
+        // appending in increasing order is the common case
+        if (!m_keys.empty() && m_keys.back() < key) {
+            return m_keys.size();
+        }
+        return (std::lower_bound(m_keys.begin(), m_keys.end(), key) - m_keys.begin());
+    }
+
+    inline void recount()
+    {
+        m_cardinality = 0;
+        for (auto const& container : m_containers) {
+            m_cardinality += container.cardinality();
+        }
+    }
+
+public:
+    inline RoaringBitmap()
+        : m_cardinality(0)
+    {
+        // Nothing here
+    }
+
+    // only for compatibility with BitSet, the universe is fixed
+    inline explicit RoaringBitmap(u64)
+        : m_cardinality(0)
+    {
+        // Nothing here
+    }
+
+    inline RoaringBitmap(const RoaringBitmap& other) = default;
+    inline RoaringBitmap(RoaringBitmap&& other) = default;
+    inline RoaringBitmap& operator = (const RoaringBitmap& other) = default;
+    inline RoaringBitmap& operator = (RoaringBitmap&& other) = default;
+
+    // values must be less than 2^32, others would wrap around
+    inline void set(u64 value)
+    {
+#if defined KINARA_CFG_DEBUG_MODE_BUILD_
+        assert(value <= 0xFFFFFFFFULL);
+#endif /* KINARA_CFG_DEBUG_MODE_BUILD_ */
+        const LowBits key = high_bits(value);
+        auto index = find_chunk(key);
+        if (index == m_keys.size() || m_keys[index] != key) {
+            m_keys.insert(m_keys.begin() + index, key);
+            m_containers.insert(m_containers.begin() + index, Container());
+        }
+        if (m_containers[index].set(low_bits(value))) {
+            ++m_cardinality;
+        }
+    }
+
+    inline void clear(u64 value)
+    {
+#if defined KINARA_CFG_DEBUG_MODE_BUILD_
+        assert(value <= 0xFFFFFFFFULL);
+#endif /* KINARA_CFG_DEBUG_MODE_BUILD_ */
+        const LowBits key = high_bits(value);
+        auto index = find_chunk(key);
+        if (index == m_keys.size() || m_keys[index] != key) {
+            return;
+        }
+        if (m_containers[index].clear(low_bits(value))) {
+            --m_cardinality;
+            if (m_containers[index].cardinality() == 0) {
+                m_keys.erase(m_keys.begin() + index);
+                m_containers.erase(m_containers.begin() + index);
+            }
+        }
+    }
+
+    inline void clear()
+    {
+        m_keys.clear();
+        m_containers.clear();
+        m_cardinality = 0;
+    }
+
+    inline bool test(u64 value) const
+    {
+#if defined KINARA_CFG_DEBUG_MODE_BUILD_
+        assert(value <= 0xFFFFFFFFULL);
+#endif /* KINARA_CFG_DEBUG_MODE_BUILD_ */
+        const LowBits key = high_bits(value);
+        auto index = find_chunk(key);
+        return (index != m_keys.size() && m_keys[index] == key &&
+                m_containers[index].test(low_bits(value)));
+    }
+
+    inline u64 size() const
+    {
+        return m_cardinality;
+    }
+
+    inline u64 count() const
+    {
+        return m_cardinality;
+    }
+
+    inline bool empty() const
+    {
+        return (m_cardinality == 0);
+    }
+
+    // calls function with every value, in increasing order
+    template <typename FunctionType>
+    inline void for_each(const FunctionType& function) const
+    {
+        for (u64 i = 0; i < m_keys.size(); ++i) {
+            m_containers[i].for_each((u64)m_keys[i] << 16, function);
+        }
+    }
+
+    inline RoaringBitmap& operator |= (const RoaringBitmap& other)
+    {
+        std::vector<LowBits> keys;
+        std::vector<Container> containers;
+        keys.reserve(m_keys.size() + other.m_keys.size());
+        containers.reserve(m_keys.size() + other.m_keys.size());
+        u64 i = 0;
+        u64 j = 0;
+        while (i < m_keys.size() || j < other.m_keys.size()) {
+            if (j == other.m_keys.size() || (i < m_keys.size() && m_keys[i] < other.m_keys[j])) {
+                keys.push_back(m_keys[i]);
+                containers.push_back(std::move(m_containers[i++]));
+            } else if (i == m_keys.size() || other.m_keys[j] < m_keys[i]) {
+                keys.push_back(other.m_keys[j]);
+                containers.push_back(other.m_containers[j++]);
+            } else {
+                m_containers[i].unite(other.m_containers[j++]);
+                keys.push_back(m_keys[i]);
+                containers.push_back(std::move(m_containers[i++]));
+            }
+        }
+        m_keys.swap(keys);
+        m_containers.swap(containers);
+        recount();
+        return *this;
+    }
+
+    inline RoaringBitmap& operator &= (const RoaringBitmap& other)
+    {
+        std::vector<LowBits> keys;
+        std::vector<Container> containers;
+        u64 i = 0;
+        u64 j = 0;
+        while (i < m_keys.size() && j < other.m_keys.size()) {
+            if (m_keys[i] < other.m_keys[j]) {
+                ++i;
+            } else if (other.m_keys[j] < m_keys[i]) {
+                ++j;
+            } else {
+                m_containers[i].intersect(other.m_containers[j++]);
+                if (m_containers[i].cardinality() != 0) {
+                    keys.push_back(m_keys[i]);
+                    containers.push_back(std::move(m_containers[i]));
+                }
+                ++i;
+            }
+        }
+        m_keys.swap(keys);
+        m_containers.swap(containers);
+        recount();
+        return *this;
+    }
+
+    inline RoaringBitmap operator | (const RoaringBitmap& other) const
+    {
+        RoaringBitmap retval(*this);
+        retval |= other;
+        return retval;
+    }
+
+    inline RoaringBitmap operator & (const RoaringBitmap& other) const
+    {
+        RoaringBitmap retval(*this);
+        retval &= other;
+        return retval;
+    }
+
+    inline bool operator == (const RoaringBitmap& other) const
+    {
+        if (m_cardinality != other.m_cardinality || m_keys != other.m_keys) {
+            return false;
+        }
+        for (u64 i = 0; i < m_keys.size(); ++i) {
+            if (!(m_containers[i] == other.m_containers[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline bool operator != (const RoaringBitmap& other) const
+    {
+        return !(*this == other);
+    }
+
+    // converts chunks to runs where that takes less space
+    inline void run_optimize()
+    {
+        for (auto& container : m_containers) {
+            container.run_optimize();
+        }
+    }
+
+    // an estimate of the heap memory in use
+    inline u64 memory_bytes() const
+    {
+        u64 retval = m_keys.capacity() * sizeof(LowBits) + m_containers.capacity() * sizeof(Container);
+        for (auto const& container : m_containers) {
+            retval += container.memory_bytes();
+        }
+        return retval;
+    }
+
+    // The format is the number of chunks, then each chunk as its high
+    // bits, its kind, its cardinality and its contents, little endian
+    inline void serialize(std::ostream& out) const
+    {
+        roaring_bitmap_detail_::write_value(out, (u32)m_keys.size());
+        for (u64 i = 0; i < m_keys.size(); ++i) {
+            roaring_bitmap_detail_::write_value(out, m_keys[i]);
+            m_containers[i].serialize(out);
+        }
+    }
+
+    // returns false, leaving the bitmap empty, on malformed input
+    inline bool deserialize(std::istream& in)
+    {
+        clear();
+        u32 num_chunks;
+        if (!roaring_bitmap_detail_::read_value(in, num_chunks) || num_chunks > (1 << 16)) {
+            return false;
+        }
+        m_keys.resize(num_chunks);
+        m_containers.resize(num_chunks);
+        for (u32 i = 0; i < num_chunks; ++i) {
+            if (!roaring_bitmap_detail_::read_value(in, m_keys[i]) ||
+                !m_containers[i].deserialize(in) ||
+                (i > 0 && m_keys[i - 1] >= m_keys[i])) {
+                clear();
+                return false;
+            }
+        }
+        recount();
+        return true;
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_ROARING_BITMAP_HPP_ */
+
+//
+// RoaringBitmap.hpp ends here
@@ -0,0 +1,642 @@
+// SmallVector.hpp ---
+//
+// Filename: SmallVector.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 21:03:26 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+
+// Code:
+
+// A vector with the interface of Vector that keeps up to N elements
+// inline, in the object itself, and only goes to the heap when it
+// grows beyond that. Most of the vectors built while generating
+// successors or rewriting expressions are this short, and never
+// allocate at all.
+//
+// Types for which IsTriviallyRelocatable holds are moved around as
+// raw bytes: growing a heap buffer is a realloc(), and insertions and
+// erasures shift the tail with a memmove(). This holds for trivially
+// copyable types, and may be specialized for others whose objects
+// can be moved to a new address with a memcpy() without running any
+// constructor or destructor, such as most handle and pointer classes.
+// Other types are moved element by element.
+//
+// As with Vector, the iterators are pointers, insertions and growth
+// invalidate them, and vectors compare by size first, and then
+// lexicographically.
+
+#if !defined KINARA_COMMON_CONTAINERS_SMALL_VECTOR_HPP_
+#define KINARA_COMMON_CONTAINERS_SMALL_VECTOR_HPP_
+
+#include <new>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+
+template <typename T>
+class IsTriviallyRelocatable
+    : public std::integral_constant<bool, std::is_trivially_copyable<T>::value>
+{
+    // Nothing here
+};
+
+template <typename T, u32 N = 8>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector needs room for at least one element inline");
+
+public:
+    typedef T ValueType;
+    typedef T* Iterator;
+    typedef const T* ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+private:
+    static const bool sc_relocatable = IsTriviallyRelocatable<T>::value;
+
+    T* m_data;
+    u64 m_size;
+    u64 m_capacity;
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type m_inline;
+
+    inline T* inline_data()
+    {
+        return reinterpret_cast<T*>(&m_inline);
+    }
+
+    inline bool is_inline() const
+    {
+        return (m_data == reinterpret_cast<const T*>(&m_inline));
+    }
+
+    inline void destroy_range(T* first, T* last)
+    {
+        if (!std::is_trivially_destructible<T>::value) {
+            for (; first != last; ++first) {
+                first->~T();
+            }
+        }
+    }
+
+    // moves [first, last) to uninitialized memory at destination
+    inline void relocate(T* first, T* last, T* destination)
+    {
+        if (sc_relocatable) {
+            std::memcpy(static_cast<void*>(destination), first, sizeof(T) * (last - first));
+            return;
+        }
+        for (T* it = first; it != last; ++it, ++destination) {
+            new (destination) T(std::move(*it));
+        }
+        destroy_range(first, last);
+    }
+
+    template <typename InputIterator>
+    inline bool is_own_element(const InputIterator& iterator) const
+    {
+        return false;
+    }
+
+    inline bool is_own_element(const T* pointer) const
+    {
+        return (pointer >= m_data && pointer < m_data + m_size);
+    }
+
+    inline bool is_own_element(T* pointer) const
+    {
+        return (pointer >= m_data && pointer < m_data + m_size);
+    }
+
+    // moves the elements to a heap buffer of new_capacity elements
+    inline void reallocate(u64 new_capacity)
+    {
+        T* new_data;
+        if (sc_relocatable && !is_inline()) {
+            new_data = static_cast<T*>(std::realloc(static_cast<void*>(m_data),
+                                                         sizeof(T) * new_capacity));
+            if (new_data == nullptr) {
+                throw std::bad_alloc();
+            }
+        } else {
+            new_data = static_cast<T*>(std::malloc(sizeof(T) * new_capacity));
+            if (new_data == nullptr) {
+                throw std::bad_alloc();
+            }
+            relocate(m_data, m_data + m_size, new_data);
+            if (!is_inline()) {
+                std::free(m_data);
+            }
+        }
+        m_data = new_data;
+        m_capacity = new_capacity;
+    }
+
+    inline void grow_to(u64 min_capacity)
+    {
+        if (min_capacity > m_capacity) {
+            reallocate(std::max(min_capacity, 2 * m_capacity));
+        }
+    }
+
+    // frees a heap buffer, the elements must be gone
+    inline void release_storage()
+    {
+        if (!is_inline()) {
+            std::free(m_data);
+        }
+        m_data = inline_data();
+        m_capacity = N;
+    }
+
+    template <typename InputIterator>
+    inline void append(InputIterator first, InputIterator last)
+    {
+        reserve(m_size + std::distance(first, last));
+        for (auto it = first; it != last; ++it) {
+            new (m_data + m_size) T(*it);
+            ++m_size;
+        }
+    }
+
+    // takes the elements of other, leaving it empty
+    inline void steal(SmallVector& other)
+    {
+        if (other.is_inline()) {
+            relocate(other.m_data, other.m_data + other.m_size, m_data);
+            m_size = other.m_size;
+        } else {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_data = other.inline_data();
+            other.m_capacity = N;
+        }
+        other.m_size = 0;
+    }
+
+public:
+    inline SmallVector()
+        : m_data(inline_data()), m_size(0), m_capacity(N)
+    {
+        // Nothing here
+    }
+
+    inline explicit SmallVector(u64 size)
+        : SmallVector()
+    {
+        resize(size);
+    }
+
+    inline SmallVector(u64 size, const T& value)
+        : SmallVector()
+    {
+        resize(size, value);
+    }
+
+    template <typename InputIterator,
+              typename = typename std::enable_if<
+                  !std::is_integral<InputIterator>::value>::type>
+    inline SmallVector(InputIterator first, InputIterator last)
+        : SmallVector()
+    {
+        append(first, last);
+    }
+
+    inline SmallVector(std::initializer_list<T> init_list)
+        : SmallVector()
+    {
+        append(init_list.begin(), init_list.end());
+    }
+
+    inline SmallVector(const SmallVector& other)
+        : SmallVector()
+    {
+        append(other.begin(), other.end());
+    }
+
+    inline SmallVector(SmallVector&& other)
+        : SmallVector()
+    {
+        steal(other);
+    }
+
+    inline ~SmallVector()
+    {
+        destroy_range(m_data, m_data + m_size);
+        release_storage();
+    }
+
+    inline SmallVector& operator = (const SmallVector& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        clear();
+        append(other.begin(), other.end());
+        return *this;
+    }
+
+    inline SmallVector& operator = (SmallVector&& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        clear();
+        release_storage();
+        steal(other);
+        return *this;
+    }
+
+    inline SmallVector& operator = (std::initializer_list<T> init_list)
+    {
+        clear();
+        append(init_list.begin(), init_list.end());
+        return *this;
+    }
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    inline u64 capacity() const
+    {
+        return m_capacity;
+    }
+
+    // whether the elements are in the inline buffer
+    inline bool is_small() const
+    {
+        return is_inline();
+    }
+
+    inline T* data()
+    {
+        return m_data;
+    }
+
+    inline const T* data() const
+    {
+        return m_data;
+    }
+
+    inline T& operator [] (u64 index)
+    {
+        return m_data[index];
+    }
+
+    inline const T& operator [] (u64 index) const
+    {
+        return m_data[index];
+    }
+
+    inline T& front()
+    {
+        return m_data[0];
+    }
+
+    inline const T& front() const
+    {
+        return m_data[0];
+    }
+
+    inline T& back()
+    {
+        return m_data[m_size - 1];
+    }
+
+    inline const T& back() const
+    {
+        return m_data[m_size - 1];
+    }
+
+    inline Iterator begin()
+    {
+        return m_data;
+    }
+
+    inline Iterator end()
+    {
+        return m_data + m_size;
+    }
+
+    inline ConstIterator begin() const
+    {
+        return m_data;
+    }
+
+    inline ConstIterator end() const
+    {
+        return m_data + m_size;
+    }
+
+    inline ConstIterator cbegin() const
+    {
+        return m_data;
+    }
+
+    inline ConstIterator cend() const
+    {
+        return m_data + m_size;
+    }
+
+    inline void reserve(u64 new_capacity)
+    {
+        if (new_capacity > m_capacity) {
+            reallocate(new_capacity);
+        }
+    }
+
+    template <typename... ArgTypes>
+    inline void emplace_back(ArgTypes&&... args)
+    {
+        if (m_size == m_capacity) {
+            // the arguments may refer to an element
+            T value(std::forward<ArgTypes>(args)...);
+            grow_to(m_size + 1);
+            new (m_data + m_size) T(std::move(value));
+        } else {
+            new (m_data + m_size) T(std::forward<ArgTypes>(args)...);
+        }
+        ++m_size;
+    }
+
+    inline void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    inline void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    inline void pop_back()
+    {
+        --m_size;
+        m_data[m_size].~T();
+    }
+
+    inline Iterator insert(ConstIterator position, const T& value)
+    {
+        return insert(position, &value, &value + 1);
+    }
+
+    template <typename InputIterator>
+    inline Iterator insert(ConstIterator position, InputIterator first, InputIterator last)
+    {
+        const u64 index = position - m_data;
+        const u64 num_inserted = std::distance(first, last);
+        if (num_inserted == 0) {
+            return m_data + index;
+        }
+
+        if (m_size + num_inserted > m_capacity) {
+            // build the new buffer around the inserted values,
+            // which may still be read from the old one
+            const u64 new_capacity = std::max(m_size + num_inserted, 2 * m_capacity);
+            T* new_data = static_cast<T*>(std::malloc(sizeof(T) * new_capacity));
+            if (new_data == nullptr) {
+                throw std::bad_alloc();
+            }
+            T* out = new_data + index;
+            for (auto it = first; it != last; ++it, ++out) {
+                new (out) T(*it);
+            }
+            relocate(m_data, m_data + index, new_data);
+            relocate(m_data + index, m_data + m_size, out);
+            if (!is_inline()) {
+                std::free(m_data);
+            }
+            m_data = new_data;
+            m_capacity = new_capacity;
+            m_size += num_inserted;
+            return m_data + index;
+        }
+
+        if (sc_relocatable && index < m_size) {
+            if (is_own_element(first)) {
+                SmallVector values(first, last);
+                return insert(position, values.begin(), values.end());
+            }
+            std::memmove(static_cast<void*>(m_data + index + num_inserted), m_data + index,
+                         sizeof(T) * (m_size - index));
+            T* out = m_data + index;
+            for (auto it = first; it != last; ++it, ++out) {
+                new (out) T(*it);
+            }
+            m_size += num_inserted;
+            return m_data + index;
+        }
+
+        const u64 old_size = m_size;
+        for (auto it = first; it != last; ++it) {
+            new (m_data + m_size) T(*it);
+            ++m_size;
+        }
+        std::rotate(m_data + index, m_data + old_size, m_data + m_size);
+        return m_data + index;
+    }
+
+    inline Iterator erase(ConstIterator position)
+    {
+        return erase(position, position + 1);
+    }
+
+    inline Iterator erase(ConstIterator first, ConstIterator last)
+    {
+        T* const first_erased = m_data + (first - m_data);
+        T* const last_erased = m_data + (last - m_data);
+        if (first_erased == last_erased) {
+            return first_erased;
+        }
+        if (sc_relocatable) {
+            destroy_range(first_erased, last_erased);
+            std::memmove(static_cast<void*>(first_erased), last_erased,
+                         sizeof(T) * (end() - last_erased));
+        } else {
+            T* new_end = std::move(last_erased, end(), first_erased);
+            destroy_range(new_end, end());
+        }
+        m_size -= (last_erased - first_erased);
+        return first_erased;
+    }
+
+    inline void resize(u64 new_size)
+    {
+        if (new_size < m_size) {
+            destroy_range(m_data + new_size, m_data + m_size);
+            m_size = new_size;
+            return;
+        }
+        grow_to(new_size);
+        while (m_size < new_size) {
+            new (m_data + m_size) T();
+            ++m_size;
+        }
+    }
+
+    inline void resize(u64 new_size, const T& value)
+    {
+        if (new_size < m_size) {
+            destroy_range(m_data + new_size, m_data + m_size);
+            m_size = new_size;
+            return;
+        }
+        if (new_size > m_capacity) {
+            T copy(value);
+            grow_to(new_size);
+            while (m_size < new_size) {
+                new (m_data + m_size) T(copy);
+                ++m_size;
+            }
+            return;
+        }
+        while (m_size < new_size) {
+            new (m_data + m_size) T(value);
+            ++m_size;
+        }
+    }
+
+    inline void clear()
+    {
+        destroy_range(m_data, m_data + m_size);
+        m_size = 0;
+    }
+
+    // moves the elements back inline if they fit
+    inline void shrink_to_fit()
+    {
+        if (is_inline() || m_size == m_capacity) {
+            return;
+        }
+        if (m_size > N) {
+            reallocate(m_size);
+            return;
+        }
+        T* heap_data = m_data;
+        m_data = inline_data();
+        relocate(heap_data, heap_data + m_size, m_data);
+        std::free(heap_data);
+        m_capacity = N;
+    }
+
+    inline Iterator find(const T& value)
+    {
+        return std::find(begin(), end(), value);
+    }
+
+    inline ConstIterator find(const T& value) const
+    {
+        return std::find(begin(), end(), value);
+    }
+
+    inline void sort()
+    {
+        std::sort(begin(), end());
+    }
+
+    template <typename Comparator>
+    inline void sort(const Comparator& comparator)
+    {
+        std::sort(begin(), end(), comparator);
+    }
+
+    inline void reverse()
+    {
+        std::reverse(begin(), end());
+    }
+
+    inline bool operator == (const SmallVector& other) const
+    {
+        return (m_size == other.m_size && std::equal(begin(), end(), other.begin()));
+    }
+
+    inline bool operator != (const SmallVector& other) const
+    {
+        return !(*this == other);
+    }
+
+    inline bool operator < (const SmallVector& other) const
+    {
+        if (m_size != other.m_size) {
+            return (m_size < other.m_size);
+        }
+        return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+    }
+
+    inline bool operator > (const SmallVector& other) const
+    {
+        return (other < *this);
+    }
+
+    inline bool operator <= (const SmallVector& other) const
+    {
+        return !(other < *this);
+    }
+
+    inline bool operator >= (const SmallVector& other) const
+    {
+        return !(*this < other);
+    }
+};
+
+template <u32 N = 8>
+using u32SmallVector = SmallVector<u32, N>;
+
+template <u32 N = 8>
+using u64SmallVector = SmallVector<u64, N>;
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_SMALL_VECTOR_HPP_ */
+
+//
+// SmallVector.hpp ends here
@@ -0,0 +1,970 @@
+// SwissHashTable.hpp ---
+//
+// Filename: SwissHashTable.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 15:10:27 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// An open addressing hash table which keeps one control byte per
+// slot. A control byte is either one of the markers for an empty or
+// a deleted slot, or seven bits of the hash of the element in the
+// slot. Slots are grouped sixteen to a group, and a probe compares
+// the control bytes of a whole group at once (using SSE2 when it is
+// available), comparing keys only on a match of the hash bits. As a
+// consequence, no key values need to be reserved as sentinels.
+
+#if !defined KINARA_COMMON_CONTAINERS_SWISS_HASH_TABLE_HPP_
+#define KINARA_COMMON_CONTAINERS_SWISS_HASH_TABLE_HPP_
+
+#include <new>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+
+#if defined __SSE2__
+#include <emmintrin.h>
+#endif /* __SSE2__ */
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+namespace swiss_hash_table_detail_ {
+
+typedef std::int8_t ControlByte;
+
+static const ControlByte sc_empty_slot = -128;
+static const ControlByte sc_deleted_slot = -2;
+static const u64 sc_group_width = 16;
+
+// a bitmask with one bit per slot of a group
+class GroupMask
+{
+private:
+    u32 m_mask;
+
+public:
+    inline explicit GroupMask(u32 mask)
+        : m_mask(mask)
+    {
+        // Nothing here
+    }
+
+    inline operator bool () const
+    {
+        return (m_mask != 0);
+    }
+
+    inline u32 lowest() const
+    {
+        return __builtin_ctz(m_mask);
+    }
+
+    inline void remove_lowest()
+    {
+        m_mask &= (m_mask - 1);
+    }
+
+    inline void remove_below(u32 offset)
+    {
+        m_mask &= ~((1u << offset) - 1);
+    }
+};
+
+class Group
+{
+private:
+#if defined __SSE2__
+    __m128i m_control;
+#else
+    const ControlByte* m_control;
+#endif /* __SSE2__ */
+
+    // both markers have the sign bit set, hash fragments don't
+    inline u32 empty_or_deleted_bits() const
+    {
+#if defined __SSE2__
+        return _mm_movemask_epi8(m_control);
+#else
+        u32 mask = 0;
+        for (u64 i = 0; i < sc_group_width; ++i) {
+            mask |= ((u32)(m_control[i] < 0) << i);
+        }
+        return mask;
+#endif /* __SSE2__ */
+    }
+
+public:
+    inline explicit Group(const ControlByte* control)
+#if defined __SSE2__
+        : m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)))
+#else
+        : m_control(control)
+#endif /* __SSE2__ */
+    {
+        // Nothing here
+    }
+
+    // slots whose control byte is equal to the hash fragment
+    inline GroupMask match(ControlByte hash_fragment) const
+    {
+#if defined __SSE2__
+        auto matches = _mm_cmpeq_epi8(_mm_set1_epi8(hash_fragment), m_control);
+        return GroupMask(_mm_movemask_epi8(matches));
+#else
+        u32 mask = 0;
+        for (u64 i = 0; i < sc_group_width; ++i) {
+            mask |= ((u32)(m_control[i] == hash_fragment) << i);
+        }
+        return GroupMask(mask);
+#endif /* __SSE2__ */
+    }
+
+    inline GroupMask match_empty() const
+    {
+        return match(sc_empty_slot);
+    }
+
+    inline GroupMask match_empty_or_deleted() const
+    {
+        return GroupMask(empty_or_deleted_bits());
+    }
+
+    inline GroupMask match_full() const
+    {
+        return GroupMask((~empty_or_deleted_bits()) & 0xFFFF);
+    }
+};
+
+template <typename TableType, bool ISCONST>
+class IteratorBase
+{
+    friend TableType;
+    template <typename, bool> friend class IteratorBase;
+
+public:
+    typedef typename TableType::ValueType ValueType;
+    typedef typename std::conditional<ISCONST, const ValueType, ValueType>::type
+    QualifiedValueType;
+
+    typedef std::forward_iterator_tag iterator_category;
+    typedef ValueType value_type;
+    typedef i64 difference_type;
+    typedef QualifiedValueType* pointer;
+    typedef QualifiedValueType& reference;
+
+private:
+    typedef typename std::conditional<ISCONST, const TableType, TableType>::type
+    QualifiedTableType;
+
+    QualifiedTableType* m_table;
+    u64 m_index;
+
+    inline IteratorBase(QualifiedTableType* table, u64 index)
+        : m_table(table), m_index(index)
+    {
+        // Nothing here
+    }
+
+public:
+    inline IteratorBase()
+        : m_table(nullptr), m_index(0)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase(const IteratorBase& other) = default;
+
+    // conversion from a mutable iterator to a const one
+    template <bool OTHERCONST,
+              typename = typename std::enable_if<ISCONST && !OTHERCONST>::type>
+    inline IteratorBase(const IteratorBase<TableType, OTHERCONST>& other)
+        : m_table(other.m_table), m_index(other.m_index)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase& operator = (const IteratorBase& other) = default;
+
+    inline reference operator * () const
+    {
+        return m_table->slot_ref(m_index);
+    }
+
+    inline pointer operator -> () const
+    {
+        return &(m_table->slot_ref(m_index));
+    }
+
+    inline IteratorBase& operator ++ ()
+    {
+        m_index = m_table->next_full_slot(m_index + 1);
+        return *this;
+    }
+
+    inline IteratorBase operator ++ (int)
+    {
+        auto retval = *this;
+        ++(*this);
+        return retval;
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator == (const IteratorBase<TableType, OTHERCONST>& other) const
+    {
+        return (m_index == other.m_index);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator != (const IteratorBase<TableType, OTHERCONST>& other) const
+    {
+        return (m_index != other.m_index);
+    }
+};
+
+} /* end namespace swiss_hash_table_detail_ */
+
+// T is the type of the elements, KeyExtractor extracts
+// the key (of type KeyType) from an element
+//
+// By default, growing the table rehashes all the elements at
+// once. With incremental rehashing enabled, the old table is
+// kept around when the table grows, and every insertion, mutable
+// find or erase by key moves a bounded number of groups from the
+// old table into the new one. Lookups consult both tables until
+// the old one has been drained. Slot indices beyond the capacity
+// of the (new) table refer to slots of the old table.
+template <typename T, typename KeyType, typename KeyExtractor,
+          typename HashFunction, typename EqualsFunction>
+class SwissHashTable
+{
+    template <typename, bool> friend class swiss_hash_table_detail_::IteratorBase;
+
+public:
+    typedef T ValueType;
+    typedef swiss_hash_table_detail_::IteratorBase<SwissHashTable, false> Iterator;
+    typedef swiss_hash_table_detail_::IteratorBase<SwissHashTable, true> ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+private:
+    typedef swiss_hash_table_detail_::ControlByte ControlByte;
+    typedef swiss_hash_table_detail_::Group Group;
+    typedef swiss_hash_table_detail_::GroupMask GroupMask;
+
+    // sets store their elements as const T
+    typedef typename std::remove_const<T>::type StorageType;
+
+    static const u64 sc_group_width = swiss_hash_table_detail_::sc_group_width;
+    // groups moved out of the old table per operation, the old
+    // table is drained long before the new one can fill up
+    static const u64 sc_groups_per_migration_step = 2;
+
+    ControlByte* m_control;
+    StorageType* m_slots;
+    u64 m_capacity;
+    u64 m_size;
+    u64 m_num_deleted;
+
+    // the table being drained by an incremental rehash
+    ControlByte* m_old_control;
+    StorageType* m_old_slots;
+    u64 m_old_capacity;
+    u64 m_old_size;
+    u64 m_migration_cursor;
+    bool m_incremental_rehash;
+
+    KeyExtractor m_key_extractor;
+    HashFunction m_hash_function;
+    EqualsFunction m_equals_function;
+
+    // The low bits of the spread hash pick the home slot, so small
+    // integral keys under an identity hash land (and iterate) in
+    // order; xoring in the high bits keeps keys that differ only
+    // in their high bits from piling up in one group
+    static inline u64 spread_hash(u64 hash_value)
+    {
+        return (hash_value ^ (hash_value >> 16) ^ (hash_value >> 32));
+    }
+
+    static inline ControlByte hash_fragment(u64 hash_value)
+    {
+        return (ControlByte)((hash_value * 0x9E3779B97F4A7C15ULL) >> 57);
+    }
+
+    static inline u64 max_load(u64 capacity)
+    {
+        return capacity - (capacity / 8);
+    }
+
+    static inline u64 next_full_slot(const ControlByte* control, u64 capacity, u64 index)
+    {
+        while (index < capacity) {
+            const u64 group_start = index & ~(sc_group_width - 1);
+            auto full = Group(control + group_start).match_full();
+            full.remove_below(index - group_start);
+            if (full) {
+                return group_start + full.lowest();
+            }
+            index = group_start + sc_group_width;
+        }
+        return capacity;
+    }
+
+    inline u64 num_groups() const
+    {
+        return (m_capacity / sc_group_width);
+    }
+
+    inline u64 end_index() const
+    {
+        return (m_capacity + m_old_capacity);
+    }
+
+    inline bool is_migrating() const
+    {
+        return (m_old_capacity != 0);
+    }
+
+    inline StorageType& slot_ref(u64 index)
+    {
+        return (index < m_capacity ? m_slots[index] : m_old_slots[index - m_capacity]);
+    }
+
+    inline const StorageType& slot_ref(u64 index) const
+    {
+        return (index < m_capacity ? m_slots[index] : m_old_slots[index - m_capacity]);
+    }
+
+    inline u64 next_full_slot(u64 index) const
+    {
+        if (index < m_capacity) {
+            index = next_full_slot(m_control, m_capacity, index);
+            if (index < m_capacity || !is_migrating()) {
+                return index;
+            }
+        }
+        if (!is_migrating()) {
+            return m_capacity;
+        }
+        return m_capacity + next_full_slot(m_old_control, m_old_capacity, index - m_capacity);
+    }
+
+    inline void allocate(u64 capacity)
+    {
+        m_capacity = capacity;
+        if (capacity == 0) {
+            m_control = nullptr;
+            m_slots = nullptr;
+            return;
+        }
+        m_control = new ControlByte[capacity];
+        memset(m_control, swiss_hash_table_detail_::sc_empty_slot, capacity);
+        m_slots = static_cast<StorageType*>(::operator new(capacity * sizeof(StorageType)));
+    }
+
+    inline void destroy_elements()
+    {
+        if (!std::is_trivially_destructible<StorageType>::value) {
+            for (u64 i = next_full_slot(0); i < end_index(); i = next_full_slot(i + 1)) {
+                slot_ref(i).~StorageType();
+            }
+        }
+    }
+
+    // frees the old table, whose elements must
+    // have been moved out or destroyed already
+    inline void release_old_table()
+    {
+        if (!is_migrating()) {
+            return;
+        }
+        delete[] m_old_control;
+        ::operator delete(m_old_slots);
+        m_old_control = nullptr;
+        m_old_slots = nullptr;
+        m_old_capacity = 0;
+        m_old_size = 0;
+        m_migration_cursor = 0;
+    }
+
+    inline void deallocate()
+    {
+        if (end_index() == 0) {
+            return;
+        }
+        destroy_elements();
+        release_old_table();
+        delete[] m_control;
+        ::operator delete(m_slots);
+        m_control = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+    }
+
+    inline void set_control(u64 index, ControlByte control)
+    {
+        m_control[index] = control;
+    }
+
+    // probes a single table, returns capacity if the key is not present
+    inline u64 find_index(const ControlByte* control, const StorageType* slots,
+                          u64 capacity, const KeyType& key, u64 hash_value) const
+    {
+        if (capacity == 0) {
+            return capacity;
+        }
+
+        const u64 table_num_groups = capacity / sc_group_width;
+        const u64 group_mask = table_num_groups - 1;
+        const ControlByte fragment = hash_fragment(hash_value);
+        u64 group_index = (spread_hash(hash_value) / sc_group_width) & group_mask;
+
+        for (u64 probe = 1; probe <= table_num_groups; ++probe) {
+            const u64 group_start = group_index * sc_group_width;
+            Group group(control + group_start);
+
+            auto matches = group.match(fragment);
+            while (matches) {
+                const u64 index = group_start + matches.lowest();
+                if (m_equals_function(m_key_extractor(slots[index]), key)) {
+                    return index;
+                }
+                matches.remove_lowest();
+            }
+            if (group.match_empty()) {
+                return capacity;
+            }
+            // triangular probing visits every group of a power of two
+            group_index = (group_index + probe) & group_mask;
+        }
+        return capacity;
+    }
+
+    // returns end_index() if the key is not present
+    inline u64 find_index(const KeyType& key, u64 hash_value) const
+    {
+        const u64 index = find_index(m_control, m_slots, m_capacity, key, hash_value);
+        if (index != m_capacity || !is_migrating()) {
+            return index;
+        }
+        return m_capacity + find_index(m_old_control, m_old_slots, m_old_capacity,
+                                       key, hash_value);
+    }
+
+    // finds a free slot on the probe sequence of hash_value,
+    // preferring the home slot itself
+    inline u64 find_free_slot(u64 hash_value) const
+    {
+        const u64 group_mask = num_groups() - 1;
+        const u64 home_slot = spread_hash(hash_value) & (m_capacity - 1);
+        if (m_control[home_slot] < 0) {
+            return home_slot;
+        }
+
+        u64 group_index = home_slot / sc_group_width;
+        for (u64 probe = 1; ; ++probe) {
+            const u64 group_start = group_index * sc_group_width;
+            Group group(m_control + group_start);
+            auto free_slots = group.match_empty_or_deleted();
+            if (free_slots) {
+                return group_start + free_slots.lowest();
+            }
+            group_index = (group_index + probe) & group_mask;
+        }
+    }
+
+    // constructs an element known not to be present in the
+    // (new) table, without updating the size of the table
+    template <typename... ArgTypes>
+    inline u64 place_element(u64 hash_value, ArgTypes&&... args)
+    {
+        const u64 index = find_free_slot(hash_value);
+        new (m_slots + index) StorageType(std::forward<ArgTypes>(args)...);
+        if (m_control[index] == swiss_hash_table_detail_::sc_deleted_slot) {
+            --m_num_deleted;
+        }
+        set_control(index, hash_fragment(hash_value));
+        return index;
+    }
+
+    // moves the elements of up to num_groups groups of the old table
+    // into the new one, releasing the old table once it is drained
+    inline void migrate_groups(u64 num_groups_to_migrate)
+    {
+        const u64 old_num_groups = m_old_capacity / sc_group_width;
+        for (u64 i = 0; i < num_groups_to_migrate && m_old_size != 0 &&
+                 m_migration_cursor < old_num_groups; ++i, ++m_migration_cursor) {
+            const u64 group_start = m_migration_cursor * sc_group_width;
+            auto full = Group(m_old_control + group_start).match_full();
+            while (full) {
+                const u64 index = group_start + full.lowest();
+                StorageType& element = m_old_slots[index];
+                place_element(m_hash_function(m_key_extractor(element)), std::move(element));
+                element.~StorageType();
+                // elements not yet moved may have probed past this
+                // slot, so it cannot be marked empty
+                m_old_control[index] = swiss_hash_table_detail_::sc_deleted_slot;
+                --m_old_size;
+                full.remove_lowest();
+            }
+        }
+        if (m_old_size == 0 || m_migration_cursor == old_num_groups) {
+            release_old_table();
+        }
+    }
+
+    inline void migration_step()
+    {
+        if (is_migrating()) {
+            migrate_groups(sc_groups_per_migration_step);
+        }
+    }
+
+    inline void finish_migration()
+    {
+        if (is_migrating()) {
+            migrate_groups(m_old_capacity / sc_group_width);
+        }
+    }
+
+    // makes the current table the old one, to be drained
+    // into a new table of new_capacity slots
+    inline void begin_migration(u64 new_capacity)
+    {
+        m_old_control = m_control;
+        m_old_slots = m_slots;
+        m_old_capacity = m_capacity;
+        m_old_size = m_size;
+        m_migration_cursor = 0;
+
+        allocate(new_capacity);
+        m_num_deleted = 0;
+        if (m_old_size == 0) {
+            release_old_table();
+        }
+    }
+
+    inline void rehash(u64 new_capacity)
+    {
+        finish_migration();
+
+        ControlByte* old_control = m_control;
+        StorageType* old_slots = m_slots;
+        const u64 old_capacity = m_capacity;
+
+        allocate(new_capacity);
+        m_num_deleted = 0;
+
+        for (u64 i = 0; i < old_capacity; ++i) {
+            if (old_control[i] < 0) {
+                continue;
+            }
+            place_element(m_hash_function(m_key_extractor(old_slots[i])),
+                          std::move(old_slots[i]));
+            old_slots[i].~StorageType();
+        }
+
+        if (old_capacity != 0) {
+            delete[] old_control;
+            ::operator delete(old_slots);
+        }
+    }
+
+    // makes room for one more element
+    inline void prepare_insert()
+    {
+        if (m_capacity == 0) {
+            rehash(sc_group_width);
+            return;
+        }
+        if ((m_size - m_old_size) + m_num_deleted + 1 <= max_load(m_capacity)) {
+            return;
+        }
+        // an incremental rehash is done by now unless erases left
+        // the new table full of tombstones, complete it first
+        finish_migration();
+
+        // purge the tombstones in place if they are
+        // what is taking up most of the space
+        const u64 new_capacity = (m_size + 1 <= max_load(m_capacity) / 2 ?
+                                  m_capacity : m_capacity * 2);
+        if (m_incremental_rehash) {
+            begin_migration(new_capacity);
+        } else {
+            rehash(new_capacity);
+        }
+    }
+
+    inline void copy_from(const SwissHashTable& other)
+    {
+        allocate(other.m_capacity);
+        m_size = other.m_size;
+        m_num_deleted = other.m_num_deleted;
+        m_incremental_rehash = other.m_incremental_rehash;
+        if (m_capacity == 0) {
+            return;
+        }
+        memcpy(m_control, other.m_control, m_capacity);
+        for (u64 i = next_full_slot(m_control, m_capacity, 0); i < m_capacity;
+             i = next_full_slot(m_control, m_capacity, i + 1)) {
+            new (m_slots + i) StorageType(other.m_slots[i]);
+        }
+        // the copy does not inherit the incremental rehash of other,
+        // the new table of other always has room for all its elements
+        for (u64 i = next_full_slot(other.m_old_control, other.m_old_capacity, 0);
+             i < other.m_old_capacity;
+             i = next_full_slot(other.m_old_control, other.m_old_capacity, i + 1)) {
+            const StorageType& element = other.m_old_slots[i];
+            place_element(m_hash_function(m_key_extractor(element)), element);
+        }
+    }
+
+    inline void steal_from(SwissHashTable& other)
+    {
+        m_control = other.m_control;
+        m_slots = other.m_slots;
+        m_capacity = other.m_capacity;
+        m_size = other.m_size;
+        m_num_deleted = other.m_num_deleted;
+        m_old_control = other.m_old_control;
+        m_old_slots = other.m_old_slots;
+        m_old_capacity = other.m_old_capacity;
+        m_old_size = other.m_old_size;
+        m_migration_cursor = other.m_migration_cursor;
+        m_incremental_rehash = other.m_incremental_rehash;
+
+        other.m_control = nullptr;
+        other.m_slots = nullptr;
+        other.m_capacity = 0;
+        other.m_size = 0;
+        other.m_num_deleted = 0;
+        other.m_old_control = nullptr;
+        other.m_old_slots = nullptr;
+        other.m_old_capacity = 0;
+        other.m_old_size = 0;
+        other.m_migration_cursor = 0;
+    }
+
+protected:
+    inline u64 hash_key(const KeyType& key) const
+    {
+        return m_hash_function(key);
+    }
+
+    // constructs a new element from args if no element with
+    // the same key exists, returns the index of the element
+    // with the key and whether it was inserted
+    template <typename... ArgTypes>
+    inline std::pair<u64, bool> emplace_unique(const KeyType& key, ArgTypes&&... args)
+    {
+        const u64 hash_value = m_hash_function(key);
+        auto index = find_index(key, hash_value);
+        if (index != end_index()) {
+            return std::make_pair(index, false);
+        }
+
+        // key and args may refer to an element of this table, which
+        // a rehash or a migration step would move, so the new element
+        // is built before either can happen. Its index remains valid
+        // after the migration step, it is in the new table
+        StorageType new_element(std::forward<ArgTypes>(args)...);
+        prepare_insert();
+        index = place_element(hash_value, std::move(new_element));
+        ++m_size;
+        migration_step();
+        return std::make_pair(index, true);
+    }
+
+    inline T& slot_at(u64 index)
+    {
+        return slot_ref(index);
+    }
+
+    inline Iterator make_iterator(u64 index)
+    {
+        return Iterator(this, index);
+    }
+
+    // A probe only moves past a group when it has no empty
+    // slots, so if this group has one, nothing can have been
+    // placed beyond it on account of this slot. Erasing from the
+    // old table never releases it, so that erasing through an
+    // iterator does not invalidate the other iterators.
+    inline void erase_at(u64 index)
+    {
+        slot_ref(index).~StorageType();
+        --m_size;
+
+        if (index >= m_capacity) {
+            index -= m_capacity;
+            --m_old_size;
+            const u64 group_start = index & ~(sc_group_width - 1);
+            m_old_control[index] = (Group(m_old_control + group_start).match_empty() ?
+                                    swiss_hash_table_detail_::sc_empty_slot :
+                                    swiss_hash_table_detail_::sc_deleted_slot);
+            return;
+        }
+
+        const u64 group_start = index & ~(sc_group_width - 1);
+        if (Group(m_control + group_start).match_empty()) {
+            set_control(index, swiss_hash_table_detail_::sc_empty_slot);
+        } else {
+            set_control(index, swiss_hash_table_detail_::sc_deleted_slot);
+            ++m_num_deleted;
+        }
+    }
+
+public:
+    inline SwissHashTable()
+        : m_control(nullptr), m_slots(nullptr), m_capacity(0),
+          m_size(0), m_num_deleted(0),
+          m_old_control(nullptr), m_old_slots(nullptr), m_old_capacity(0),
+          m_old_size(0), m_migration_cursor(0), m_incremental_rehash(false)
+    {
+        // Nothing here
+    }
+
+    inline SwissHashTable(const SwissHashTable& other)
+        : m_control(nullptr), m_slots(nullptr), m_capacity(0),
+          m_size(0), m_num_deleted(0),
+          m_old_control(nullptr), m_old_slots(nullptr), m_old_capacity(0),
+          m_old_size(0), m_migration_cursor(0), m_incremental_rehash(false),
+          m_key_extractor(other.m_key_extractor),
+          m_hash_function(other.m_hash_function),
+          m_equals_function(other.m_equals_function)
+    {
+        copy_from(other);
+    }
+
+    inline SwissHashTable(SwissHashTable&& other)
+        : m_control(nullptr), m_slots(nullptr), m_capacity(0),
+          m_size(0), m_num_deleted(0),
+          m_old_control(nullptr), m_old_slots(nullptr), m_old_capacity(0),
+          m_old_size(0), m_migration_cursor(0), m_incremental_rehash(false),
+          m_key_extractor(std::move(other.m_key_extractor)),
+          m_hash_function(std::move(other.m_hash_function)),
+          m_equals_function(std::move(other.m_equals_function))
+    {
+        steal_from(other);
+    }
+
+    inline ~SwissHashTable()
+    {
+        deallocate();
+    }
+
+    inline SwissHashTable& operator = (const SwissHashTable& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        deallocate();
+        copy_from(other);
+        return *this;
+    }
+
+    inline SwissHashTable& operator = (SwissHashTable&& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        deallocate();
+        steal_from(other);
+        return *this;
+    }
+
+    // No values are reserved by this table, these are only here to
+    // keep the interface of the other unordered containers and do
+    // nothing at all. In particular, the values passed to them remain
+    // ordinary keys, which can be inserted, found and erased
+    inline void set_deleted_value(const KeyType&)
+    {
+        // Nothing here
+    }
+
+    inline void set_nonused_value(const KeyType&)
+    {
+        // Nothing here
+    }
+
+    // trades a little throughput on every operation for not having
+    // to stop and rehash every element when the table grows
+    inline void set_incremental_rehash(bool incremental_rehash)
+    {
+        if (!incremental_rehash) {
+            finish_migration();
+        }
+        m_incremental_rehash = incremental_rehash;
+    }
+
+    inline bool is_rehashing() const
+    {
+        return is_migrating();
+    }
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    inline u64 capacity() const
+    {
+        return m_capacity;
+    }
+
+    inline void clear()
+    {
+        if (m_capacity == 0) {
+            return;
+        }
+        destroy_elements();
+        release_old_table();
+        memset(m_control, swiss_hash_table_detail_::sc_empty_slot, m_capacity);
+        m_size = 0;
+        m_num_deleted = 0;
+    }
+
+    inline void reserve(u64 num_elements)
+    {
+        finish_migration();
+        u64 new_capacity = (m_capacity == 0 ? sc_group_width : m_capacity);
+        while (max_load(new_capacity) < num_elements) {
+            new_capacity *= 2;
+        }
+        if (new_capacity != m_capacity) {
+            rehash(new_capacity);
+        }
+    }
+
+    inline void shrink_to_fit()
+    {
+        if (m_size == 0) {
+            deallocate();
+            m_num_deleted = 0;
+            return;
+        }
+        finish_migration();
+        u64 new_capacity = sc_group_width;
+        while (max_load(new_capacity) < m_size) {
+            new_capacity *= 2;
+        }
+        if (new_capacity != m_capacity || m_num_deleted != 0) {
+            rehash(new_capacity);
+        }
+    }
+
+    inline Iterator begin()
+    {
+        return Iterator(this, next_full_slot(0));
+    }
+
+    inline Iterator end()
+    {
+        return Iterator(this, end_index());
+    }
+
+    inline ConstIterator begin() const
+    {
+        return ConstIterator(this, next_full_slot(0));
+    }
+
+    inline ConstIterator end() const
+    {
+        return ConstIterator(this, end_index());
+    }
+
+    inline ConstIterator cbegin() const
+    {
+        return begin();
+    }
+
+    inline ConstIterator cend() const
+    {
+        return end();
+    }
+
+    // lookups do not migrate any elements, so that they do
+    // not invalidate references to the elements of the table
+    inline Iterator find(const KeyType& key)
+    {
+        return Iterator(this, find_index(key, m_hash_function(key)));
+    }
+
+    inline ConstIterator find(const KeyType& key) const
+    {
+        return ConstIterator(this, find_index(key, m_hash_function(key)));
+    }
+
+    inline u64 count(const KeyType& key) const
+    {
+        return (find_index(key, m_hash_function(key)) != end_index() ? 1 : 0);
+    }
+
+    inline u64 erase(const KeyType& key)
+    {
+        auto index = find_index(key, m_hash_function(key));
+        if (index == end_index()) {
+            return 0;
+        }
+        // key may refer to the element being erased, it is
+        // not used once the element is gone
+        erase_at(index);
+        migration_step();
+        return 1;
+    }
+
+    inline Iterator erase(const ConstIterator& position)
+    {
+        const u64 index = position.m_index;
+        erase_at(index);
+        return Iterator(this, next_full_slot(index + 1));
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_SWISS_HASH_TABLE_HPP_ */
+
+//
+// SwissHashTable.hpp ends here
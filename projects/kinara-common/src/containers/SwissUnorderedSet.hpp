@@ -0,0 +1,168 @@
+// SwissUnorderedSet.hpp ---
+//
+// Filename: SwissUnorderedSet.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 15:52:40 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// Unordered sets on top of SwissHashTable. These have the interface
+// of UnifiedUnorderedSet, but do not need deleted or nonused values.
+
+#if !defined KINARA_COMMON_CONTAINERS_SWISS_UNORDERED_SET_HPP_
+#define KINARA_COMMON_CONTAINERS_SWISS_UNORDERED_SET_HPP_
+
+#include <utility>
+#include <functional>
+#include <initializer_list>
+
+#include "SwissHashTable.hpp"
+
+namespace kinara {
+namespace containers {
+namespace swiss_unordered_set_detail_ {
+
+template <typename T>
+class KeyExtractor
+{
+public:
+    inline const T& operator () (const T& element) const
+    {
+        return element;
+    }
+};
+
+} /* end namespace swiss_unordered_set_detail_ */
+
+template <typename T, typename HashFunction = std::hash<T>,
+          typename EqualsFunction = std::equal_to<T>>
+class SwissUnorderedSet
+    : public SwissHashTable<const T, T, swiss_unordered_set_detail_::KeyExtractor<T>,
+                            HashFunction, EqualsFunction>
+{
+private:
+    typedef SwissHashTable<const T, T, swiss_unordered_set_detail_::KeyExtractor<T>,
+                           HashFunction, EqualsFunction> BaseType;
+
+public:
+    typedef typename BaseType::Iterator Iterator;
+    typedef typename BaseType::ConstIterator ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+    inline SwissUnorderedSet()
+        : BaseType()
+    {
+        // Nothing here
+    }
+
+    // the table reserves no values, these are ignored
+    inline SwissUnorderedSet(const T&, const T&)
+        : BaseType()
+    {
+        // Nothing here
+    }
+
+    inline SwissUnorderedSet(std::initializer_list<T> init_list)
+        : BaseType()
+    {
+        insert(init_list);
+    }
+
+    inline SwissUnorderedSet(std::initializer_list<T> init_list,
+                             const T&, const T&)
+        : BaseType()
+    {
+        insert(init_list);
+    }
+
+    template <typename InputIterator>
+    inline SwissUnorderedSet(const InputIterator& first, const InputIterator& last)
+        : BaseType()
+    {
+        insert(first, last);
+    }
+
+    inline SwissUnorderedSet(const SwissUnorderedSet& other) = default;
+    inline SwissUnorderedSet(SwissUnorderedSet&& other) = default;
+
+    inline SwissUnorderedSet& operator = (const SwissUnorderedSet& other) = default;
+    inline SwissUnorderedSet& operator = (SwissUnorderedSet&& other) = default;
+
+    inline SwissUnorderedSet& operator = (std::initializer_list<T> init_list)
+    {
+        this->clear();
+        insert(init_list);
+        return *this;
+    }
+
+    inline std::pair<Iterator, bool> insert(const T& element)
+    {
+        auto result = this->emplace_unique(element, element);
+        return std::make_pair(this->make_iterator(result.first), result.second);
+    }
+
+    inline std::pair<Iterator, bool> insert(T&& element)
+    {
+        auto result = this->emplace_unique(element, std::move(element));
+        return std::make_pair(this->make_iterator(result.first), result.second);
+    }
+
+    template <typename InputIterator>
+    inline void insert(const InputIterator& first, const InputIterator& last)
+    {
+        for (auto it = first; it != last; ++it) {
+            insert(*it);
+        }
+    }
+
+    inline void insert(std::initializer_list<T> init_list)
+    {
+        insert(init_list.begin(), init_list.end());
+    }
+
+    template <typename... ArgTypes>
+    inline std::pair<Iterator, bool> emplace(ArgTypes&&... args)
+    {
+        return insert(T(std::forward<ArgTypes>(args)...));
+    }
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_SWISS_UNORDERED_SET_HPP_ */
+
+//
+// SwissUnorderedSet.hpp ends here
@@ -0,0 +1,206 @@
+// UnrolledDList.hpp ---
+//
+// Filename: UnrolledDList.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 14:48:52 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// A list with the interface of DList that stores up to K elements
+// per node, for lists that are mostly traversed, such as event and
+// work lists. See UnrolledListBase.hpp for the layout, and for the
+// operations that invalidate iterators.
+
+#if !defined KINARA_COMMON_CONTAINERS_UNROLLED_DLIST_HPP_
+#define KINARA_COMMON_CONTAINERS_UNROLLED_DLIST_HPP_
+
+#include "UnrolledListBase.hpp"
+
+namespace kinara {
+namespace containers {
+
+template <typename T, u32 K = unrolled_list_detail_::default_node_capacity(sizeof(T))>
+class UnrolledDList : public unrolled_list_detail_::UnrolledListBase<T, K>
+{
+private:
+    typedef unrolled_list_detail_::UnrolledListBase<T, K> BaseType;
+
+public:
+    typedef typename BaseType::ValueType ValueType;
+    typedef typename BaseType::Iterator Iterator;
+    typedef typename BaseType::ConstIterator ConstIterator;
+    typedef std::reverse_iterator<Iterator> ReverseIterator;
+    typedef std::reverse_iterator<ConstIterator> ConstReverseIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+    typedef ReverseIterator reverse_iterator;
+    typedef ConstReverseIterator const_reverse_iterator;
+
+    inline UnrolledDList()
+        : BaseType()
+    {
+        // Nothing here
+    }
+
+    inline explicit UnrolledDList(u64 size)
+        : BaseType(size)
+    {
+        // Nothing here
+    }
+
+    inline UnrolledDList(u64 size, const T& value)
+        : BaseType(size, value)
+    {
+        // Nothing here
+    }
+
+    template <typename InputIterator,
+              typename = typename std::enable_if<
+                  !std::is_integral<InputIterator>::value>::type>
+    inline UnrolledDList(InputIterator first, InputIterator last)
+        : BaseType(first, last)
+    {
+        // Nothing here
+    }
+
+    inline UnrolledDList(std::initializer_list<T> init_list)
+        : BaseType(init_list)
+    {
+        // Nothing here
+    }
+
+    inline UnrolledDList(const UnrolledDList& other) = default;
+    inline UnrolledDList(UnrolledDList&& other) = default;
+
+    inline ~UnrolledDList()
+    {
+        // Nothing here
+    }
+
+    inline UnrolledDList& operator = (const UnrolledDList& other) = default;
+    inline UnrolledDList& operator = (UnrolledDList&& other) = default;
+
+    inline UnrolledDList& operator = (std::initializer_list<T> init_list)
+    {
+        BaseType::operator = (init_list);
+        return *this;
+    }
+
+    inline ReverseIterator rbegin()
+    {
+        return ReverseIterator(BaseType::end());
+    }
+
+    inline ReverseIterator rend()
+    {
+        return ReverseIterator(BaseType::begin());
+    }
+
+    inline ConstReverseIterator rbegin() const
+    {
+        return ConstReverseIterator(BaseType::end());
+    }
+
+    inline ConstReverseIterator rend() const
+    {
+        return ConstReverseIterator(BaseType::begin());
+    }
+
+    inline ConstReverseIterator crbegin() const
+    {
+        return rbegin();
+    }
+
+    inline ConstReverseIterator crend() const
+    {
+        return rend();
+    }
+
+    inline void splice(ConstIterator position, UnrolledDList& other)
+    {
+        BaseType::splice_range(position, other, other.begin(), other.end());
+    }
+
+    inline void splice(ConstIterator position, UnrolledDList& other, ConstIterator element)
+    {
+        BaseType::move_element(position, other, element);
+    }
+
+    inline void splice(ConstIterator position, UnrolledDList& other,
+                       ConstIterator first, ConstIterator last)
+    {
+        BaseType::splice_range(position, other, first, last);
+    }
+
+    inline bool operator == (const UnrolledDList& other) const
+    {
+        return (BaseType::compare(other) == 0);
+    }
+
+    inline bool operator != (const UnrolledDList& other) const
+    {
+        return (BaseType::compare(other) != 0);
+    }
+
+    inline bool operator < (const UnrolledDList& other) const
+    {
+        return (BaseType::compare(other) < 0);
+    }
+
+    inline bool operator <= (const UnrolledDList& other) const
+    {
+        return (BaseType::compare(other) <= 0);
+    }
+
+    inline bool operator > (const UnrolledDList& other) const
+    {
+        return (BaseType::compare(other) > 0);
+    }
+
+    inline bool operator >= (const UnrolledDList& other) const
+    {
+        return (BaseType::compare(other) >= 0);
+    }
+};
+
+typedef UnrolledDList<u32> u32UnrolledDList;
+typedef UnrolledDList<u64> u64UnrolledDList;
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_UNROLLED_DLIST_HPP_ */
+
+//
+// UnrolledDList.hpp ends here
@@ -0,0 +1,1073 @@
+// UnrolledListBase.hpp ---
+//
+// Filename: UnrolledListBase.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 14:02:37 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// The node layout, iterators and operations shared by UnrolledSList
+// and UnrolledDList. Each node holds up to K elements in an array,
+// so a traversal follows one link per K elements rather than one per
+// element, and walks through memory in order within a node. The
+// links cost 1/K of what they cost in SList or DList, per element.
+//
+// The elements of a node occupy the slots m_begin to
+// m_begin + m_count - 1 of its array, so that pushing or popping at
+// either end of a node does not move the others. Nodes are never
+// empty: a full node is split in two when an element is inserted
+// into its middle, and a node that drops below a quarter of its
+// capacity absorbs its successor if the two fit in one node.
+//
+// Both lists use doubly linked nodes. With K elements per node the
+// back link costs 8 / K bytes per element, and it lets the singly
+// linked variant keep constant time push_back(), pop_back() and
+// insertion before a position.
+//
+// Unlike in SList and DList, insertions and erasures move elements
+// within a node, so they invalidate the iterators into the nodes
+// they touch, as with Deque. Splicing relinks whole nodes, but
+// splits the nodes at the ends of the spliced range, and so also
+// invalidates the iterators into those.
+
+#if !defined KINARA_COMMON_CONTAINERS_UNROLLED_LIST_BASE_HPP_
+#define KINARA_COMMON_CONTAINERS_UNROLLED_LIST_BASE_HPP_
+
+#include <new>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+#include "../basetypes/KinaraTypes.hpp"
+
+namespace kinara {
+namespace containers {
+namespace unrolled_list_detail_ {
+
+// about four cache lines worth of elements per node
+static constexpr u32 default_node_capacity(u64 element_size)
+{
+    return ((256 / element_size) < 4 ? 4 : (u32)(256 / element_size));
+}
+
+struct NodeBase
+{
+    NodeBase* m_next;
+    NodeBase* m_prev;
+    u32 m_begin;
+    u32 m_count;
+};
+
+template <typename T, u32 K>
+struct Node : public NodeBase
+{
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type m_slots[K];
+
+    inline T* elements()
+    {
+        return reinterpret_cast<T*>(m_slots);
+    }
+};
+
+template <typename T, u32 K>
+class UnrolledListBase;
+
+// An iterator is a node and a slot in it. The end iterator is the
+// sentinel node at slot 0, and the before-begin iterator of the
+// singly linked variant is the sentinel node at slot 1.
+template <typename T, u32 K, bool ISCONST>
+class IteratorBase
+{
+    friend class UnrolledListBase<T, K>;
+    template <typename, u32, bool> friend class IteratorBase;
+
+public:
+    typedef T ValueType;
+    typedef typename std::conditional<ISCONST, const T, T>::type QualifiedValueType;
+
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef i64 difference_type;
+    typedef QualifiedValueType* pointer;
+    typedef QualifiedValueType& reference;
+
+private:
+    NodeBase* m_node;
+    u32 m_slot;
+
+    inline IteratorBase(NodeBase* node, u32 slot)
+        : m_node(node), m_slot(slot)
+    {
+        // Nothing here
+    }
+
+public:
+    inline IteratorBase()
+        : m_node(nullptr), m_slot(0)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase(const IteratorBase& other) = default;
+
+    // conversion from a mutable iterator to a const one
+    template <bool OTHERCONST,
+              typename = typename std::enable_if<ISCONST && !OTHERCONST>::type>
+    inline IteratorBase(const IteratorBase<T, K, OTHERCONST>& other)
+        : m_node(other.m_node), m_slot(other.m_slot)
+    {
+        // Nothing here
+    }
+
+    inline IteratorBase& operator = (const IteratorBase& other) = default;
+
+    inline reference operator * () const
+    {
+        return static_cast<Node<T, K>*>(m_node)->elements()[m_slot];
+    }
+
+    inline pointer operator -> () const
+    {
+        return &(operator*());
+    }
+
+    inline IteratorBase& operator ++ ()
+    {
+        // the sentinel is the only node with no elements
+        if (m_node->m_count == 0 ||
+            ++m_slot == m_node->m_begin + m_node->m_count) {
+            m_node = m_node->m_next;
+            m_slot = m_node->m_begin;
+        }
+        return *this;
+    }
+
+    inline IteratorBase operator ++ (int)
+    {
+        auto retval = *this;
+        ++(*this);
+        return retval;
+    }
+
+    inline IteratorBase& operator -- ()
+    {
+        if (m_node->m_count == 0 || m_slot == m_node->m_begin) {
+            m_node = m_node->m_prev;
+            m_slot = m_node->m_begin + m_node->m_count;
+        }
+        --m_slot;
+        return *this;
+    }
+
+    inline IteratorBase operator -- (int)
+    {
+        auto retval = *this;
+        --(*this);
+        return retval;
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator == (const IteratorBase<T, K, OTHERCONST>& other) const
+    {
+        return (m_node == other.m_node && m_slot == other.m_slot);
+    }
+
+    template <bool OTHERCONST>
+    inline bool operator != (const IteratorBase<T, K, OTHERCONST>& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+template <typename T, u32 K>
+class UnrolledListBase
+{
+    static_assert(K >= 4, "Unrolled lists need room for at least four elements per node");
+
+public:
+    typedef T ValueType;
+    typedef IteratorBase<T, K, false> Iterator;
+    typedef IteratorBase<T, K, true> ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+protected:
+    typedef Node<T, K> NodeType;
+
+    // sort() merges up to this many sorted runs in place rather
+    // than sorting the whole list
+    static const u64 sc_max_natural_runs = 16;
+    static const bool sc_sort_by_value =
+        std::is_trivially_copyable<T>::value && sizeof(T) <= 16;
+
+    NodeBase m_sentinel;
+    u64 m_size;
+
+    static inline T* elements_of(NodeBase* node)
+    {
+        return static_cast<NodeType*>(node)->elements();
+    }
+
+    static inline Iterator successor(ConstIterator position)
+    {
+        ++position;
+        return Iterator(position.m_node, position.m_slot);
+    }
+
+    // the element at the given offset into a node, or the first
+    // element after the node if the offset is past its end
+    static inline Iterator iterator_at(NodeBase* node, u32 index)
+    {
+        if (index < node->m_count) {
+            return Iterator(node, node->m_begin + index);
+        }
+        return Iterator(node->m_next, node->m_next->m_begin);
+    }
+
+    inline Iterator before_first() const
+    {
+        return Iterator(const_cast<NodeBase*>(&m_sentinel), 1);
+    }
+
+    inline void reset()
+    {
+        m_sentinel.m_next = &m_sentinel;
+        m_sentinel.m_prev = &m_sentinel;
+        m_sentinel.m_begin = 0;
+        m_sentinel.m_count = 0;
+        m_size = 0;
+    }
+
+    // takes over the nodes of other, which must be empty itself
+    inline void steal(UnrolledListBase& other)
+    {
+        if (other.m_size == 0) {
+            return;
+        }
+        m_sentinel.m_next = other.m_sentinel.m_next;
+        m_sentinel.m_prev = other.m_sentinel.m_prev;
+        m_sentinel.m_next->m_prev = &m_sentinel;
+        m_sentinel.m_prev->m_next = &m_sentinel;
+        m_size = other.m_size;
+        other.reset();
+    }
+
+    // links a new, empty node before successor, with its elements
+    // to start at the given slot
+    inline NodeBase* allocate_node(NodeBase* successor, u32 begin)
+    {
+        NodeBase* node = new NodeType;
+        node->m_begin = begin;
+        node->m_count = 0;
+        node->m_next = successor;
+        node->m_prev = successor->m_prev;
+        successor->m_prev->m_next = node;
+        successor->m_prev = node;
+        return node;
+    }
+
+    // destroys the elements of the node, unlinks it and frees it,
+    // without adjusting m_size
+    inline void free_node(NodeBase* node)
+    {
+        T* elements = elements_of(node);
+        for (u32 i = node->m_begin, last = node->m_begin + node->m_count; i < last; ++i) {
+            elements[i].~T();
+        }
+        node->m_prev->m_next = node->m_next;
+        node->m_next->m_prev = node->m_prev;
+        delete static_cast<NodeType*>(node);
+    }
+
+    // moves the elements from the given offset onwards into a new
+    // node after this one, and returns the new node
+    inline NodeBase* split_node(NodeBase* node, u32 index)
+    {
+        NodeBase* upper = allocate_node(node->m_next, 0);
+        T* from = elements_of(node) + node->m_begin + index;
+        T* to = elements_of(upper);
+        const u32 num_moved = node->m_count - index;
+        for (u32 i = 0; i < num_moved; ++i) {
+            new (to + i) T(std::move(from[i]));
+            from[i].~T();
+        }
+        upper->m_count = num_moved;
+        node->m_count = index;
+        return upper;
+    }
+
+    // moves the elements of the node down to start at slot 0
+    inline void compact_node(NodeBase* node)
+    {
+        T* elements = elements_of(node);
+        for (u32 i = 0; i < node->m_count; ++i) {
+            new (elements + i) T(std::move(elements[node->m_begin + i]));
+            elements[node->m_begin + i].~T();
+        }
+        node->m_begin = 0;
+    }
+
+    // moves the elements of the successor of the node into it, if
+    // either of the two is less than a quarter full and they fit in
+    // a single node
+    inline bool coalesce(NodeBase* node)
+    {
+        NodeBase* next = node->m_next;
+        if (node == &m_sentinel || next == &m_sentinel ||
+            node->m_count + next->m_count > K ||
+            (node->m_count >= K / 4 && next->m_count >= K / 4)) {
+            return false;
+        }
+        if (node->m_begin + node->m_count + next->m_count > K) {
+            compact_node(node);
+        }
+
+        T* to = elements_of(node) + node->m_begin + node->m_count;
+        T* from = elements_of(next) + next->m_begin;
+        for (u32 i = 0; i < next->m_count; ++i) {
+            new (to + i) T(std::move(from[i]));
+            from[i].~T();
+        }
+        node->m_count += next->m_count;
+        next->m_count = 0;
+        free_node(next);
+        return true;
+    }
+
+    // returns the first node of the part of the list that starts at
+    // the given position, splitting its node if it is in the middle
+    inline NodeBase* cut_before(NodeBase* node, u32 slot)
+    {
+        if (node == &m_sentinel || slot == node->m_begin) {
+            return node;
+        }
+        return split_node(node, slot - node->m_begin);
+    }
+
+    // adjusts a position after the node it was in has been cut at
+    // the given slot
+    static inline void adjust_for_cut(NodeBase*& node, u32& slot,
+                                      NodeBase* cut_node, u32 cut_slot, NodeBase* upper)
+    {
+        if (upper != cut_node && node == cut_node && slot >= cut_slot) {
+            node = upper;
+            slot -= cut_slot;
+        }
+    }
+
+    template <typename... ArgTypes>
+    inline Iterator emplace_at(NodeBase* node, u32 slot, ArgTypes&&... args)
+    {
+        // a position at the start of a node is also the end of
+        // its predecessor, which is the cheaper place to add to
+        u32 index = slot - node->m_begin;
+        NodeBase* prev = node->m_prev;
+        if (index == 0 && prev != &m_sentinel && prev->m_begin + prev->m_count < K) {
+            node = prev;
+            index = prev->m_count;
+        } else if (node == &m_sentinel) {
+            node = allocate_node(node, 0);
+        } else if (index == 0 && node->m_count == K) {
+            node = allocate_node(node, K - 1);
+        }
+
+        T* elements = elements_of(node);
+        if (index == 0 && node->m_begin > 0) {
+            new (elements + node->m_begin - 1) T(std::forward<ArgTypes>(args)...);
+            --node->m_begin;
+            ++node->m_count;
+            ++m_size;
+            return Iterator(node, node->m_begin);
+        }
+        if (index == node->m_count && node->m_begin + node->m_count < K) {
+            new (elements + node->m_begin + index) T(std::forward<ArgTypes>(args)...);
+            ++node->m_count;
+            ++m_size;
+            return Iterator(node, node->m_begin + index);
+        }
+
+        // the value is built before anything moves, since the
+        // arguments may refer to an element of this node
+        T value(std::forward<ArgTypes>(args)...);
+        if (node->m_count == K) {
+            NodeBase* upper = split_node(node, K / 2);
+            if (index > K / 2) {
+                node = upper;
+                index -= K / 2;
+            }
+            elements = elements_of(node);
+        }
+
+        const u32 begin = node->m_begin;
+        const u32 end = begin + node->m_count;
+        if (index == node->m_count && end < K) {
+            new (elements + end) T(std::move(value));
+        } else if (end < K && (begin == 0 || index >= node->m_count / 2)) {
+            new (elements + end) T(std::move(elements[end - 1]));
+            for (u32 i = end - 1; i > begin + index; --i) {
+                elements[i] = std::move(elements[i - 1]);
+            }
+            elements[begin + index] = std::move(value);
+        } else {
+            new (elements + begin - 1) T(std::move(elements[begin]));
+            for (u32 i = begin; i + 1 < begin + index; ++i) {
+                elements[i] = std::move(elements[i + 1]);
+            }
+            elements[begin + index - 1] = std::move(value);
+            --node->m_begin;
+        }
+        ++node->m_count;
+        ++m_size;
+        return Iterator(node, node->m_begin + index);
+    }
+
+    inline Iterator erase_at(NodeBase* node, u32 slot)
+    {
+        T* elements = elements_of(node);
+        const u32 index = slot - node->m_begin;
+        const u32 end = node->m_begin + node->m_count;
+
+        // close the gap from the shorter side
+        if (index < node->m_count / 2) {
+            std::move_backward(elements + node->m_begin, elements + slot, elements + slot + 1);
+            elements[node->m_begin].~T();
+            ++node->m_begin;
+        } else {
+            std::move(elements + slot + 1, elements + end, elements + slot);
+            elements[end - 1].~T();
+        }
+        --node->m_count;
+        --m_size;
+
+        if (node->m_count == 0) {
+            NodeBase* next = node->m_next;
+            free_node(node);
+            return Iterator(next, next->m_begin);
+        }
+        if (node->m_count < K / 4) {
+            coalesce(node);
+        }
+        return iterator_at(node, index);
+    }
+
+    // destroys everything from the position to the end
+    inline void truncate(ConstIterator position)
+    {
+        NodeBase* node = position.m_node;
+        if (node == &m_sentinel) {
+            return;
+        }
+        while (node->m_next != &m_sentinel) {
+            m_size -= node->m_next->m_count;
+            free_node(node->m_next);
+        }
+
+        const u32 num_kept = position.m_slot - node->m_begin;
+        T* elements = elements_of(node);
+        for (u32 i = num_kept; i < node->m_count; ++i) {
+            elements[node->m_begin + i].~T();
+        }
+        m_size -= (node->m_count - num_kept);
+        node->m_count = num_kept;
+        if (num_kept == 0) {
+            free_node(node);
+        }
+    }
+
+    inline void move_element(ConstIterator position, UnrolledListBase& other,
+                             ConstIterator element)
+    {
+        if (&other == this) {
+            splice_range(position, other, element, successor(element));
+            return;
+        }
+        emplace_at(position.m_node, position.m_slot,
+                   std::move(elements_of(element.m_node)[element.m_slot]));
+        other.erase_at(element.m_node, element.m_slot);
+    }
+
+    // moves [first, last) of other to just before the position, and
+    // returns an iterator to the first element moved
+    inline Iterator splice_range(ConstIterator position, UnrolledListBase& other,
+                                 ConstIterator first, ConstIterator last)
+    {
+        if (first == last) {
+            return Iterator(position.m_node, position.m_slot);
+        }
+
+        const bool whole_list = (&other != this && first == other.begin() && last == other.end());
+        NodeBase* first_node = first.m_node;
+        u32 first_slot = first.m_slot;
+        NodeBase* last_node = last.m_node;
+        u32 last_slot = last.m_slot;
+
+        // cut at each of the three positions, adjusting the ones
+        // not cut yet, so that the range is a run of whole nodes
+        NodeBase* position_cut = cut_before(position.m_node, position.m_slot);
+        adjust_for_cut(first_node, first_slot, position.m_node, position.m_slot, position_cut);
+        adjust_for_cut(last_node, last_slot, position.m_node, position.m_slot, position_cut);
+        NodeBase* last_cut = other.cut_before(last_node, last_slot);
+        adjust_for_cut(first_node, first_slot, last_node, last_slot, last_cut);
+        NodeBase* first_cut = other.cut_before(first_node, first_slot);
+
+        if (position_cut == first_cut || position_cut == last_cut) {
+            return Iterator(first_cut, first_cut->m_begin);
+        }
+
+        if (&other != this) {
+            u64 num_moved = other.m_size;
+            if (!whole_list) {
+                num_moved = 0;
+                for (auto node = first_cut; node != last_cut; node = node->m_next) {
+                    num_moved += node->m_count;
+                }
+            }
+            m_size += num_moved;
+            other.m_size -= num_moved;
+        }
+
+        NodeBase* range_tail = last_cut->m_prev;
+        NodeBase* range_prev = first_cut->m_prev;
+        range_prev->m_next = last_cut;
+        last_cut->m_prev = range_prev;
+
+        NodeBase* position_prev = position_cut->m_prev;
+        position_prev->m_next = first_cut;
+        first_cut->m_prev = position_prev;
+        range_tail->m_next = position_cut;
+        position_cut->m_prev = range_tail;
+
+        // tidy up the nodes that the cuts may have left sparse
+        if (&other != this) {
+            other.coalesce(range_prev);
+        }
+        coalesce(range_tail);
+        const u32 num_before = position_prev->m_count;
+        if (coalesce(position_prev)) {
+            return iterator_at(position_prev, num_before);
+        }
+        return Iterator(first_cut, first_cut->m_begin);
+    }
+
+    // merges adjacent pairs of sorted runs until one is left; the
+    // merges only move elements between slots, so the iterators to
+    // the starts of the runs stay valid
+    template <typename Comparator>
+    inline void merge_runs(std::vector<Iterator>& run_starts, const Comparator& comparator)
+    {
+        while (run_starts.size() > 1) {
+            u64 num_merged = 0;
+            for (u64 i = 0; i < run_starts.size(); i += 2) {
+                if (i + 1 < run_starts.size()) {
+                    auto run_end = (i + 2 < run_starts.size() ? run_starts[i + 2] : end());
+                    std::inplace_merge(run_starts[i], run_starts[i + 1], run_end, comparator);
+                }
+                run_starts[num_merged++] = run_starts[i];
+            }
+            run_starts.resize(num_merged);
+        }
+    }
+
+    // size first, then lexicographically
+    inline i32 compare(const UnrolledListBase& other) const
+    {
+        if (m_size != other.m_size) {
+            return (m_size < other.m_size ? -1 : 1);
+        }
+        for (auto it1 = begin(), it2 = other.begin(), last = end(); it1 != last; ++it1, ++it2) {
+            if (*it1 < *it2) {
+                return -1;
+            }
+            if (*it2 < *it1) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+public:
+    inline UnrolledListBase()
+    {
+        reset();
+    }
+
+    inline explicit UnrolledListBase(u64 size)
+        : UnrolledListBase()
+    {
+        resize(size);
+    }
+
+    inline UnrolledListBase(u64 size, const T& value)
+        : UnrolledListBase()
+    {
+        resize(size, value);
+    }
+
+    template <typename InputIterator,
+              typename = typename std::enable_if<
+                  !std::is_integral<InputIterator>::value>::type>
+    inline UnrolledListBase(InputIterator first, InputIterator last)
+        : UnrolledListBase()
+    {
+        for (auto it = first; it != last; ++it) {
+            emplace_back(*it);
+        }
+    }
+
+    inline UnrolledListBase(std::initializer_list<T> init_list)
+        : UnrolledListBase(init_list.begin(), init_list.end())
+    {
+        // Nothing here
+    }
+
+    inline UnrolledListBase(const UnrolledListBase& other)
+        : UnrolledListBase(other.begin(), other.end())
+    {
+        // Nothing here
+    }
+
+    inline UnrolledListBase(UnrolledListBase&& other)
+        : UnrolledListBase()
+    {
+        steal(other);
+    }
+
+    inline ~UnrolledListBase()
+    {
+        clear();
+    }
+
+    inline UnrolledListBase& operator = (const UnrolledListBase& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        clear();
+        for (auto const& element : other) {
+            emplace_back(element);
+        }
+        return *this;
+    }
+
+    inline UnrolledListBase& operator = (UnrolledListBase&& other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        clear();
+        steal(other);
+        return *this;
+    }
+
+    inline UnrolledListBase& operator = (std::initializer_list<T> init_list)
+    {
+        clear();
+        for (auto const& element : init_list) {
+            emplace_back(element);
+        }
+        return *this;
+    }
+
+    inline u64 size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return (m_size == 0);
+    }
+
+    inline Iterator begin()
+    {
+        return Iterator(m_sentinel.m_next, m_sentinel.m_next->m_begin);
+    }
+
+    inline Iterator end()
+    {
+        return Iterator(&m_sentinel, 0);
+    }
+
+    inline ConstIterator begin() const
+    {
+        return ConstIterator(m_sentinel.m_next, m_sentinel.m_next->m_begin);
+    }
+
+    inline ConstIterator end() const
+    {
+        return ConstIterator(const_cast<NodeBase*>(&m_sentinel), 0);
+    }
+
+    inline ConstIterator cbegin() const
+    {
+        return begin();
+    }
+
+    inline ConstIterator cend() const
+    {
+        return end();
+    }
+
+    inline T& front()
+    {
+        return *begin();
+    }
+
+    inline const T& front() const
+    {
+        return *begin();
+    }
+
+    inline T& back()
+    {
+        NodeBase* last = m_sentinel.m_prev;
+        return elements_of(last)[last->m_begin + last->m_count - 1];
+    }
+
+    inline const T& back() const
+    {
+        NodeBase* last = m_sentinel.m_prev;
+        return elements_of(last)[last->m_begin + last->m_count - 1];
+    }
+
+    inline void push_front(const T& value)
+    {
+        emplace_front(value);
+    }
+
+    inline void push_front(T&& value)
+    {
+        emplace_front(std::move(value));
+    }
+
+    template <typename... ArgTypes>
+    inline void emplace_front(ArgTypes&&... args)
+    {
+        emplace_at(m_sentinel.m_next, m_sentinel.m_next->m_begin,
+                   std::forward<ArgTypes>(args)...);
+    }
+
+    inline void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    inline void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template <typename... ArgTypes>
+    inline void emplace_back(ArgTypes&&... args)
+    {
+        emplace_at(&m_sentinel, 0, std::forward<ArgTypes>(args)...);
+    }
+
+    inline void pop_front()
+    {
+        erase_at(m_sentinel.m_next, m_sentinel.m_next->m_begin);
+    }
+
+    inline void pop_back()
+    {
+        NodeBase* last = m_sentinel.m_prev;
+        erase_at(last, last->m_begin + last->m_count - 1);
+    }
+
+    template <typename... ArgTypes>
+    inline Iterator emplace(ConstIterator position, ArgTypes&&... args)
+    {
+        return emplace_at(position.m_node, position.m_slot, std::forward<ArgTypes>(args)...);
+    }
+
+    inline Iterator insert(ConstIterator position, const T& value)
+    {
+        return emplace(position, value);
+    }
+
+    inline Iterator insert(ConstIterator position, T&& value)
+    {
+        return emplace(position, std::move(value));
+    }
+
+    inline Iterator erase(ConstIterator position)
+    {
+        return erase_at(position.m_node, position.m_slot);
+    }
+
+    inline Iterator erase(ConstIterator first, ConstIterator last)
+    {
+        u64 num_left = 0;
+        for (auto it = first; it != last; ++it) {
+            ++num_left;
+        }
+
+        // whole nodes are freed, partial ones closed up in one move
+        Iterator position(first.m_node, first.m_slot);
+        while (num_left > 0) {
+            NodeBase* node = position.m_node;
+            const u32 index = position.m_slot - node->m_begin;
+            if (index == 0 && node->m_count <= num_left) {
+                NodeBase* next = node->m_next;
+                num_left -= node->m_count;
+                m_size -= node->m_count;
+                free_node(node);
+                position = Iterator(next, next->m_begin);
+                continue;
+            }
+
+            const u32 num_erased = (u32)std::min((u64)(node->m_count - index), num_left);
+            T* elements = elements_of(node);
+            const u32 end = node->m_begin + node->m_count;
+            std::move(elements + position.m_slot + num_erased, elements + end,
+                      elements + position.m_slot);
+            for (u32 i = end - num_erased; i < end; ++i) {
+                elements[i].~T();
+            }
+            node->m_count -= num_erased;
+            m_size -= num_erased;
+            num_left -= num_erased;
+            position = iterator_at(node, index);
+        }
+        return position;
+    }
+
+    inline void clear()
+    {
+        while (m_sentinel.m_next != &m_sentinel) {
+            free_node(m_sentinel.m_next);
+        }
+        m_size = 0;
+    }
+
+    inline void resize(u64 size)
+    {
+        if (size < m_size) {
+            auto it = begin();
+            std::advance(it, size);
+            truncate(it);
+        }
+        while (m_size < size) {
+            emplace_back();
+        }
+    }
+
+    inline void resize(u64 size, const T& value)
+    {
+        if (size < m_size) {
+            auto it = begin();
+            std::advance(it, size);
+            truncate(it);
+        }
+        while (m_size < size) {
+            emplace_back(value);
+        }
+    }
+
+    // the survivors are moved down into the slots of the elements
+    // removed, so the nodes stay as full as they were
+    template <typename Predicate>
+    inline void remove_if(const Predicate& predicate)
+    {
+        auto out = begin();
+        for (auto it = begin(), last = end(); it != last; ++it) {
+            if (predicate(*it)) {
+                continue;
+            }
+            if (out != it) {
+                *out = std::move(*it);
+            }
+            ++out;
+        }
+        truncate(out);
+    }
+
+    inline void remove(const T& value)
+    {
+        // copied, since it could be an element of this list
+        const T removed_value(value);
+        remove_if([&] (const T& element) -> bool { return (element == removed_value); });
+    }
+
+    template <typename BinaryPredicate>
+    inline void unique(const BinaryPredicate& predicate)
+    {
+        if (m_size == 0) {
+            return;
+        }
+        auto out = begin();
+        T* last_kept = &(*out);
+        ++out;
+        for (auto it = out, last = end(); it != last; ++it) {
+            if (predicate(*last_kept, *it)) {
+                continue;
+            }
+            if (out != it) {
+                *out = std::move(*it);
+            }
+            last_kept = &(*out);
+            ++out;
+        }
+        truncate(out);
+    }
+
+    inline void unique()
+    {
+        unique(std::equal_to<T>());
+    }
+
+    // Stable. Lists that are already in order, in reverse order, or
+    // made of a few sorted runs are handled without sorting, by
+    // reversing or by merging the runs in place. Other lists are
+    // sorted in a contiguous buffer: small, trivially copyable
+    // elements are moved into it and back, and larger ones are
+    // sorted through an array of pointers to them, and then moved
+    // once, into new nodes that are full.
+    template <typename Comparator>
+    inline void sort(const Comparator& comparator)
+    {
+        if (m_size < 2) {
+            return;
+        }
+
+        std::vector<Iterator> run_starts(1, begin());
+        u64 num_runs = 1;
+        bool descending = true;
+        auto previous = begin();
+        for (auto it = successor(previous), last = end(); it != last; previous = it, ++it) {
+            if (!comparator(*it, *previous)) {
+                descending = false;
+            } else if (++num_runs <= sc_max_natural_runs) {
+                run_starts.push_back(it);
+            }
+            if (!descending && num_runs > sc_max_natural_runs) {
+                break;
+            }
+        }
+
+        if (descending) {
+            reverse();
+            return;
+        }
+        if (num_runs <= sc_max_natural_runs) {
+            merge_runs(run_starts, comparator);
+            return;
+        }
+
+        if (sc_sort_by_value) {
+            std::vector<T> buffer;
+            buffer.reserve(m_size);
+            for (auto& element : *this) {
+                buffer.push_back(std::move(element));
+            }
+            std::stable_sort(buffer.begin(), buffer.end(), comparator);
+            auto source = buffer.begin();
+            for (auto& element : *this) {
+                element = std::move(*source);
+                ++source;
+            }
+            return;
+        }
+
+        std::vector<T*> pointers;
+        pointers.reserve(m_size);
+        for (auto& element : *this) {
+            pointers.push_back(&element);
+        }
+        std::stable_sort(pointers.begin(), pointers.end(),
+                         [&] (const T* element1, const T* element2) -> bool
+                         {
+                             return comparator(*element1, *element2);
+                         });
+        UnrolledListBase sorted;
+        for (auto pointer : pointers) {
+            sorted.emplace_back(std::move(*pointer));
+        }
+        clear();
+        steal(sorted);
+    }
+
+    inline void sort()
+    {
+        sort(std::less<T>());
+    }
+
+    template <typename Comparator>
+    inline void merge(UnrolledListBase& other, const Comparator& comparator)
+    {
+        if (&other == this || other.m_size == 0) {
+            return;
+        }
+        auto middle = splice_range(end(), other, other.begin(), other.end());
+        std::inplace_merge(begin(), middle, end(), comparator);
+    }
+
+    inline void merge(UnrolledListBase& other)
+    {
+        merge(other, std::less<T>());
+    }
+
+    inline void reverse()
+    {
+        NodeBase* node = &m_sentinel;
+        do {
+            std::swap(node->m_next, node->m_prev);
+            if (node != &m_sentinel) {
+                T* elements = elements_of(node);
+                std::reverse(elements + node->m_begin, elements + node->m_begin + node->m_count);
+            }
+            node = node->m_prev;
+        } while (node != &m_sentinel);
+    }
+
+    inline void swap(UnrolledListBase& other)
+    {
+        UnrolledListBase temp(std::move(other));
+        other.steal(*this);
+        steal(temp);
+    }
+};
+
+} /* end namespace unrolled_list_detail_ */
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_UNROLLED_LIST_BASE_HPP_ */
+
+//
+// UnrolledListBase.hpp ends here
@@ -0,0 +1,245 @@
+// UnrolledSList.hpp ---
+//
+// Filename: UnrolledSList.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 14:41:09 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// A list with the interface of SList that stores up to K elements
+// per node, for lists that are mostly traversed, such as event and
+// work lists. See UnrolledListBase.hpp for the layout, and for the
+// operations that invalidate iterators.
+
+#if !defined KINARA_COMMON_CONTAINERS_UNROLLED_SLIST_HPP_
+#define KINARA_COMMON_CONTAINERS_UNROLLED_SLIST_HPP_
+
+#include "UnrolledListBase.hpp"
+
+namespace kinara {
+namespace containers {
+
+template <typename T, u32 K = unrolled_list_detail_::default_node_capacity(sizeof(T))>
+class UnrolledSList : public unrolled_list_detail_::UnrolledListBase<T, K>
+{
+private:
+    typedef unrolled_list_detail_::UnrolledListBase<T, K> BaseType;
+
+public:
+    typedef typename BaseType::ValueType ValueType;
+    typedef typename BaseType::Iterator Iterator;
+    typedef typename BaseType::ConstIterator ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+
+    inline UnrolledSList()
+        : BaseType()
+    {
+        // Nothing here
+    }
+
+    inline explicit UnrolledSList(u64 size)
+        : BaseType(size)
+    {
+        // Nothing here
+    }
+
+    inline UnrolledSList(u64 size, const T& value)
+        : BaseType(size, value)
+    {
+        // Nothing here
+    }
+
+    template <typename InputIterator,
+              typename = typename std::enable_if<
+                  !std::is_integral<InputIterator>::value>::type>
+    inline UnrolledSList(InputIterator first, InputIterator last)
+        : BaseType(first, last)
+    {
+        // Nothing here
+    }
+
+    inline UnrolledSList(std::initializer_list<T> init_list)
+        : BaseType(init_list)
+    {
+        // Nothing here
+    }
+
+    inline UnrolledSList(const UnrolledSList& other) = default;
+    inline UnrolledSList(UnrolledSList&& other) = default;
+
+    inline ~UnrolledSList()
+    {
+        // Nothing here
+    }
+
+    inline UnrolledSList& operator = (const UnrolledSList& other) = default;
+    inline UnrolledSList& operator = (UnrolledSList&& other) = default;
+
+    inline UnrolledSList& operator = (std::initializer_list<T> init_list)
+    {
+        BaseType::operator = (init_list);
+        return *this;
+    }
+
+    inline Iterator before_begin()
+    {
+        return BaseType::before_first();
+    }
+
+    inline ConstIterator before_begin() const
+    {
+        return BaseType::before_first();
+    }
+
+    inline ConstIterator cbefore_begin() const
+    {
+        return BaseType::before_first();
+    }
+
+    inline Iterator insert_after(ConstIterator position, const T& value)
+    {
+        return BaseType::emplace(BaseType::successor(position), value);
+    }
+
+    inline Iterator insert_after(ConstIterator position, T&& value)
+    {
+        return BaseType::emplace(BaseType::successor(position), std::move(value));
+    }
+
+    template <typename... ArgTypes>
+    inline Iterator emplace_after(ConstIterator position, ArgTypes&&... args)
+    {
+        return BaseType::emplace(BaseType::successor(position),
+                                 std::forward<ArgTypes>(args)...);
+    }
+
+    inline Iterator erase_after(ConstIterator position)
+    {
+        return BaseType::erase(BaseType::successor(position));
+    }
+
+    // erases the elements strictly between first and last
+    inline Iterator erase_after(ConstIterator first, ConstIterator last)
+    {
+        return BaseType::erase(BaseType::successor(first), last);
+    }
+
+    inline void splice(ConstIterator position, UnrolledSList& other)
+    {
+        BaseType::splice_range(position, other, other.begin(), other.end());
+    }
+
+    // moves the elements strictly between first and last
+    inline void splice(ConstIterator position, UnrolledSList& other,
+                       ConstIterator first, ConstIterator last)
+    {
+        BaseType::splice_range(position, other, BaseType::successor(first), last);
+    }
+
+    inline void splice_after(ConstIterator position, UnrolledSList& other)
+    {
+        BaseType::splice_range(BaseType::successor(position), other,
+                               other.begin(), other.end());
+    }
+
+    // moves the element after element
+    inline void splice_after(ConstIterator position, UnrolledSList& other,
+                             ConstIterator element)
+    {
+        BaseType::move_element(BaseType::successor(position), other,
+                               BaseType::successor(element));
+    }
+
+    // moves the elements strictly between first and last
+    inline void splice_after(ConstIterator position, UnrolledSList& other,
+                             ConstIterator first, ConstIterator last)
+    {
+        BaseType::splice_range(BaseType::successor(position), other,
+                               BaseType::successor(first), last);
+    }
+
+    inline void splice_element(ConstIterator position, UnrolledSList& other,
+                               ConstIterator element)
+    {
+        BaseType::move_element(position, other, element);
+    }
+
+    inline void splice_element_after(ConstIterator position, UnrolledSList& other,
+                                     ConstIterator element)
+    {
+        BaseType::move_element(BaseType::successor(position), other, element);
+    }
+
+    inline bool operator == (const UnrolledSList& other) const
+    {
+        return (BaseType::compare(other) == 0);
+    }
+
+    inline bool operator != (const UnrolledSList& other) const
+    {
+        return (BaseType::compare(other) != 0);
+    }
+
+    inline bool operator < (const UnrolledSList& other) const
+    {
+        return (BaseType::compare(other) < 0);
+    }
+
+    inline bool operator <= (const UnrolledSList& other) const
+    {
+        return (BaseType::compare(other) <= 0);
+    }
+
+    inline bool operator > (const UnrolledSList& other) const
+    {
+        return (BaseType::compare(other) > 0);
+    }
+
+    inline bool operator >= (const UnrolledSList& other) const
+    {
+        return (BaseType::compare(other) >= 0);
+    }
+};
+
+typedef UnrolledSList<u32> u32UnrolledSList;
+typedef UnrolledSList<u64> u64UnrolledSList;
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+#endif /* KINARA_COMMON_CONTAINERS_UNROLLED_SLIST_HPP_ */
+
+//
+// UnrolledSList.hpp ends here
@@ -0,0 +1,650 @@
+// PersistentMap.hpp ---
+//
+// Filename: PersistentMap.hpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 14:02:11 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+// A copy-on-write hash array mapped trie. Copying a map is O(1):
+// the copies share their nodes, and a modification copies only the
+// shared nodes on the path from the root to the modified entry.
+
+#if !defined KINARA_PERSISTENT_MAP_HPP_
+#define KINARA_PERSISTENT_MAP_HPP_
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <functional>
+
+#include "../common/ESMCFwdDecls.hpp"
+
+namespace ESMC {
+
+template <typename K, typename V, typename HashFun = hash<K>,
+          typename EqualsFun = equal_to<K>>
+class PersistentMap
+{
+public:
+    typedef pair<K, V> value_type;
+    typedef K key_type;
+    typedef V mapped_type;
+
+private:
+    // 5 bits of the hash per level. Entries whose 64 bit
+    // hashes collide end up in a leaf below the last level
+    static const u32 BitsPerLevel = 5;
+    static const u64 LevelMask = (1 << BitsPerLevel) - 1;
+    static const u32 MaxShift = 60;
+
+    // The entries and the sub-tries of a node are kept in two
+    // arrays, compressed by the bitmaps. An entry that shares
+    // its hash fragment with another is pushed into a sub-trie
+    class Node
+    {
+    public:
+        mutable u64 RefCount;
+        u32 DataMap;
+        u32 NodeMap;
+        vector<value_type> Data;
+        vector<Node*> Children;
+
+        inline Node();
+        inline Node(const Node& Other);
+        inline ~Node();
+    };
+
+    Node* Root;
+    u64 NumEntries;
+    HashFun Hasher;
+    EqualsFun Equals;
+
+    inline static void Acquire(Node* TheNode);
+    inline static void Release(Node* TheNode);
+    inline static u32 Index(u32 BitMap, u32 Bit);
+    inline static u32 BitFor(u64 Hash, u32 Shift);
+
+    inline void MakeUnique(Node*& TheNode);
+    inline const value_type* Lookup(const K& Key) const;
+    inline V* InsertInto(Node*& TheNode, const K& Key, u64 Hash,
+                         u32 Shift, bool& Inserted);
+    inline bool EraseFrom(Node*& TheNode, const K& Key, u64 Hash, u32 Shift);
+
+public:
+    class ConstIterator
+    {
+        friend class PersistentMap;
+
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef pair<K, V> value_type;
+        typedef i64 difference_type;
+        typedef const pair<K, V>* pointer;
+        typedef const pair<K, V>& reference;
+
+    private:
+        // (node, position) pairs. Positions below the number of
+        // entries in a node refer to the entries, the remaining
+        // positions to the children
+        vector<pair<const Node*, u32>> Stack;
+
+        inline ConstIterator();
+        inline ConstIterator(const Node* Root);
+        inline void Settle();
+
+    public:
+        inline const value_type& operator * () const;
+        inline const value_type* operator -> () const;
+        inline ConstIterator& operator ++ ();
+        inline ConstIterator operator ++ (int);
+        inline bool operator == (const ConstIterator& Other) const;
+        inline bool operator != (const ConstIterator& Other) const;
+    };
+
+    typedef ConstIterator const_iterator;
+    typedef ConstIterator iterator;
+
+    inline PersistentMap();
+    inline PersistentMap(const PersistentMap& Other);
+    inline PersistentMap(PersistentMap&& Other);
+    inline ~PersistentMap();
+
+    inline PersistentMap& operator = (const PersistentMap& Other);
+    inline PersistentMap& operator = (PersistentMap&& Other);
+
+    inline u64 size() const;
+    inline bool empty() const;
+    inline void clear();
+
+    inline ConstIterator begin() const;
+    inline ConstIterator end() const;
+    inline ConstIterator find(const K& Key) const;
+    inline u64 count(const K& Key) const;
+
+    // The reference points into a node that only this map owns
+    // at the time of the call. Copying the map shares that node
+    // and the next write copies it again, so the reference must
+    // not be used after the map is copied or modified
+    inline V& operator [] (const K& Key);
+    inline pair<ConstIterator, bool> insert(const value_type& Entry);
+    inline u64 erase(const K& Key);
+
+    // Returns a copy of this map with Key mapped to Value.
+    // Everything except the path to Key is shared with this map
+    inline PersistentMap Extend(const K& Key, const V& Value) const;
+};
+
+// PersistentMap::Node implementation
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>::Node::Node()
+    : RefCount(0), DataMap(0), NodeMap(0)
+{
+    // Nothing here
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>::Node::Node(const Node& Other)
+    : RefCount(0), DataMap(Other.DataMap), NodeMap(Other.NodeMap),
+      Data(Other.Data), Children(Other.Children)
+{
+    for (auto Child : Children) {
+        Acquire(Child);
+    }
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>::Node::~Node()
+{
+    for (auto Child : Children) {
+        Release(Child);
+    }
+}
+
+// PersistentMap::ConstIterator implementation
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator::ConstIterator()
+{
+    // Nothing here
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator::ConstIterator(const Node* Root)
+{
+    if (Root != nullptr) {
+        Stack.push_back(make_pair(Root, 0));
+        Settle();
+    }
+}
+
+// Moves to the next entry, starting at the current position
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline void PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator::Settle()
+{
+    while (Stack.size() > 0) {
+        auto& Top = Stack.back();
+        const u32 NumData = Top.first->Data.size();
+        if (Top.second < NumData) {
+            return;
+        }
+        if (Top.second - NumData < Top.first->Children.size()) {
+            const Node* Child = Top.first->Children[Top.second - NumData];
+            ++Top.second;
+            Stack.push_back(make_pair(Child, 0));
+        } else {
+            Stack.pop_back();
+        }
+    }
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline const typename PersistentMap<K, V, HashFun, EqualsFun>::value_type&
+PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator::operator * () const
+{
+    return Stack.back().first->Data[Stack.back().second];
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline const typename PersistentMap<K, V, HashFun, EqualsFun>::value_type*
+PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator::operator -> () const
+{
+    return &(Stack.back().first->Data[Stack.back().second]);
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline typename PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator&
+PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator::operator ++ ()
+{
+    ++Stack.back().second;
+    Settle();
+    return *this;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline typename PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator
+PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator::operator ++ (int)
+{
+    auto Retval = *this;
+    ++(*this);
+    return Retval;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline bool
+PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator::operator ==
+(const ConstIterator& Other) const
+{
+    if (Stack.size() == 0 || Other.Stack.size() == 0) {
+        return (Stack.size() == Other.Stack.size());
+    }
+    return (Stack.back() == Other.Stack.back());
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline bool
+PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator::operator !=
+(const ConstIterator& Other) const
+{
+    return !(*this == Other);
+}
+
+// PersistentMap implementation
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline void PersistentMap<K, V, HashFun, EqualsFun>::Acquire(Node* TheNode)
+{
+    if (TheNode != nullptr) {
+        ++TheNode->RefCount;
+    }
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline void PersistentMap<K, V, HashFun, EqualsFun>::Release(Node* TheNode)
+{
+    if (TheNode != nullptr && --TheNode->RefCount == 0) {
+        delete TheNode;
+    }
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline u32 PersistentMap<K, V, HashFun, EqualsFun>::Index(u32 BitMap, u32 Bit)
+{
+    return __builtin_popcount(BitMap & (Bit - 1));
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline u32 PersistentMap<K, V, HashFun, EqualsFun>::BitFor(u64 Hash, u32 Shift)
+{
+    return (1u << ((Hash >> Shift) & LevelMask));
+}
+
+// Ensures that TheNode is referenced only from this map, so
+// that it can be modified in place. Must be applied top down
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline void PersistentMap<K, V, HashFun, EqualsFun>::MakeUnique(Node*& TheNode)
+{
+    if (TheNode->RefCount > 1) {
+        Node* Copy = new Node(*TheNode);
+        Acquire(Copy);
+        Release(TheNode);
+        TheNode = Copy;
+    }
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline const typename PersistentMap<K, V, HashFun, EqualsFun>::value_type*
+PersistentMap<K, V, HashFun, EqualsFun>::Lookup(const K& Key) const
+{
+    const Node* Cur = Root;
+    const u64 Hash = Hasher(Key);
+    u32 Shift = 0;
+
+    while (Cur != nullptr) {
+        if (Shift > MaxShift) {
+            for (auto const& Entry : Cur->Data) {
+                if (Equals(Entry.first, Key)) {
+                    return &Entry;
+                }
+            }
+            return nullptr;
+        }
+
+        const u32 Bit = BitFor(Hash, Shift);
+        if ((Cur->DataMap & Bit) != 0) {
+            auto const& Entry = Cur->Data[Index(Cur->DataMap, Bit)];
+            return (Equals(Entry.first, Key) ? &Entry : nullptr);
+        }
+        if ((Cur->NodeMap & Bit) == 0) {
+            return nullptr;
+        }
+        Cur = Cur->Children[Index(Cur->NodeMap, Bit)];
+        Shift += BitsPerLevel;
+    }
+    return nullptr;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline V* PersistentMap<K, V, HashFun, EqualsFun>::InsertInto(Node*& TheNode,
+                                                              const K& Key,
+                                                              u64 Hash, u32 Shift,
+                                                              bool& Inserted)
+{
+    MakeUnique(TheNode);
+
+    if (Shift > MaxShift) {
+        for (auto& Entry : TheNode->Data) {
+            if (Equals(Entry.first, Key)) {
+                return &Entry.second;
+            }
+        }
+        Inserted = true;
+        TheNode->Data.push_back(make_pair(Key, V()));
+        return &TheNode->Data.back().second;
+    }
+
+    const u32 Bit = BitFor(Hash, Shift);
+    if ((TheNode->NodeMap & Bit) != 0) {
+        return InsertInto(TheNode->Children[Index(TheNode->NodeMap, Bit)],
+                          Key, Hash, Shift + BitsPerLevel, Inserted);
+    }
+
+    const u32 DataIdx = Index(TheNode->DataMap, Bit);
+    if ((TheNode->DataMap & Bit) == 0) {
+        Inserted = true;
+        TheNode->DataMap |= Bit;
+        TheNode->Data.insert(TheNode->Data.begin() + DataIdx, make_pair(Key, V()));
+        return &TheNode->Data[DataIdx].second;
+    }
+
+    if (Equals(TheNode->Data[DataIdx].first, Key)) {
+        return &TheNode->Data[DataIdx].second;
+    }
+
+    // Push the existing entry down into a new sub-trie
+    // along with the new one
+    value_type Existing = TheNode->Data[DataIdx];
+    TheNode->Data.erase(TheNode->Data.begin() + DataIdx);
+    TheNode->DataMap &= ~Bit;
+
+    Node* Child = new Node();
+    Acquire(Child);
+    bool Dummy = false;
+    *InsertInto(Child, Existing.first, Hasher(Existing.first),
+                Shift + BitsPerLevel, Dummy) = Existing.second;
+
+    const u32 NodeIdx = Index(TheNode->NodeMap, Bit);
+    TheNode->NodeMap |= Bit;
+    TheNode->Children.insert(TheNode->Children.begin() + NodeIdx, Child);
+    return InsertInto(TheNode->Children[NodeIdx], Key, Hash,
+                      Shift + BitsPerLevel, Inserted);
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline bool PersistentMap<K, V, HashFun, EqualsFun>::EraseFrom(Node*& TheNode,
+                                                               const K& Key,
+                                                               u64 Hash, u32 Shift)
+{
+    MakeUnique(TheNode);
+
+    if (Shift > MaxShift) {
+        for (auto it = TheNode->Data.begin(); it != TheNode->Data.end(); ++it) {
+            if (Equals(it->first, Key)) {
+                TheNode->Data.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const u32 Bit = BitFor(Hash, Shift);
+    if ((TheNode->DataMap & Bit) != 0) {
+        TheNode->Data.erase(TheNode->Data.begin() + Index(TheNode->DataMap, Bit));
+        TheNode->DataMap &= ~Bit;
+        return true;
+    }
+
+    const u32 NodeIdx = Index(TheNode->NodeMap, Bit);
+    Node*& Child = TheNode->Children[NodeIdx];
+    if (!EraseFrom(Child, Key, Hash, Shift + BitsPerLevel)) {
+        return false;
+    }
+
+    // Keep the trie canonical: a sub-trie left with a
+    // single entry is pulled back up into this node
+    if (Child->Children.size() == 0 && Child->Data.size() <= 1) {
+        if (Child->Data.size() == 1) {
+            const u32 DataIdx = Index(TheNode->DataMap, Bit);
+            TheNode->DataMap |= Bit;
+            TheNode->Data.insert(TheNode->Data.begin() + DataIdx, Child->Data[0]);
+        }
+        Release(Child);
+        TheNode->Children.erase(TheNode->Children.begin() + NodeIdx);
+        TheNode->NodeMap &= ~Bit;
+    }
+    return true;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>::PersistentMap()
+    : Root(nullptr), NumEntries(0)
+{
+    // Nothing here
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>::PersistentMap(const PersistentMap& Other)
+    : Root(Other.Root), NumEntries(Other.NumEntries),
+      Hasher(Other.Hasher), Equals(Other.Equals)
+{
+    Acquire(Root);
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>::PersistentMap(PersistentMap&& Other)
+    : Root(Other.Root), NumEntries(Other.NumEntries),
+      Hasher(Other.Hasher), Equals(Other.Equals)
+{
+    Other.Root = nullptr;
+    Other.NumEntries = 0;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>::~PersistentMap()
+{
+    Release(Root);
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>&
+PersistentMap<K, V, HashFun, EqualsFun>::operator = (const PersistentMap& Other)
+{
+    if (&Other == this) {
+        return *this;
+    }
+    Acquire(Other.Root);
+    Release(Root);
+    Root = Other.Root;
+    NumEntries = Other.NumEntries;
+    return *this;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>&
+PersistentMap<K, V, HashFun, EqualsFun>::operator = (PersistentMap&& Other)
+{
+    swap(Root, Other.Root);
+    swap(NumEntries, Other.NumEntries);
+    return *this;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline u64 PersistentMap<K, V, HashFun, EqualsFun>::size() const
+{
+    return NumEntries;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline bool PersistentMap<K, V, HashFun, EqualsFun>::empty() const
+{
+    return (NumEntries == 0);
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline void PersistentMap<K, V, HashFun, EqualsFun>::clear()
+{
+    Release(Root);
+    Root = nullptr;
+    NumEntries = 0;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline typename PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator
+PersistentMap<K, V, HashFun, EqualsFun>::begin() const
+{
+    return ConstIterator(Root);
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline typename PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator
+PersistentMap<K, V, HashFun, EqualsFun>::end() const
+{
+    return ConstIterator();
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline typename PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator
+PersistentMap<K, V, HashFun, EqualsFun>::find(const K& Key) const
+{
+    ConstIterator Retval;
+    const Node* Cur = Root;
+    const u64 Hash = Hasher(Key);
+    u32 Shift = 0;
+
+    while (Cur != nullptr) {
+        const u32 NumData = Cur->Data.size();
+        if (Shift > MaxShift) {
+            for (u32 i = 0; i < NumData; ++i) {
+                if (Equals(Cur->Data[i].first, Key)) {
+                    Retval.Stack.push_back(make_pair(Cur, i));
+                    return Retval;
+                }
+            }
+            return end();
+        }
+
+        const u32 Bit = BitFor(Hash, Shift);
+        if ((Cur->DataMap & Bit) != 0) {
+            const u32 DataIdx = Index(Cur->DataMap, Bit);
+            if (!Equals(Cur->Data[DataIdx].first, Key)) {
+                return end();
+            }
+            Retval.Stack.push_back(make_pair(Cur, DataIdx));
+            return Retval;
+        }
+        if ((Cur->NodeMap & Bit) == 0) {
+            return end();
+        }
+
+        // Position the parent past the child we descend into,
+        // which is where Settle() would leave it
+        const u32 NodeIdx = Index(Cur->NodeMap, Bit);
+        Retval.Stack.push_back(make_pair(Cur, NumData + NodeIdx + 1));
+        Cur = Cur->Children[NodeIdx];
+        Shift += BitsPerLevel;
+    }
+    return end();
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline u64 PersistentMap<K, V, HashFun, EqualsFun>::count(const K& Key) const
+{
+    return (Lookup(Key) != nullptr ? 1 : 0);
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline V& PersistentMap<K, V, HashFun, EqualsFun>::operator [] (const K& Key)
+{
+    if (Root == nullptr) {
+        Root = new Node();
+        Acquire(Root);
+    }
+    bool Inserted = false;
+    V* Retval = InsertInto(Root, Key, Hasher(Key), 0, Inserted);
+    if (Inserted) {
+        ++NumEntries;
+    }
+    return *Retval;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline pair<typename PersistentMap<K, V, HashFun, EqualsFun>::ConstIterator, bool>
+PersistentMap<K, V, HashFun, EqualsFun>::insert(const value_type& Entry)
+{
+    auto it = find(Entry.first);
+    if (it != end()) {
+        return make_pair(it, false);
+    }
+    (*this)[Entry.first] = Entry.second;
+    return make_pair(find(Entry.first), true);
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline u64 PersistentMap<K, V, HashFun, EqualsFun>::erase(const K& Key)
+{
+    // Avoid copying the path for keys that are not present
+    if (Lookup(Key) == nullptr) {
+        return 0;
+    }
+    EraseFrom(Root, Key, Hasher(Key), 0);
+    --NumEntries;
+    if (NumEntries == 0) {
+        clear();
+    }
+    return 1;
+}
+
+template <typename K, typename V, typename HashFun, typename EqualsFun>
+inline PersistentMap<K, V, HashFun, EqualsFun>
+PersistentMap<K, V, HashFun, EqualsFun>::Extend(const K& Key, const V& Value) const
+{
+    PersistentMap Retval(*this);
+    Retval[Key] = Value;
+    return Retval;
+}
+
+} /* end namespace ESMC */
+
+#endif /* KINARA_PERSISTENT_MAP_HPP_ */
+
+//
+// PersistentMap.hpp ends here
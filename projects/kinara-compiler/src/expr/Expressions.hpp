@@ -47,13 +47,21 @@
 #include <boost/functional/hash.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <functional>
+#include <chrono>
+#include <map>
+#include <array>
+#include <sstream>
+#include <iomanip>
 #include <unordered_map>
 #include <unordered_set>
+#include <memory>
+#include <atomic>
 
 #include "../common/ESMCFwdDecls.hpp"
 #include "../containers/RefCountable.hpp"
 #include "../containers/SmartPtr.hpp"
 #include "../containers/RefCache.hpp"
+#include "../containers/PersistentMap.hpp"
 #include "../utils/UIDGenerator.hpp"
 
 // This classes in this file are heavily templatized
@@ -176,6 +184,10 @@ public:
     }
 };
 
+#if defined KINARA_CFG_LOGGING_BUILD_
+class ExprProfiler;
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+
 template <typename E, template <typename> class S>
 class ExpressionBase : public RefCountable, public Stringifiable
 {
@@ -184,6 +196,11 @@ private:
     ExprMgr<E, S>* Mgr;
     mutable bool HashValid;
     mutable typename S<E>::TypeT ExpType;
+#if defined KINARA_CFG_LOGGING_BUILD_
+    // Co-owned with the manager, expressions can
+    // outlive the manager that created them
+    shared_ptr<ExprProfiler> Profiler;
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 
 public:
     mutable E ExtensionData;
@@ -191,6 +208,14 @@ public:
 
 protected:
     mutable u64 HashCode;
+    // The largest de Bruijn index of a bound variable that is
+    // free in this expression, or -1 if there is no such variable.
+    // Set by the constructors of the derived classes
+    i64 MaxFreeBoundIdx;
+
+#if defined KINARA_CFG_LOGGING_BUILD_
+    inline ExprProfiler& GetProfiler() const;
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 
 public:
     inline ExpressionBase(ExprMgr<E, S>* Manager,
@@ -208,6 +233,9 @@ public:
     inline bool LE(const ExpressionBase<E, S>* Other) const;
     inline bool GE(const ExpressionBase<E, S>* Other) const;
     inline bool GT(const ExpressionBase<E, S>* Other) const;
+    inline i64 GetMaxFreeBoundIdx() const;
+    // true if no bound variable occurs free in this expression
+    inline bool IsBoundClosed() const;
     virtual string ToString(u32 Verbosity = 0) const override;
 
     // Abstract methods
@@ -262,12 +290,25 @@ private:
     ExprMgr<ExtListT, S>* Mgr;
     mutable bool HashValid;
     mutable i64 ExpType;
+#if defined KINARA_CFG_LOGGING_BUILD_
+    // Co-owned with the manager, expressions can
+    // outlive the manager that created them
+    shared_ptr<ExprProfiler> Profiler;
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 
 public:
     mutable ExtListT ExtensionData;
 
 protected:
     mutable u64 HashCode;
+    // The largest de Bruijn index of a bound variable that is
+    // free in this expression, or -1 if there is no such variable.
+    // Set by the constructors of the derived classes
+    i64 MaxFreeBoundIdx;
+
+#if defined KINARA_CFG_LOGGING_BUILD_
+    inline ExprProfiler& GetProfiler() const;
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 
 public:
     inline ExpressionBase(ExprMgr<ExtListT, S>* Manager,
@@ -285,6 +326,9 @@ public:
     inline bool LE(const ExpressionBase<ExtListT, S>* Other) const;
     inline bool GE(const ExpressionBase<ExtListT, S>* Other) const;
     inline bool GT(const ExpressionBase<ExtListT, S>* Other) const;
+    inline i64 GetMaxFreeBoundIdx() const;
+    // true if no bound variable occurs free in this expression
+    inline bool IsBoundClosed() const;
     virtual string ToString(u32 Verbosity = 0) const override;
 
     // Abstract methods
@@ -540,9 +584,304 @@ public:
     }
 };
 
+// Limits on the work done by a single transform (one visitor pass).
+// A limit of zero means unbounded. Interruption and the time limit
+// are only checked once every CheckInterval nodes, the node limit
+// is checked at every node.
+class TransformBudget
+{
+public:
+    u64 MaxNodes;
+    u64 MaxMillis;
+    u64 CheckInterval;
+
+    TransformBudget(u64 MaxNodes = 0, u64 MaxMillis = 0, u64 CheckInterval = 1024)
+        : MaxNodes(MaxNodes), MaxMillis(MaxMillis),
+          CheckInterval(CheckInterval == 0 ? 1 : CheckInterval)
+    {
+        // Nothing here
+    }
+
+    inline bool IsUnbounded() const
+    {
+        return (MaxNodes == 0 && MaxMillis == 0);
+    }
+};
+
+enum class TransformAbortReason
+{
+    Interrupted,
+    NodeBudgetExhausted,
+    TimeBudgetExhausted
+};
+
+// Thrown out of a transform or visitor pass when the manager
+// has been interrupted or the transform budget is exhausted.
+// No partial result is available in this case.
+class ExprTransformAborted : public exception
+{
+private:
+    TransformAbortReason Reason;
+    u64 NumNodesVisited;
+    string Message;
+
+public:
+    ExprTransformAborted(TransformAbortReason Reason, u64 NumNodesVisited)
+        : Reason(Reason), NumNodesVisited(NumNodesVisited)
+    {
+        switch (Reason) {
+        case TransformAbortReason::Interrupted:
+            Message = "Expression transform interrupted";
+            break;
+        case TransformAbortReason::NodeBudgetExhausted:
+            Message = "Expression transform exceeded its node budget";
+            break;
+        case TransformAbortReason::TimeBudgetExhausted:
+            Message = "Expression transform exceeded its time budget";
+            break;
+        }
+        Message += " after visiting " + to_string(NumNodesVisited) + " nodes";
+    }
+
+    virtual ~ExprTransformAborted() {}
+
+    inline TransformAbortReason GetReason() const
+    {
+        return Reason;
+    }
+
+    inline u64 GetNumNodesVisited() const
+    {
+        return NumNodesVisited;
+    }
+
+    virtual const char* what() const noexcept override
+    {
+        return Message.c_str();
+    }
+};
+
+#if defined KINARA_CFG_LOGGING_BUILD_
+
+// Instrumentation for the expression DAG owned by an ExprMgr.
+// Only compiled into the logging builds. Node counts are
+// maintained by the constructors and destructors of the
+// expression classes, so they count live nodes, i.e., nodes
+// that are either in the cache or still referenced elsewhere
+class ExprProfiler
+{
+public:
+    enum class NodeKind
+    {
+        Const = 0,
+        Var,
+        BoundVar,
+        Op,
+        Quantified,
+        NumKinds
+    };
+
+    enum class CacheOp
+    {
+        MakeExpr = 0,
+        MakeVar,
+        MakeVal,
+        NumOps
+    };
+
+    // bucket i counts pauses in [2^(i-1), 2^i) microseconds,
+    // bucket 0 counts pauses of under a microsecond
+    static const u32 NumGCPauseBuckets = 32;
+
+private:
+    static const u32 NumKinds = (u32)NodeKind::NumKinds;
+    static const u32 NumCacheOps = (u32)CacheOp::NumOps;
+
+    array<u64, NumKinds> LiveNodes;
+    map<i64, u64> LiveOpNodes;
+    u64 LiveOpChildren;
+    array<u64, NumCacheOps> CacheHits;
+    array<u64, NumCacheOps> CacheMisses;
+    array<u64, NumGCPauseBuckets> GCPauses;
+    u64 NumGCs;
+    u64 TotalGCMicros;
+
+    static inline const char* KindName(u32 Kind)
+    {
+        static const char* Names[] = { "const", "var", "bound_var", "op", "quantified" };
+        return Names[Kind];
+    }
+
+    static inline const char* CacheOpName(u32 Op)
+    {
+        static const char* Names[] = { "make_expr", "make_var", "make_val" };
+        return Names[Op];
+    }
+
+public:
+    ExprProfiler()
+        : LiveOpChildren(0), NumGCs(0), TotalGCMicros(0)
+    {
+        LiveNodes.fill(0);
+        Reset();
+    }
+
+    inline void Reset()
+    {
+        // Live node counts are not reset, they reflect
+        // the nodes that currently exist
+        CacheHits.fill(0);
+        CacheMisses.fill(0);
+        GCPauses.fill(0);
+        NumGCs = 0;
+        TotalGCMicros = 0;
+    }
+
+    inline void NodeCreated(NodeKind Kind)
+    {
+        ++LiveNodes[(u32)Kind];
+    }
+
+    inline void NodeDestroyed(NodeKind Kind)
+    {
+        --LiveNodes[(u32)Kind];
+    }
+
+    inline void OpNodeCreated(i64 OpCode, u64 NumChildren)
+    {
+        ++LiveNodes[(u32)NodeKind::Op];
+        ++LiveOpNodes[OpCode];
+        LiveOpChildren += NumChildren;
+    }
+
+    inline void OpNodeDestroyed(i64 OpCode, u64 NumChildren)
+    {
+        --LiveNodes[(u32)NodeKind::Op];
+        auto it = LiveOpNodes.find(OpCode);
+        if (--(it->second) == 0) {
+            LiveOpNodes.erase(it);
+        }
+        LiveOpChildren -= NumChildren;
+    }
+
+    inline void CacheLookup(CacheOp Op, bool Hit)
+    {
+        if (Hit) {
+            ++CacheHits[(u32)Op];
+        } else {
+            ++CacheMisses[(u32)Op];
+        }
+    }
+
+    inline void GCPause(u64 Micros)
+    {
+        u32 Bucket = 0;
+        while (Bucket < NumGCPauseBuckets - 1 && (Micros >> Bucket) != 0) {
+            ++Bucket;
+        }
+        ++GCPauses[Bucket];
+        ++NumGCs;
+        TotalGCMicros += Micros;
+    }
+
+    inline u64 GetNumLiveNodes(NodeKind Kind) const
+    {
+        return LiveNodes[(u32)Kind];
+    }
+
+    inline u64 GetNumLiveNodes() const
+    {
+        u64 Retval = 0;
+        for (auto Count : LiveNodes) {
+            Retval += Count;
+        }
+        return Retval;
+    }
+
+    inline const map<i64, u64>& GetLiveOpNodes() const
+    {
+        return LiveOpNodes;
+    }
+
+    inline double GetAvgChildrenPerOp() const
+    {
+        auto NumOps = LiveNodes[(u32)NodeKind::Op];
+        return (NumOps == 0 ? 0.0 : (double)LiveOpChildren / NumOps);
+    }
+
+    inline double GetCacheHitRate(CacheOp Op) const
+    {
+        auto Total = CacheHits[(u32)Op] + CacheMisses[(u32)Op];
+        return (Total == 0 ? 0.0 : (double)CacheHits[(u32)Op] / Total);
+    }
+
+    inline const array<u64, NumGCPauseBuckets>& GetGCPauseHistogram() const
+    {
+        return GCPauses;
+    }
+
+    inline string ToJSON() const
+    {
+        ostringstream sstr;
+        sstr << setprecision(6);
+        sstr << "{" << endl << "  \"live_nodes\": {";
+        for (u32 i = 0; i < NumKinds; ++i) {
+            sstr << (i == 0 ? "" : ", ") << "\"" << KindName(i) << "\": "
+                 << LiveNodes[i];
+        }
+        sstr << "}," << endl << "  \"live_op_nodes_by_opcode\": {";
+        bool First = true;
+        for (auto const& OpCount : LiveOpNodes) {
+            sstr << (First ? "" : ", ") << "\"" << OpCount.first << "\": "
+                 << OpCount.second;
+            First = false;
+        }
+        sstr << "}," << endl << "  \"avg_children_per_op\": "
+             << GetAvgChildrenPerOp() << "," << endl << "  \"cache\": {";
+        for (u32 i = 0; i < NumCacheOps; ++i) {
+            sstr << (i == 0 ? "" : ", ") << "\"" << CacheOpName(i) << "\": {"
+                 << "\"hits\": " << CacheHits[i] << ", "
+                 << "\"misses\": " << CacheMisses[i] << ", "
+                 << "\"hit_rate\": " << GetCacheHitRate((CacheOp)i) << "}";
+        }
+        sstr << "}," << endl << "  \"gc\": {\"collections\": " << NumGCs
+             << ", \"total_pause_us\": " << TotalGCMicros
+             << ", \"pause_histogram_us\": [";
+        for (u32 i = 0; i < NumGCPauseBuckets; ++i) {
+            sstr << (i == 0 ? "" : ", ") << GCPauses[i];
+        }
+        sstr << "]}" << endl << "}";
+        return sstr.str();
+    }
+};
+
+// Tree size vs. DAG size of an expression
+struct ExprSharingStats
+{
+    // The tree size can be exponential in the DAG size
+    double TreeSize;
+    u64 DAGSize;
+
+    inline double GetSharingFactor() const
+    {
+        return (DAGSize == 0 ? 1.0 : TreeSize / DAGSize);
+    }
+};
+
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+
+template <typename E, template <typename> class S>
+class TermIndex;
+
+template <typename E, template <typename> class S>
+class BoundVarRewriter;
+
 template <typename E, template <typename> class S>
 class ExprMgr
 {
+    friend class BoundVarRewriter<E, S>;
+    friend class ExpressionBase<E, S>;
+
 public:
     typedef S<E> SemT;
     typedef typename SemT::LExpT LExpT;
@@ -550,19 +889,63 @@ public:
     typedef Expr<E, S> ExpT;
     typedef ExprI<E, S> IExpT;
 
-    typedef unordered_map<ExpT, ExpT, ExpressionPtrHasher> SubstMapT;
+    // Copies share structure, so extending a copy of
+    // a substitution for a nested scope is cheap. Keys are
+    // hashed structurally, so the iteration order does not
+    // depend on where the expressions were allocated
+    typedef PersistentMap<ExpT, ExpT, ExpressionPtrHasher> SubstMapT;
 
     typedef RefCache<ExpressionBase<E, S>, ExpressionPtrHasher,
                      FastExpressionPtrEquals, CSmartPtr> ExpCacheT;
 
     typedef unordered_set<ExpT, ExpressionPtrHasher, FastExpressionPtrEquals> ExpSetT;
 
+    typedef TermIndex<E, S> TermIndexT;
+
 private:
     SemT* Sem;
+#if defined KINARA_CFG_LOGGING_BUILD_
+    // Shared with every expression created by this manager,
+    // the destructors of the expressions update it
+    shared_ptr<ExprProfiler> Profiler;
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
     ExpCacheT ExpCache;
     ExpT TrueExp;
     ExpT FalseExp;
-    volatile bool Interrupted;
+    // Interrupt() may be called from another thread. The flag
+    // guards no other data, so relaxed loads and stores suffice
+    atomic<bool> Interrupted;
+    TransformBudget Budget;
+
+    class ShiftKeyT
+    {
+    public:
+        ExpT Exp;
+        i64 Offset;
+        u64 Cutoff;
+
+        inline bool operator == (const ShiftKeyT& Other) const
+        {
+            return (Exp == Other.Exp && Offset == Other.Offset &&
+                    Cutoff == Other.Cutoff);
+        }
+    };
+
+    class ShiftKeyHasherT
+    {
+    public:
+        inline u64 operator () (const ShiftKeyT& Key) const
+        {
+            u64 Retval = Key.Exp->Hash();
+            boost::hash_combine(Retval, Key.Offset);
+            boost::hash_combine(Retval, Key.Cutoff);
+            return Retval;
+        }
+    };
+
+    // Memoized results of ShiftBoundVars, cleared on GC
+    // because the entries keep the expressions alive
+    unordered_map<ShiftKeyT, ExpT, ShiftKeyHasherT> ShiftCache;
 
     inline void CheckMgr(const vector<ExpT>& Children) const;
     inline void CheckMgr(const ExpT& Exp) const;
@@ -639,14 +1022,44 @@ public:
     inline ExpT SimplifyFP(const ExpT& Exp);
     inline ExpT Substitute(const SubstMapT& Subst, const ExpT& Exp);
     inline ExpT TermSubstitute(const SubstMapT& Subst, const ExpT& Exp);
+    // Replaces the outermost subterms of Exp that match a pattern
+    // in Rules, the replacements are not rewritten any further
+    inline ExpT Rewrite(const TermIndexT& Rules, const ExpT& Exp);
     inline ExpT BoundSubstitute(const SubstMapT& Subst, const ExpT& Exp);
+
+    // Operations on the de Bruijn indices of the bound variables
+    // that are free in an expression. Subexpressions without such
+    // variables are returned as is, without being traversed.
+    // Adds Offset to every free index that is >= Cutoff, the
+    // results are memoized until the next GC
+    inline ExpT ShiftBoundVars(const ExpT& Exp, i64 Offset, u64 Cutoff = 0);
+    // Replaces the free index i with Terms[i], for i < Terms.size(),
+    // and lowers the remaining free indices by Terms.size()
+    inline ExpT OpenBoundVars(const ExpT& Exp, const vector<ExpT>& Terms);
+    // Replaces the variable Vars[i] with the index i, and raises the
+    // existing free indices by Vars.size()
+    inline ExpT CloseBoundVars(const ExpT& Exp, const vector<ExpT>& Vars);
     inline ExpSetT
     Gather(const ExpT& Exp,
            const function<bool(const ExpressionBase<E, S>*)>& Pred) const;
 
     inline void GC();
+
+    // Interruption is sticky until cleared. Transforms check
+    // for it (and for the budget) every few nodes and throw
+    // ExprTransformAborted, except SimplifyFP, which returns
+    // the last fully simplified expression
     inline void Interrupt();
+    inline void ClearInterrupt();
     inline bool IsInterrupted() const;
+    inline void SetTransformBudget(const TransformBudget& NewBudget);
+    inline const TransformBudget& GetTransformBudget() const;
+
+#if defined KINARA_CFG_LOGGING_BUILD_
+    inline ExprProfiler& GetProfiler();
+    inline const ExprProfiler& GetProfiler() const;
+    inline ExprSharingStats GetSharingStats(const ExpT& Exp) const;
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 
     static inline ExprMgr* Make();
 };
@@ -658,11 +1071,22 @@ class ExpressionVisitorBase
 {
 private:
     string Name;
+    bool Budgeted;
+    u64 NumNodesVisited;
+    chrono::steady_clock::time_point StartTime;
 
 public:
-    ExpressionVisitorBase(const string& Name);
+    // Visitors that only inspect expressions, such as the ones
+    // gathering statistics, are not budgeted and never aborted
+    ExpressionVisitorBase(const string& Name, bool Budgeted = true);
     virtual ~ExpressionVisitorBase();
     const string& GetName() const;
+    inline u64 GetNumNodesVisited() const;
+
+    // Called by every expression before it dispatches to this
+    // visitor, throws ExprTransformAborted when the visitor
+    // must stop
+    inline void Checkpoint(const ExprMgr<E, S>* Mgr);
 
     virtual void VisitConstExpression(const ConstExpression<E, S>* Exp);
     virtual void VisitVarExpression(const VarExpression<E, S>* Exp);
@@ -705,7 +1129,112 @@ public:
                           const SubstMapT& SubstMap);
 };
 
-// A term substitutor
+// A discrimination tree over expressions. An entry is keyed by
+// the preorder sequence of the symbols in its pattern: an op
+// expression contributes its (opcode, arity) pair and every other
+// expression contributes itself, since they are all interned.
+// Pattern variables become wildcards that match any subterm, so
+// the index supports both exact and pattern lookups. A lookup
+// walks the query term down the tree and most terms that do not
+// match any pattern are rejected at their root symbol.
+// Quantified expressions are treated as atomic symbols, i.e.,
+// patterns do not look inside binders.
+template <typename E, template <typename> class S>
+class TermIndex
+{
+public:
+    typedef Expr<E, S> ExpT;
+    typedef typename ExprMgr<E, S>::SubstMapT SubstMapT;
+    typedef typename ExprMgr<E, S>::ExpSetT ExpSetT;
+
+private:
+    typedef const ExpressionBase<E, S>* ExpPtrT;
+
+    class Symbol
+    {
+    public:
+        ExpPtrT Atom;
+        i64 OpCode;
+        u64 Arity;
+        bool IsWildcard;
+
+        inline Symbol(ExpPtrT Atom, i64 OpCode, u64 Arity, bool IsWildcard);
+        inline bool operator == (const Symbol& Other) const;
+    };
+
+    class SymbolHasher
+    {
+    public:
+        inline u64 operator () (const Symbol& Sym) const;
+    };
+
+    class Entry
+    {
+    public:
+        ExpT Pattern;
+        ExpT Replacement;
+        // The pattern variable for each wildcard on the path, in preorder,
+        // and the position of the first wildcard for the same variable
+        vector<ExpT> PatternVars;
+        vector<u32> FirstOccurrence;
+        // The number of wildcards that repeat an earlier pattern variable
+        u32 NumRepeated;
+    };
+
+    class Node
+    {
+    public:
+        unordered_map<Symbol, Node*, SymbolHasher> Children;
+        Node* WildcardChild;
+        vector<Entry> Entries;
+
+        inline Node();
+        inline ~Node();
+    };
+
+    Node* Root;
+    u64 NumEntries;
+    u64 NumPatterns;
+
+    static inline Symbol GetSymbol(ExpPtrT Exp);
+    static inline void Flatten(const ExpT& Exp, const ExpSetT& PatternVars,
+                               vector<Symbol>& Symbols, vector<ExpT>& Wildcards);
+    inline const Entry* Retrieve(const Node* CurNode, bool ExactOnly,
+                                 vector<ExpPtrT>& Pending,
+                                 vector<ExpPtrT>& Matched) const;
+
+public:
+    inline TermIndex();
+    inline TermIndex(const SubstMapT& SubstMap);
+    TermIndex(const TermIndex& Other) = delete;
+    TermIndex& operator = (const TermIndex& Other) = delete;
+    inline ~TermIndex();
+
+    // Subterms of Pattern that are in PatternVars match any term.
+    // Inserting a pattern that is already present replaces the
+    // existing replacement
+    inline void Insert(const ExpT& Pattern, const ExpT& Replacement,
+                       const ExpSetT& PatternVars = ExpSetT());
+    inline u64 Size() const;
+    // true if some pattern in the index has pattern variables
+    inline bool HasPatternVars() const;
+
+    // Returns the replacement for a pattern without variables that
+    // is identical to Exp, or ExpT::NullPtr if there is none
+    inline ExpT FindExact(const ExpressionBase<E, S>* Exp) const;
+    // Finds a pattern that matches Exp and binds its pattern variables.
+    // Returns false if no pattern matches Exp. Symbols are preferred
+    // over wildcards in preorder, and of the patterns with the same
+    // symbols, the ones that repeat more pattern variables, e.g.,
+    // f(x, x) over f(x, y). So the pattern found is never more general
+    // than another pattern that also matches Exp
+    inline bool Find(const ExpressionBase<E, S>* Exp, ExpT& Replacement,
+                     SubstMapT& Bindings) const;
+};
+
+// A term substitutor, also used for pattern based rewriting.
+// A plain substitution looks each term up in its map, only a
+// rewrite with a prebuilt index walks the index
 template <typename E, template <typename> class S>
 class TermSubstitutor : public ExpressionVisitorBase<E, S>
 {
@@ -713,13 +1242,18 @@ protected:
     typedef ExprMgr<E, S> MgrType;
     typedef typename MgrType::ExpT ExpT;
     typedef typename MgrType::SubstMapT SubstMapT;
+    typedef typename MgrType::TermIndexT TermIndexT;
 
     MgrType* Mgr;
     SubstMapT SubstMap;
+    const TermIndexT* Index;
     stack<ExpT> ExpStack;
 
+    inline bool TrySubstitute(const ExpressionBase<E, S>* Exp);
+
 public:
     inline TermSubstitutor(MgrType* Mgr, const SubstMapT& Subst);
+    inline TermSubstitutor(MgrType* Mgr, const TermIndexT& Index);
     inline virtual ~TermSubstitutor();
 
     inline virtual void VisitVarExpression(const VarExpression<E, S>* Exp) override;
@@ -735,6 +1269,9 @@ public:
     inline static ExpT Do(MgrType* Mgr,
                           const ExpT& Exp,
                           const SubstMapT& SubstMap);
+    inline static ExpT Do(MgrType* Mgr,
+                          const ExpT& Exp,
+                          const TermIndexT& Index);
 };
 
 // A term substitutor for substituting a term with bound de-bruijn vars
@@ -771,6 +1308,58 @@ public:
                           const SubstMapT& SubstMap);
 };
 
+// Shifts, opens or closes the free de Bruijn indices of an
+// expression, see ExprMgr::ShiftBoundVars and friends
+template <typename E, template <typename> class S>
+class BoundVarRewriter : ExpressionVisitorBase<E, S>
+{
+public:
+    enum class Mode
+    {
+        Shift,
+        Open,
+        Close
+    };
+
+private:
+    typedef ExprMgr<E, S> MgrType;
+    typedef typename MgrType::ExpT ExpT;
+    typedef const ExpressionBase<E, S>* ExpPtrT;
+
+    MgrType* Mgr;
+    Mode TheMode;
+    i64 Offset;
+    u64 Cutoff;
+    const vector<ExpT>* Terms;
+    u64 Depth;
+    stack<ExpT> ExpStack;
+    // Results for Open and Close, per binder depth
+    vector<unordered_map<ExpPtrT, ExpT>> Memo;
+
+    inline BoundVarRewriter(MgrType* Mgr, Mode TheMode, i64 Offset,
+                            u64 Cutoff, const vector<ExpT>* Terms);
+
+    inline bool TryShortcut(ExpPtrT Exp);
+    inline void PushResult(ExpPtrT Exp, const ExpT& Result);
+
+public:
+    inline virtual ~BoundVarRewriter();
+
+    inline virtual void VisitVarExpression(const VarExpression<E, S>* Exp) override;
+    inline virtual void VisitConstExpression(const ConstExpression<E, S>* Exp) override;
+    inline virtual void VisitBoundVarExpression(const BoundVarExpression<E, S>* Exp)
+        override;
+    inline virtual void VisitOpExpression(const OpExpression<E, S>* Exp) override;
+    inline virtual void VisitEQuantifiedExpression(const EQuantifiedExpression<E, S>* Exp)
+        override;
+    inline virtual void VisitAQuantifiedExpression(const AQuantifiedExpression<E, S>* Exp)
+        override;
+
+    inline static ExpT Do(MgrType* Mgr, const ExpT& Exp, i64 Offset, u64 Cutoff);
+    inline static ExpT Do(MgrType* Mgr, const ExpT& Exp, Mode TheMode,
+                          const vector<ExpT>& Terms);
+};
+
 template <typename E, template <typename> class S>
 class Gatherer : ExpressionVisitorBase<E, S>
 {
@@ -798,9 +1387,43 @@ public:
     Do(const ExpT& Exp, const function<bool(const ExpressionBase<E, S>*)>& Pred);
 };
 
+#if defined KINARA_CFG_LOGGING_BUILD_
+
+// Computes the tree size of an expression, visiting each
+// shared subexpression only once
 template <typename E, template <typename> class S>
-ExpressionVisitorBase<E, S>::ExpressionVisitorBase(const string& Name)
-    : Name(Name)
+class SharingCounter : ExpressionVisitorBase<E, S>
+{
+private:
+    typedef Expr<E, S> ExpT;
+    unordered_map<const ExpressionBase<E, S>*, double> TreeSizes;
+
+    inline bool Visited(const ExpressionBase<E, S>* Exp) const;
+    inline double GetTreeSize(const ExpT& Exp) const;
+
+public:
+    inline SharingCounter();
+    inline virtual ~SharingCounter();
+
+    inline virtual void VisitVarExpression(const VarExpression<E, S>* Exp) override;
+    inline virtual void VisitConstExpression(const ConstExpression<E, S>* Exp) override;
+    inline virtual void VisitBoundVarExpression(const BoundVarExpression<E, S>* Exp)
+        override;
+    inline virtual void VisitOpExpression(const OpExpression<E, S>* Exp) override;
+    inline virtual void VisitEQuantifiedExpression(const EQuantifiedExpression<E, S>* Exp)
+        override;
+    inline virtual void VisitAQuantifiedExpression(const AQuantifiedExpression<E, S>* Exp)
+        override;
+
+    static inline ExprSharingStats Do(const ExpT& Exp);
+};
+
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+
+template <typename E, template <typename> class S>
+ExpressionVisitorBase<E, S>::ExpressionVisitorBase(const string& Name, bool Budgeted)
+    : Name(Name), Budgeted(Budgeted), NumNodesVisited(0),
+      StartTime(chrono::steady_clock::now())
 {
     // Nothing here
 }
@@ -817,6 +1440,42 @@ const string& ExpressionVisitorBase<E, S>::GetName() const
     return Name;
 }
 
+template <typename E, template <typename> class S>
+inline u64 ExpressionVisitorBase<E, S>::GetNumNodesVisited() const
+{
+    return NumNodesVisited;
+}
+
+template <typename E, template <typename> class S>
+inline void ExpressionVisitorBase<E, S>::Checkpoint(const ExprMgr<E, S>* Mgr)
+{
+    ++NumNodesVisited;
+    if (!Budgeted) {
+        return;
+    }
+    auto const& Budget = Mgr->GetTransformBudget();
+
+    if (Budget.MaxNodes != 0 && NumNodesVisited > Budget.MaxNodes) {
+        throw ExprTransformAborted(TransformAbortReason::NodeBudgetExhausted,
+                                   NumNodesVisited);
+    }
+    if (Budget.CheckInterval > 1 && NumNodesVisited % Budget.CheckInterval != 0) {
+        return;
+    }
+    if (Mgr->IsInterrupted()) {
+        throw ExprTransformAborted(TransformAbortReason::Interrupted,
+                                   NumNodesVisited);
+    }
+    if (Budget.MaxMillis != 0) {
+        auto Elapsed = chrono::steady_clock::now() - StartTime;
+        if ((u64)chrono::duration_cast<chrono::milliseconds>(Elapsed).count() >=
+            Budget.MaxMillis) {
+            throw ExprTransformAborted(TransformAbortReason::TimeBudgetExhausted,
+                                       NumNodesVisited);
+        }
+    }
+}
+
 template <typename E, template <typename> class S>
 void ExpressionVisitorBase<E, S>::VisitConstExpression(const ConstExpression<E, S>* Exp)
 {
@@ -964,6 +1623,265 @@ Substitutor<E, S>::Do(MgrType* Mgr,
     return TheSubstitutor.SubstStack[0];
 }
 
+// TermIndex implementation
+template <typename E, template <typename> class S>
+inline TermIndex<E, S>::Symbol::Symbol(ExpPtrT Atom, i64 OpCode,
+                                       u64 Arity, bool IsWildcard)
+    : Atom(Atom), OpCode(OpCode), Arity(Arity), IsWildcard(IsWildcard)
+{
+    // Nothing here
+}
+
+template <typename E, template <typename> class S>
+inline bool TermIndex<E, S>::Symbol::operator == (const Symbol& Other) const
+{
+    return (Atom == Other.Atom && OpCode == Other.OpCode &&
+            Arity == Other.Arity && IsWildcard == Other.IsWildcard);
+}
+
+template <typename E, template <typename> class S>
+inline u64 TermIndex<E, S>::SymbolHasher::operator () (const Symbol& Sym) const
+{
+    if (Sym.Atom != nullptr) {
+        return Sym.Atom->Hash();
+    }
+    u64 Retval = 0;
+    boost::hash_combine(Retval, Sym.OpCode);
+    boost::hash_combine(Retval, Sym.Arity);
+    return Retval;
+}
+
+template <typename E, template <typename> class S>
+inline TermIndex<E, S>::Node::Node()
+    : WildcardChild(nullptr)
+{
+    // Nothing here
+}
+
+template <typename E, template <typename> class S>
+inline TermIndex<E, S>::Node::~Node()
+{
+    for (auto const& Child : Children) {
+        delete Child.second;
+    }
+    delete WildcardChild;
+}
+
+template <typename E, template <typename> class S>
+inline TermIndex<E, S>::TermIndex()
+    : Root(new Node()), NumEntries(0), NumPatterns(0)
+{
+    // Nothing here
+}
+
+template <typename E, template <typename> class S>
+inline TermIndex<E, S>::TermIndex(const SubstMapT& SubstMap)
+    : TermIndex()
+{
+    for (auto const& SubstEntry : SubstMap) {
+        Insert(SubstEntry.first, SubstEntry.second);
+    }
+}
+
+template <typename E, template <typename> class S>
+inline TermIndex<E, S>::~TermIndex()
+{
+    delete Root;
+}
+
+template <typename E, template <typename> class S>
+inline typename TermIndex<E, S>::Symbol
+TermIndex<E, S>::GetSymbol(ExpPtrT Exp)
+{
+    auto ExpAsOp = Exp->template As<OpExpression>();
+    if (ExpAsOp != nullptr) {
+        return Symbol(nullptr, ExpAsOp->GetOpCode(),
+                      ExpAsOp->GetChildren().size(), false);
+    } else {
+        return Symbol(Exp, 0, 0, false);
+    }
+}
+
+template <typename E, template <typename> class S>
+inline void TermIndex<E, S>::Flatten(const ExpT& Exp, const ExpSetT& PatternVars,
+                                     vector<Symbol>& Symbols,
+                                     vector<ExpT>& Wildcards)
+{
+    if (PatternVars.find(Exp) != PatternVars.end()) {
+        Symbols.push_back(Symbol(nullptr, 0, 0, true));
+        Wildcards.push_back(Exp);
+        return;
+    }
+    Symbols.push_back(GetSymbol(Exp));
+    auto ExpAsOp = Exp->template As<OpExpression>();
+    if (ExpAsOp != nullptr) {
+        for (auto const& Child : ExpAsOp->GetChildren()) {
+            Flatten(Child, PatternVars, Symbols, Wildcards);
+        }
+    }
+}
+
+template <typename E, template <typename> class S>
+inline void TermIndex<E, S>::Insert(const ExpT& Pattern, const ExpT& Replacement,
+                                    const ExpSetT& PatternVars)
+{
+    vector<Symbol> Symbols;
+    vector<ExpT> Wildcards;
+    Flatten(Pattern, PatternVars, Symbols, Wildcards);
+
+    Node* CurNode = Root;
+    for (auto const& Sym : Symbols) {
+        Node*& NextNode = (Sym.IsWildcard ? CurNode->WildcardChild :
+                           CurNode->Children[Sym]);
+        if (NextNode == nullptr) {
+            NextNode = new Node();
+        }
+        CurNode = NextNode;
+    }
+
+    for (auto& OldEntry : CurNode->Entries) {
+        if (OldEntry.Pattern == Pattern) {
+            OldEntry.Replacement = Replacement;
+            return;
+        }
+    }
+
+    Entry NewEntry;
+    NewEntry.Pattern = Pattern;
+    NewEntry.Replacement = Replacement;
+    NewEntry.PatternVars = Wildcards;
+    NewEntry.NumRepeated = 0;
+    const u32 NumWildcards = Wildcards.size();
+    for (u32 i = 0; i < NumWildcards; ++i) {
+        u32 First = i;
+        for (u32 j = 0; j < i; ++j) {
+            if (Wildcards[j] == Wildcards[i]) {
+                First = j;
+                ++NewEntry.NumRepeated;
+                break;
+            }
+        }
+        NewEntry.FirstOccurrence.push_back(First);
+    }
+
+    // The entries at a node differ only in which wildcards are
+    // bound to the same variable. An entry that is more specific
+    // than another repeats more variables, so keeping the entries
+    // ordered by the number of repeats tries it first
+    auto Pos = CurNode->Entries.begin();
+    while (Pos != CurNode->Entries.end() && Pos->NumRepeated >= NewEntry.NumRepeated) {
+        ++Pos;
+    }
+    CurNode->Entries.insert(Pos, NewEntry);
+    ++NumEntries;
+    if (NumWildcards > 0) {
+        ++NumPatterns;
+    }
+}
+
+template <typename E, template <typename> class S>
+inline u64 TermIndex<E, S>::Size() const
+{
+    return NumEntries;
+}
+
+template <typename E, template <typename> class S>
+inline bool TermIndex<E, S>::HasPatternVars() const
+{
+    return (NumPatterns > 0);
+}
+
+// Pending holds the subterms of the query that remain to be
+// matched, in reverse preorder. Matched holds the subterms that
+// were matched by the wildcards on the path to CurNode, and is
+// left holding the bindings of the entry found, if any.
+// Symbol edges are tried before wildcard edges, so that more
+// specific patterns are found first
+template <typename E, template <typename> class S>
+inline const typename TermIndex<E, S>::Entry*
+TermIndex<E, S>::Retrieve(const Node* CurNode, bool ExactOnly,
+                          vector<ExpPtrT>& Pending,
+                          vector<ExpPtrT>& Matched) const
+{
+    if (Pending.size() == 0) {
+        for (auto const& CurEntry : CurNode->Entries) {
+            const u32 NumWildcards = CurEntry.FirstOccurrence.size();
+            bool Consistent = true;
+            for (u32 i = 0; i < NumWildcards && Consistent; ++i) {
+                Consistent = (Matched[i] == Matched[CurEntry.FirstOccurrence[i]]);
+            }
+            if (Consistent) {
+                return &CurEntry;
+            }
+        }
+        return nullptr;
+    }
+
+    const Entry* Retval = nullptr;
+    auto Term = Pending.back();
+    Pending.pop_back();
+
+    auto it = CurNode->Children.find(GetSymbol(Term));
+    if (it != CurNode->Children.end()) {
+        auto TermAsOp = Term->template As<OpExpression>();
+        u32 NumChildren = 0;
+        if (TermAsOp != nullptr) {
+            auto const& Children = TermAsOp->GetChildren();
+            NumChildren = Children.size();
+            for (u32 i = 0; i < NumChildren; ++i) {
+                Pending.push_back(Children[NumChildren - i - 1]);
+            }
+        }
+        Retval = Retrieve(it->second, ExactOnly, Pending, Matched);
+        Pending.resize(Pending.size() - NumChildren);
+    }
+
+    if (Retval == nullptr && !ExactOnly && CurNode->WildcardChild != nullptr) {
+        Matched.push_back(Term);
+        Retval = Retrieve(CurNode->WildcardChild, ExactOnly, Pending, Matched);
+        if (Retval == nullptr) {
+            Matched.pop_back();
+        }
+    }
+
+    Pending.push_back(Term);
+    return Retval;
+}
+
+template <typename E, template <typename> class S>
+inline typename TermIndex<E, S>::ExpT
+TermIndex<E, S>::FindExact(const ExpressionBase<E, S>* Exp) const
+{
+    vector<ExpPtrT> Pending(1, Exp);
+    vector<ExpPtrT> Matched;
+    auto Found = Retrieve(Root, true, Pending, Matched);
+    if (Found == nullptr) {
+        return ExpT::NullPtr;
+    }
+    return Found->Replacement;
+}
+
+template <typename E, template <typename> class S>
+inline bool TermIndex<E, S>::Find(const ExpressionBase<E, S>* Exp,
+                                  ExpT& Replacement,
+                                  SubstMapT& Bindings) const
+{
+    vector<ExpPtrT> Pending(1, Exp);
+    vector<ExpPtrT> Matched;
+    auto Found = Retrieve(Root, false, Pending, Matched);
+    if (Found == nullptr) {
+        return false;
+    }
+
+    Replacement = Found->Replacement;
+    Bindings.clear();
+    const u32 NumWildcards = Found->PatternVars.size();
+    for (u32 i = 0; i < NumWildcards; ++i) {
+        Bindings[Found->PatternVars[i]] = Matched[i];
+    }
+    return true;
+}
+
 // Term substitutor implementation
 
 // Assumptions on the substmap:
@@ -978,7 +1896,7 @@ template <typename E, template <typename> class S>
 inline TermSubstitutor<E, S>::TermSubstitutor(MgrType* Mgr,
                                               const SubstMapT& SubstMap)
     : ExpressionVisitorBase<E, S>("TermSubstitutor"),
-      Mgr(Mgr), SubstMap(SubstMap)
+      Mgr(Mgr), SubstMap(SubstMap), Index(nullptr)
 {
     // for (auto it1 = SubstMap.begin(); it1 != SubstMap.end(); ++it1) {
     //     auto const& From1 = it1->first;
@@ -1030,6 +1948,15 @@ inline TermSubstitutor<E, S>::TermSubstitutor(MgrType* Mgr,
     // }
 }
 
+template <typename E, template <typename> class S>
+inline TermSubstitutor<E, S>::TermSubstitutor(MgrType* Mgr,
+                                              const TermIndexT& Index)
+    : ExpressionVisitorBase<E, S>("TermSubstitutor"),
+      Mgr(Mgr), Index(&Index)
+{
+    // Nothing here
+}
+
 template <typename E, template <typename> class S>
 inline TermSubstitutor<E, S>::~TermSubstitutor()
 {
@@ -1037,13 +1964,46 @@ inline TermSubstitutor<E, S>::~TermSubstitutor()
 }
 
 template <typename E, template <typename> class S>
-inline void
-TermSubstitutor<E, S>::VisitVarExpression(const VarExpression<E, S>* Exp)
+inline bool
+TermSubstitutor<E, S>::TrySubstitute(const ExpressionBase<E, S>* Exp)
 {
-    auto it = SubstMap.find(Exp);
-    if (it != SubstMap.end()) {
+    if (Index == nullptr) {
+        auto it = SubstMap.find(Exp);
+        if (it == SubstMap.end()) {
+            return false;
+        }
         ExpStack.push(it->second);
+        return true;
+    }
+
+    // an index without pattern variables needs no bindings
+    if (!Index->HasPatternVars()) {
+        auto Replacement = Index->FindExact(Exp);
+        if (Replacement == ExpT::NullPtr) {
+            return false;
+        }
+        ExpStack.push(Replacement);
+        return true;
+    }
+
+    ExpT Replacement;
+    SubstMapT Bindings;
+    if (!Index->Find(Exp, Replacement, Bindings)) {
+        return false;
+    }
+    if (Bindings.size() == 0) {
+        ExpStack.push(Replacement);
     } else {
+        ExpStack.push(Mgr->Substitute(Bindings, Replacement));
+    }
+    return true;
+}
+
+template <typename E, template <typename> class S>
+inline void
+TermSubstitutor<E, S>::VisitVarExpression(const VarExpression<E, S>* Exp)
+{
+    if (!TrySubstitute(Exp)) {
         ExpStack.push(Exp);
     }
 }
@@ -1052,10 +2012,7 @@ template <typename E, template <typename> class S>
 inline void
 TermSubstitutor<E, S>::VisitBoundVarExpression(const BoundVarExpression<E, S>* Exp)
 {
-    auto it = SubstMap.find(Exp);
-    if (it != SubstMap.end()) {
-        ExpStack.push(it->second);
-    } else {
+    if (!TrySubstitute(Exp)) {
         ExpStack.push(Exp);
     }
 }
@@ -1064,10 +2021,7 @@ template <typename E, template <typename> class S>
 inline void
 TermSubstitutor<E, S>::VisitConstExpression(const ConstExpression<E, S>* Exp)
 {
-    auto it = SubstMap.find(Exp);
-    if (it != SubstMap.end()) {
-        ExpStack.push(it->second);
-    } else {
+    if (!TrySubstitute(Exp)) {
         ExpStack.push(Exp);
     }
 }
@@ -1076,10 +2030,7 @@ template <typename E, template <typename> class S>
 inline void
 TermSubstitutor<E, S>::VisitOpExpression(const OpExpression<E, S>* Exp)
 {
-    auto it = SubstMap.find(Exp);
-    if (it != SubstMap.end()) {
-        ExpStack.push(it->second);
-    } else {
+    if (!TrySubstitute(Exp)) {
         ExpressionVisitorBase<E, S>::VisitOpExpression(Exp);
         auto const& OldChildren = Exp->GetChildren();
         const u32 NumChildren = OldChildren.size();
@@ -1130,6 +2081,16 @@ TermSubstitutor<E, S>::Do(MgrType* Mgr, const ExpT& Exp,
     return TheSubstitutor.ExpStack.top();
 }
 
+template <typename E, template <typename> class S>
+inline typename TermSubstitutor<E, S>::ExpT
+TermSubstitutor<E, S>::Do(MgrType* Mgr, const ExpT& Exp,
+                          const TermIndexT& Index)
+{
+    TermSubstitutor TheSubstitutor(Mgr, Index);
+    Exp->Accept(&TheSubstitutor);
+    return TheSubstitutor.ExpStack.top();
+}
+
 // BoundSubstitutor implementation
 template <typename E, template <typename> class S>
 inline BoundSubstitutor<E, S>::BoundSubstitutor(MgrType* Mgr,
@@ -1229,86 +2190,305 @@ BoundSubstitutor<E, S>::TrySubstitute(const ExpressionBase<E, S>* Exp)
 }
 
 template <typename E, template <typename> class S>
-inline void
-BoundSubstitutor<E, S>::VisitVarExpression(const VarExpression<E, S>* Exp)
+inline void
+BoundSubstitutor<E, S>::VisitVarExpression(const VarExpression<E, S>* Exp)
+{
+    if (TrySubstitute(Exp)) {
+        return;
+    } else {
+        this->ExpStack.push(Exp);
+    }
+}
+
+template <typename E, template <typename> class S>
+inline void
+BoundSubstitutor<E, S>::VisitConstExpression(const ConstExpression<E, S>* Exp)
+{
+    if (TrySubstitute(Exp)) {
+        return;
+    } else {
+        this->ExpStack.push(Exp);
+    }
+}
+
+template <typename E, template <typename> class S>
+inline void
+BoundSubstitutor<E, S>::VisitBoundVarExpression(const BoundVarExpression<E, S>* Exp)
+{
+    this->ExpStack.push(Exp);
+}
+
+template <typename E, template <typename> class S>
+inline void
+BoundSubstitutor<E, S>::VisitOpExpression(const OpExpression<E, S>* Exp)
+{
+    if (TrySubstitute(Exp)) {
+        return;
+    } else {
+        ExpressionVisitorBase<E, S>::VisitOpExpression(Exp);
+        auto const& OldChildren = Exp->GetChildren();
+        auto const NumChildren = OldChildren.size();
+        vector<ExpT> NewChildren(NumChildren);
+
+        for (u32 i = 0; i < NumChildren; ++i) {
+            NewChildren[NumChildren - i - 1] = this->ExpStack.top();
+            this->ExpStack.pop();
+        }
+
+        this->ExpStack.push(this->Mgr->MakeExpr(Exp->GetOpCode(), NewChildren));
+    }
+}
+
+template <typename E, template <typename> class S>
+inline void
+BoundSubstitutor<E, S>::VisitEQuantifiedExpression(const EQuantifiedExpression<E, S>* Exp)
+{
+    OffsetToAdd += Exp->GetQVarTypes().size();
+    Exp->GetQExpression()->Accept(this);
+    auto NewQExpr = this->ExpStack.top();
+    this->ExpStack.pop();
+    this->ExpStack.push(this->Mgr->MakeExists(Exp->GetQVarTypes(), NewQExpr));
+    OffsetToAdd -= Exp->GetQVarTypes().size();
+}
+
+template <typename E, template <typename> class S>
+inline void
+BoundSubstitutor<E, S>::VisitAQuantifiedExpression(const AQuantifiedExpression<E, S>* Exp)
+{
+    OffsetToAdd += Exp->GetQVarTypes().size();
+    Exp->GetQExpression()->Accept(this);
+    auto NewQExpr = this->ExpStack.top();
+    this->ExpStack.pop();
+    this->ExpStack.push(this->Mgr->MakeForAll(Exp->GetQVarTypes(), NewQExpr));
+    OffsetToAdd -= Exp->GetQVarTypes().size();
+}
+
+template <typename E, template <typename> class S>
+inline typename BoundSubstitutor<E, S>::ExpT
+BoundSubstitutor<E, S>::Do(MgrType* Mgr, const ExpT& Exp, const SubstMapT& SubstMap)
+{
+    BoundSubstitutor TheSubstitutor(Mgr, SubstMap);
+    Exp->Accept(&TheSubstitutor);
+    return TheSubstitutor.ExpStack.top();
+}
+
+// BoundVarRewriter implementation
+template <typename E, template <typename> class S>
+inline BoundVarRewriter<E, S>::BoundVarRewriter(MgrType* Mgr, Mode TheMode,
+                                                i64 Offset, u64 Cutoff,
+                                                const vector<ExpT>* Terms)
+    : ExpressionVisitorBase<E, S>("BoundVarRewriter"),
+      Mgr(Mgr), TheMode(TheMode), Offset(Offset), Cutoff(Cutoff),
+      Terms(Terms), Depth(0)
+{
+    // Nothing here
+}
+
+template <typename E, template <typename> class S>
+inline BoundVarRewriter<E, S>::~BoundVarRewriter()
+{
+    // Nothing here
+}
+
+// Pushes the result for Exp if it is already known
+template <typename E, template <typename> class S>
+inline bool BoundVarRewriter<E, S>::TryShortcut(ExpPtrT Exp)
+{
+    if (TheMode != Mode::Close &&
+        Exp->GetMaxFreeBoundIdx() < (i64)(Cutoff + Depth)) {
+        ExpStack.push(Exp);
+        return true;
+    }
+
+    if (TheMode == Mode::Shift) {
+        typename MgrType::ShiftKeyT Key { Exp, Offset, Cutoff + Depth };
+        auto it = Mgr->ShiftCache.find(Key);
+        if (it != Mgr->ShiftCache.end()) {
+            ExpStack.push(it->second);
+            return true;
+        }
+        return false;
+    }
+
+    if (Memo.size() <= Depth) {
+        return false;
+    }
+    auto it = Memo[Depth].find(Exp);
+    if (it != Memo[Depth].end()) {
+        ExpStack.push(it->second);
+        return true;
+    }
+    return false;
+}
+
+template <typename E, template <typename> class S>
+inline void BoundVarRewriter<E, S>::PushResult(ExpPtrT Exp, const ExpT& Result)
 {
-    if (TrySubstitute(Exp)) {
-        return;
+    if (TheMode == Mode::Shift) {
+        typename MgrType::ShiftKeyT Key { Exp, Offset, Cutoff + Depth };
+        Mgr->ShiftCache[Key] = Result;
     } else {
-        this->ExpStack.push(Exp);
+        if (Memo.size() <= Depth) {
+            Memo.resize(Depth + 1);
+        }
+        Memo[Depth][Exp] = Result;
     }
+    ExpStack.push(Result);
 }
 
 template <typename E, template <typename> class S>
 inline void
-BoundSubstitutor<E, S>::VisitConstExpression(const ConstExpression<E, S>* Exp)
-{
-    if (TrySubstitute(Exp)) {
-        return;
-    } else {
-        this->ExpStack.push(Exp);
+BoundVarRewriter<E, S>::VisitVarExpression(const VarExpression<E, S>* Exp)
+{
+    if (TheMode == Mode::Close) {
+        const u32 NumVars = Terms->size();
+        for (u32 i = 0; i < NumVars; ++i) {
+            if ((*Terms)[i] == Exp) {
+                ExpStack.push(Mgr->MakeBoundVar(Exp->GetVarType(), i + Depth));
+                return;
+            }
+        }
     }
+    ExpStack.push(Exp);
 }
 
 template <typename E, template <typename> class S>
 inline void
-BoundSubstitutor<E, S>::VisitBoundVarExpression(const BoundVarExpression<E, S>* Exp)
+BoundVarRewriter<E, S>::VisitConstExpression(const ConstExpression<E, S>* Exp)
 {
-    this->ExpStack.push(Exp);
+    ExpStack.push(Exp);
 }
 
 template <typename E, template <typename> class S>
 inline void
-BoundSubstitutor<E, S>::VisitOpExpression(const OpExpression<E, S>* Exp)
+BoundVarRewriter<E, S>::VisitBoundVarExpression(const BoundVarExpression<E, S>* Exp)
 {
-    if (TrySubstitute(Exp)) {
+    const i64 VarIdx = Exp->GetVarIdx();
+    if (VarIdx < (i64)(Cutoff + Depth)) {
+        ExpStack.push(Exp);
         return;
-    } else {
-        ExpressionVisitorBase<E, S>::VisitOpExpression(Exp);
-        auto const& OldChildren = Exp->GetChildren();
-        auto const NumChildren = OldChildren.size();
-        vector<ExpT> NewChildren(NumChildren);
+    }
 
-        for (u32 i = 0; i < NumChildren; ++i) {
-            NewChildren[NumChildren - i - 1] = this->ExpStack.top();
-            this->ExpStack.pop();
+    const i64 NumTerms = (TheMode == Mode::Shift ? 0 : Terms->size());
+    switch (TheMode) {
+    case Mode::Shift:
+        if (VarIdx + Offset < (i64)(Cutoff + Depth)) {
+            throw ExprTypeError("Shifting a bound variable would capture it");
+        }
+        ExpStack.push(Mgr->MakeBoundVar(Exp->GetVarType(), VarIdx + Offset));
+        break;
+    case Mode::Open:
+        if (VarIdx - (i64)Depth < NumTerms) {
+            ExpStack.push(Mgr->ShiftBoundVars((*Terms)[VarIdx - Depth], Depth));
+        } else {
+            ExpStack.push(Mgr->MakeBoundVar(Exp->GetVarType(), VarIdx - NumTerms));
         }
+        break;
+    case Mode::Close:
+        ExpStack.push(Mgr->MakeBoundVar(Exp->GetVarType(), VarIdx + NumTerms));
+        break;
+    }
+}
 
-        this->ExpStack.push(this->Mgr->MakeExpr(Exp->GetOpCode(), NewChildren));
+template <typename E, template <typename> class S>
+inline void
+BoundVarRewriter<E, S>::VisitOpExpression(const OpExpression<E, S>* Exp)
+{
+    if (TryShortcut(Exp)) {
+        return;
+    }
+
+    auto const& OldChildren = Exp->GetChildren();
+    const u32 NumChildren = OldChildren.size();
+    for (auto const& Child : OldChildren) {
+        Child->Accept(this);
+    }
+
+    vector<ExpT> NewChildren(NumChildren);
+    bool Changed = false;
+    for (u32 i = 0; i < NumChildren; ++i) {
+        NewChildren[NumChildren - i - 1] = ExpStack.top();
+        ExpStack.pop();
+        Changed = Changed || (NewChildren[NumChildren - i - 1] !=
+                              OldChildren[NumChildren - i - 1]);
+    }
+
+    if (Changed) {
+        PushResult(Exp, Mgr->MakeExpr(Exp->GetOpCode(), NewChildren));
+    } else {
+        PushResult(Exp, Exp);
     }
 }
 
 template <typename E, template <typename> class S>
 inline void
-BoundSubstitutor<E, S>::VisitEQuantifiedExpression(const EQuantifiedExpression<E, S>* Exp)
+BoundVarRewriter<E, S>::VisitEQuantifiedExpression(const EQuantifiedExpression<E, S>* Exp)
 {
-    OffsetToAdd += Exp->GetQVarTypes().size();
+    if (TryShortcut(Exp)) {
+        return;
+    }
+
+    auto const& QVarTypes = Exp->GetQVarTypes();
+    Depth += QVarTypes.size();
     Exp->GetQExpression()->Accept(this);
-    auto NewQExpr = this->ExpStack.top();
-    this->ExpStack.pop();
-    this->ExpStack.push(this->Mgr->MakeExists(Exp->GetQVarTypes(), NewQExpr));
-    OffsetToAdd -= Exp->GetQVarTypes().size();
+    Depth -= QVarTypes.size();
+    auto NewQExpr = ExpStack.top();
+    ExpStack.pop();
+
+    if (NewQExpr != Exp->GetQExpression()) {
+        PushResult(Exp, Mgr->MakeExists(QVarTypes, NewQExpr));
+    } else {
+        PushResult(Exp, Exp);
+    }
 }
 
 template <typename E, template <typename> class S>
 inline void
-BoundSubstitutor<E, S>::VisitAQuantifiedExpression(const AQuantifiedExpression<E, S>* Exp)
+BoundVarRewriter<E, S>::VisitAQuantifiedExpression(const AQuantifiedExpression<E, S>* Exp)
 {
-    OffsetToAdd += Exp->GetQVarTypes().size();
+    if (TryShortcut(Exp)) {
+        return;
+    }
+
+    auto const& QVarTypes = Exp->GetQVarTypes();
+    Depth += QVarTypes.size();
     Exp->GetQExpression()->Accept(this);
-    auto NewQExpr = this->ExpStack.top();
-    this->ExpStack.pop();
-    this->ExpStack.push(this->Mgr->MakeForAll(Exp->GetQVarTypes(), NewQExpr));
-    OffsetToAdd -= Exp->GetQVarTypes().size();
+    Depth -= QVarTypes.size();
+    auto NewQExpr = ExpStack.top();
+    ExpStack.pop();
+
+    if (NewQExpr != Exp->GetQExpression()) {
+        PushResult(Exp, Mgr->MakeForAll(QVarTypes, NewQExpr));
+    } else {
+        PushResult(Exp, Exp);
+    }
 }
 
 template <typename E, template <typename> class S>
-inline typename BoundSubstitutor<E, S>::ExpT
-BoundSubstitutor<E, S>::Do(MgrType* Mgr, const ExpT& Exp, const SubstMapT& SubstMap)
+inline typename BoundVarRewriter<E, S>::ExpT
+BoundVarRewriter<E, S>::Do(MgrType* Mgr, const ExpT& Exp, i64 Offset, u64 Cutoff)
 {
-    BoundSubstitutor TheSubstitutor(Mgr, SubstMap);
-    Exp->Accept(&TheSubstitutor);
-    return TheSubstitutor.ExpStack.top();
+    BoundVarRewriter TheRewriter(Mgr, Mode::Shift, Offset, Cutoff, nullptr);
+    Exp->Accept(&TheRewriter);
+    return TheRewriter.ExpStack.top();
+}
+
+template <typename E, template <typename> class S>
+inline typename BoundVarRewriter<E, S>::ExpT
+BoundVarRewriter<E, S>::Do(MgrType* Mgr, const ExpT& Exp, Mode TheMode,
+                           const vector<ExpT>& Terms)
+{
+    if (TheMode == Mode::Close) {
+        for (auto const& Var : Terms) {
+            if (!(Var->template Is<VarExpression>())) {
+                throw ExprTypeError((string)"Only variables can be closed over, " +
+                                    "got:\n" + Var->ToString());
+            }
+        }
+    }
+    BoundVarRewriter TheRewriter(Mgr, TheMode, 0, 0, &Terms);
+    Exp->Accept(&TheRewriter);
+    return TheRewriter.ExpStack.top();
 }
 
 // Gatherer implementation
@@ -1392,14 +2572,113 @@ Gatherer<E, S>::Do(const ExpT& Exp,
     return TheGatherer.GatheredExps;
 }
 
+#if defined KINARA_CFG_LOGGING_BUILD_
+
+// SharingCounter implementation
+template <typename E, template <typename> class S>
+inline SharingCounter<E, S>::SharingCounter()
+    : ExpressionVisitorBase<E, S>("SharingCounter", false)
+{
+    // Nothing here
+}
+
+template <typename E, template <typename> class S>
+inline SharingCounter<E, S>::~SharingCounter()
+{
+    // Nothing here
+}
+
+template <typename E, template <typename> class S>
+inline bool SharingCounter<E, S>::Visited(const ExpressionBase<E, S>* Exp) const
+{
+    return (TreeSizes.find(Exp) != TreeSizes.end());
+}
+
+template <typename E, template <typename> class S>
+inline double SharingCounter<E, S>::GetTreeSize(const ExpT& Exp) const
+{
+    return TreeSizes.find(Exp)->second;
+}
+
+template <typename E, template <typename> class S>
+inline void SharingCounter<E, S>::VisitVarExpression(const VarExpression<E, S>* Exp)
+{
+    TreeSizes[Exp] = 1.0;
+}
+
+template <typename E, template <typename> class S>
+inline void SharingCounter<E, S>::VisitConstExpression(const ConstExpression<E, S>* Exp)
+{
+    TreeSizes[Exp] = 1.0;
+}
+
+template <typename E, template <typename> class S>
+inline void
+SharingCounter<E, S>::VisitBoundVarExpression(const BoundVarExpression<E, S>* Exp)
+{
+    TreeSizes[Exp] = 1.0;
+}
+
+template <typename E, template <typename> class S>
+inline void SharingCounter<E, S>::VisitOpExpression(const OpExpression<E, S>* Exp)
+{
+    if (Visited(Exp)) {
+        return;
+    }
+    double TreeSize = 1.0;
+    for (auto const& Child : Exp->GetChildren()) {
+        Child->Accept(this);
+        TreeSize += GetTreeSize(Child);
+    }
+    TreeSizes[Exp] = TreeSize;
+}
+
+template <typename E, template <typename> class S>
+inline void
+SharingCounter<E, S>::VisitEQuantifiedExpression(const EQuantifiedExpression<E, S>* Exp)
+{
+    if (Visited(Exp)) {
+        return;
+    }
+    Exp->GetQExpression()->Accept(this);
+    TreeSizes[Exp] = 1.0 + GetTreeSize(Exp->GetQExpression());
+}
+
+template <typename E, template <typename> class S>
+inline void
+SharingCounter<E, S>::VisitAQuantifiedExpression(const AQuantifiedExpression<E, S>* Exp)
+{
+    if (Visited(Exp)) {
+        return;
+    }
+    Exp->GetQExpression()->Accept(this);
+    TreeSizes[Exp] = 1.0 + GetTreeSize(Exp->GetQExpression());
+}
+
+template <typename E, template <typename> class S>
+inline ExprSharingStats SharingCounter<E, S>::Do(const ExpT& Exp)
+{
+    SharingCounter<E, S> TheCounter;
+    Exp->Accept(&TheCounter);
+    ExprSharingStats Retval;
+    Retval.TreeSize = TheCounter.GetTreeSize(Exp);
+    Retval.DAGSize = TheCounter.TreeSizes.size();
+    return Retval;
+}
+
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+
 
 // ExpressionBase implementation
 template <typename E, template <typename> class S>
 inline ExpressionBase<E, S>::ExpressionBase(ExprMgr<E, S>* Manager,
                                             const E& ExtVal)
     : Mgr(Manager), HashValid(false),
-      ExpType(S<E>::InvalidType), ExtensionData(ExtVal),
-      HashCode(0)
+      ExpType(S<E>::InvalidType),
+#if defined KINARA_CFG_LOGGING_BUILD_
+      Profiler(Manager->Profiler),
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+      ExtensionData(ExtVal), HashCode(0), MaxFreeBoundIdx(-1)
 {
     // Nothing here
 }
@@ -1410,6 +2689,16 @@ inline ExpressionBase<E, S>::~ExpressionBase()
     // Nothing here
 }
 
+#if defined KINARA_CFG_LOGGING_BUILD_
+
+template <typename E, template <typename> class S>
+inline ExprProfiler& ExpressionBase<E, S>::GetProfiler() const
+{
+    return *Profiler;
+}
+
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+
 template <typename E, template <typename> class S>
 inline ExprMgr<E, S>*
 ExpressionBase<E, S>::GetMgr() const
@@ -1498,6 +2787,18 @@ inline bool ExpressionBase<E, S>::FastEQ(const ExpressionBase<E, S>* Other) cons
     return (Equals(Other));
 }
 
+template <typename E, template <typename> class S>
+inline i64 ExpressionBase<E, S>::GetMaxFreeBoundIdx() const
+{
+    return MaxFreeBoundIdx;
+}
+
+template <typename E, template <typename> class S>
+inline bool ExpressionBase<E, S>::IsBoundClosed() const
+{
+    return (MaxFreeBoundIdx < 0);
+}
+
 template <typename E, template <typename> class S>
 string ExpressionBase<E, S>::ToString(u32 Verbosity) const
 {
@@ -1510,9 +2811,11 @@ string ExpressionBase<E, S>::ToString(u32 Verbosity) const
 template <template <typename> class S>
 inline ExpressionBase<ExtListT, S>::ExpressionBase(ExprMgr<ExtListT, S>* Manager,
                                                    const ExtListT& ExtVal)
-    : Mgr(Manager), HashValid(false),
-      ExpType(-1), ExtensionData(ExtVal),
-      HashCode(0)
+    : Mgr(Manager), HashValid(false), ExpType(-1),
+#if defined KINARA_CFG_LOGGING_BUILD_
+      Profiler(Manager->Profiler),
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+      ExtensionData(ExtVal), HashCode(0), MaxFreeBoundIdx(-1)
 {
     // Nothing here
 }
@@ -1523,6 +2826,16 @@ inline ExpressionBase<ExtListT, S>::~ExpressionBase()
     // Nothing here
 }
 
+#if defined KINARA_CFG_LOGGING_BUILD_
+
+template <template <typename> class S>
+inline ExprProfiler& ExpressionBase<ExtListT, S>::GetProfiler() const
+{
+    return *Profiler;
+}
+
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+
 template <template <typename> class S>
 inline ExprMgr<ExtListT, S>*
 ExpressionBase<ExtListT, S>::GetMgr() const
@@ -1611,6 +2924,18 @@ inline bool ExpressionBase<ExtListT, S>::FastEQ(const ExpressionBase<ExtListT, S
     return (Equals(Other));
 }
 
+template <template <typename> class S>
+inline i64 ExpressionBase<ExtListT, S>::GetMaxFreeBoundIdx() const
+{
+    return MaxFreeBoundIdx;
+}
+
+template <template <typename> class S>
+inline bool ExpressionBase<ExtListT, S>::IsBoundClosed() const
+{
+    return (MaxFreeBoundIdx < 0);
+}
+
 template <template <typename> class S>
 string ExpressionBase<ExtListT, S>::ToString(u32 Verbosity) const
 {
@@ -1687,13 +3012,17 @@ inline ConstExpression<E, S>::ConstExpression(ExprMgr<E, S>* Manager,
       ConstValue(ConstValue),
       ConstType(ConstType)
 {
-    // Nothing here
+#if defined KINARA_CFG_LOGGING_BUILD_
+    Manager->GetProfiler().NodeCreated(ExprProfiler::NodeKind::Const);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
 inline ConstExpression<E, S>::~ConstExpression()
 {
-    // Nothing here
+#if defined KINARA_CFG_LOGGING_BUILD_
+    this->GetProfiler().NodeDestroyed(ExprProfiler::NodeKind::Const);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
@@ -1742,6 +3071,7 @@ inline void ConstExpression<E, S>::ComputeHash() const
 template <typename E, template <typename> class S>
 inline void ConstExpression<E, S>::Accept(ExpressionVisitorBase<E, S>* Visitor) const
 {
+    Visitor->Checkpoint(this->GetMgr());
     Visitor->VisitConstExpression(this);
 }
 
@@ -1754,13 +3084,17 @@ inline VarExpression<E, S>::VarExpression(ExprMgr<E, S>* Manager,
     : ExpressionBase<E, S>(Manager, ExtVal),
       VarName(VarName), VarType(VarType)
 {
-    // Nothing here
+#if defined KINARA_CFG_LOGGING_BUILD_
+    Manager->GetProfiler().NodeCreated(ExprProfiler::NodeKind::Var);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
 inline VarExpression<E, S>::~VarExpression()
 {
-    // Nothing here
+#if defined KINARA_CFG_LOGGING_BUILD_
+    this->GetProfiler().NodeDestroyed(ExprProfiler::NodeKind::Var);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
@@ -1815,6 +3149,7 @@ inline void VarExpression<E, S>::ComputeHash() const
 template <typename E, template <typename> class S>
 inline void VarExpression<E, S>::Accept(ExpressionVisitorBase<E, S>* Visitor) const
 {
+    Visitor->Checkpoint(this->GetMgr());
     Visitor->VisitVarExpression(this);
 }
 
@@ -1828,13 +3163,18 @@ inline BoundVarExpression<E, S>::BoundVarExpression(ExprMgr<E, S>* Manager,
     : ExpressionBase<E, S>(Manager, ExtVal),
       VarType(VarType), VarIdx(VarIdx)
 {
-    // Nothing here
+    this->MaxFreeBoundIdx = VarIdx;
+#if defined KINARA_CFG_LOGGING_BUILD_
+    Manager->GetProfiler().NodeCreated(ExprProfiler::NodeKind::BoundVar);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
 inline BoundVarExpression<E, S>::~BoundVarExpression()
 {
-    // Nothing here
+#if defined KINARA_CFG_LOGGING_BUILD_
+    this->GetProfiler().NodeDestroyed(ExprProfiler::NodeKind::BoundVar);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
@@ -1888,6 +3228,7 @@ inline void BoundVarExpression<E, S>::ComputeHash() const
 template <typename E, template <typename> class S>
 inline void BoundVarExpression<E, S>::Accept(ExpressionVisitorBase<E, S>* Visitor) const
 {
+    Visitor->Checkpoint(this->GetMgr());
     Visitor->VisitBoundVarExpression(this);
 }
 
@@ -1899,13 +3240,20 @@ inline OpExpression<E, S>::OpExpression(ExprMgr<E, S>* Manager,
                                         const E& ExtVal)
     : ExpressionBase<E, S>(Manager, ExtVal), OpCode(OpCode), Children(Children)
 {
-    // Nothing here
+    for (auto const& Child : Children) {
+        this->MaxFreeBoundIdx = max(this->MaxFreeBoundIdx, Child->GetMaxFreeBoundIdx());
+    }
+#if defined KINARA_CFG_LOGGING_BUILD_
+    Manager->GetProfiler().OpNodeCreated(OpCode, Children.size());
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
 inline OpExpression<E, S>::~OpExpression()
 {
-    // Nothing here
+#if defined KINARA_CFG_LOGGING_BUILD_
+    this->GetProfiler().OpNodeDestroyed(OpCode, Children.size());
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
@@ -1993,6 +3341,7 @@ inline void OpExpression<E, S>::ComputeHash() const
 template <typename E, template <typename> class S>
 inline void OpExpression<E, S>::Accept(ExpressionVisitorBase<E, S>* Visitor) const
 {
+    Visitor->Checkpoint(this->GetMgr());
     Visitor->VisitOpExpression(this);
 }
 
@@ -2006,13 +3355,20 @@ inline QuantifiedExpressionBase<E, S>::QuantifiedExpressionBase
  )
     : ExpressionBase<E, S>(Manager, ExtVal), QVarTypes(QVarTypes), QExpression(QExpression)
 {
-    // Nothing here
+    // The first QVarTypes.size() indices are bound by this quantifier
+    this->MaxFreeBoundIdx = max((i64)-1, QExpression->GetMaxFreeBoundIdx() -
+                                (i64)QVarTypes.size());
+#if defined KINARA_CFG_LOGGING_BUILD_
+    Manager->GetProfiler().NodeCreated(ExprProfiler::NodeKind::Quantified);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
 inline QuantifiedExpressionBase<E, S>::~QuantifiedExpressionBase()
 {
-    // Nothing here
+#if defined KINARA_CFG_LOGGING_BUILD_
+    this->GetProfiler().NodeDestroyed(ExprProfiler::NodeKind::Quantified);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
@@ -2136,6 +3492,7 @@ inline void EQuantifiedExpression<E, S>::ComputeHash() const
 template <typename E, template <typename> class S>
 inline void EQuantifiedExpression<E, S>::Accept(ExpressionVisitorBase<E, S>* Visitor) const
 {
+    Visitor->Checkpoint(this->GetMgr());
     Visitor->VisitEQuantifiedExpression(this);
 }
 
@@ -2184,7 +3541,7 @@ inline bool AQuantifiedExpression<E, S>::FastEQ(const ExpressionBase<E, S>* Othe
     if (this->Hash() != Other->Hash()) {
         return false;
     }
-    auto OtherAsForAll = Other->template As<ESMC::Exprs::EQuantifiedExpression>();
+    auto OtherAsForAll = Other->template As<ESMC::Exprs::AQuantifiedExpression>();
     if (OtherAsForAll == nullptr) {
         return false;
     }
@@ -2202,6 +3559,7 @@ inline void AQuantifiedExpression<E, S>::ComputeHash() const
 template <typename E, template <typename> class S>
 inline void AQuantifiedExpression<E, S>::Accept(ExpressionVisitorBase<E, S>* Visitor) const
 {
+    Visitor->Checkpoint(this->GetMgr());
     Visitor->VisitAQuantifiedExpression(this);
 }
 
@@ -2223,6 +3581,9 @@ template <typename... ArgTypes>
 inline ExprMgr<E, S>::ExprMgr(ArgTypes&&... Args)
     : Interrupted(false)
 {
+#if defined KINARA_CFG_LOGGING_BUILD_
+    Profiler = make_shared<ExprProfiler>();
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
     Sem = new S<E>(this, forward<ArgTypes>(Args)...);
     TrueExp = ExpCache.template Get<ConstExpression<E, S>>(this, "true",
                                                            Sem->MakeBoolType(),
@@ -2355,10 +3716,16 @@ ExprMgr<E, S>::MakeVal(const string& ValString, const TypeT& ValType,
                        const E& ExtVal)
 {
     auto TrimmedValString = boost::algorithm::trim_copy(ValString);
+#if defined KINARA_CFG_LOGGING_BUILD_
+    ExpT NewExp = new ConstExpression<E, S>(this, TrimmedValString, ValType, ExtVal);
+    auto Retval = ExpCache.Get(NewExp);
+    Profiler->CacheLookup(ExprProfiler::CacheOp::MakeVal, Retval != NewExp);
+#else
     auto Retval =
         ExpCache.template Get<ConstExpression<E, S>>(this,
                                                      TrimmedValString,
                                                      ValType, ExtVal);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
     Sem->TypeCheck(Retval);
     return Retval;
 }
@@ -2368,8 +3735,14 @@ inline typename ExprMgr<E, S>::ExpT
 ExprMgr<E, S>::MakeVar(const string& VarName, const TypeT& VarType,
                        const E& ExtVal)
 {
+#if defined KINARA_CFG_LOGGING_BUILD_
+    ExpT NewExp = new VarExpression<E, S>(this, VarName, VarType, ExtVal);
+    auto Retval = ExpCache.Get(NewExp);
+    Profiler->CacheLookup(ExprProfiler::CacheOp::MakeVar, Retval != NewExp);
+#else
     auto Retval =
         ExpCache.template Get<VarExpression<E, S>>(this, VarName, VarType, ExtVal);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
     Sem->TypeCheck(Retval);
     return Retval;
 }
@@ -2394,7 +3767,14 @@ ExprMgr<E, S>::MakeExpr(const i64 OpCode,
     CheckMgr(Children);
     ExpT NewExp = new OpExpression<E, S>(this, OpCode, Children, ExtVal);
     auto Retval = Sem->Canonicalize(NewExp);
+#if defined KINARA_CFG_LOGGING_BUILD_
+    // The canonical form may itself be a cached expression
+    auto Cached = ExpCache.Find(Retval);
+    Profiler->CacheLookup(ExprProfiler::CacheOp::MakeExpr, Cached != ExpT::NullPtr);
+    Retval = (Cached != ExpT::NullPtr ? Cached : Internalize(Retval));
+#else
     Retval = Internalize(Retval);
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
     Sem->TypeCheck(Retval);
     return Retval;
 }
@@ -2442,15 +3822,14 @@ ExprMgr<E, S>::MakeQExpression(const vector<TypeT>& QVarTypes,
                                const E& ExtVal)
 {
     CheckMgr(QExpr);
+    if (QVarTypes.size() == 0) {
+        return QExpr;
+    }
     ExpT NewExp = new T<E, S>(this, QVarTypes, QExpr, ExtVal);
     auto Retval = Sem->Canonicalize(NewExp);
     Retval = Internalize(Retval);
     Sem->TypeCheck(Retval);
-    if (QVarTypes.size() == 0) {
-        return QExpr;
-    } else {
-        return Retval;
-    }
+    return Retval;
 }
 
 template <typename E, template <typename> class S>
@@ -2536,12 +3915,27 @@ template <typename E, template <typename> class S>
 inline typename ExprMgr<E, S>::ExpT
 ExprMgr<E, S>::SimplifyFP(const ExpT &Exp)
 {
+    auto StartTime = chrono::steady_clock::now();
+    auto OutOfTime = [&] () -> bool
+        {
+            if (Budget.MaxMillis == 0) {
+                return false;
+            }
+            auto Elapsed = chrono::steady_clock::now() - StartTime;
+            return ((u64)chrono::duration_cast<chrono::milliseconds>(Elapsed).count() >=
+                    Budget.MaxMillis);
+        };
+
     auto OldExp = Exp;
     ExpT SimpExp = OldExp;
-    do {
-        OldExp = SimpExp;
-        SimpExp = Simplify(OldExp);
-    } while (SimpExp != OldExp && !Interrupted);
+    try {
+        do {
+            OldExp = SimpExp;
+            SimpExp = Simplify(OldExp);
+        } while (SimpExp != OldExp && !IsInterrupted() && !OutOfTime());
+    } catch (const ExprTransformAborted&) {
+        // SimpExp still holds the result of the last completed pass
+    }
     return SimpExp;
 }
 
@@ -2584,6 +3978,13 @@ ExprMgr<E, S>::TermSubstitute(const SubstMapT& Subst, const ExpT& Exp)
     return ApplyTransform<TermSubstitutor<E, S>>(Exp, Subst);
 }
 
+template <typename E, template <typename> class S>
+inline typename ExprMgr<E, S>::ExpT
+ExprMgr<E, S>::Rewrite(const TermIndexT& Rules, const ExpT& Exp)
+{
+    return ApplyTransform<TermSubstitutor<E, S>>(Exp, Rules);
+}
+
 template <typename E, template <typename> class S>
 inline typename ExprMgr<E, S>::ExpT
 ExprMgr<E, S>::BoundSubstitute(const SubstMapT& Subst, const ExpT& Exp)
@@ -2591,24 +3992,104 @@ ExprMgr<E, S>::BoundSubstitute(const SubstMapT& Subst, const ExpT& Exp)
     return ApplyTransform<BoundSubstitutor<E, S>>(Exp, Subst);
 }
 
+template <typename E, template <typename> class S>
+inline typename ExprMgr<E, S>::ExpT
+ExprMgr<E, S>::ShiftBoundVars(const ExpT& Exp, i64 Offset, u64 Cutoff)
+{
+    if (Offset == 0 || Exp->GetMaxFreeBoundIdx() < (i64)Cutoff) {
+        return Exp;
+    }
+    return ApplyTransform<BoundVarRewriter<E, S>>(Exp, Offset, Cutoff);
+}
+
+template <typename E, template <typename> class S>
+inline typename ExprMgr<E, S>::ExpT
+ExprMgr<E, S>::OpenBoundVars(const ExpT& Exp, const vector<ExpT>& Terms)
+{
+    if (Terms.size() == 0 || Exp->IsBoundClosed()) {
+        return Exp;
+    }
+    return ApplyTransform<BoundVarRewriter<E, S>>(Exp, BoundVarRewriter<E, S>::Mode::Open,
+                                                  Terms);
+}
+
+template <typename E, template <typename> class S>
+inline typename ExprMgr<E, S>::ExpT
+ExprMgr<E, S>::CloseBoundVars(const ExpT& Exp, const vector<ExpT>& Vars)
+{
+    if (Vars.size() == 0) {
+        return Exp;
+    }
+    return ApplyTransform<BoundVarRewriter<E, S>>(Exp, BoundVarRewriter<E, S>::Mode::Close,
+                                                  Vars);
+}
+
 template <typename E, template <typename> class S>
 inline void ExprMgr<E, S>::GC()
 {
+    ShiftCache.clear();
+#if defined KINARA_CFG_LOGGING_BUILD_
+    auto StartTime = chrono::steady_clock::now();
+    ExpCache.GC();
+    auto Elapsed = chrono::steady_clock::now() - StartTime;
+    Profiler->GCPause(chrono::duration_cast<chrono::microseconds>(Elapsed).count());
+#else
     ExpCache.GC();
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
 }
 
 template <typename E, template <typename> class S>
 inline void ExprMgr<E, S>::Interrupt()
 {
-    Interrupted = true;
+    Interrupted.store(true, memory_order_relaxed);
+}
+
+template <typename E, template <typename> class S>
+inline void ExprMgr<E, S>::ClearInterrupt()
+{
+    Interrupted.store(false, memory_order_relaxed);
 }
 
 template <typename E, template <typename> class S>
 inline bool ExprMgr<E, S>::IsInterrupted() const
 {
-    return Interrupted;
+    return Interrupted.load(memory_order_relaxed);
+}
+
+template <typename E, template <typename> class S>
+inline void ExprMgr<E, S>::SetTransformBudget(const TransformBudget& NewBudget)
+{
+    Budget = NewBudget;
+}
+
+template <typename E, template <typename> class S>
+inline const TransformBudget& ExprMgr<E, S>::GetTransformBudget() const
+{
+    return Budget;
+}
+
+#if defined KINARA_CFG_LOGGING_BUILD_
+
+template <typename E, template <typename> class S>
+inline ExprProfiler& ExprMgr<E, S>::GetProfiler()
+{
+    return *Profiler;
+}
+
+template <typename E, template <typename> class S>
+inline const ExprProfiler& ExprMgr<E, S>::GetProfiler() const
+{
+    return *Profiler;
+}
+
+template <typename E, template <typename> class S>
+inline ExprSharingStats ExprMgr<E, S>::GetSharingStats(const ExpT& Exp) const
+{
+    return SharingCounter<E, S>::Do(Exp);
 }
 
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+
 template <typename E, template <typename> class S>
 inline ExprMgr<E, S>* ExprMgr<E, S>::Make()
 {
@@ -0,0 +1,668 @@
+// ExpressionTests.cpp ---
+//
+// Filename: ExpressionTests.cpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 21:40:12 2026 (-0400)
+//
+//
+// Copyright (c) 2013, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+#include "../../src/expr/Expressions.hpp"
+
+#include <string>
+#include <functional>
+#include <random>
+#include <algorithm>
+
+#include "../../../../thirdparty/gtest/include/gtest/gtest.h"
+
+using namespace ESMC;
+using namespace ESMC::Exprs;
+
+// A minimal semanticizer, types are just names and
+// expressions are canonical as constructed
+class TestType : public RefCountable
+{
+public:
+    std::string Name;
+
+    TestType(const std::string& Name)
+        : Name(Name)
+    {
+        // Nothing here
+    }
+
+    u64 Hash() const
+    {
+        return std::hash<std::string>()(Name);
+    }
+};
+
+typedef CSmartPtr<TestType> TestTypeRef;
+
+class TestTypeLess
+{
+public:
+    bool operator () (const TestTypeRef& Type1, const TestTypeRef& Type2) const
+    {
+        return (Type1->Name < Type2->Name);
+    }
+};
+
+template <typename E>
+class TestSemanticizer
+{
+public:
+    typedef TestTypeRef TypeT;
+    typedef int LExpT;
+    typedef TestTypeLess TypeComparatorT;
+    typedef Expr<E, TestSemanticizer> ExpT;
+
+    static const TestTypeRef InvalidType;
+
+    ExprMgr<E, TestSemanticizer>* Mgr;
+    TestTypeRef BoolType;
+    TestTypeRef IntType;
+    // Used by Canonicalize() and Simplify() when set,
+    // both are the identity otherwise
+    std::function<ExpT(const ExpT&)> CanonicalizeHook;
+    std::function<ExpT(const ExpT&)> SimplifyHook;
+
+    TestSemanticizer(ExprMgr<E, TestSemanticizer>* Mgr)
+        : Mgr(Mgr), BoolType(new TestType("bool")), IntType(new TestType("int"))
+    {
+        // Nothing here
+    }
+
+    TypeT MakeBoolType()
+    {
+        return BoolType;
+    }
+
+    template <typename T>
+    void TypeCheck(const T&)
+    {
+        // Nothing here
+    }
+
+    ExpT Canonicalize(const ExpT& Exp)
+    {
+        return (CanonicalizeHook ? CanonicalizeHook(Exp) : Exp);
+    }
+
+    template <typename T>
+    std::string ExprToString(const T&)
+    {
+        return "";
+    }
+
+    ExpT Simplify(const ExpT& Exp)
+    {
+        return (SimplifyHook ? SimplifyHook(Exp) : Exp);
+    }
+};
+
+template <typename E>
+const TestTypeRef TestSemanticizer<E>::InvalidType;
+
+typedef ExprMgr<EmptyExtType, TestSemanticizer> TestMgrT;
+typedef TestMgrT::ExpT ExpT;
+typedef TestMgrT::SubstMapT SubstMapT;
+
+static const i64 OpF = 1000;
+static const i64 OpG = 1001;
+
+class ExpressionTest : public ::testing::Test
+{
+protected:
+    TestMgrT* Mgr;
+    TestTypeRef IntType;
+    ExpT X;
+    ExpT Y;
+
+    virtual void SetUp() override
+    {
+        Mgr = TestMgrT::Make();
+        IntType = Mgr->GetSemanticizer()->IntType;
+        X = Mgr->MakeVar("x", IntType);
+        Y = Mgr->MakeVar("y", IntType);
+    }
+
+    virtual void TearDown() override
+    {
+        X = ExpT::NullPtr;
+        Y = ExpT::NullPtr;
+        delete Mgr;
+    }
+
+    // g(g(...g(Leaf)...)), Depth applications of g
+    ExpT MakeChain(const ExpT& Leaf, u64 Depth)
+    {
+        ExpT Retval = Leaf;
+        for (u64 i = 0; i < Depth; ++i) {
+            Retval = Mgr->MakeExpr(OpG, Retval);
+        }
+        return Retval;
+    }
+
+    // A random expression over x, y, the bound variables #0 to #3,
+    // f, g and quantifiers over one or two variables
+    ExpT MakeRandomExp(std::default_random_engine& Generator, u32 Depth)
+    {
+        std::uniform_int_distribution<u32> Distribution(0, 9);
+        auto Choice = Distribution(Generator);
+        if (Depth == 0 || Choice < 4) {
+            switch (Choice % 3) {
+            case 0:
+                return X;
+            case 1:
+                return Y;
+            default:
+                return Mgr->MakeBoundVar(IntType, Distribution(Generator) % 4);
+            }
+        }
+        auto Child = MakeRandomExp(Generator, Depth - 1);
+        switch (Choice) {
+        case 4:
+        case 5:
+            return Mgr->MakeExpr(OpG, Child);
+        case 6:
+        case 7:
+            return Mgr->MakeExpr(OpF, Child, MakeRandomExp(Generator, Depth - 1));
+        case 8:
+            return Mgr->MakeForAll({ IntType }, Child);
+        default:
+            return Mgr->MakeExists({ IntType, IntType }, Child);
+        }
+    }
+
+    // Uncached reference implementations of the operations on bound
+    // variables, they traverse every node of the expression
+
+    ExpT RebuildWith(const ExpT& Exp, const std::function<ExpT(const ExpT&, u64)>& Leaf,
+                     u64 Depth)
+    {
+        auto OpExp = Exp->As<OpExpression>();
+        if (OpExp != nullptr) {
+            vector<ExpT> NewChildren;
+            for (auto const& Child : OpExp->GetChildren()) {
+                NewChildren.push_back(RebuildWith(Child, Leaf, Depth));
+            }
+            return Mgr->MakeExpr(OpExp->GetOpCode(), NewChildren);
+        }
+        auto QExp = Exp->As<QuantifiedExpressionBase>();
+        if (QExp != nullptr) {
+            auto const& QVarTypes = QExp->GetQVarTypes();
+            auto NewBody = RebuildWith(QExp->GetQExpression(), Leaf,
+                                       Depth + QVarTypes.size());
+            return (QExp->IsForAll() ? Mgr->MakeForAll(QVarTypes, NewBody) :
+                    Mgr->MakeExists(QVarTypes, NewBody));
+        }
+        return Leaf(Exp, Depth);
+    }
+
+    i64 RefMaxFreeBoundIdx(const ExpT& Exp, u64 Depth = 0)
+    {
+        i64 Retval = -1;
+        RebuildWith(Exp, [&] (const ExpT& Leaf, u64 CurDepth) -> ExpT
+                    {
+                        auto BoundVar = Leaf->As<BoundVarExpression>();
+                        if (BoundVar != nullptr && BoundVar->GetVarIdx() >= CurDepth) {
+                            Retval = std::max(Retval, (i64)(BoundVar->GetVarIdx() - CurDepth));
+                        }
+                        return Leaf;
+                    }, Depth);
+        return Retval;
+    }
+
+    ExpT RefShift(const ExpT& Exp, i64 Offset, u64 Cutoff)
+    {
+        return RebuildWith(Exp, [&] (const ExpT& Leaf, u64 Depth) -> ExpT
+                           {
+                               auto BoundVar = Leaf->As<BoundVarExpression>();
+                               if (BoundVar == nullptr ||
+                                   BoundVar->GetVarIdx() < Cutoff + Depth) {
+                                   return Leaf;
+                               }
+                               return Mgr->MakeBoundVar(IntType,
+                                                        BoundVar->GetVarIdx() + Offset);
+                           }, 0);
+    }
+
+    ExpT RefOpen(const ExpT& Exp, const vector<ExpT>& Terms)
+    {
+        return RebuildWith(Exp, [&] (const ExpT& Leaf, u64 Depth) -> ExpT
+                           {
+                               auto BoundVar = Leaf->As<BoundVarExpression>();
+                               if (BoundVar == nullptr || BoundVar->GetVarIdx() < Depth) {
+                                   return Leaf;
+                               }
+                               auto FreeIdx = BoundVar->GetVarIdx() - Depth;
+                               if (FreeIdx < Terms.size()) {
+                                   return RefShift(Terms[FreeIdx], Depth, 0);
+                               }
+                               return Mgr->MakeBoundVar(IntType,
+                                                        BoundVar->GetVarIdx() - Terms.size());
+                           }, 0);
+    }
+
+    ExpT RefClose(const ExpT& Exp, const vector<ExpT>& Vars)
+    {
+        return RebuildWith(Exp, [&] (const ExpT& Leaf, u64 Depth) -> ExpT
+                           {
+                               auto it = std::find(Vars.begin(), Vars.end(), Leaf);
+                               if (it != Vars.end()) {
+                                   return Mgr->MakeBoundVar(IntType,
+                                                            Depth + (it - Vars.begin()));
+                               }
+                               auto BoundVar = Leaf->As<BoundVarExpression>();
+                               if (BoundVar == nullptr || BoundVar->GetVarIdx() < Depth) {
+                                   return Leaf;
+                               }
+                               return Mgr->MakeBoundVar(IntType,
+                                                        BoundVar->GetVarIdx() + Vars.size());
+                           }, 0);
+    }
+};
+
+TEST_F(ExpressionTest, NodeBudget)
+{
+    auto Chain = MakeChain(X, 64);
+    SubstMapT Subst;
+    Subst[X] = Y;
+
+    Mgr->SetTransformBudget(TransformBudget(16));
+    try {
+        Mgr->Substitute(Subst, Chain);
+        FAIL() << "Substitute did not respect the node budget";
+    } catch (const ExprTransformAborted& Ex) {
+        EXPECT_EQ(TransformAbortReason::NodeBudgetExhausted, Ex.GetReason());
+        EXPECT_EQ((u64)17, Ex.GetNumNodesVisited());
+    }
+
+    // the budget applies to each transform separately
+    EXPECT_EQ(MakeChain(Y, 8), Mgr->Substitute(Subst, MakeChain(X, 8)));
+
+    Mgr->SetTransformBudget(TransformBudget());
+    EXPECT_EQ(MakeChain(Y, 64), Mgr->Substitute(Subst, Chain));
+}
+
+TEST_F(ExpressionTest, Interrupt)
+{
+    auto Chain = MakeChain(X, 64);
+    SubstMapT Subst;
+    Subst[X] = Y;
+
+    // check for the interruption on every node
+    Mgr->SetTransformBudget(TransformBudget(0, 0, 1));
+    Mgr->Interrupt();
+    EXPECT_TRUE(Mgr->IsInterrupted());
+    try {
+        Mgr->Substitute(Subst, Chain);
+        FAIL() << "Substitute ignored the interruption";
+    } catch (const ExprTransformAborted& Ex) {
+        EXPECT_EQ(TransformAbortReason::Interrupted, Ex.GetReason());
+    }
+
+    // interruption is sticky
+    EXPECT_THROW(Mgr->Substitute(Subst, Chain), ExprTransformAborted);
+
+    Mgr->ClearInterrupt();
+    EXPECT_FALSE(Mgr->IsInterrupted());
+    EXPECT_EQ(MakeChain(Y, 64), Mgr->Substitute(Subst, Chain));
+}
+
+TEST_F(ExpressionTest, SimplifyFP)
+{
+    auto Sem = Mgr->GetSemanticizer();
+    // each pass strips one application of g
+    Sem->SimplifyHook = [&] (const ExpT& Exp) -> ExpT
+        {
+            auto OpExp = Exp->As<OpExpression>();
+            return (OpExp == nullptr ? Exp : OpExp->GetChildren()[0]);
+        };
+    EXPECT_EQ(X, Mgr->SimplifyFP(MakeChain(X, 8)));
+
+    // a pass that is aborted leaves the result of the
+    // last completed pass
+    SubstMapT Subst;
+    Subst[X] = Y;
+    u64 NumPasses = 0;
+    Sem->SimplifyHook = [&] (const ExpT& Exp) -> ExpT
+        {
+            if (++NumPasses == 3) {
+                Mgr->Interrupt();
+                return Mgr->Substitute(Subst, Exp);
+            }
+            return Exp->As<OpExpression>()->GetChildren()[0];
+        };
+    Mgr->SetTransformBudget(TransformBudget(0, 0, 1));
+    EXPECT_EQ(MakeChain(X, 6), Mgr->SimplifyFP(MakeChain(X, 8)));
+    EXPECT_EQ((u64)3, NumPasses);
+
+    Mgr->ClearInterrupt();
+    Sem->SimplifyHook = nullptr;
+}
+
+TEST_F(ExpressionTest, TermIndex)
+{
+    typedef TestMgrT::TermIndexT TermIndexT;
+    typedef TestMgrT::ExpSetT ExpSetT;
+
+    auto A = Mgr->MakeVar("a", IntType);
+    auto B = Mgr->MakeVar("b", IntType);
+    auto R1 = Mgr->MakeVar("r1", IntType);
+    auto R2 = Mgr->MakeVar("r2", IntType);
+    auto R3 = Mgr->MakeVar("r3", IntType);
+    auto FAB = Mgr->MakeExpr(OpF, A, B);
+    auto FAA = Mgr->MakeExpr(OpF, A, A);
+    auto FXY = Mgr->MakeExpr(OpF, X, Y);
+    auto FXX = Mgr->MakeExpr(OpF, X, X);
+    auto GB = Mgr->MakeExpr(OpG, B);
+
+    TermIndexT Index;
+    Index.Insert(FAB, R1);
+    EXPECT_FALSE(Index.HasPatternVars());
+    EXPECT_EQ(R1, Index.FindExact(FAB));
+    EXPECT_EQ(ExpT::NullPtr, Index.FindExact(Mgr->MakeExpr(OpF, B, A)));
+    EXPECT_EQ(ExpT::NullPtr, Index.FindExact(A));
+
+    // f(x, x) is more specific than f(x, y), in either insertion order
+    Index.Insert(FXY, R2, ExpSetT({ X, Y }));
+    Index.Insert(FXX, R3, ExpSetT({ X }));
+    EXPECT_TRUE(Index.HasPatternVars());
+    EXPECT_EQ((u64)3, Index.Size());
+
+    TermIndexT RevIndex;
+    RevIndex.Insert(FXX, R3, ExpSetT({ X }));
+    RevIndex.Insert(FXY, R2, ExpSetT({ X, Y }));
+
+    ExpT Replacement;
+    SubstMapT Bindings;
+    for (auto CurIndex : { &Index, &RevIndex }) {
+        EXPECT_TRUE(CurIndex->Find(FAA, Replacement, Bindings));
+        EXPECT_EQ(R3, Replacement);
+        EXPECT_EQ((u64)1, Bindings.size());
+        EXPECT_EQ(A, Bindings.find(X)->second);
+
+        EXPECT_TRUE(CurIndex->Find(Mgr->MakeExpr(OpF, A, GB), Replacement, Bindings));
+        EXPECT_EQ(R2, Replacement);
+        EXPECT_EQ((u64)2, Bindings.size());
+        EXPECT_EQ(A, Bindings.find(X)->second);
+        EXPECT_EQ(GB, Bindings.find(Y)->second);
+
+        EXPECT_FALSE(CurIndex->Find(GB, Replacement, Bindings));
+        EXPECT_FALSE(CurIndex->Find(Mgr->MakeExpr(OpF, A, A, A), Replacement, Bindings));
+    }
+
+    // the pattern without variables is the most specific
+    EXPECT_TRUE(Index.Find(FAB, Replacement, Bindings));
+    EXPECT_EQ(R1, Replacement);
+    EXPECT_EQ((u64)0, Bindings.size());
+
+    // inserting a pattern again replaces its replacement
+    Index.Insert(FXX, R1, ExpSetT({ X }));
+    EXPECT_EQ((u64)3, Index.Size());
+    EXPECT_TRUE(Index.Find(FAA, Replacement, Bindings));
+    EXPECT_EQ(R1, Replacement);
+}
+
+TEST_F(ExpressionTest, Rewrite)
+{
+    typedef TestMgrT::TermIndexT TermIndexT;
+    typedef TestMgrT::ExpSetT ExpSetT;
+
+    auto A = Mgr->MakeVar("a", IntType);
+    auto B = Mgr->MakeVar("b", IntType);
+    auto GA = Mgr->MakeExpr(OpG, A);
+    auto GB = Mgr->MakeExpr(OpG, B);
+
+    // g(x) --> x, f(x, x) --> g(x)
+    TermIndexT Rules;
+    Rules.Insert(Mgr->MakeExpr(OpG, X), X, ExpSetT({ X }));
+    Rules.Insert(Mgr->MakeExpr(OpF, X, X), Mgr->MakeExpr(OpG, X), ExpSetT({ X }));
+
+    // only the outermost matches are rewritten, and
+    // the replacements are not rewritten any further
+    EXPECT_EQ(Mgr->MakeExpr(OpF, A, GB),
+              Mgr->Rewrite(Rules, Mgr->MakeExpr(OpF, GA, Mgr->MakeExpr(OpG, GB))));
+    EXPECT_EQ(Mgr->MakeExpr(OpG, GA),
+              Mgr->Rewrite(Rules, Mgr->MakeExpr(OpF, GA, GA)));
+    EXPECT_EQ(Mgr->MakeExpr(OpF, A, B), Mgr->Rewrite(Rules, Mgr->MakeExpr(OpF, A, B)));
+
+    // term substitution, without pattern variables
+    auto C = Mgr->MakeVar("c", IntType);
+    SubstMapT Subst;
+    Subst[A] = B;
+    Subst[GB] = C;
+    EXPECT_EQ(Mgr->MakeExpr(OpF, B, C),
+              Mgr->TermSubstitute(Subst, Mgr->MakeExpr(OpF, A, GB)));
+    EXPECT_EQ(Mgr->MakeExpr(OpG, B), Mgr->TermSubstitute(Subst, GA));
+}
+
+TEST_F(ExpressionTest, BoundVars)
+{
+    std::default_random_engine Generator;
+    auto B0 = Mgr->MakeBoundVar(IntType, 0);
+    vector<ExpT> Terms({ Y, Mgr->MakeExpr(OpG, B0) });
+    vector<ExpT> Vars({ X, Y });
+
+    for (u32 i = 0; i < 256; ++i) {
+        auto Exp = MakeRandomExp(Generator, 6);
+        EXPECT_EQ(RefMaxFreeBoundIdx(Exp), Exp->GetMaxFreeBoundIdx());
+        EXPECT_EQ(Exp->GetMaxFreeBoundIdx() < 0, Exp->IsBoundClosed());
+
+        for (u64 Cutoff = 0; Cutoff < 3; ++Cutoff) {
+            for (i64 Offset = 1; Offset < 4; Offset += 2) {
+                auto Expected = RefShift(Exp, Offset, Cutoff);
+                EXPECT_EQ(Expected, Mgr->ShiftBoundVars(Exp, Offset, Cutoff));
+                // the second time around it comes from the cache
+                EXPECT_EQ(Expected, Mgr->ShiftBoundVars(Exp, Offset, Cutoff));
+                EXPECT_EQ(Exp, Mgr->ShiftBoundVars(Expected, -Offset, Cutoff));
+            }
+        }
+
+        EXPECT_EQ(RefOpen(Exp, Terms), Mgr->OpenBoundVars(Exp, Terms));
+        auto Closed = Mgr->CloseBoundVars(Exp, Vars);
+        EXPECT_EQ(RefClose(Exp, Vars), Closed);
+        EXPECT_EQ(Exp, Mgr->OpenBoundVars(Closed, Vars));
+
+        if (i % 64 == 63) {
+            Mgr->GC();
+        }
+    }
+
+    // shifting a closed expression is a no-op
+    auto ClosedExp = Mgr->MakeForAll({ IntType }, Mgr->MakeExpr(OpF, B0, X));
+    EXPECT_TRUE(ClosedExp->IsBoundClosed());
+    EXPECT_EQ(ClosedExp, Mgr->ShiftBoundVars(ClosedExp, 5));
+    EXPECT_THROW(Mgr->ShiftBoundVars(B0, -1), ExprTypeError);
+}
+
+TEST_F(ExpressionTest, SubstMap)
+{
+    auto FXY = Mgr->MakeExpr(OpF, X, Y);
+    SubstMapT Subst;
+    Subst[X] = Y;
+
+    // extending a copy for a nested scope leaves the original alone
+    auto Inner = Subst.Extend(Y, X);
+    EXPECT_EQ((u64)1, Subst.size());
+    EXPECT_EQ((u64)2, Inner.size());
+    EXPECT_EQ(Mgr->MakeExpr(OpF, Y, Y), Mgr->Substitute(Subst, FXY));
+    EXPECT_EQ(Mgr->MakeExpr(OpF, Y, X), Mgr->Substitute(Inner, FXY));
+
+    auto Copy = Inner;
+    Copy.erase(X);
+    EXPECT_EQ(Mgr->MakeExpr(OpF, X, X), Mgr->Substitute(Copy, FXY));
+    EXPECT_EQ(Mgr->MakeExpr(OpF, Y, X), Mgr->Substitute(Inner, FXY));
+}
+
+// The iteration order of a substitution depends only on
+// its keys, not on where they happen to be allocated
+TEST(SubstMapTest, IterationOrder)
+{
+    auto Mgr1 = TestMgrT::Make();
+    auto Mgr2 = TestMgrT::Make();
+    auto IntType1 = Mgr1->GetSemanticizer()->IntType;
+    auto IntType2 = Mgr2->GetSemanticizer()->IntType;
+
+    vector<ExpT> Padding;
+    SubstMapT Subst1;
+    SubstMapT Subst2;
+    for (u32 i = 0; i < 64; ++i) {
+        auto Name1 = "v" + std::to_string(i);
+        auto Name2 = "v" + std::to_string(63 - i);
+        Padding.push_back(Mgr2->MakeVar("p" + std::to_string(i), IntType2));
+        Subst1[Mgr1->MakeVar(Name1, IntType1)] = Mgr1->MakeTrue();
+        Subst2[Mgr2->MakeVar(Name2, IntType2)] = Mgr2->MakeTrue();
+    }
+
+    vector<std::string> Order1;
+    vector<std::string> Order2;
+    for (auto const& Entry : Subst1) {
+        Order1.push_back(Entry.first->As<VarExpression>()->GetVarName());
+    }
+    for (auto const& Entry : Subst2) {
+        Order2.push_back(Entry.first->As<VarExpression>()->GetVarName());
+    }
+    EXPECT_EQ((u64)64, Order1.size());
+    EXPECT_EQ(Order1, Order2);
+
+    Padding.clear();
+    Subst1.clear();
+    Subst2.clear();
+    delete Mgr1;
+    delete Mgr2;
+}
+
+#if defined KINARA_CFG_LOGGING_BUILD_
+
+TEST_F(ExpressionTest, ProfilerCounts)
+{
+    typedef ExprProfiler::NodeKind NodeKind;
+    typedef ExprProfiler::CacheOp CacheOp;
+
+    auto& Profiler = Mgr->GetProfiler();
+    Profiler.Reset();
+
+    // the true and false constants, x and y
+    EXPECT_EQ((u64)2, Profiler.GetNumLiveNodes(NodeKind::Const));
+    EXPECT_EQ((u64)2, Profiler.GetNumLiveNodes(NodeKind::Var));
+    EXPECT_EQ((u64)4, Profiler.GetNumLiveNodes());
+
+    auto FXY = Mgr->MakeExpr(OpF, X, Y);
+    EXPECT_EQ(FXY, Mgr->MakeExpr(OpF, X, Y));
+    EXPECT_EQ(0.5, Profiler.GetCacheHitRate(CacheOp::MakeExpr));
+    EXPECT_EQ((u64)1, Profiler.GetNumLiveNodes(NodeKind::Op));
+    EXPECT_EQ((u64)1, Profiler.GetLiveOpNodes().at(OpF));
+    EXPECT_EQ(2.0, Profiler.GetAvgChildrenPerOp());
+
+    EXPECT_EQ(X, Mgr->MakeVar("x", IntType));
+    Mgr->MakeVar("z", IntType);
+    EXPECT_EQ(0.5, Profiler.GetCacheHitRate(CacheOp::MakeVar));
+    EXPECT_EQ((u64)3, Profiler.GetNumLiveNodes(NodeKind::Var));
+    Mgr->GC();
+    EXPECT_EQ((u64)2, Profiler.GetNumLiveNodes(NodeKind::Var));
+
+    // g(e) canonicalizes to e, which is cached, and the children of f
+    // are swapped when the first one is y. So g(x) and f(y, x) are hits,
+    // f(y, y) canonicalizes to a new expression, which is a miss
+    Mgr->GetSemanticizer()->CanonicalizeHook = [&] (const ExpT& Exp) -> ExpT
+        {
+            auto OpExp = Exp->As<OpExpression>();
+            if (OpExp == nullptr) {
+                return Exp;
+            }
+            auto const& Children = OpExp->GetChildren();
+            if (OpExp->GetOpCode() == OpG) {
+                return Children[0];
+            }
+            if (Children[0] != Y) {
+                return Exp;
+            }
+            return new OpExpression<EmptyExtType, TestSemanticizer>
+                (Mgr, OpF, vector<ExpT>({ Children[1], Children[0] }));
+        };
+    Profiler.Reset();
+    EXPECT_EQ(X, Mgr->MakeExpr(OpG, X));
+    EXPECT_EQ(FXY, Mgr->MakeExpr(OpF, Y, X));
+    EXPECT_EQ(1.0, Profiler.GetCacheHitRate(CacheOp::MakeExpr));
+    auto FYY = Mgr->MakeExpr(OpF, Y, Y);
+    EXPECT_EQ(2.0 / 3.0, Profiler.GetCacheHitRate(CacheOp::MakeExpr));
+    EXPECT_EQ(FYY, Mgr->MakeExpr(OpF, Y, Y));
+    EXPECT_EQ((u64)2, Profiler.GetNumLiveNodes(NodeKind::Op));
+    Mgr->GetSemanticizer()->CanonicalizeHook = nullptr;
+
+    FXY = ExpT::NullPtr;
+    FYY = ExpT::NullPtr;
+    Mgr->GC();
+    EXPECT_EQ((u64)0, Profiler.GetNumLiveNodes(NodeKind::Op));
+    EXPECT_TRUE(Profiler.GetLiveOpNodes().empty());
+}
+
+TEST_F(ExpressionTest, SharingStats)
+{
+    auto Chain = MakeChain(X, 64);
+    auto FCC = Mgr->MakeExpr(OpF, Chain, Chain);
+
+    // the statistics are gathered regardless of the budget
+    // and of an interruption
+    Mgr->SetTransformBudget(TransformBudget(16, 0, 1));
+    Mgr->Interrupt();
+    auto Stats = Mgr->GetSharingStats(FCC);
+    EXPECT_EQ(131.0, Stats.TreeSize);
+    EXPECT_EQ((u64)66, Stats.DAGSize);
+
+    Mgr->ClearInterrupt();
+    Mgr->SetTransformBudget(TransformBudget());
+}
+
+TEST(ExpressionProfilerTest, ExpressionsOutliveManager)
+{
+    auto Mgr = TestMgrT::Make();
+    auto IntType = Mgr->GetSemanticizer()->IntType;
+    auto X = Mgr->MakeVar("x", IntType);
+    auto FXX = Mgr->MakeExpr(OpF, X, X);
+    delete Mgr;
+
+    // the destructors update the profiler, which is
+    // still owned by the surviving expressions
+    FXX = ExpT::NullPtr;
+    X = ExpT::NullPtr;
+}
+
+#endif /* KINARA_CFG_LOGGING_BUILD_ */
+
+//
+// ExpressionTests.cpp ends here
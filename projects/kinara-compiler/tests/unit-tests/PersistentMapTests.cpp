@@ -0,0 +1,243 @@
+// PersistentMapTests.cpp ---
+//
+// Filename: PersistentMapTests.cpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 23:05:37 2026 (-0400)
+//
+//
+// Copyright (c) 2013, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+#include "../../src/containers/PersistentMap.hpp"
+
+#include <string>
+#include <random>
+#include <vector>
+#include <unordered_map>
+
+#include "../../../../thirdparty/gtest/include/gtest/gtest.h"
+
+using ESMC::PersistentMap;
+using ESMC::u64;
+
+// Every key collides with a quarter of the others in all 64 bits
+class CollidingHasher
+{
+public:
+    inline u64 operator () (u64 Key) const
+    {
+        return (Key % 4);
+    }
+};
+
+// Keys agree on the low 40 bits of their hashes,
+// which pushes them down to the last levels of the trie
+class DeepHasher
+{
+public:
+    inline u64 operator () (u64 Key) const
+    {
+        return (Key << 40);
+    }
+};
+
+template <typename MapType>
+static inline bool test_equal(const MapType& Map,
+                              const std::unordered_map<u64, u64>& StdMap)
+{
+    if (Map.size() != StdMap.size()) {
+        return false;
+    }
+    u64 NumVisited = 0;
+    for (auto const& Entry : Map) {
+        auto it = StdMap.find(Entry.first);
+        if (it == StdMap.end() || it->second != Entry.second) {
+            return false;
+        }
+        ++NumVisited;
+    }
+    return (NumVisited == StdMap.size());
+}
+
+template <typename MapType>
+static inline void test_against_std_map(u64 NumKeys)
+{
+    MapType Map;
+    std::unordered_map<u64, u64> StdMap;
+
+    std::default_random_engine Generator;
+    std::uniform_int_distribution<u64> KeyDistribution(0, NumKeys - 1);
+    std::uniform_int_distribution<u64> OpDistribution(0, 2);
+
+    for (u64 i = 0; i < 16 * NumKeys; ++i) {
+        auto Key = KeyDistribution(Generator);
+        if (OpDistribution(Generator) == 0) {
+            EXPECT_EQ(StdMap.erase(Key), Map.erase(Key));
+        } else {
+            Map[Key] = i;
+            StdMap[Key] = i;
+        }
+        EXPECT_EQ(StdMap.size(), Map.size());
+        EXPECT_EQ(StdMap.count(Key), Map.count(Key));
+    }
+    EXPECT_TRUE(test_equal(Map, StdMap));
+
+    for (u64 Key = 0; Key < NumKeys; ++Key) {
+        EXPECT_EQ(StdMap.erase(Key), Map.erase(Key));
+    }
+    EXPECT_TRUE(Map.empty());
+    EXPECT_TRUE(Map.begin() == Map.end());
+}
+
+TEST(PersistentMapTest, Functional)
+{
+    PersistentMap<u64, u64> Map;
+    EXPECT_TRUE(Map.empty());
+    EXPECT_TRUE(Map.begin() == Map.end());
+    EXPECT_TRUE(Map.find(42) == Map.end());
+    EXPECT_EQ((u64)0, Map.erase(42));
+
+    Map[42] = 1;
+    EXPECT_EQ((u64)1, Map.size());
+    EXPECT_EQ((u64)1, Map.find(42)->second);
+    EXPECT_FALSE(Map.insert(std::make_pair((u64)42, (u64)2)).second);
+    EXPECT_EQ((u64)1, Map.find(42)->second);
+    EXPECT_TRUE(Map.insert(std::make_pair((u64)43, (u64)2)).second);
+    EXPECT_EQ((u64)2, Map.size());
+
+    EXPECT_EQ((u64)1, Map.erase(42));
+    EXPECT_EQ((u64)0, Map.erase(42));
+    EXPECT_EQ((u64)0, Map.count(42));
+    EXPECT_EQ((u64)1, Map.count(43));
+    Map.clear();
+    EXPECT_TRUE(Map.empty());
+
+    test_against_std_map<PersistentMap<u64, u64>>(1 << 12);
+}
+
+TEST(PersistentMapTest, Collisions)
+{
+    PersistentMap<u64, u64, CollidingHasher> CollidingMap;
+    for (u64 i = 0; i < 64; ++i) {
+        CollidingMap[i] = i + 42;
+    }
+    EXPECT_EQ((u64)64, CollidingMap.size());
+    for (u64 i = 0; i < 64; ++i) {
+        EXPECT_EQ(i + 42, CollidingMap.find(i)->second);
+    }
+    for (u64 i = 0; i < 64; i += 2) {
+        EXPECT_EQ((u64)1, CollidingMap.erase(i));
+    }
+    for (u64 i = 0; i < 64; ++i) {
+        EXPECT_EQ(i % 2, CollidingMap.count(i));
+    }
+
+    test_against_std_map<PersistentMap<u64, u64, CollidingHasher>>(256);
+    test_against_std_map<PersistentMap<u64, u64, DeepHasher>>(1 << 10);
+}
+
+TEST(PersistentMapTest, CopyOnWrite)
+{
+    typedef PersistentMap<u64, u64> MapType;
+
+    MapType Map;
+    std::unordered_map<u64, u64> StdMap;
+    for (u64 i = 0; i < 1024; ++i) {
+        Map[i] = i;
+        StdMap[i] = i;
+    }
+
+    // writes to a copy are not visible in the original
+    MapType Copy = Map;
+    auto StdCopy = StdMap;
+    for (u64 i = 0; i < 1024; i += 3) {
+        Copy[i] = i + 1;
+        StdCopy[i] = i + 1;
+    }
+    for (u64 i = 1; i < 1024; i += 3) {
+        EXPECT_EQ((u64)1, Copy.erase(i));
+        StdCopy.erase(i);
+    }
+    Copy[2048] = 0;
+    StdCopy[2048] = 0;
+    EXPECT_TRUE(test_equal(Map, StdMap));
+    EXPECT_TRUE(test_equal(Copy, StdCopy));
+
+    // nor are writes to the original visible in the copy
+    for (u64 i = 2; i < 1024; i += 3) {
+        EXPECT_EQ((u64)1, Map.erase(i));
+        StdMap.erase(i);
+    }
+    EXPECT_TRUE(test_equal(Map, StdMap));
+    EXPECT_TRUE(test_equal(Copy, StdCopy));
+
+    // Extend leaves the map it is called on alone
+    auto Extended = Copy.Extend(2048, 1).Extend(4096, 2);
+    EXPECT_EQ((u64)0, Copy.find(2048)->second);
+    EXPECT_EQ((u64)0, Copy.count(4096));
+    EXPECT_EQ(Copy.size() + 1, Extended.size());
+    EXPECT_EQ((u64)1, Extended.find(2048)->second);
+    EXPECT_EQ((u64)2, Extended.find(4096)->second);
+
+    // the copies outlive the original
+    MapType Moved = std::move(Map);
+    EXPECT_TRUE(Map.empty());
+    Moved.clear();
+    EXPECT_TRUE(test_equal(Copy, StdCopy));
+
+    MapType Assigned;
+    Assigned[1] = 1;
+    Assigned = Copy;
+    Copy.clear();
+    EXPECT_TRUE(test_equal(Assigned, StdCopy));
+    Assigned = Assigned;
+    EXPECT_TRUE(test_equal(Assigned, StdCopy));
+}
+
+TEST(PersistentMapTest, StringValues)
+{
+    PersistentMap<u64, std::string> Map;
+    for (u64 i = 0; i < 256; ++i) {
+        Map[i] = std::to_string(i);
+    }
+    auto Copy = Map;
+    for (u64 i = 0; i < 256; ++i) {
+        Copy[i] += "!";
+    }
+    for (u64 i = 0; i < 256; ++i) {
+        EXPECT_EQ(std::to_string(i), Map.find(i)->second);
+        EXPECT_EQ(std::to_string(i) + "!", Copy.find(i)->second);
+    }
+}
+
+//
+// PersistentMapTests.cpp ends here
@@ -0,0 +1,438 @@
+// BitSetTests.cpp ---
+//
+// Filename: BitSetTests.cpp
+// Author: Abhishek Udupa
+// Created: Sun Oct 18 23:20:44 2026 (-0400)
+//
+//
+// Copyright (c) 2015, Abhishek Udupa, University of Pennsylvania
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. All advertising materials mentioning features or use of this software
+//    must display the following acknowledgement:
+//    This product includes software developed by The University of Pennsylvania
+// 4. Neither the name of the University of Pennsylvania nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+
+// Code:
+
+#include "../../projects/kinara-common/src/containers/BitSetOps.hpp"
+#include "../../projects/kinara-common/src/containers/RoaringBitmap.hpp"
+
+#include <set>
+#include <bitset>
+#include <memory>
+#include <random>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <iterator>
+
+#include "../../thirdparty/gtest/include/gtest/gtest.h"
+
+using kinara::u08;
+using kinara::u16;
+using kinara::u32;
+using kinara::u64;
+
+namespace bitset_ops = kinara::containers::bitset_ops;
+using kinara::containers::RoaringBitmap;
+
+const u64 max_num_bits = (1 << 16) + 37;
+const u64 max_test_iterations = (1 << 4);
+const u64 max_performance_iterations = (1 << 12);
+
+static inline std::vector<u64> make_random_words(u64 num_bits, u64 seed, u64 density)
+{
+    std::default_random_engine generator(seed);
+    std::uniform_int_distribution<u64> distribution(0, density - 1);
+    std::vector<u64> retval(bitset_ops::num_words(num_bits), 0);
+    for (u64 i = 0; i < num_bits; ++i) {
+        if (distribution(generator) == 0) {
+            retval[i / 64] |= ((u64)1 << (i % 64));
+        }
+    }
+    return retval;
+}
+
+static inline std::vector<bool> to_bools(const std::vector<u64>& words, u64 num_bits)
+{
+    std::vector<bool> retval(num_bits);
+    for (u64 i = 0; i < num_bits; ++i) {
+        retval[i] = ((words[i / 64] >> (i % 64)) & 1) != 0;
+    }
+    return retval;
+}
+
+TEST(BitSetOpsTest, Functional)
+{
+    for (u64 iteration = 0; iteration < max_test_iterations; ++iteration) {
+        // vary the length, to exercise the tails of the vector loops
+        const u64 num_bits = max_num_bits - iteration * 61;
+        const u64 num_words = bitset_ops::num_words(num_bits);
+        auto words1 = make_random_words(num_bits, 2 * iteration, 3);
+        auto words2 = make_random_words(num_bits, 2 * iteration + 1, 2 + iteration);
+        auto bools1 = to_bools(words1, num_bits);
+        auto bools2 = to_bools(words2, num_bits);
+
+        u64 expected_count = 0;
+        for (u64 i = 0; i < num_bits; ++i) {
+            expected_count += (bools1[i] ? 1 : 0);
+        }
+        EXPECT_EQ(expected_count, bitset_ops::count(words1.data(), num_words));
+
+        auto result = words1;
+        bitset_ops::and_with(result.data(), words2.data(), num_words);
+        auto and_bools = to_bools(result, num_bits);
+
+        result = words1;
+        bitset_ops::or_with(result.data(), words2.data(), num_words);
+        auto or_bools = to_bools(result, num_bits);
+
+        result = words1;
+        bitset_ops::xor_with(result.data(), words2.data(), num_words);
+        auto xor_bools = to_bools(result, num_bits);
+
+        result = words1;
+        bitset_ops::and_not_with(result.data(), words2.data(), num_words);
+        auto and_not_bools = to_bools(result, num_bits);
+
+        for (u64 i = 0; i < num_bits; ++i) {
+            EXPECT_EQ(bools1[i] && bools2[i], and_bools[i]);
+            EXPECT_EQ(bools1[i] || bools2[i], or_bools[i]);
+            EXPECT_EQ(bools1[i] != bools2[i], xor_bools[i]);
+            EXPECT_EQ(bools1[i] && !bools2[i], and_not_bools[i]);
+        }
+
+        // find_next and for_each_set_bit visit the same bits
+        std::vector<u64> found;
+        for (u64 i = bitset_ops::find_first(words2.data(), num_bits); i < num_bits;
+             i = bitset_ops::find_next(words2.data(), num_bits, i + 1)) {
+            found.push_back(i);
+        }
+        std::vector<u64> visited;
+        bitset_ops::for_each_set_bit(words2.data(), num_words,
+                                     [&] (u64 index) -> void { visited.push_back(index); });
+        std::vector<u64> expected;
+        for (u64 i = 0; i < num_bits; ++i) {
+            if (bools2[i]) {
+                expected.push_back(i);
+            }
+        }
+        EXPECT_EQ(expected, found);
+        EXPECT_EQ(expected, visited);
+    }
+
+    std::vector<u64> empty_words(bitset_ops::num_words(max_num_bits), 0);
+    EXPECT_EQ(max_num_bits, bitset_ops::find_first(empty_words.data(), max_num_bits));
+    EXPECT_EQ((u64)0, bitset_ops::count(empty_words.data(), empty_words.size()));
+}
+
+// The performance tests below do the same work: intersect, union and
+// count two bitsets of max_num_bits bits, and walk the set bits
+
+TEST(BitSetOpsTest, Performance)
+{
+    const u64 num_words = bitset_ops::num_words(max_num_bits);
+    auto words1 = make_random_words(max_num_bits, 1, 2);
+    auto words2 = make_random_words(max_num_bits, 2, 2);
+    auto result = words1;
+
+    u64 total = 0;
+    for (u64 i = 0; i < max_performance_iterations; ++i) {
+        result = words1;
+        bitset_ops::and_with(result.data(), words2.data(), num_words);
+        total += bitset_ops::count(result.data(), num_words);
+        bitset_ops::or_with(result.data(), words2.data(), num_words);
+        total += bitset_ops::count(result.data(), num_words);
+        bitset_ops::for_each_set_bit(result.data(), num_words,
+                                     [&] (u64 index) -> void { total += index & 1; });
+    }
+    EXPECT_LT((u64)0, total);
+}
+
+TEST(StdVectorBoolTest, Performance)
+{
+    auto bools1 = to_bools(make_random_words(max_num_bits, 1, 2), max_num_bits);
+    auto bools2 = to_bools(make_random_words(max_num_bits, 2, 2), max_num_bits);
+    std::vector<bool> result(max_num_bits);
+
+    u64 total = 0;
+    for (u64 i = 0; i < max_performance_iterations; ++i) {
+        for (u64 j = 0; j < max_num_bits; ++j) {
+            result[j] = bools1[j] && bools2[j];
+        }
+        for (u64 j = 0; j < max_num_bits; ++j) {
+            total += (result[j] ? 1 : 0);
+        }
+        for (u64 j = 0; j < max_num_bits; ++j) {
+            result[j] = result[j] || bools2[j];
+        }
+        for (u64 j = 0; j < max_num_bits; ++j) {
+            total += (result[j] ? 1 : 0);
+        }
+        for (u64 j = 0; j < max_num_bits; ++j) {
+            if (result[j]) {
+                total += j & 1;
+            }
+        }
+    }
+    EXPECT_LT((u64)0, total);
+}
+
+TEST(StdBitSetTest, Performance)
+{
+    typedef std::bitset<max_num_bits> BitSetType;
+    std::unique_ptr<BitSetType> bits1(new BitSetType());
+    std::unique_ptr<BitSetType> bits2(new BitSetType());
+    std::unique_ptr<BitSetType> result(new BitSetType());
+    auto bools1 = to_bools(make_random_words(max_num_bits, 1, 2), max_num_bits);
+    auto bools2 = to_bools(make_random_words(max_num_bits, 2, 2), max_num_bits);
+    for (u64 j = 0; j < max_num_bits; ++j) {
+        (*bits1)[j] = bools1[j];
+        (*bits2)[j] = bools2[j];
+    }
+
+    u64 total = 0;
+    for (u64 i = 0; i < max_performance_iterations; ++i) {
+        *result = *bits1;
+        *result &= *bits2;
+        total += result->count();
+        *result |= *bits2;
+        total += result->count();
+        for (u64 j = 0; j < max_num_bits; ++j) {
+            if ((*result)[j]) {
+                total += j & 1;
+            }
+        }
+    }
+    EXPECT_LT((u64)0, total);
+}
+
+// Values spread over a few chunks of the 2^32 universe: a sparse chunk,
+// a dense chunk, a chunk of long runs and a chunk near the top
+static inline std::set<u64> make_roaring_values(u64 seed)
+{
+    std::default_random_engine generator(seed);
+    std::uniform_int_distribution<u64> low_distribution(0, (1 << 16) - 1);
+    std::set<u64> retval;
+    for (u64 i = 0; i < 1000; ++i) {
+        retval.insert((3 << 16) + low_distribution(generator));
+    }
+    for (u64 i = 0; i < 20000; ++i) {
+        retval.insert((7 << 16) + low_distribution(generator));
+    }
+    for (u64 start = 0; start < (1 << 16); start += 1000 + low_distribution(generator) % 1000) {
+        for (u64 j = start; j < std::min<u64>(start + 500, 1 << 16); ++j) {
+            retval.insert((11 << 16) + j);
+        }
+    }
+    for (u64 i = 0; i < 100; ++i) {
+        retval.insert(0xFFFF0000 + low_distribution(generator));
+    }
+    return retval;
+}
+
+static inline std::vector<u64> to_vector(const RoaringBitmap& bitmap)
+{
+    std::vector<u64> retval;
+    bitmap.for_each([&] (u64 value) -> void { retval.push_back(value); });
+    return retval;
+}
+
+TEST(RoaringBitmapTest, Functional)
+{
+    for (u64 iteration = 0; iteration < max_test_iterations; ++iteration) {
+        auto values1 = make_roaring_values(2 * iteration);
+        auto values2 = make_roaring_values(2 * iteration + 1);
+        RoaringBitmap bitmap1;
+        RoaringBitmap bitmap2;
+        for (auto value : values1) {
+            bitmap1.set(value);
+        }
+        for (auto value : values2) {
+            bitmap2.set(value);
+        }
+
+        EXPECT_EQ(values1.size(), bitmap1.size());
+        EXPECT_EQ(std::vector<u64>(values1.begin(), values1.end()), to_vector(bitmap1));
+        for (auto value : values1) {
+            EXPECT_TRUE(bitmap1.test(value));
+        }
+        EXPECT_FALSE(bitmap1.test(0));
+        EXPECT_FALSE(bitmap1.test((5 << 16) + 17));
+
+        std::vector<u64> expected_union;
+        std::set_union(values1.begin(), values1.end(), values2.begin(), values2.end(),
+                       std::back_inserter(expected_union));
+        std::vector<u64> expected_intersection;
+        std::set_intersection(values1.begin(), values1.end(), values2.begin(), values2.end(),
+                              std::back_inserter(expected_intersection));
+        EXPECT_EQ(expected_union, to_vector(bitmap1 | bitmap2));
+        EXPECT_EQ(expected_union.size(), (bitmap1 | bitmap2).size());
+        EXPECT_EQ(expected_intersection, to_vector(bitmap1 & bitmap2));
+        EXPECT_EQ(expected_intersection.size(), (bitmap1 & bitmap2).size());
+
+        // run containers hold the same values, and still combine correctly
+        auto optimized1 = bitmap1;
+        auto optimized2 = bitmap2;
+        optimized1.run_optimize();
+        optimized2.run_optimize();
+        EXPECT_TRUE(optimized1 == bitmap1);
+        EXPECT_GT(bitmap1.memory_bytes(), optimized1.memory_bytes());
+        EXPECT_EQ(expected_union, to_vector(optimized1 | optimized2));
+        EXPECT_EQ(expected_intersection, to_vector(optimized1 & bitmap2));
+
+        std::stringstream stream;
+        optimized1.serialize(stream);
+        bitmap2.serialize(stream);
+        RoaringBitmap restored;
+        EXPECT_TRUE(restored.deserialize(stream));
+        EXPECT_TRUE(restored == bitmap1);
+        EXPECT_TRUE(restored.deserialize(stream));
+        EXPECT_TRUE(restored == bitmap2);
+        EXPECT_FALSE(restored.deserialize(stream));
+        EXPECT_TRUE(restored.empty());
+
+        // clear half the values, dense chunks become arrays again
+        u64 i = 0;
+        for (auto it = values1.begin(); it != values1.end(); ++i) {
+            if (i % 2 == 0) {
+                bitmap1.clear(*it);
+                optimized1.clear(*it);
+                it = values1.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        EXPECT_EQ(values1.size(), bitmap1.size());
+        EXPECT_EQ(std::vector<u64>(values1.begin(), values1.end()), to_vector(bitmap1));
+        EXPECT_TRUE(optimized1 == bitmap1);
+
+        for (auto value : values1) {
+            bitmap1.clear(value);
+        }
+        EXPECT_TRUE(bitmap1.empty());
+        EXPECT_TRUE(to_vector(bitmap1).empty());
+        bitmap2.clear();
+        EXPECT_EQ((u64)0, bitmap2.size());
+    }
+}
+
+template <typename T>
+static inline void write_le(std::ostream& out, T value)
+{
+    for (u32 i = 0; i < sizeof(T); ++i) {
+        out.put((char)((u64)value >> (8 * i)));
+    }
+}
+
+// containers whose kind does not match their cardinality are
+// rejected, and equality holds across kinds of container
+TEST(RoaringBitmapTest, Representations)
+{
+    // an array of 4097 values, which must be a bitmap
+    std::stringstream array_stream;
+    write_le<u32>(array_stream, 1);
+    write_le<u16>(array_stream, 0);
+    write_le<u08>(array_stream, 0);
+    write_le<u32>(array_stream, 4097);
+    for (u32 i = 0; i < 4097; ++i) {
+        write_le<u16>(array_stream, i);
+    }
+    RoaringBitmap restored;
+    EXPECT_FALSE(restored.deserialize(array_stream));
+    EXPECT_TRUE(restored.empty());
+
+    // a bitmap of 10 values, which must be an array
+    std::stringstream bitmap_stream;
+    write_le<u32>(bitmap_stream, 1);
+    write_le<u16>(bitmap_stream, 0);
+    write_le<u08>(bitmap_stream, 1);
+    write_le<u32>(bitmap_stream, 10);
+    write_le<u64>(bitmap_stream, 0x3ff);
+    for (u32 i = 1; i < 1024; ++i) {
+        write_le<u64>(bitmap_stream, 0);
+    }
+    EXPECT_FALSE(restored.deserialize(bitmap_stream));
+    EXPECT_TRUE(restored.empty());
+
+    // the same cardinality, as runs, an array and a bitmap
+    for (u32 num_values : { 100, 5000 }) {
+        RoaringBitmap contiguous;
+        RoaringBitmap shifted;
+        for (u32 i = 0; i < num_values; ++i) {
+            contiguous.set(i);
+            shifted.set(i + 1);
+        }
+        auto optimized = contiguous;
+        optimized.run_optimize();
+        EXPECT_TRUE(optimized == contiguous);
+        EXPECT_TRUE(contiguous == optimized);
+        EXPECT_FALSE(optimized == shifted);
+        EXPECT_FALSE(shifted == optimized);
+        EXPECT_FALSE(contiguous == shifted);
+
+        auto optimized_shifted = shifted;
+        optimized_shifted.run_optimize();
+        EXPECT_FALSE(optimized == optimized_shifted);
+        EXPECT_TRUE(optimized_shifted == shifted);
+    }
+}
+
+// sparse sets over the whole 2^32 universe, where a flat bitset
+// would need half a gigabyte, loaded in increasing order
+TEST(RoaringBitmapTest, Performance)
+{
+    std::default_random_engine generator(1);
+    std::uniform_int_distribution<u64> distribution(0, UINT32_MAX);
+    std::vector<u64> values1(1 << 18);
+    std::vector<u64> values2(1 << 18);
+    for (u64 i = 0; i < values1.size(); ++i) {
+        values1[i] = distribution(generator);
+        values2[i] = distribution(generator);
+    }
+    std::sort(values1.begin(), values1.end());
+    std::sort(values2.begin(), values2.end());
+
+    u64 total = 0;
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        RoaringBitmap bitmap1;
+        RoaringBitmap bitmap2;
+        for (u64 j = 0; j < values1.size(); ++j) {
+            bitmap1.set(values1[j]);
+            bitmap2.set(values2[j]);
+        }
+        for (u64 j = 0; j < values1.size(); ++j) {
+            total += (bitmap1.test(values2[j]) ? 1 : 0);
+            total += (bitmap2.test(values2[j]) ? 1 : 0);
+        }
+        total += (bitmap1 | bitmap2).size();
+        total += (bitmap1 & bitmap2).size();
+    }
+    EXPECT_LT((u64)0, total);
+}
+
+//
+// BitSetTests.cpp ends here
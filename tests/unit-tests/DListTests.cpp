@@ -36,6 +36,8 @@
 // Code:
 
 #include "../../projects/kinara-common/src/containers/DList.hpp"
+#include "../../projects/kinara-common/src/containers/UnrolledDList.hpp"
+#include <list>
 #include <vector>
 #include <random>
 #include <cstdlib>
@@ -54,6 +56,8 @@ using kinara::containers::PoolMPtrDList;
 
 using kinara::containers::PoolDList;
 using kinara::containers::u32PoolDList;
+using kinara::containers::UnrolledDList;
+using kinara::containers::u32UnrolledDList;
 
 using testing::Types;
 
@@ -73,8 +77,17 @@ protected:
     virtual ~RCDListTest() {}
 };
 
+template <typename u32UnrolledDListType>
+class u32UnrolledDListTest : public testing::Test
+{
+protected:
+    u32UnrolledDListTest() {}
+    virtual ~u32UnrolledDListTest() {}
+};
+
 TYPED_TEST_CASE_P(u32DListTest);
 TYPED_TEST_CASE_P(RCDListTest);
+TYPED_TEST_CASE_P(u32UnrolledDListTest);
 
 TYPED_TEST_P(u32DListTest, Constructor)
 {
@@ -560,6 +573,447 @@ TYPED_TEST_P(RCDListTest, RefCountableTests)
     list1.clear();
 }
 
+#define LIST_PERF_TEST_SIZE (1 << 16)
+#define LIST_PERF_TEST_ITERATIONS (1 << 6)
+#define LIST_ITERATION_PERF_TEST_ITERATIONS (1 << 10)
+
+// The perf variants build and tear down many lists, so that they
+// mostly measure node allocation and recycling
+TYPED_TEST_P(u32DListTest, SplicePerf)
+{
+    typedef TypeParam u32ListType;
+
+    for (u32 j = 0; j < LIST_PERF_TEST_ITERATIONS; ++j) {
+        u32ListType list1;
+        for (u32 i = 0; i < LIST_PERF_TEST_SIZE; i += 1024) {
+            u32ListType list2;
+            for (u32 k = 0; k < 1024; ++k) {
+                list2.push_back(i + k);
+            }
+            list1.splice(list1.begin(), list2);
+        }
+        EXPECT_EQ((u64)LIST_PERF_TEST_SIZE, list1.size());
+        list1.clear();
+    }
+}
+
+TYPED_TEST_P(u32DListTest, SortMergePerf)
+{
+    typedef TypeParam u32ListType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 30);
+
+    for (u32 j = 0; j < LIST_PERF_TEST_ITERATIONS / 4; ++j) {
+        u32ListType list1, list2;
+        for (u32 i = 0; i < LIST_PERF_TEST_SIZE; ++i) {
+            list1.push_front(distribution(generator));
+            list2.push_front(distribution(generator));
+        }
+        list1.sort();
+        list2.sort();
+        list1.merge(list2);
+        EXPECT_EQ((u64)(2 * LIST_PERF_TEST_SIZE), list1.size());
+        EXPECT_EQ((u64)0, list2.size());
+    }
+}
+
+TYPED_TEST_P(u32DListTest, RemovePerf)
+{
+    typedef TypeParam u32ListType;
+
+    for (u32 j = 0; j < LIST_PERF_TEST_ITERATIONS; ++j) {
+        u32ListType list1;
+        for (u32 i = 0; i < LIST_PERF_TEST_SIZE; ++i) {
+            list1.push_back(i % 16);
+        }
+        for (u32 i = 0; i < 16; i += 2) {
+            list1.remove(i);
+        }
+        EXPECT_EQ((u64)(LIST_PERF_TEST_SIZE / 2), list1.size());
+    }
+}
+
+// The list is sorted before it is traversed, so that the order of the
+// nodes in memory is unrelated to their order in the list, as in a
+// list that has seen a lot of churn
+TYPED_TEST_P(u32DListTest, IterationPerf)
+{
+    typedef TypeParam u32ListType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 16);
+
+    u32ListType list1;
+    u64 expected_sum = 0;
+    for (u32 i = 0; i < LIST_PERF_TEST_SIZE; ++i) {
+        auto num = distribution(generator);
+        list1.push_front(num);
+        expected_sum += num;
+    }
+    list1.sort();
+
+    for (u32 j = 0; j < LIST_ITERATION_PERF_TEST_ITERATIONS; ++j) {
+        u64 sum = 0;
+        for (auto num : list1) {
+            sum += num;
+        }
+        EXPECT_EQ(expected_sum, sum);
+    }
+}
+
+// The unrolled lists are tested with nodes of eight elements as well
+// as with the default, so that even the short lists here span
+// several nodes
+TYPED_TEST_P(u32UnrolledDListTest, Insertions)
+{
+    typedef TypeParam u32ListType;
+
+    u32ListType list1;
+    list1.push_back(2);
+    list1.push_front(1);
+    list1.emplace_back(3);
+    list1.emplace_front(0);
+
+    EXPECT_EQ((u64)4, list1.size());
+    EXPECT_EQ((u32)0, list1.front());
+    EXPECT_EQ((u32)3, list1.back());
+
+    list1.pop_back();
+    list1.pop_front();
+    list1.erase(list1.begin());
+    EXPECT_EQ((u64)1, list1.size());
+    EXPECT_EQ((u32)2, list1.front());
+    EXPECT_EQ((u32)2, list1.back());
+
+    // insertions invalidate the iterators into the node they go
+    // into, so each position is found anew
+    list1 = { 1, 2, 4, 5, 7 };
+    auto position = list1.begin();
+    std::advance(position, 2);
+    auto ins_pos = list1.insert(position, 3);
+    EXPECT_EQ((u32)3, *ins_pos);
+    std::advance(ins_pos, 3);
+    ins_pos = list1.emplace(ins_pos, 6);
+    EXPECT_EQ((u32)6, *ins_pos);
+    list1.insert(list1.begin(), 0);
+    list1.insert(list1.end(), 8);
+
+    u32 i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(i++, num);
+    }
+    EXPECT_EQ((u32)9, i);
+
+    // grow well past a node, inserting into the middle each time
+    list1.clear();
+    for (u32 j = 1; j < 256; j += 2) {
+        list1.push_back(j);
+    }
+    for (auto it = list1.begin(); it != list1.end(); ++it) {
+        it = list1.insert(it, *it - 1);
+        ++it;
+    }
+    EXPECT_EQ((u64)256, list1.size());
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(i++, num);
+    }
+    for (auto it = list1.rbegin(), last = list1.rend(); it != last; ++it) {
+        EXPECT_EQ(--i, *it);
+    }
+
+    auto first = list1.begin();
+    std::advance(first, 10);
+    auto last = first;
+    std::advance(last, 200);
+    auto after = list1.erase(first, last);
+    EXPECT_EQ((u32)210, *after);
+    EXPECT_EQ((u64)56, list1.size());
+
+    list1.resize(5);
+    EXPECT_EQ((u32)4, list1.back());
+    list1.resize(8, 42);
+    EXPECT_EQ((u64)8, list1.size());
+    EXPECT_EQ((u32)42, list1.back());
+}
+
+TYPED_TEST_P(u32UnrolledDListTest, Splice)
+{
+    typedef TypeParam u32ListType;
+
+    u32ListType list1, list2;
+    list1 = { 1, 2, 3, 9, 10 };
+    list2 = { 4, 5, 6, 7, 8 };
+    auto pos = list1.begin();
+    std::advance(pos, 3);
+    list1.splice(pos, list2);
+
+    EXPECT_EQ((u64)10, list1.size());
+    EXPECT_EQ((u64)0, list2.size());
+    EXPECT_TRUE(list2.begin() == list2.end());
+    u32 i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    list1 = { 1, 2, 4, 5 };
+    list2 = { 6, 7, 3, 8, 9, 10 };
+    pos = list1.begin();
+    std::advance(pos, 2);
+    auto opos = list2.begin();
+    std::advance(opos, 2);
+    list1.splice(pos, list2, opos);
+
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    for (auto num : list2) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    list1 = { 1, 2 };
+    list2 = { 3, 4, 5, 6, 7, 8, 9, 10 };
+    auto opos_end = list2.begin();
+    std::advance(opos_end, 3);
+    list1.splice(list1.end(), list2, list2.begin(), opos_end);
+
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    for (auto num : list2) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    // ranges that start and end in the middle of nodes, within one
+    // list as well as between two
+    list1.clear();
+    list2.clear();
+    for (u32 j = 0; j < 100; ++j) {
+        list1.push_back(j);
+        list2.push_back(100 + j);
+    }
+    auto first = list2.begin();
+    std::advance(first, 13);
+    auto last = list2.begin();
+    std::advance(last, 83);
+    pos = list1.begin();
+    std::advance(pos, 37);
+    list1.splice(pos, list2, first, last);
+    EXPECT_EQ((u64)170, list1.size());
+    EXPECT_EQ((u64)30, list2.size());
+
+    std::vector<u32> expected;
+    for (u32 j = 0; j < 37; ++j) {
+        expected.push_back(j);
+    }
+    for (u32 j = 113; j < 183; ++j) {
+        expected.push_back(j);
+    }
+    for (u32 j = 37; j < 100; ++j) {
+        expected.push_back(j);
+    }
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), list1.begin()));
+
+    first = list1.begin();
+    std::advance(first, 37);
+    last = list1.begin();
+    std::advance(last, 107);
+    list1.splice(list1.end(), list1, first, last);
+    EXPECT_EQ((u64)170, list1.size());
+    std::rotate(expected.begin() + 37, expected.begin() + 107, expected.end());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), list1.begin()));
+    EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(), list1.rbegin()));
+}
+
+TYPED_TEST_P(u32UnrolledDListTest, RemoveUniqueSortMerge)
+{
+    typedef TypeParam u32ListType;
+
+    u32ListType list1 = { 1, 2, 3, 3, 4, 5 };
+    list1.remove(3);
+    EXPECT_EQ(u32ListType({ 1, 2, 4, 5 }), list1);
+    list1 = { 1, 2, 2, 3, 4, 4 };
+    list1.unique();
+    EXPECT_EQ(u32ListType({ 1, 2, 3, 4 }), list1);
+    list1.reverse();
+    EXPECT_EQ(u32ListType({ 4, 3, 2, 1 }), list1);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 10);
+    std::vector<u32> expected;
+    u32ListType list2;
+    list1.clear();
+    for (u32 j = 0; j < 1000; ++j) {
+        auto num = distribution(generator);
+        (j % 3 == 0 ? list1 : list2).push_front(num);
+        expected.push_back(num);
+    }
+    list1.sort();
+    list2.sort();
+    list1.merge(list2);
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ((u64)1000, list1.size());
+    EXPECT_EQ((u64)0, list2.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), list1.begin()));
+
+    list1.unique();
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    EXPECT_EQ((u64)expected.size(), list1.size());
+    EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(), list1.rbegin()));
+}
+
+TYPED_TEST_P(u32UnrolledDListTest, Relational)
+{
+    typedef TypeParam u32ListType;
+    u32ListType list1, list2, list3, list4, list5;
+    list1 = { 1, 2, 3, 4, 5 };
+    list5 = { 1, 2, 3, 4, 5 };
+    list2 = { 9, 10 };
+    list3 = { 1, 2, 3, 4, 6 };
+    list4 = { 1, 2, 3, 4 };
+
+    EXPECT_LT(list2, list1);
+    EXPECT_GT(list1, list2);
+    EXPECT_LT(list1, list3);
+    EXPECT_EQ(list1, list5);
+    EXPECT_LT(list4, list3);
+    EXPECT_GT(list3, list4);
+}
+
+// Checks a random mix of operations, including splices between two
+// lists, against std::list
+TYPED_TEST_P(u32UnrolledDListTest, RandomOperations)
+{
+    typedef TypeParam u32ListType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 20);
+
+    u32ListType list1, list2;
+    std::list<u32> expected1, expected2;
+    for (u32 i = 0; i < 20000; ++i) {
+        const u32 num = distribution(generator);
+        const u64 index = (expected1.empty() ? 0 : num % expected1.size());
+        auto position = list1.begin();
+        std::advance(position, index);
+        auto expected_position = expected1.begin();
+        std::advance(expected_position, index);
+
+        switch (num % 8) {
+        case 0:
+            list1.push_back(num);
+            expected1.push_back(num);
+            break;
+        case 1:
+            list1.push_front(num);
+            expected1.push_front(num);
+            break;
+        case 2:
+        case 3:
+            list1.insert(position, num);
+            expected1.insert(expected_position, num);
+            break;
+        case 4:
+            if (!expected1.empty()) {
+                list1.erase(position);
+                expected1.erase(expected_position);
+            }
+            break;
+        case 5:
+            list2.push_back(num);
+            expected2.push_back(num);
+            list2.push_front(num + 1);
+            expected2.push_front(num + 1);
+            break;
+        case 6:
+            if (expected2.size() > 4) {
+                auto first = list2.begin();
+                auto last = list2.end();
+                ++first;
+                --last;
+                auto expected_first = expected2.begin();
+                auto expected_last = expected2.end();
+                ++expected_first;
+                --expected_last;
+                list1.splice(position, list2, first, last);
+                expected1.splice(expected_position, expected2, expected_first, expected_last);
+            }
+            break;
+        default:
+            if (!expected1.empty()) {
+                list2.splice(list2.begin(), list1, position);
+                expected2.splice(expected2.begin(), expected1, expected_position);
+            }
+            break;
+        }
+
+        ASSERT_EQ((u64)expected1.size(), list1.size());
+        ASSERT_EQ((u64)expected2.size(), list2.size());
+        if (i % 256 == 0) {
+            ASSERT_TRUE(std::equal(expected1.begin(), expected1.end(), list1.begin()));
+            ASSERT_TRUE(std::equal(expected2.rbegin(), expected2.rend(), list2.rbegin()));
+        }
+    }
+    EXPECT_TRUE(std::equal(expected1.begin(), expected1.end(), list1.begin()));
+    EXPECT_TRUE(std::equal(expected2.begin(), expected2.end(), list2.begin()));
+}
+
+// The list is sorted before it is traversed, so that the order of the
+// nodes in memory is unrelated to their order in the list, as in a
+// list that has seen a lot of churn
+TYPED_TEST_P(u32UnrolledDListTest, IterationPerf)
+{
+    typedef TypeParam u32ListType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 16);
+
+    u32ListType list1;
+    u64 expected_sum = 0;
+    for (u32 i = 0; i < LIST_PERF_TEST_SIZE; ++i) {
+        auto num = distribution(generator);
+        list1.push_front(num);
+        expected_sum += num;
+    }
+    list1.sort();
+
+    for (u32 j = 0; j < LIST_ITERATION_PERF_TEST_ITERATIONS; ++j) {
+        u64 sum = 0;
+        for (auto num : list1) {
+            sum += num;
+        }
+        EXPECT_EQ(expected_sum, sum);
+    }
+}
+
+TEST(UnrolledDListTest, RefCountableTests)
+{
+    UnrolledDList<RCClass, 8> list1;
+    for (u32 i = 0; i < 128; ++i) {
+        list1.push_back(RCClass(i));
+    }
+
+    list1.emplace_front(128);
+    list1.emplace_back(129);
+
+    auto list2 = list1;
+    auto position = list1.begin();
+    std::advance(position, 64);
+    list1.splice(position, list2, list2.begin(), list2.end());
+    EXPECT_EQ((u64)260, list1.size());
+
+    list1.remove(list1.back());
+    list1.resize(10);
+    EXPECT_EQ((u64)10, list1.size());
+    list1.clear();
+}
+
 REGISTER_TYPED_TEST_CASE_P(u32DListTest,
                            Constructor,
                            Assignment,
@@ -570,17 +1024,32 @@ REGISTER_TYPED_TEST_CASE_P(u32DListTest,
                            Unique,
                            SortMerge,
                            Reverse,
-                           Relational);
+                           Relational,
+                           SplicePerf,
+                           SortMergePerf,
+                           RemovePerf,
+                           IterationPerf);
 
 REGISTER_TYPED_TEST_CASE_P(RCDListTest, RefCountableTests);
 
+REGISTER_TYPED_TEST_CASE_P(u32UnrolledDListTest,
+                           Insertions,
+                           Splice,
+                           RemoveUniqueSortMerge,
+                           Relational,
+                           RandomOperations,
+                           IterationPerf);
+
 typedef Types<u32DList, u32PoolDList> u32DListImplementations;
 typedef Types<MPtrDList<RCClass>, PoolMPtrDList<RCClass>> RCDListImplementations;
+typedef Types<UnrolledDList<u32, 8>, u32UnrolledDList> u32UnrolledDListImplementations;
 
 INSTANTIATE_TYPED_TEST_CASE_P(NonPoolAndPoolDList,
                               u32DListTest, u32DListImplementations);
 INSTANTIATE_TYPED_TEST_CASE_P(NonPoolAndPoolDListRC,
                               RCDListTest, RCDListImplementations);
+INSTANTIATE_TYPED_TEST_CASE_P(SmallAndDefaultNodeUnrolledDList,
+                              u32UnrolledDListTest, u32UnrolledDListImplementations);
 
 //
 // DListTests.cpp ends here
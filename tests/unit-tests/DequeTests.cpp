@@ -36,8 +36,11 @@
 // Code:
 
 #include "../../projects/kinara-common/src/containers/Deque.hpp"
+#include "../../projects/kinara-common/src/containers/ChunkedDeque.hpp"
+#include "../../projects/kinara-common/src/containers/ExternalDeque.hpp"
 #include <algorithm>
 #include <deque>
+#include <string>
 
 #include "RCClass.hpp"
 
@@ -45,9 +48,13 @@
 
 using kinara::u32;
 using kinara::u64;
+using kinara::i64;
 using kinara::containers::Deque;
 using kinara::containers::u32Deque;
 using kinara::containers::MPtrDeque;
+using kinara::containers::ChunkedDeque;
+using kinara::containers::u32ChunkedDeque;
+using kinara::containers::ExternalDeque;
 
 #define MAX_TEST_SIZE 2048
 #define TEST_NUM_ITERATIONS 2048
@@ -533,5 +540,320 @@ TEST(DequeTest, RefCountableTests)
     EXPECT_EQ((u64)MAX_TEST_SIZE, deque2.size());
 }
 
+// Small blocks, so that the random operations below cross
+// block boundaries and grow the block map often
+typedef ChunkedDeque<u32, 16> u32SmallBlockDeque;
+
+TEST(ChunkedDequeTest, Functional)
+{
+    u32SmallBlockDeque deque1;
+    std::deque<u32> std_deque;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, (1 << 30));
+
+    for (u32 i = 0; i < TEST_NUM_ITERATIONS; ++i) {
+        const u32 op = distribution(generator) % 8;
+        const u32 count = 1 + distribution(generator) % 64;
+        if (op <= 1) {
+            for (u32 j = 0; j < count; ++j) {
+                deque1.push_back(i + j);
+                std_deque.push_back(i + j);
+            }
+        } else if (op == 2) {
+            for (u32 j = 0; j < count; ++j) {
+                deque1.push_front(i + j);
+                std_deque.push_front(i + j);
+            }
+        } else if (op == 3) {
+            for (u32 j = 0; j < count && !std_deque.empty(); ++j) {
+                EXPECT_EQ(std_deque.back(), deque1.back());
+                deque1.pop_back();
+                std_deque.pop_back();
+            }
+        } else if (op == 4) {
+            for (u32 j = 0; j < count && !std_deque.empty(); ++j) {
+                EXPECT_EQ(std_deque.front(), deque1.front());
+                deque1.pop_front();
+                std_deque.pop_front();
+            }
+        } else if (op == 5) {
+            std::vector<u32> insert_vector(count, i);
+            const u64 position = distribution(generator) % (std_deque.size() + 1);
+            deque1.insert(deque1.begin() + position, insert_vector.begin(), insert_vector.end());
+            std_deque.insert(std_deque.begin() + position,
+                             insert_vector.begin(), insert_vector.end());
+        } else if (op == 6 && !std_deque.empty()) {
+            const u64 first = distribution(generator) % std_deque.size();
+            const u64 last = first + distribution(generator) % (std_deque.size() - first + 1);
+            deque1.erase(deque1.begin() + first, deque1.begin() + last);
+            std_deque.erase(std_deque.begin() + first, std_deque.begin() + last);
+        } else if (op == 7) {
+            const u64 new_size = distribution(generator) % (2 * std_deque.size() + 1);
+            deque1.resize(new_size, i);
+            std_deque.resize(new_size, i);
+        }
+
+        EXPECT_EQ(std_deque.size(), deque1.size());
+        EXPECT_EQ((i64)std_deque.size(), deque1.end() - deque1.begin());
+        for (u64 j = 0; j < std_deque.size(); ++j) {
+            EXPECT_EQ(std_deque[j], deque1[j]);
+        }
+    }
+
+    auto deque2 = deque1;
+    EXPECT_TRUE(deque2 == deque1);
+    deque2.sort();
+    std::sort(std_deque.begin(), std_deque.end());
+    EXPECT_TRUE(std::equal(std_deque.begin(), std_deque.end(), deque2.begin()));
+
+    deque1.clear();
+    EXPECT_TRUE(deque1.empty());
+    EXPECT_EQ(deque1.begin(), deque1.end());
+
+    // an empty range must leave every element alone, elements
+    // that are moved onto themselves would be left empty
+    ChunkedDeque<std::string, 16> string_deque;
+    for (u32 i = 0; i < 40; ++i) {
+        string_deque.push_back(std::string(32, 'a' + (i % 26)));
+    }
+    for (u64 i = 0; i <= string_deque.size(); i += 7) {
+        auto it = string_deque.erase(string_deque.begin() + i, string_deque.begin() + i);
+        EXPECT_EQ(string_deque.begin() + i, it);
+    }
+    EXPECT_EQ((u64)40, string_deque.size());
+    for (u32 i = 0; i < 40; ++i) {
+        EXPECT_EQ(std::string(32, 'a' + (i % 26)), string_deque[i]);
+    }
+}
+
+TEST(ChunkedDequeTest, AppendRange)
+{
+    u32SmallBlockDeque deque1({1, 2, 3 });
+    std::vector<u32> values;
+    for (u32 i = 4; i <= 100; ++i) {
+        values.push_back(i);
+    }
+
+    deque1.append_range(values.begin(), values.end());
+    EXPECT_EQ(100ull, deque1.size());
+    u32 i = 0;
+    for (auto num : deque1) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ(100u, i);
+
+    // starting in the middle of a block, after pops at the front
+    for (u32 j = 0; j < 37; ++j) {
+        deque1.pop_front();
+    }
+    deque1.append_range(values.begin(), values.end());
+    EXPECT_EQ(63ull + values.size(), deque1.size());
+    EXPECT_EQ(38u, deque1.front());
+    EXPECT_EQ(100u, deque1[62]);
+    EXPECT_EQ(4u, deque1[63]);
+    EXPECT_EQ(100u, deque1.back());
+}
+
+// A queue that is pushed at the back and popped at the front reuses
+// its blocks, and holds on to no more memory than its contents need
+TEST(ChunkedDequeTest, BlockRecycling)
+{
+    u32SmallBlockDeque deque1;
+    const u64 window = 1000;
+
+    for (u32 i = 0; i < window; ++i) {
+        deque1.push_back(i);
+    }
+    const u64 steady_bytes = deque1.memory_bytes();
+
+    for (u32 i = window; i < 1000 * window; ++i) {
+        deque1.push_back(i);
+        EXPECT_EQ(i - window, deque1.front());
+        deque1.pop_front();
+    }
+    EXPECT_EQ(window, deque1.size());
+    EXPECT_GE(2 * steady_bytes, deque1.memory_bytes());
+
+    while (!deque1.empty()) {
+        deque1.pop_front();
+    }
+    deque1.shrink_to_fit();
+    EXPECT_EQ((u64)0, deque1.memory_bytes());
+}
+
+TEST(ChunkedDequeTest, RefCountableTests)
+{
+    ChunkedDeque<RCClass, 16> deque1;
+
+    for (int i = 0; i < MAX_TEST_SIZE; ++i) {
+        if (i % 2 == 0) {
+            deque1.push_back(RCClass(i));
+        } else {
+            deque1.push_front(RCClass(i));
+        }
+    }
+
+    auto deque2 = deque1;
+    for (u32 i = 0; i < MAX_TEST_SIZE; ++i) {
+        EXPECT_EQ((int)deque1[i], (int)deque2[i]);
+    }
+
+    deque1.clear();
+    EXPECT_EQ((u64)MAX_TEST_SIZE, deque2.size());
+}
+
+#define PERF_TEST_SIZE ((u64)100000000)
+
+// The frontier of a breadth first search: a long run of pushes at the
+// back, with the elements read in order and popped from the front
+TEST(ChunkedDequeTest, Performance)
+{
+    u32ChunkedDeque deque1;
+
+    for (u64 i = 0; i < PERF_TEST_SIZE; ++i) {
+        deque1.push_back((u32)i);
+    }
+    EXPECT_EQ(PERF_TEST_SIZE, deque1.size());
+
+    u64 sum = 0;
+    for (u64 i = 0; i < PERF_TEST_SIZE; ++i) {
+        sum += deque1.front();
+        deque1.pop_front();
+    }
+    EXPECT_EQ(PERF_TEST_SIZE * (PERF_TEST_SIZE - 1) / 2, sum);
+    EXPECT_TRUE(deque1.empty());
+}
+
+TEST(StdDequeTest, Performance)
+{
+    std::deque<u32> deque1;
+
+    for (u64 i = 0; i < PERF_TEST_SIZE; ++i) {
+        deque1.push_back((u32)i);
+    }
+    EXPECT_EQ(PERF_TEST_SIZE, deque1.size());
+
+    u64 sum = 0;
+    for (u64 i = 0; i < PERF_TEST_SIZE; ++i) {
+        sum += deque1.front();
+        deque1.pop_front();
+    }
+    EXPECT_EQ(PERF_TEST_SIZE * (PERF_TEST_SIZE - 1) / 2, sum);
+    EXPECT_TRUE(deque1.empty());
+}
+
+// Tiny segments and budget, so that both ends spill, and segments
+// are read back at both ends, many times over
+TEST(ExternalDequeTest, Functional)
+{
+    ExternalDeque<u64> deque1(16, 128);
+    std::deque<u64> std_deque;
+    bool spilled = false;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, (1 << 30));
+
+    for (u32 i = 0; i < TEST_NUM_ITERATIONS; ++i) {
+        const u32 op = distribution(generator) % 6;
+        const u32 count = 1 + distribution(generator) % 512;
+        if (op <= 1) {
+            for (u32 j = 0; j < count; ++j) {
+                deque1.push_back(((u64)i << 32) | j);
+                std_deque.push_back(((u64)i << 32) | j);
+            }
+        } else if (op == 2) {
+            for (u32 j = 0; j < count; ++j) {
+                deque1.push_front(((u64)i << 32) | j);
+                std_deque.push_front(((u64)i << 32) | j);
+            }
+        } else if (op <= 4) {
+            for (u32 j = 0; j < count && !std_deque.empty(); ++j) {
+                EXPECT_EQ(std_deque.front(), deque1.front());
+                deque1.pop_front();
+                std_deque.pop_front();
+            }
+        } else {
+            for (u32 j = 0; j < count && !std_deque.empty(); ++j) {
+                EXPECT_EQ(std_deque.back(), deque1.back());
+                deque1.pop_back();
+                std_deque.pop_back();
+            }
+        }
+
+        EXPECT_EQ(std_deque.size(), deque1.size());
+        EXPECT_GE((u64)256, deque1.size() - deque1.spilled_size());
+        spilled = spilled || (deque1.spilled_size() > 0);
+        if (!std_deque.empty()) {
+            EXPECT_EQ(std_deque.front(), deque1.front());
+            EXPECT_EQ(std_deque.back(), deque1.back());
+        }
+    }
+    EXPECT_TRUE(spilled);
+
+    while (!std_deque.empty()) {
+        EXPECT_EQ(std_deque.front(), deque1.front());
+        deque1.pop_front();
+        std_deque.pop_front();
+    }
+    EXPECT_TRUE(deque1.empty());
+
+    deque1.push_back(42);
+    deque1.clear();
+    EXPECT_TRUE(deque1.empty());
+    EXPECT_EQ((u64)0, deque1.spilled_size());
+}
+
+// A queue of a steady length streaming through the file reuses the
+// extents of the segments it has read back, so the file stays at
+// the size of the segments on disk at any one time
+TEST(ExternalDequeTest, SteadyStream)
+{
+    const u64 queue_length = 2048;
+    const u64 segment_size = 16;
+    ExternalDeque<u64> deque1(segment_size, 128);
+
+    for (u64 i = 0; i < queue_length; ++i) {
+        deque1.push_back(i);
+    }
+    EXPECT_LT((u64)0, deque1.spilled_size());
+
+    const u64 max_file_bytes = (queue_length / segment_size + 2) * segment_size * sizeof(u64);
+    u64 num_out_of_order = 0;
+    for (u64 i = 0; i < 64 * queue_length; ++i) {
+        num_out_of_order += (deque1.front() != i ? 1 : 0);
+        deque1.pop_front();
+        deque1.push_back(queue_length + i);
+        EXPECT_GE(max_file_bytes, deque1.file_bytes());
+    }
+    EXPECT_EQ((u64)0, num_out_of_order);
+    EXPECT_EQ(queue_length, deque1.size());
+
+    deque1.clear();
+    EXPECT_EQ((u64)0, deque1.file_bytes());
+}
+
+// A frontier of 2^25 states, with 2^20 of them in memory, pushed at
+// the back and then streamed from disk at the front
+TEST(ExternalDequeTest, Performance)
+{
+    const u64 num_elements = ((u64)1 << 25);
+    ExternalDeque<u64> deque1((u64)1 << 16, (u64)1 << 20);
+
+    for (u64 i = 0; i < num_elements; ++i) {
+        deque1.push_back(i);
+    }
+    EXPECT_EQ(num_elements, deque1.size());
+    EXPECT_LT(num_elements - ((u64)1 << 20), deque1.spilled_size());
+
+    u64 num_out_of_order = 0;
+    for (u64 i = 0; i < num_elements; ++i) {
+        num_out_of_order += (deque1.front() != i ? 1 : 0);
+        deque1.pop_front();
+    }
+    EXPECT_EQ((u64)0, num_out_of_order);
+    EXPECT_TRUE(deque1.empty());
+}
+
 //
 // DListTests.cpp ends here
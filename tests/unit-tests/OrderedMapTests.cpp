@@ -38,11 +38,13 @@
 // Code:
 
 #include "../../projects/kinara-common/src/containers/OrderedMap.hpp"
+#include "../../projects/kinara-common/src/containers/BTreeOrderedMap.hpp"
 
 #include <utility>
 #include <random>
 #include <algorithm>
 #include <map>
+#include <vector>
 
 #include "RCClass.hpp"
 
@@ -58,7 +60,10 @@ const u64 max_test_iterations = (1 << 4);
 
 using kinara::containers::OrderedMap;
 
+using kinara::containers::BTreeOrderedMap;
+
 typedef OrderedMap<u64, u64> u64u64OrderedMap;
+typedef BTreeOrderedMap<u64, u64> u64u64BTreeOrderedMap;
 
 static inline bool test_equal(const u64u64OrderedMap& kinara_map, const std::map<u64, u64>& std_map)
 {
@@ -81,6 +86,28 @@ static inline bool test_equal(const u64u64OrderedMap& kinara_map, const std::map
     return true;
 }
 
+static inline bool test_equal(const u64u64BTreeOrderedMap& kinara_map,
+                              const std::map<u64, u64>& std_map)
+{
+    if (kinara_map.size() != std_map.size()) {
+        return false;
+    }
+
+    auto it1 = kinara_map.begin();
+    auto it2 = std_map.begin();
+    auto end1 = kinara_map.end();
+    auto end2 = std_map.end();
+
+    while (it1 != end1 && it2 != end2) {
+        if (it1->first != it2->first || it1->second != it2->second) {
+            return false;
+        }
+        ++it1;
+        ++it2;
+    }
+    return (it1 == end1 && it2 == end2);
+}
+
 TEST(OrderedMapTest, Constructor)
 {
     typedef u64u64OrderedMap MapType;
@@ -270,6 +297,154 @@ TEST(OrderedMapTest, Performance)
     }
 }
 
+TEST(BTreeOrderedMapTest, Functional)
+{
+    typedef u64u64BTreeOrderedMap MapType;
+
+    MapType kinara_map;
+    std::map<u64, u64> std_map;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 1);
+    std::uniform_int_distribution<u64> elem_distribution(0, 4 * max_insertion_value);
+
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        std_map.clear();
+        kinara_map.clear();
+
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            auto key = (i % 2 == 0 ? j : elem_distribution(generator));
+            std_map[key] = j + 42;
+            kinara_map[key] = j + 42;
+        }
+        EXPECT_TRUE(test_equal(kinara_map, std_map));
+
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            auto key = (i % 2 == 0 ? j : elem_distribution(generator));
+            if (distribution(generator) == 1) {
+                EXPECT_EQ(std_map.erase(key), kinara_map.erase(key));
+            }
+        }
+        EXPECT_TRUE(test_equal(kinara_map, std_map));
+
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            auto key = elem_distribution(generator);
+            auto std_it = std_map.find(key);
+            auto kinara_it = kinara_map.find(key);
+            EXPECT_EQ(std_it == std_map.end(), kinara_it == kinara_map.end());
+            if (std_it != std_map.end() && kinara_it != kinara_map.end()) {
+                EXPECT_EQ(std_it->second, kinara_it->second);
+            }
+        }
+
+        auto result = kinara_map.emplace(max_insertion_value * 8, 7);
+        EXPECT_TRUE(result.second);
+        EXPECT_EQ(7ull, result.first->second);
+        result = kinara_map.emplace(max_insertion_value * 8, 8);
+        EXPECT_FALSE(result.second);
+        EXPECT_EQ(7ull, result.first->second);
+        std_map[max_insertion_value * 8] = 7;
+        EXPECT_TRUE(test_equal(kinara_map, std_map));
+    }
+}
+
+// the arguments of an emplace may refer to elements of the leaf
+// that the new element goes into, and which it shifts
+TEST(BTreeOrderedMapTest, EmplaceAliasing)
+{
+    typedef u64u64BTreeOrderedMap MapType;
+
+    MapType kinara_map;
+    for (u64 i = 1; i <= 10; ++i) {
+        kinara_map[i * 10] = i * 20;
+    }
+
+    auto result = kinara_map.emplace(5, kinara_map.find(70)->second);
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(140ull, result.first->second);
+    EXPECT_EQ(140ull, kinara_map.find(5)->second);
+    EXPECT_EQ(140ull, kinara_map.find(70)->second);
+
+    result = kinara_map.emplace(kinara_map.find(100)->first + 1, kinara_map.find(100)->second);
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(200ull, kinara_map.find(101)->second);
+    EXPECT_EQ((u64)12, kinara_map.size());
+}
+
+TEST(BTreeOrderedMapTest, RangeScan)
+{
+    typedef u64u64BTreeOrderedMap MapType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> elem_distribution(0, 4 * max_insertion_value);
+
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        // duplicate keys keep their first value, as with insertion
+        std::vector<std::pair<u64, u64>> entries;
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            entries.push_back(std::make_pair(elem_distribution(generator), j));
+        }
+        std::map<u64, u64> std_map(entries.begin(), entries.end());
+        MapType kinara_map(entries.begin(), entries.end());
+        EXPECT_TRUE(test_equal(kinara_map, std_map));
+
+        MapType sorted_map;
+        sorted_map.assign_sorted(std_map.begin(), std_map.end());
+        EXPECT_TRUE(test_equal(sorted_map, std_map));
+
+        for (u64 j = 0; j < 64; ++j) {
+            const u64 low = elem_distribution(generator);
+            const u64 high = low + (1 << (j % 16));
+            u64 expected_sum = 0;
+            for (auto it = std_map.lower_bound(low); it != std_map.lower_bound(high); ++it) {
+                expected_sum += it->first + it->second;
+            }
+
+            u64 sum = 0;
+            kinara_map.for_each_in_range(low, high, [&] (const std::pair<const u64, u64>& entry)
+                                         -> void { sum += entry.first + entry.second; });
+            EXPECT_EQ(expected_sum, sum);
+
+            sum = 0;
+            for (auto it = kinara_map.lower_bound(low); it != kinara_map.lower_bound(high); ++it) {
+                sum += it->first + it->second;
+            }
+            EXPECT_EQ(expected_sum, sum);
+
+            auto std_upper = std_map.upper_bound(low);
+            auto kinara_upper = kinara_map.upper_bound(low);
+            EXPECT_EQ(std_upper == std_map.end(), kinara_upper == kinara_map.end());
+            if (std_upper != std_map.end() && kinara_upper != kinara_map.end()) {
+                EXPECT_EQ(std_upper->first, kinara_upper->first);
+            }
+        }
+    }
+}
+
+TEST(BTreeOrderedMapTest, Performance)
+{
+    typedef u64u64BTreeOrderedMap MapType;
+
+    MapType kinara_map;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 1);
+
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        kinara_map.clear();
+
+        for (u64 i = 0; i < 64 * max_insertion_value; ++i) {
+            kinara_map[i] = i + 42;
+        }
+
+        for (u64 i = 0; i < 64 * max_insertion_value; ++i) {
+            if (distribution(generator) == 1) {
+                kinara_map.erase(i);
+            }
+        }
+    }
+}
+
 TEST(StdVsOrderedMapTest, Performance)
 {
     std::map<u64, u64> std_map;
@@ -38,11 +38,15 @@
 // Code:
 
 #include "../../projects/kinara-common/src/containers/OrderedSet.hpp"
+#include "../../projects/kinara-common/src/containers/BTreeOrderedSet.hpp"
+#include "../../projects/kinara-common/src/containers/RadixSort.hpp"
 
 #include <utility>
 #include <random>
 #include <algorithm>
 #include <set>
+#include <vector>
+#include <string>
 
 #include "RCClass.hpp"
 
@@ -57,6 +61,7 @@ const u64 max_insertion_value = (1 << 18);
 const u64 max_test_iterations = (1 << 4);
 
 using kinara::containers::u64OrderedSet;
+using kinara::containers::u64BTreeOrderedSet;
 
 static inline bool test_equal(const u64OrderedSet& set1, std::set<u64>& set2)
 {
@@ -80,6 +85,28 @@ static inline bool test_equal(const u64OrderedSet& set1, std::set<u64>& set2)
     return true;
 }
 
+static inline bool test_equal(const u64BTreeOrderedSet& set1, std::set<u64>& set2)
+{
+    if (set1.size() != set2.size()) {
+        return false;
+    }
+
+    auto it1 = set1.begin();
+    auto it2 = set2.begin();
+
+    auto end1 = set1.end();
+    auto end2 = set2.end();
+
+    while (it1 != end1 && it2 != end2) {
+        if (*it1 != *it2) {
+            return false;
+        }
+        ++it1;
+        ++it2;
+    }
+    return (it1 == end1 && it2 == end2);
+}
+
 TEST(OrderedSetTest, Constructor)
 {
     typedef u64OrderedSet SetType;
@@ -255,6 +282,158 @@ TEST(OrderedSetTest, Performance)
     }
 }
 
+TEST(BTreeOrderedSetTest, Functional)
+{
+    typedef u64BTreeOrderedSet SetType;
+
+    SetType kinara_set;
+    std::set<u64> std_set;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 1);
+    std::uniform_int_distribution<u64> elem_distribution(0, 4 * max_insertion_value);
+
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        std_set.clear();
+        kinara_set.clear();
+
+        // alternate between ascending and random insertions
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            auto value = (i % 2 == 0 ? j : elem_distribution(generator));
+            EXPECT_EQ(std_set.insert(value).second, kinara_set.insert(value).second);
+        }
+        EXPECT_EQ(std_set.size(), kinara_set.size());
+        EXPECT_TRUE(test_equal(kinara_set, std_set));
+
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            auto value = (i % 2 == 0 ? j : elem_distribution(generator));
+            if (distribution(generator) == 1) {
+                EXPECT_EQ(std_set.erase(value), kinara_set.erase(value));
+            }
+        }
+        EXPECT_EQ(std_set.size(), kinara_set.size());
+        EXPECT_TRUE(test_equal(kinara_set, std_set));
+
+        for (u64 j = 0; j < 1024; ++j) {
+            auto value = elem_distribution(generator);
+            auto std_lower = std_set.lower_bound(value);
+            auto kinara_lower = kinara_set.lower_bound(value);
+            EXPECT_EQ(std_lower == std_set.end(), kinara_lower == kinara_set.end());
+            if (std_lower != std_set.end() && kinara_lower != kinara_set.end()) {
+                EXPECT_EQ(*std_lower, *kinara_lower);
+            }
+            auto std_upper = std_set.upper_bound(value);
+            auto kinara_upper = kinara_set.upper_bound(value);
+            EXPECT_EQ(std_upper == std_set.end(), kinara_upper == kinara_set.end());
+            if (std_upper != std_set.end() && kinara_upper != kinara_set.end()) {
+                EXPECT_EQ(*std_upper, *kinara_upper);
+            }
+            EXPECT_EQ(std_set.count(value), kinara_set.count(value));
+        }
+
+        // iterate backwards
+        auto std_it = std_set.rbegin();
+        for (auto it = kinara_set.end(); it != kinara_set.begin(); ++std_it) {
+            --it;
+            EXPECT_EQ(*std_it, *it);
+        }
+
+        // erase through iterators
+        u64 j = 0;
+        for (auto it = kinara_set.begin(); it != kinara_set.end(); ++j) {
+            if (j % 3 == 0) {
+                std_set.erase(*it);
+                it = kinara_set.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        EXPECT_TRUE(test_equal(kinara_set, std_set));
+
+        kinara_set.shrink_to_fit();
+        EXPECT_TRUE(test_equal(kinara_set, std_set));
+
+        for (auto value : std_set) {
+            kinara_set.erase(value);
+        }
+        EXPECT_TRUE(kinara_set.empty());
+        EXPECT_TRUE(kinara_set.begin() == kinara_set.end());
+    }
+}
+
+TEST(BTreeOrderedSetTest, BulkConstruction)
+{
+    typedef u64BTreeOrderedSet SetType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> elem_distribution(0, 4 * max_insertion_value);
+
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        std::vector<u64> sorted_values;
+        for (u64 j = 0; j < (max_insertion_value >> i); ++j) {
+            sorted_values.push_back(2 * j + i);
+        }
+        SetType kinara_set;
+        kinara_set.assign_sorted(sorted_values.begin(), sorted_values.end());
+        std::set<u64> std_set(sorted_values.begin(), sorted_values.end());
+        EXPECT_TRUE(test_equal(kinara_set, std_set));
+
+        // random values with duplicates, some already present
+        std::vector<u64> values;
+        for (u64 j = 0; j < (max_insertion_value >> (i / 2)); ++j) {
+            values.push_back(elem_distribution(generator));
+        }
+        kinara_set.insert(values.begin(), values.end());
+        std_set.insert(values.begin(), values.end());
+        EXPECT_TRUE(test_equal(kinara_set, std_set));
+
+        SetType other_set;
+        other_set.assign_sorted(values.begin(), values.end());
+        EXPECT_EQ(std::set<u64>(values.begin(), values.end()).size(), other_set.size());
+
+        other_set = kinara_set;
+        EXPECT_TRUE(test_equal(other_set, std_set));
+
+        u64 sum = 0;
+        u64 expected_sum = 0;
+        kinara_set.for_each_in_range(1000, 5000, [&] (u64 value) -> void { sum += value; });
+        for (auto it = std_set.lower_bound(1000); it != std_set.lower_bound(5000); ++it) {
+            expected_sum += *it;
+        }
+        EXPECT_EQ(expected_sum, sum);
+    }
+}
+
+TEST(BTreeOrderedSetTest, Performance)
+{
+    typedef u64BTreeOrderedSet SetType;
+
+    SetType kinara_set;
+    const u64 multiplier = 16;
+    const u64 divisor = 4;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 1);
+    std::uniform_int_distribution<u64> elem_distribution(0, multiplier * max_insertion_value);
+    std::uniform_int_distribution<u64> delete_distribution(0, multiplier * max_insertion_value);
+
+    for (u64 j = 0; j < max_test_iterations / divisor; ++j) {
+        kinara_set.clear();
+
+        for (u64 i = 0; i < multiplier * max_insertion_value; ++i) {
+            kinara_set.insert(elem_distribution(generator));
+        }
+
+        kinara_set.shrink_to_fit();
+
+        for (u64 i = 0; i < multiplier * max_insertion_value; ++i) {
+            if (distribution(generator) == 1) {
+                kinara_set.erase(delete_distribution(generator));
+            }
+        }
+    }
+}
+
 TEST(OrderedVsStdSetTest, Performance)
 {
     typedef std::set<u64> SetType;
@@ -283,5 +462,152 @@ TEST(OrderedVsStdSetTest, Performance)
     }
 }
 
+TEST(RadixSortTest, Functional)
+{
+    using kinara::containers::radix_sort;
+    using kinara::containers::radix_sort_unique;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, max_insertion_value);
+    std::uniform_int_distribution<i64> signed_distribution(-(i64)max_insertion_value,
+                                                           (i64)max_insertion_value);
+
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        // vary the size, small inputs take the comparison sort
+        const u64 size = (max_insertion_value >> i) + i;
+        std::vector<u64> values(size);
+        for (auto& value : values) {
+            value = distribution(generator) << (4 * i);
+        }
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+        radix_sort(values.begin(), values.end());
+        EXPECT_EQ(expected, values);
+
+        // already sorted input is left alone
+        radix_sort(values.begin(), values.end());
+        EXPECT_EQ(expected, values);
+
+        auto new_end = radix_sort_unique(values.begin(), values.end());
+        values.erase(new_end, values.end());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+        EXPECT_EQ(expected, values);
+
+        std::vector<i64> signed_values(size);
+        for (auto& value : signed_values) {
+            value = signed_distribution(generator);
+        }
+        auto signed_expected = signed_values;
+        std::sort(signed_expected.begin(), signed_expected.end());
+        radix_sort(signed_values.begin(), signed_values.end());
+        EXPECT_EQ(signed_expected, signed_values);
+
+        // sorting by key is stable, and unique keeps the first of each key
+        std::vector<std::pair<u32, u64>> entries(size);
+        for (u64 j = 0; j < size; ++j) {
+            entries[j] = std::make_pair((u32)(distribution(generator) % 1024), j);
+        }
+        auto entries_expected = entries;
+        auto key = [] (const std::pair<u32, u64>& entry) -> u32 { return entry.first; };
+        std::stable_sort(entries_expected.begin(), entries_expected.end(),
+                         [] (const std::pair<u32, u64>& a, const std::pair<u32, u64>& b) -> bool
+                         {
+                             return a.first < b.first;
+                         });
+        radix_sort(entries.begin(), entries.end(), key);
+        EXPECT_EQ(entries_expected, entries);
+
+        entries.erase(radix_sort_unique(entries.begin(), entries.end(), key), entries.end());
+        u64 j = 0;
+        for (auto const& entry : entries_expected) {
+            if (j == 0 || entries[j - 1].first != entry.first) {
+                ASSERT_LT(j, entries.size());
+                EXPECT_EQ(entry, entries[j]);
+                ++j;
+            }
+        }
+        EXPECT_EQ(j, entries.size());
+    }
+}
+
+// values with no default constructor, which own memory
+class KeyedString
+{
+public:
+    u32 m_key;
+    std::string m_value;
+
+    KeyedString(u32 key, const std::string& value)
+        : m_key(key), m_value(value)
+    {
+        // Nothing here
+    }
+};
+
+TEST(RadixSortTest, NonDefaultConstructible)
+{
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, (1 << 30));
+
+    // an odd and an even number of passes over the scratch space
+    for (u32 max_key : { (u32)1 << 30, (u32)1 << 20 }) {
+        std::vector<KeyedString> entries;
+        for (u64 i = 0; i < 4096; ++i) {
+            entries.push_back(KeyedString(distribution(generator) % max_key,
+                                          std::string(24, 'a' + (i % 26))));
+        }
+        auto expected = entries;
+        auto less = [] (const KeyedString& a, const KeyedString& b) -> bool
+            {
+                return a.m_key < b.m_key;
+            };
+        std::stable_sort(expected.begin(), expected.end(), less);
+        kinara::containers::radix_sort(entries.begin(), entries.end(),
+                                       [] (const KeyedString& entry) -> u32
+                                       {
+                                           return entry.m_key;
+                                       });
+        ASSERT_EQ(expected.size(), entries.size());
+        for (u64 i = 0; i < entries.size(); ++i) {
+            EXPECT_EQ(expected[i].m_key, entries[i].m_key);
+            EXPECT_EQ(expected[i].m_value, entries[i].m_value);
+        }
+    }
+}
+
+TEST(RadixSortTest, Performance)
+{
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution;
+    std::vector<u64> input(16 * max_insertion_value);
+    for (auto& value : input) {
+        value = distribution(generator);
+    }
+
+    std::vector<u64> values;
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        values = input;
+        kinara::containers::radix_sort(values.begin(), values.end());
+    }
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST(StdVsRadixSortTest, Performance)
+{
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution;
+    std::vector<u64> input(16 * max_insertion_value);
+    for (auto& value : input) {
+        value = distribution(generator);
+    }
+
+    std::vector<u64> values;
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        values = input;
+        std::sort(values.begin(), values.end());
+    }
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
 //
 // OrderedSetTests.cpp ends here
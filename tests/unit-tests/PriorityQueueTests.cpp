@@ -38,6 +38,9 @@
 #include "../../projects/kinara-common/src/containers/PriorityQueue.hpp"
 #include "../../projects/kinara-common/src/containers/Vector.hpp"
 #include "../../projects/kinara-common/src/containers/MultiWayHeap.hpp"
+#include "../../projects/kinara-common/src/containers/AddressableMultiWayHeap.hpp"
+#include "../../projects/kinara-common/src/containers/IntegerPriorityQueue.hpp"
+#include "../../projects/kinara-common/src/containers/MultiQueue.hpp"
 
 #include <vector>
 #include <utility>
@@ -45,6 +48,11 @@
 #include <cstdlib>
 #include <algorithm>
 #include <queue>
+#include <set>
+#include <iterator>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include "RCClass.hpp"
 
@@ -66,6 +74,12 @@ using kinara::containers::TernaryHeap;
 using kinara::containers::QuaternaryHeap;
 using kinara::containers::MultiWayHeap;
 using kinara::containers::Vector;
+using kinara::containers::AddressableMultiWayHeap;
+using kinara::containers::AddressableBinaryHeap;
+using kinara::containers::AddressableQuaternaryHeap;
+using kinara::containers::RadixHeap;
+using kinara::containers::BucketQueue;
+using kinara::containers::MultiQueue;
 
 using testing::Types;
 
@@ -114,8 +128,26 @@ public:
     }
 };
 
+template <typename HeapType>
+class AddressablePrioQueueTest : public testing::Test
+{
+protected:
+    AddressablePrioQueueTest() {}
+    virtual ~AddressablePrioQueueTest() {}
+};
+
+template <typename PrioQueueType>
+class IntegerPrioQueueTest : public testing::Test
+{
+protected:
+    IntegerPrioQueueTest() {}
+    virtual ~IntegerPrioQueueTest() {}
+};
+
 TYPED_TEST_CASE_P(PrioQueueTest);
 TYPED_TEST_CASE_P(PrioQueuePerfTest);
+TYPED_TEST_CASE_P(AddressablePrioQueueTest);
+TYPED_TEST_CASE_P(IntegerPrioQueueTest);
 
 TYPED_TEST_P(PrioQueueTest, Constructor)
 {
@@ -223,6 +255,517 @@ TYPED_TEST_P(PrioQueuePerfTest, PerfTest)
     }
 }
 
+// Random pushes, pops, priority changes and erasures, checked
+// against an ordered set of (value, handle) pairs
+TYPED_TEST_P(AddressablePrioQueueTest, Functional)
+{
+    typedef TypeParam HeapT;
+    typedef typename HeapT::Handle Handle;
+    HeapT heap;
+    std::set<std::pair<i64, Handle> > expected;
+    std::vector<Handle> handles;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<i64> distribution(0, 1 << 20);
+    std::uniform_int_distribution<u32> op_distribution(0, 5);
+
+    for (u32 i = 0; i < NUM_TEST_ITERATIONS; ++i) {
+        for (u32 j = 0; j < MAX_TEST_SIZE; ++j) {
+            const u32 op = (expected.empty() ? 0 : op_distribution(generator));
+            if (op <= 1) {
+                const i64 value = distribution(generator);
+                const Handle handle = heap.push(value);
+                EXPECT_TRUE(expected.insert(std::make_pair(value, handle)).second);
+                handles.push_back(handle);
+                continue;
+            }
+
+            // pick a random live handle, dropping the stale ones
+            const u64 index = distribution(generator) % handles.size();
+            const Handle handle = handles[index];
+            if (!heap.contains(handle)) {
+                handles[index] = handles.back();
+                handles.pop_back();
+                continue;
+            }
+            const i64 value = heap.value(handle);
+            EXPECT_EQ((u64)1, expected.count(std::make_pair(value, handle)));
+            expected.erase(std::make_pair(value, handle));
+
+            if (op == 2) {
+                const i64 new_value = value + distribution(generator) % 1024;
+                heap.increase_key(handle, new_value);
+                expected.insert(std::make_pair(new_value, handle));
+            } else if (op == 3) {
+                const i64 new_value = value - distribution(generator) % 1024;
+                heap.decrease_key(handle, new_value);
+                expected.insert(std::make_pair(new_value, handle));
+            } else if (op == 4) {
+                const i64 new_value = distribution(generator);
+                heap.update(handle, new_value);
+                expected.insert(std::make_pair(new_value, handle));
+            } else {
+                heap.erase(handle);
+                EXPECT_FALSE(heap.contains(handle));
+            }
+
+            EXPECT_EQ(expected.size(), heap.size());
+            if (!expected.empty()) {
+                EXPECT_EQ(expected.rbegin()->first, heap.top());
+                EXPECT_EQ(heap.top(), heap.value(heap.top_handle()));
+            }
+        }
+
+        while (!heap.empty()) {
+            EXPECT_EQ(expected.rbegin()->first, heap.top());
+            expected.erase(std::make_pair(heap.top(), heap.top_handle()));
+            heap.pop();
+        }
+        EXPECT_TRUE(expected.empty());
+        handles.clear();
+    }
+}
+
+// Pushes PERF_TEST_TEST_SIZE elements, then raises the priority of
+// each of them once, as a best-first search would on finding a better
+// path to a state, then pops everything
+TYPED_TEST_P(AddressablePrioQueueTest, PerfTest)
+{
+    typedef TypeParam HeapT;
+    typedef typename HeapT::Handle Handle;
+    HeapT heap;
+    std::vector<Handle> handles(PERF_TEST_TEST_SIZE);
+
+    for (u64 j = 0; j < PERF_TEST_ITERATIONS / 8; ++j) {
+        for (u64 i = 0; i < PERF_TEST_TEST_SIZE; ++i) {
+            handles[i] = heap.push((i64)((i * 0x9E3779B97F4A7C15ULL) >> 34));
+        }
+        for (u64 i = 0; i < PERF_TEST_TEST_SIZE; ++i) {
+            heap.increase_key(handles[i], heap.value(handles[i]) + (1 << 20));
+        }
+
+        EXPECT_EQ(PERF_TEST_TEST_SIZE, heap.size());
+
+        for (u64 i = 0; i < PERF_TEST_TEST_SIZE; ++i) {
+            heap.pop();
+        }
+
+        EXPECT_EQ(0ul, heap.size());
+    }
+}
+
+// Batches of pushes, both smaller and larger than the heap, and
+// batches of pops, checked against a multiset
+TYPED_TEST_P(AddressablePrioQueueTest, BulkOperations)
+{
+    typedef TypeParam HeapT;
+    typedef typename HeapT::Handle Handle;
+    HeapT heap;
+    std::multiset<i64> expected;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<i64> distribution(0, 1 << 20);
+
+    for (u32 i = 0; i < NUM_TEST_ITERATIONS; ++i) {
+        const u64 batch_size = 1 + distribution(generator) % MAX_TEST_SIZE;
+        std::vector<i64> values(batch_size);
+        for (auto& value : values) {
+            value = distribution(generator);
+        }
+        std::vector<Handle> handles;
+        heap.push_range(values.begin(), values.end(), std::back_inserter(handles));
+        expected.insert(values.begin(), values.end());
+
+        EXPECT_EQ(batch_size, handles.size());
+        for (u64 j = 0; j < batch_size; ++j) {
+            EXPECT_TRUE(heap.contains(handles[j]));
+            EXPECT_EQ(values[j], heap.value(handles[j]));
+        }
+        EXPECT_EQ(expected.size(), heap.size());
+        EXPECT_EQ(*expected.rbegin(), heap.top());
+
+        std::vector<i64> popped;
+        const u64 num_to_pop = distribution(generator) % (heap.size() + 1);
+        heap.pop_n(num_to_pop, std::back_inserter(popped));
+        EXPECT_EQ(num_to_pop, popped.size());
+        for (auto value : popped) {
+            EXPECT_EQ(*expected.rbegin(), value);
+            expected.erase(std::prev(expected.end()));
+        }
+        EXPECT_EQ(expected.size(), heap.size());
+        if (!heap.empty()) {
+            EXPECT_EQ(*expected.rbegin(), heap.top());
+        }
+    }
+
+    // popping more than there is empties the heap, top down
+    std::vector<i64> popped;
+    heap.pop_n(heap.size() + 1, std::back_inserter(popped));
+    EXPECT_TRUE(heap.empty());
+    EXPECT_TRUE(std::equal(popped.begin(), popped.end(), expected.rbegin()));
+    EXPECT_EQ(expected.size(), popped.size());
+}
+
+// Pushes 0 to PERF_TEST_TEST_SIZE one at a time, then pops them one
+// at a time, as in PrioQueuePerfTest
+TYPED_TEST_P(AddressablePrioQueueTest, PushPopPerfTest)
+{
+    typedef TypeParam HeapT;
+    HeapT heap;
+
+    for (u64 j = 0; j < PERF_TEST_ITERATIONS / 8; ++j) {
+        for (u64 i = 0; i < PERF_TEST_TEST_SIZE; ++i) {
+            heap.push((i64)i);
+        }
+
+        EXPECT_EQ(PERF_TEST_TEST_SIZE, heap.size());
+
+        for (u64 i = 0; i < PERF_TEST_TEST_SIZE; ++i) {
+            heap.pop();
+        }
+
+        EXPECT_EQ(0ul, heap.size());
+    }
+}
+
+// The same work with push_range() and pop_n()
+TYPED_TEST_P(AddressablePrioQueueTest, BulkPerfTest)
+{
+    typedef TypeParam HeapT;
+    HeapT heap;
+    std::vector<i64> values(PERF_TEST_TEST_SIZE);
+    std::vector<i64> popped(PERF_TEST_TEST_SIZE);
+
+    for (u64 j = 0; j < PERF_TEST_ITERATIONS / 8; ++j) {
+        for (u64 i = 0; i < PERF_TEST_TEST_SIZE; ++i) {
+            values[i] = (i64)i;
+        }
+        heap.push_range(values.begin(), values.end());
+
+        EXPECT_EQ(PERF_TEST_TEST_SIZE, heap.size());
+
+        heap.pop_n(PERF_TEST_TEST_SIZE, popped.begin());
+
+        EXPECT_EQ(0ul, heap.size());
+        EXPECT_EQ((i64)PERF_TEST_TEST_SIZE - 1, popped[0]);
+    }
+}
+
+// The same work with std::priority_queue, pushing a duplicate for each
+// change of priority and skipping the stale entries as they surface
+TEST(LazyDeletionPrioQueueTest, PerfTest)
+{
+    std::priority_queue<std::pair<i64, u64> > prio_queue;
+    std::vector<i64> current(PERF_TEST_TEST_SIZE);
+
+    for (u64 j = 0; j < PERF_TEST_ITERATIONS / 8; ++j) {
+        for (u64 i = 0; i < PERF_TEST_TEST_SIZE; ++i) {
+            current[i] = (i64)((i * 0x9E3779B97F4A7C15ULL) >> 34);
+            prio_queue.push(std::make_pair(current[i], i));
+        }
+        for (u64 i = 0; i < PERF_TEST_TEST_SIZE; ++i) {
+            current[i] += (1 << 20);
+            prio_queue.push(std::make_pair(current[i], i));
+        }
+
+        EXPECT_EQ(2 * PERF_TEST_TEST_SIZE, prio_queue.size());
+
+        u64 num_popped = 0;
+        while (!prio_queue.empty()) {
+            auto const& top = prio_queue.top();
+            if (top.first == current[top.second]) {
+                ++num_popped;
+            }
+            prio_queue.pop();
+        }
+
+        EXPECT_EQ(PERF_TEST_TEST_SIZE, num_popped);
+    }
+}
+
+// Checks the integer queues against std::priority_queue, under the
+// Comparator of the queue, in the pattern of a Dijkstra search: pushed
+// values are never above the value last popped, which both queues
+// need for RadixHeap and which stresses the range of BucketQueue
+TYPED_TEST_P(IntegerPrioQueueTest, Functional)
+{
+    typedef TypeParam PrioQueueT;
+    typedef typename PrioQueueT::ComparatorType ComparatorT;
+    PrioQueueT prio_queue;
+    std::priority_queue<i64, std::vector<i64>, ComparatorT> std_prio_queue;
+    ComparatorT comparator;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<i64> distribution(0, 1 << 10);
+
+    for (u32 i = 0; i < NUM_TEST_ITERATIONS; ++i) {
+        const i64 start = distribution(generator) - (1 << 9);
+        prio_queue.push(start);
+        std_prio_queue.push(start);
+
+        for (u32 j = 0; j < MAX_TEST_SIZE && !prio_queue.empty(); ++j) {
+            EXPECT_EQ(std_prio_queue.size(), prio_queue.size());
+            EXPECT_EQ(std_prio_queue.top(), prio_queue.top());
+            const i64 current = prio_queue.top();
+            prio_queue.pop();
+            std_prio_queue.pop();
+
+            const u32 num_to_push = (j < MAX_TEST_SIZE / 2 ? 3 : 1);
+            for (u32 k = 0; k < num_to_push; ++k) {
+                const i64 delta = distribution(generator) % 64;
+                const i64 value = (comparator(current, current + 1) ?
+                                   current - delta : current + delta);
+                prio_queue.push(value);
+                std_prio_queue.push(value);
+            }
+        }
+
+        while (!prio_queue.empty()) {
+            EXPECT_EQ(std_prio_queue.top(), prio_queue.top());
+            prio_queue.pop();
+            std_prio_queue.pop();
+        }
+        EXPECT_TRUE(std_prio_queue.empty());
+    }
+
+    // arbitrary pushes are fine before the first pop
+    for (u32 i = 0; i < MAX_TEST_SIZE; ++i) {
+        const i64 value = distribution(generator) - (1 << 9);
+        prio_queue.push(value);
+        std_prio_queue.push(value);
+    }
+    while (!prio_queue.empty()) {
+        EXPECT_EQ(std_prio_queue.top(), prio_queue.top());
+        prio_queue.pop();
+        std_prio_queue.pop();
+    }
+}
+
+// values too far apart for the counts are refused, and leave
+// the queue as it was
+TEST(BucketQueueTest, Span)
+{
+    BucketQueue<i64> prio_queue;
+    prio_queue.push(0);
+    prio_queue.push(1 << 20);
+    EXPECT_THROW(prio_queue.push((i64)1 << 40), std::length_error);
+    EXPECT_THROW(prio_queue.push(-((i64)1 << 40)), std::length_error);
+    EXPECT_EQ((u64)2, prio_queue.size());
+    EXPECT_EQ(1 << 20, prio_queue.top());
+    prio_queue.pop();
+    EXPECT_EQ(0, prio_queue.top());
+    prio_queue.pop();
+    EXPECT_TRUE(prio_queue.empty());
+
+    // once empty, the range starts afresh
+    prio_queue.push((i64)1 << 40);
+    EXPECT_EQ((i64)1 << 40, prio_queue.top());
+    prio_queue.pop();
+
+    // the counts cover at most 2^24 values, in either direction
+    prio_queue.push(0);
+    prio_queue.push((1 << 24) - 1);
+    EXPECT_THROW(prio_queue.push(1 << 24), std::length_error);
+    EXPECT_THROW(prio_queue.push(-1), std::length_error);
+    prio_queue.pop();
+    prio_queue.push(-((1 << 24) - 1));
+    EXPECT_THROW(prio_queue.push(1), std::length_error);
+    EXPECT_EQ((u64)2, prio_queue.size());
+    EXPECT_EQ(0, prio_queue.top());
+    prio_queue.pop();
+    EXPECT_EQ(-((1 << 24) - 1), prio_queue.top());
+}
+
+static inline u64 get_num_test_threads()
+{
+    auto retval = std::thread::hardware_concurrency();
+    return (retval < 2 ? 2 : retval);
+}
+
+// With a single queue, a MultiQueue is an exact priority queue
+TEST(MultiQueueTest, SingleQueue)
+{
+    MultiQueue<i64> prio_queue(1, 1);
+    std::priority_queue<i64> std_prio_queue;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<i64> distribution(0, 1 << 20);
+
+    for (u32 i = 0; i < NUM_TEST_ITERATIONS; ++i) {
+        for (u32 j = 0; j < MAX_TEST_SIZE; ++j) {
+            const i64 value = distribution(generator);
+            prio_queue.push(value);
+            std_prio_queue.push(value);
+        }
+        EXPECT_EQ(std_prio_queue.size(), prio_queue.size());
+
+        i64 value;
+        while (!std_prio_queue.empty()) {
+            EXPECT_TRUE(prio_queue.try_pop(value));
+            EXPECT_EQ(std_prio_queue.top(), value);
+            std_prio_queue.pop();
+        }
+        EXPECT_TRUE(prio_queue.empty());
+        EXPECT_FALSE(prio_queue.try_pop(value));
+    }
+}
+
+// Threads push disjoint ranges of values while popping, then drain
+// the queue; every value must come out exactly once
+TEST(MultiQueueTest, Functional)
+{
+    const u64 num_threads = get_num_test_threads();
+    const u64 num_per_thread = MAX_TEST_SIZE * NUM_TEST_ITERATIONS;
+    MultiQueue<i64> prio_queue(num_threads);
+    std::vector<std::vector<i64> > popped(num_threads);
+
+    std::vector<std::thread> threads;
+    for (u64 t = 0; t < num_threads; ++t) {
+        threads.push_back(std::thread([&, t] () -> void
+                                      {
+                                          i64 value;
+                                          for (u64 i = 0; i < num_per_thread; ++i) {
+                                              prio_queue.push((i64)(i * num_threads + t));
+                                              if (i % 3 == 0 && prio_queue.try_pop(value)) {
+                                                  popped[t].push_back(value);
+                                              }
+                                          }
+                                          while (prio_queue.try_pop(value)) {
+                                              popped[t].push_back(value);
+                                          }
+                                      }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(prio_queue.empty());
+    std::vector<i64> all_popped;
+    for (auto const& values : popped) {
+        all_popped.insert(all_popped.end(), values.begin(), values.end());
+    }
+    std::sort(all_popped.begin(), all_popped.end());
+    EXPECT_EQ(num_threads * num_per_thread, all_popped.size());
+    for (u64 i = 0; i < all_popped.size(); ++i) {
+        EXPECT_EQ((i64)i, all_popped[i]);
+    }
+}
+
+// Measures how far pops stray from the true top: the rank error of a
+// pop is the number of elements still in the queue that are better
+// than the one popped, tracked with a Fenwick tree over the values
+TEST(MultiQueueTest, RankError)
+{
+    const u64 num_threads = get_num_test_threads();
+    const u64 num_values = PERF_TEST_TEST_SIZE / 4;
+    MultiQueue<i64> prio_queue(num_threads);
+    std::vector<u64> fenwick(num_values + 1, 0);
+
+    std::vector<i64> values(num_values);
+    for (u64 i = 0; i < num_values; ++i) {
+        values[i] = (i64)i;
+    }
+    std::default_random_engine generator;
+    std::shuffle(values.begin(), values.end(), generator);
+    for (auto value : values) {
+        prio_queue.push(value);
+        for (u64 j = value + 1; j <= num_values; j += (j & (~j + 1))) {
+            ++fenwick[j];
+        }
+    }
+
+    u64 total_rank_error = 0;
+    u64 max_rank_error = 0;
+    i64 value;
+    for (u64 i = 0; i < num_values; ++i) {
+        EXPECT_TRUE(prio_queue.try_pop(value));
+        u64 num_not_better = 0;
+        for (u64 j = value + 1; j > 0; j -= (j & (~j + 1))) {
+            num_not_better += fenwick[j];
+        }
+        const u64 rank_error = (num_values - i) - num_not_better;
+        total_rank_error += rank_error;
+        max_rank_error = std::max(max_rank_error, rank_error);
+        for (u64 j = value + 1; j <= num_values; j += (j & (~j + 1))) {
+            --fenwick[j];
+        }
+    }
+    EXPECT_TRUE(prio_queue.empty());
+
+    const double mean_rank_error = (double)total_rank_error / num_values;
+    printf("MultiQueue with %llu queues: mean rank error %.2f, max rank error %llu\n",
+           (unsigned long long)prio_queue.get_num_queues(), mean_rank_error,
+           (unsigned long long)max_rank_error);
+    EXPECT_LT(mean_rank_error, (double)(4 * prio_queue.get_num_queues()));
+}
+
+// Every thread repeatedly pops an element and pushes two successors,
+// as the workers of a parallel best-first search would
+TEST(MultiQueueTest, Performance)
+{
+    const u64 num_threads = get_num_test_threads();
+    const u64 num_per_thread = PERF_TEST_TEST_SIZE * 4 / num_threads;
+    MultiQueue<i64> prio_queue(num_threads);
+
+    std::vector<std::thread> threads;
+    for (u64 t = 0; t < num_threads; ++t) {
+        threads.push_back(std::thread([&, t] () -> void
+                                      {
+                                          i64 value = (i64)t;
+                                          prio_queue.push(value);
+                                          for (u64 i = 0; i < num_per_thread; ++i) {
+                                              if (!prio_queue.try_pop(value)) {
+                                                  value = (i64)i;
+                                              }
+                                              prio_queue.push(value - (i64)(i % 7));
+                                              prio_queue.push(value - (i64)(i % 13));
+                                          }
+                                      }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(num_threads * (num_per_thread + 1), prio_queue.size());
+}
+
+// The same work on a single priority queue behind a mutex
+TEST(LockedPrioQueueTest, ConcurrentPerformance)
+{
+    const u64 num_threads = get_num_test_threads();
+    const u64 num_per_thread = PERF_TEST_TEST_SIZE * 4 / num_threads;
+    i64PriorityQueue prio_queue;
+    std::mutex prio_queue_mutex;
+
+    std::vector<std::thread> threads;
+    for (u64 t = 0; t < num_threads; ++t) {
+        threads.push_back(std::thread([&, t] () -> void
+                                      {
+                                          i64 value = (i64)t;
+                                          {
+                                              std::lock_guard<std::mutex> guard(prio_queue_mutex);
+                                              prio_queue.push(value);
+                                          }
+                                          for (u64 i = 0; i < num_per_thread; ++i) {
+                                              std::lock_guard<std::mutex> guard(prio_queue_mutex);
+                                              if (!prio_queue.empty()) {
+                                                  value = prio_queue.top();
+                                                  prio_queue.pop();
+                                              } else {
+                                                  value = (i64)i;
+                                              }
+                                              prio_queue.push(value - (i64)(i % 7));
+                                              prio_queue.push(value - (i64)(i % 13));
+                                          }
+                                      }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(num_threads * (num_per_thread + 1), prio_queue.size());
+}
+
 REGISTER_TYPED_TEST_CASE_P(PrioQueueTest,
                            Constructor,
                            Functional);
@@ -230,6 +773,16 @@ REGISTER_TYPED_TEST_CASE_P(PrioQueueTest,
 REGISTER_TYPED_TEST_CASE_P(PrioQueuePerfTest,
                            PerfTest);
 
+REGISTER_TYPED_TEST_CASE_P(AddressablePrioQueueTest,
+                           Functional,
+                           PerfTest,
+                           BulkOperations,
+                           PushPopPerfTest,
+                           BulkPerfTest);
+
+REGISTER_TYPED_TEST_CASE_P(IntegerPrioQueueTest,
+                           Functional);
+
 typedef Types<PriorityQueue<std::pair<i64, i64>,
                             i64i64PairCompare,
                             BinaryHeap<std::pair<i64, i64> > >,
@@ -248,14 +801,35 @@ typedef Types<PriorityQueue<i64, std::less<i64>, BinaryHeap<i64> >,
               PriorityQueue<i64, std::less<i64>, MultiWayHeap<i64, std::less<i64>, 6> >,
               PriorityQueue<i64, std::less<i64>, MultiWayHeap<i64, std::less<i64>, 7> >,
               PriorityQueue<i64, std::less<i64>, MultiWayHeap<i64, std::less<i64>, 8> >,
+              RadixHeap<i64, std::less<i64> >,
+              BucketQueue<i64, std::less<i64> >,
               std::priority_queue<i64, std::vector<i64>, std::greater<i64> > >
 PriorityQueuePerfImplementations;
 
+typedef Types<AddressableBinaryHeap<i64>,
+              AddressableQuaternaryHeap<i64>,
+              AddressableMultiWayHeap<i64, std::less<i64>, 8> >
+AddressablePriorityQueueImplementations;
+
+typedef Types<RadixHeap<i64, std::less<i64> >,
+              RadixHeap<i64, std::greater<i64> >,
+              BucketQueue<i64, std::less<i64> >,
+              BucketQueue<i64, std::greater<i64> > >
+IntegerPriorityQueueImplementations;
+
 INSTANTIATE_TYPED_TEST_CASE_P(PrioQueueTemplateTests,
                               PrioQueueTest, PriorityQueueImplementations);
 
 INSTANTIATE_TYPED_TEST_CASE_P(PrioQueuePerfTests,
                               PrioQueuePerfTest, PriorityQueuePerfImplementations);
 
+INSTANTIATE_TYPED_TEST_CASE_P(AddressablePrioQueueTests,
+                              AddressablePrioQueueTest,
+                              AddressablePriorityQueueImplementations);
+
+INSTANTIATE_TYPED_TEST_CASE_P(IntegerPrioQueueTests,
+                              IntegerPrioQueueTest,
+                              IntegerPriorityQueueImplementations);
+
 //
 // PriorityQueueTests.cpp ends here
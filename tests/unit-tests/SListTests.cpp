@@ -38,7 +38,12 @@
 // Code:
 
 #include "../../projects/kinara-common/src/containers/SList.hpp"
+#include "../../projects/kinara-common/src/containers/NodePool.hpp"
+#include "../../projects/kinara-common/src/containers/UnrolledSList.hpp"
+#include <list>
+#include <string>
 #include <vector>
+#include <thread>
 #include <random>
 #include <cstdlib>
 #include <algorithm>
@@ -56,6 +61,9 @@ using kinara::containers::PoolMPtrSList;
 
 using kinara::containers::PoolSList;
 using kinara::containers::u32PoolSList;
+using kinara::containers::NodePool;
+using kinara::containers::UnrolledSList;
+using kinara::containers::u32UnrolledSList;
 
 using testing::Types;
 
@@ -76,8 +84,17 @@ protected:
     virtual ~RCSListTest() {}
 };
 
+template <typename u32UnrolledSListType>
+class u32UnrolledSListTest : public ::testing::Test
+{
+protected:
+    u32UnrolledSListTest() {}
+    virtual ~u32UnrolledSListTest() {}
+};
+
 TYPED_TEST_CASE_P(u32SListTest);
 TYPED_TEST_CASE_P(RCSListTest);
+TYPED_TEST_CASE_P(u32UnrolledSListTest);
 
 TYPED_TEST_P(u32SListTest, Constructor)
 {
@@ -691,6 +708,820 @@ TYPED_TEST_P(RCSListTest, RefCountableTests)
     list1.clear();
 }
 
+#define LIST_PERF_TEST_SIZE (1 << 16)
+#define LIST_PERF_TEST_ITERATIONS (1 << 6)
+#define LIST_ITERATION_PERF_TEST_ITERATIONS (1 << 10)
+#define LIST_SORT_PERF_TEST_SIZE (1 << 20)
+#define LIST_SORT_PERF_TEST_ITERATIONS (1 << 2)
+
+// The perf variants build and tear down many lists, so that they
+// mostly measure node allocation and recycling
+TYPED_TEST_P(u32SListTest, SplicePerf)
+{
+    typedef TypeParam u32ListType;
+
+    for (u32 j = 0; j < LIST_PERF_TEST_ITERATIONS; ++j) {
+        u32ListType list1;
+        for (u32 i = 0; i < LIST_PERF_TEST_SIZE; i += 1024) {
+            u32ListType list2;
+            for (u32 k = 0; k < 1024; ++k) {
+                list2.push_back(i + k);
+            }
+            list1.splice_after(list1.before_begin(), list2);
+        }
+        EXPECT_EQ((u64)LIST_PERF_TEST_SIZE, list1.size());
+        list1.clear();
+    }
+}
+
+TYPED_TEST_P(u32SListTest, SortMergePerf)
+{
+    typedef TypeParam u32ListType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 30);
+
+    for (u32 j = 0; j < LIST_PERF_TEST_ITERATIONS / 4; ++j) {
+        u32ListType list1, list2;
+        for (u32 i = 0; i < LIST_PERF_TEST_SIZE; ++i) {
+            list1.push_front(distribution(generator));
+            list2.push_front(distribution(generator));
+        }
+        list1.sort();
+        list2.sort();
+        list1.merge(list2);
+        EXPECT_EQ((u64)(2 * LIST_PERF_TEST_SIZE), list1.size());
+        EXPECT_EQ((u64)0, list2.size());
+    }
+}
+
+TYPED_TEST_P(u32SListTest, RemovePerf)
+{
+    typedef TypeParam u32ListType;
+
+    for (u32 j = 0; j < LIST_PERF_TEST_ITERATIONS; ++j) {
+        u32ListType list1;
+        for (u32 i = 0; i < LIST_PERF_TEST_SIZE; ++i) {
+            list1.push_back(i % 16);
+        }
+        for (u32 i = 0; i < 16; i += 2) {
+            list1.remove(i);
+        }
+        EXPECT_EQ((u64)(LIST_PERF_TEST_SIZE / 2), list1.size());
+    }
+}
+
+// The list is sorted before it is traversed, so that the order of the
+// nodes in memory is unrelated to their order in the list, as in a
+// list that has seen a lot of churn
+TYPED_TEST_P(u32SListTest, IterationPerf)
+{
+    typedef TypeParam u32ListType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 16);
+
+    u32ListType list1;
+    u64 expected_sum = 0;
+    for (u32 i = 0; i < LIST_PERF_TEST_SIZE; ++i) {
+        auto num = distribution(generator);
+        list1.push_front(num);
+        expected_sum += num;
+    }
+    list1.sort();
+
+    for (u32 j = 0; j < LIST_ITERATION_PERF_TEST_ITERATIONS; ++j) {
+        u64 sum = 0;
+        for (auto num : list1) {
+            sum += num;
+        }
+        EXPECT_EQ(expected_sum, sum);
+    }
+}
+
+class PoolTestNode
+{
+public:
+    PoolTestNode* m_next;
+    u64 m_value;
+};
+
+typedef NodePool<PoolTestNode> PoolTestNodePool;
+
+static inline u64 get_num_test_threads()
+{
+    auto retval = std::thread::hardware_concurrency();
+    return (retval < 2 ? 2 : retval);
+}
+
+TEST(NodePoolTest, Functional)
+{
+    const u64 num_nodes = 10000;
+    const u64 in_use_before = PoolTestNodePool::get_thread_statistics().get_num_in_use();
+
+    PoolTestNode* first = nullptr;
+    std::vector<PoolTestNode*> nodes;
+    for (u64 i = 0; i < num_nodes; ++i) {
+        auto node = static_cast<PoolTestNode*>(PoolTestNodePool::allocate());
+        node->m_value = i;
+        node->m_next = first;
+        first = node;
+        nodes.push_back(node);
+    }
+    // the end of the chain is the first node allocated
+    PoolTestNode* last = nodes.front();
+    std::sort(nodes.begin(), nodes.end());
+    EXPECT_TRUE(std::adjacent_find(nodes.begin(), nodes.end()) == nodes.end());
+
+    auto statistics = PoolTestNodePool::get_thread_statistics();
+    const u64 num_slabs = statistics.m_num_slabs;
+    EXPECT_EQ(in_use_before + num_nodes, statistics.get_num_in_use());
+    EXPECT_EQ((u64)1, statistics.m_num_pools);
+
+    // half of them one at a time, the rest as one chain
+    for (u64 i = 0; i < num_nodes / 2; ++i) {
+        auto next = first->m_next;
+        PoolTestNodePool::deallocate(first);
+        first = next;
+    }
+    PoolTestNodePool::deallocate_chain(first, last, num_nodes / 2);
+    EXPECT_EQ(in_use_before, PoolTestNodePool::get_thread_statistics().get_num_in_use());
+
+    // the nodes are reused
+    for (u64 i = 0; i < num_nodes; ++i) {
+        nodes[i] = static_cast<PoolTestNode*>(PoolTestNodePool::allocate());
+    }
+    EXPECT_EQ(num_slabs, PoolTestNodePool::get_thread_statistics().m_num_slabs);
+    for (auto node : nodes) {
+        PoolTestNodePool::deallocate(node);
+    }
+}
+
+// Nodes built by this thread and freed by others come back to this
+// thread's pool, which then needs no more slabs
+TEST(NodePoolTest, CrossThreadReturn)
+{
+    const u64 num_nodes = 1 << 16;
+    std::vector<PoolTestNode*> nodes(num_nodes);
+    u64 num_slabs = 0;
+
+    for (u32 j = 0; j < 16; ++j) {
+        for (u64 i = 0; i < num_nodes; ++i) {
+            nodes[i] = static_cast<PoolTestNode*>(PoolTestNodePool::allocate());
+            nodes[i]->m_value = i;
+        }
+        if (j == 0) {
+            num_slabs = PoolTestNodePool::get_thread_statistics().m_num_slabs;
+        }
+
+        const u64 num_threads = get_num_test_threads();
+        std::vector<std::thread> threads;
+        for (u64 t = 0; t < num_threads; ++t) {
+            threads.push_back(std::thread([&, t] () -> void
+                                          {
+                                              for (u64 i = t; i < num_nodes; i += num_threads) {
+                                                  EXPECT_EQ(i, nodes[i]->m_value);
+                                                  PoolTestNodePool::deallocate(nodes[i]);
+                                              }
+                                          }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    EXPECT_EQ(num_slabs, PoolTestNodePool::get_thread_statistics().m_num_slabs);
+    auto statistics = PoolTestNodePool::get_statistics();
+    EXPECT_LE((u64)1, statistics.m_num_pools);
+    EXPECT_EQ((u64)0, statistics.get_num_in_use());
+}
+
+#define NODE_POOL_PERF_TEST_SIZE (1 << 10)
+#define NODE_POOL_PERF_TEST_ITERATIONS (1 << 12)
+
+// Every thread repeatedly builds a list of nodes and frees it
+TEST(NodePoolTest, Performance)
+{
+    const u64 num_threads = get_num_test_threads();
+    std::vector<std::thread> threads;
+    for (u64 t = 0; t < num_threads; ++t) {
+        threads.push_back(std::thread([&] () -> void
+                                      {
+                                          for (u32 j = 0; j < NODE_POOL_PERF_TEST_ITERATIONS; ++j) {
+                                              PoolTestNode* first = nullptr;
+                                              PoolTestNode* last = nullptr;
+                                              for (u32 i = 0; i < NODE_POOL_PERF_TEST_SIZE; ++i) {
+                                                  auto node = static_cast<PoolTestNode*>(PoolTestNodePool::allocate());
+                                                  node->m_next = first;
+                                                  first = node;
+                                                  last = (last == nullptr ? node : last);
+                                              }
+                                              PoolTestNodePool::deallocate_chain(first, last, NODE_POOL_PERF_TEST_SIZE);
+                                          }
+                                      }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+TEST(NewDeleteTest, Performance)
+{
+    const u64 num_threads = get_num_test_threads();
+    std::vector<std::thread> threads;
+    for (u64 t = 0; t < num_threads; ++t) {
+        threads.push_back(std::thread([&] () -> void
+                                      {
+                                          for (u32 j = 0; j < NODE_POOL_PERF_TEST_ITERATIONS; ++j) {
+                                              PoolTestNode* first = nullptr;
+                                              for (u32 i = 0; i < NODE_POOL_PERF_TEST_SIZE; ++i) {
+                                                  auto node = new PoolTestNode();
+                                                  node->m_next = first;
+                                                  first = node;
+                                              }
+                                              while (first != nullptr) {
+                                                  auto next = first->m_next;
+                                                  delete first;
+                                                  first = next;
+                                              }
+                                          }
+                                      }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// The unrolled lists are tested with nodes of eight elements as well
+// as with the default, so that even the short lists here span
+// several nodes
+TYPED_TEST_P(u32UnrolledSListTest, Insertions)
+{
+    typedef TypeParam u32ListType;
+
+    u32ListType list1;
+    list1.push_back(2);
+    list1.push_front(1);
+    list1.emplace_back(3);
+    list1.emplace_front(0);
+
+    EXPECT_EQ((u64)4, list1.size());
+    EXPECT_EQ((u32)0, list1.front());
+    EXPECT_EQ((u32)3, list1.back());
+
+    list1.pop_back();
+    list1.pop_front();
+    EXPECT_EQ((u64)2, list1.size());
+    EXPECT_EQ((u32)1, list1.front());
+    EXPECT_EQ((u32)2, list1.back());
+
+    list1.erase_after(list1.begin());
+    EXPECT_EQ((u64)1, list1.size());
+    list1.erase(list1.begin());
+    EXPECT_EQ((u64)0, list1.size());
+    EXPECT_TRUE(list1.begin() == list1.end());
+
+    // insertions invalidate the iterators into the node they go
+    // into, so each position is found anew
+    list1 = { 1, 2, 4, 5, 7 };
+    auto position = list1.begin();
+    ++position;
+    auto ins_pos = list1.insert_after(position, 3);
+    EXPECT_EQ((u32)3, *ins_pos);
+    ++ins_pos;
+    ++ins_pos;
+    ins_pos = list1.insert_after(ins_pos, 6);
+    EXPECT_EQ((u32)6, *ins_pos);
+    ins_pos = list1.insert(list1.begin(), 0);
+    EXPECT_EQ((u32)0, *ins_pos);
+    ins_pos = list1.insert(list1.end(), 8);
+    EXPECT_EQ((u32)8, *ins_pos);
+    list1.emplace_after(list1.before_begin(), 42);
+    list1.pop_front();
+
+    EXPECT_EQ((u64)9, list1.size());
+    u32 i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(i++, num);
+    }
+    EXPECT_EQ((u32)9, i);
+
+    // grow well past a node, inserting into the middle each time
+    list1.clear();
+    for (u32 j = 0; j < 256; j += 2) {
+        list1.push_back(j);
+    }
+    for (auto it = list1.begin(); it != list1.end(); ++it) {
+        it = list1.insert_after(it, *it + 1);
+    }
+    EXPECT_EQ((u64)256, list1.size());
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(i++, num);
+    }
+
+    auto first = list1.begin();
+    std::advance(first, 10);
+    auto last = first;
+    std::advance(last, 201);
+    auto after = list1.erase_after(first, last);
+    EXPECT_EQ((u32)211, *after);
+    EXPECT_EQ((u64)56, list1.size());
+
+    list1.resize(5);
+    EXPECT_EQ((u64)5, list1.size());
+    EXPECT_EQ((u32)4, list1.back());
+    list1.resize(8, 42);
+    EXPECT_EQ((u64)8, list1.size());
+    EXPECT_EQ((u32)42, list1.back());
+}
+
+TYPED_TEST_P(u32UnrolledSListTest, Splice)
+{
+    typedef TypeParam u32ListType;
+
+    u32ListType list1, list2;
+    list1 = { 1, 2, 3, 9, 10 };
+    list2 = { 4, 5, 6, 7, 8 };
+
+    auto pos = list1.begin();
+    ++pos;
+    ++pos;
+    list1.splice_after(pos, list2);
+
+    EXPECT_EQ((u64)10, list1.size());
+    EXPECT_EQ((u64)0, list2.size());
+    EXPECT_TRUE(list2.begin() == list2.end());
+    u32 i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    list1 = { 1, 2, 3, 9, 10 };
+    list2 = { 4, 5, 6, 7, 8 };
+    pos = list1.begin();
+    std::advance(pos, 3);
+    list1.splice(pos, list2);
+
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    list1 = { 1, 2, 4, 5 };
+    list2 = { 6, 7, 3, 8, 9, 10 };
+    pos = list1.begin();
+    ++pos;
+    auto opos = list2.begin();
+    ++opos;
+    list1.splice_after(pos, list2, opos);
+    EXPECT_EQ((u64)5, list1.size());
+    EXPECT_EQ((u64)5, list2.size());
+
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    for (auto num : list2) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    list1 = { 1, 2, 5 };
+    list2 = { 3, 4, 6, 7, 8, 9, 10 };
+    pos = list1.begin();
+    ++pos;
+    auto opos_end = list2.begin();
+    std::advance(opos_end, 2);
+    list1.splice_after(pos, list2, list2.before_begin(), opos_end);
+    EXPECT_EQ((u64)5, list1.size());
+    EXPECT_EQ((u64)5, list2.size());
+
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    for (auto num : list2) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    list1 = { 1, 2 };
+    list2 = { 3, 4, 5, 6, 7, 8, 9, 10 };
+    opos_end = list2.begin();
+    std::advance(opos_end, 3);
+    list1.splice(list1.end(), list2, list2.before_begin(), opos_end);
+
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    for (auto num : list2) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    list1 = { 1, 2, 4, 5 };
+    list2 = { 6, 7, 3, 8, 9, 10 };
+    pos = list1.begin();
+    std::advance(pos, 2);
+    opos = list2.begin();
+    std::advance(opos, 2);
+    list1.splice_element(pos, list2, opos);
+
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    for (auto num : list2) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    list1 = { 2, 3, 4, 5 };
+    list2 = { 6, 7, 8, 9, 10, 1 };
+    opos = list2.begin();
+    std::advance(opos, 5);
+    list1.splice_element_after(list1.before_begin(), list2, opos);
+
+    i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    for (auto num : list2) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    // ranges that start and end in the middle of nodes, in both
+    // directions within one list as well as between two
+    list1.clear();
+    list2.clear();
+    for (u32 j = 0; j < 100; ++j) {
+        list1.push_back(j);
+        list2.push_back(100 + j);
+    }
+    auto before_first = list2.begin();
+    std::advance(before_first, 12);
+    auto last = list2.begin();
+    std::advance(last, 83);
+    pos = list1.begin();
+    std::advance(pos, 37);
+    list1.splice(pos, list2, before_first, last);
+    EXPECT_EQ((u64)170, list1.size());
+    EXPECT_EQ((u64)30, list2.size());
+
+    std::vector<u32> expected;
+    for (u32 j = 0; j < 37; ++j) {
+        expected.push_back(j);
+    }
+    for (u32 j = 113; j < 183; ++j) {
+        expected.push_back(j);
+    }
+    for (u32 j = 37; j < 100; ++j) {
+        expected.push_back(j);
+    }
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), list1.begin()));
+
+    before_first = list1.begin();
+    std::advance(before_first, 36);
+    last = list1.begin();
+    std::advance(last, 107);
+    list1.splice_after(list1.before_begin(), list1, before_first, last);
+    EXPECT_EQ((u64)170, list1.size());
+    std::rotate(expected.begin(), expected.begin() + 37, expected.begin() + 107);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), list1.begin()));
+}
+
+TYPED_TEST_P(u32UnrolledSListTest, RemoveUnique)
+{
+    typedef TypeParam u32ListType;
+
+    u32ListType list1 = { 1, 2, 3, 4, 5 };
+    list1.remove(3);
+    EXPECT_EQ((u64)4, list1.size());
+    EXPECT_EQ(u32ListType({ 1, 2, 4, 5 }), list1);
+
+    list1 = { 1, 2, 2, 3, 4, 4 };
+    list1.unique();
+    EXPECT_EQ(u32ListType({ 1, 2, 3, 4 }), list1);
+
+    list1.clear();
+    for (u32 i = 0; i < 1000; ++i) {
+        list1.push_back(i % 10);
+        list1.push_back(i % 10);
+    }
+    list1.remove_if([] (u32 num) -> bool { return (num % 2 == 1); });
+    EXPECT_EQ((u64)1000, list1.size());
+    list1.remove(list1.front());
+    EXPECT_EQ((u64)800, list1.size());
+    list1.unique();
+    EXPECT_EQ((u64)400, list1.size());
+
+    u32 i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ((u32)(2 + 2 * (i++ % 4)), num);
+    }
+}
+
+TYPED_TEST_P(u32UnrolledSListTest, SortMergeReverse)
+{
+    typedef TypeParam u32ListType;
+
+    u32ListType list1 = { 5, 10, 9, 1, 2 };
+    u32ListType list2 = { 4, 6, 8, 7, 3 };
+    list1.sort();
+    list2.sort();
+    EXPECT_EQ(u32ListType({ 1, 2, 5, 9, 10 }), list1);
+    EXPECT_EQ(u32ListType({ 3, 4, 6, 7, 8 }), list2);
+
+    list1.merge(list2);
+    EXPECT_EQ((u64)10, list1.size());
+    EXPECT_EQ((u64)0, list2.size());
+    u32 i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(++i, num);
+    }
+    EXPECT_EQ((u32)10, i);
+
+    list1.reverse();
+    for (auto num : list1) {
+        EXPECT_EQ(i--, num);
+    }
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 10);
+    std::vector<u32> expected;
+    list1.clear();
+    for (u32 j = 0; j < 1000; ++j) {
+        auto num = distribution(generator);
+        (j % 3 == 0 ? list1 : list2).push_front(num);
+        expected.push_back(num);
+    }
+    list1.sort();
+    list2.sort(std::less<u32>());
+    list1.merge(list2);
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ((u64)1000, list1.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), list1.begin()));
+
+    list1.reverse();
+    EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(), list1.begin()));
+}
+
+TYPED_TEST_P(u32UnrolledSListTest, Relational)
+{
+    typedef TypeParam u32ListType;
+    u32ListType list1, list2, list3, list4, list5;
+    list1 = { 1, 2, 3, 4, 5 };
+    list5 = { 1, 2, 3, 4, 5 };
+    list2 = { 9, 10 };
+    list3 = { 1, 2, 3, 4, 6 };
+    list4 = { 1, 2, 3, 4 };
+
+    EXPECT_LT(list2, list1);
+    EXPECT_GT(list1, list2);
+    EXPECT_LT(list1, list3);
+    EXPECT_EQ(list1, list5);
+    EXPECT_LT(list4, list3);
+    EXPECT_GT(list3, list4);
+
+    auto list6 = list1;
+    EXPECT_EQ(list1, list6);
+    auto list7 = std::move(list6);
+    EXPECT_EQ(list1, list7);
+    EXPECT_EQ((u64)0, list6.size());
+    list7.swap(list2);
+    EXPECT_EQ(list1, list2);
+    EXPECT_EQ(u32ListType({ 9, 10 }), list7);
+}
+
+// Sorts lists that are in order, in reverse order, made of a few
+// sorted runs, and random. The keys are in the upper half of each
+// number and the original position in the lower half, to check
+// that the sort is stable
+TYPED_TEST_P(u32UnrolledSListTest, SortRuns)
+{
+    typedef TypeParam u32ListType;
+
+    auto by_key = [] (u32 num1, u32 num2) -> bool { return ((num1 >> 16) < (num2 >> 16)); };
+    auto check_sorted = [&] (const u32ListType& list, u64 size) -> void
+        {
+            EXPECT_EQ(size, list.size());
+            EXPECT_TRUE(std::is_sorted(list.begin(), list.end()));
+        };
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 63);
+
+    for (u32 num_runs : { 1, 2, 5, 16, 17, 1000 }) {
+        u32ListType list1;
+        for (u32 i = 0; i < 4000; ++i) {
+            list1.push_back(((num_runs - 1 - (i * num_runs / 4000)) << 16) | i);
+        }
+        // each run is a block of equal keys, and the blocks are in
+        // descending order of key
+        list1.sort(by_key);
+        check_sorted(list1, 4000);
+    }
+
+    u32ListType list1;
+    for (u32 i = 0; i < 4000; ++i) {
+        list1.push_front(i);
+    }
+    list1.sort();
+    u32 i = 0;
+    for (auto num : list1) {
+        EXPECT_EQ(i++, num);
+    }
+    list1.sort();
+    check_sorted(list1, 4000);
+
+    list1.clear();
+    for (u32 j = 0; j < 4000; ++j) {
+        list1.push_back((distribution(generator) << 16) | j);
+    }
+    list1.sort(by_key);
+    check_sorted(list1, 4000);
+
+    list1 = { 3, 3 };
+    list1.sort();
+    EXPECT_EQ(u32ListType({ 3, 3 }), list1);
+}
+
+// Checks a random mix of operations against std::list
+TYPED_TEST_P(u32UnrolledSListTest, RandomOperations)
+{
+    typedef TypeParam u32ListType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 20);
+
+    u32ListType list1;
+    std::list<u32> expected;
+    for (u32 i = 0; i < 20000; ++i) {
+        const u32 num = distribution(generator);
+        const u64 index = (expected.empty() ? 0 : num % expected.size());
+        auto position = list1.begin();
+        std::advance(position, index);
+        auto expected_position = expected.begin();
+        std::advance(expected_position, index);
+
+        switch (num % 8) {
+        case 0:
+        case 1:
+            list1.push_back(num);
+            expected.push_back(num);
+            break;
+        case 2:
+            list1.push_front(num);
+            expected.push_front(num);
+            break;
+        case 3:
+        case 4:
+            list1.insert(position, num);
+            expected.insert(expected_position, num);
+            break;
+        case 5:
+            if (!expected.empty()) {
+                list1.erase(position);
+                expected.erase(expected_position);
+            }
+            break;
+        case 6:
+            if (!expected.empty()) {
+                list1.pop_front();
+                expected.pop_front();
+            }
+            break;
+        default:
+            if (!expected.empty()) {
+                list1.pop_back();
+                expected.pop_back();
+            }
+            break;
+        }
+
+        ASSERT_EQ((u64)expected.size(), list1.size());
+        if (i % 256 == 0) {
+            ASSERT_TRUE(std::equal(expected.begin(), expected.end(), list1.begin()));
+        }
+    }
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), list1.begin()));
+}
+
+// The list is sorted before it is traversed, so that the order of the
+// nodes in memory is unrelated to their order in the list, as in a
+// list that has seen a lot of churn
+TYPED_TEST_P(u32UnrolledSListTest, IterationPerf)
+{
+    typedef TypeParam u32ListType;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 16);
+
+    u32ListType list1;
+    u64 expected_sum = 0;
+    for (u32 i = 0; i < LIST_PERF_TEST_SIZE; ++i) {
+        auto num = distribution(generator);
+        list1.push_front(num);
+        expected_sum += num;
+    }
+    list1.sort();
+
+    for (u32 j = 0; j < LIST_ITERATION_PERF_TEST_ITERATIONS; ++j) {
+        u64 sum = 0;
+        for (auto num : list1) {
+            sum += num;
+        }
+        EXPECT_EQ(expected_sum, sum);
+    }
+}
+
+// Random lists, and then lists made of a few sorted runs
+template <typename ListType>
+static inline void run_sort_perf_workloads()
+{
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 30);
+
+    for (u32 j = 0; j < LIST_SORT_PERF_TEST_ITERATIONS; ++j) {
+        ListType list1;
+        for (u32 i = 0; i < LIST_SORT_PERF_TEST_SIZE; ++i) {
+            list1.push_back(distribution(generator));
+        }
+        list1.sort();
+        EXPECT_TRUE(std::is_sorted(list1.begin(), list1.end()));
+
+        ListType list2;
+        for (u32 i = 0; i < LIST_SORT_PERF_TEST_SIZE; ++i) {
+            list2.push_back(i % (LIST_SORT_PERF_TEST_SIZE / 8));
+        }
+        list2.sort();
+        EXPECT_TRUE(std::is_sorted(list2.begin(), list2.end()));
+    }
+}
+
+TYPED_TEST_P(u32UnrolledSListTest, SortPerf)
+{
+    run_sort_perf_workloads<TypeParam>();
+}
+
+TEST(StdListTest, SortPerf)
+{
+    run_sort_perf_workloads<std::list<u32>>();
+}
+
+TEST(UnrolledSListTest, RefCountableTests)
+{
+    UnrolledSList<RCClass, 8> list1;
+    for (u32 i = 0; i < 128; ++i) {
+        list1.push_back(RCClass(i));
+    }
+
+    list1.emplace_front(128);
+    list1.emplace_back(129);
+    list1.insert_after(list1.begin(), RCClass(130));
+
+    auto list2 = list1;
+    list2.sort();
+    list1.merge(list2);
+    EXPECT_EQ((u64)262, list1.size());
+
+    list1.remove(list1.front());
+    list1.unique();
+    list1.resize(10);
+    EXPECT_EQ((u64)10, list1.size());
+    list1.clear();
+}
+
+// Strings are sorted through an array of pointers to them
+TEST(UnrolledSListTest, StableSortOfStrings)
+{
+    typedef std::pair<u32, std::string> KeyedString;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 63);
+
+    UnrolledSList<KeyedString, 8> list1;
+    std::vector<KeyedString> expected;
+    for (u32 i = 0; i < 4000; ++i) {
+        expected.push_back(KeyedString(distribution(generator), std::to_string(i)));
+        list1.push_back(expected.back());
+    }
+
+    auto by_key = [] (const KeyedString& string1, const KeyedString& string2) -> bool
+        {
+            return (string1.first < string2.first);
+        };
+    list1.sort(by_key);
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+    EXPECT_EQ((u64)4000, list1.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), list1.begin()));
+}
+
 REGISTER_TYPED_TEST_CASE_P(u32SListTest,
                            Constructor,
                            Assignment,
@@ -701,17 +1532,35 @@ REGISTER_TYPED_TEST_CASE_P(u32SListTest,
                            Unique,
                            SortMerge,
                            Reverse,
-                           Relational);
+                           Relational,
+                           SplicePerf,
+                           SortMergePerf,
+                           RemovePerf,
+                           IterationPerf);
 
 REGISTER_TYPED_TEST_CASE_P(RCSListTest, RefCountableTests);
 
+REGISTER_TYPED_TEST_CASE_P(u32UnrolledSListTest,
+                           Insertions,
+                           Splice,
+                           RemoveUnique,
+                           SortMergeReverse,
+                           SortRuns,
+                           Relational,
+                           RandomOperations,
+                           IterationPerf,
+                           SortPerf);
+
 typedef Types<u32SList, u32PoolSList> u32SListImplementations;
 typedef Types<MPtrSList<RCClass>, PoolMPtrSList<RCClass>> RCSListImplementations;
+typedef Types<UnrolledSList<u32, 8>, u32UnrolledSList> u32UnrolledSListImplementations;
 
 INSTANTIATE_TYPED_TEST_CASE_P(NonPoolAndPoolSList,
                               u32SListTest, u32SListImplementations);
 INSTANTIATE_TYPED_TEST_CASE_P(NonPoolAndPoolSListRC,
                               RCSListTest, RCSListImplementations);
+INSTANTIATE_TYPED_TEST_CASE_P(SmallAndDefaultNodeUnrolledSList,
+                              u32UnrolledSListTest, u32UnrolledSListImplementations);
 
 //
 // SListTests.cpp ends here
@@ -38,11 +38,15 @@
 // Code:
 
 #include "../../projects/kinara-common/src/containers/UnorderedMap.hpp"
+#include "../../projects/kinara-common/src/containers/SwissUnorderedMap.hpp"
+#include "../../projects/kinara-common/src/containers/CompactUnorderedMap.hpp"
+#include "../../projects/kinara-common/src/containers/CuckooUnorderedMap.hpp"
 #include "../../projects/kinara-common/src/containers/Vector.hpp"
 
 #include <utility>
 #include <random>
 #include <algorithm>
+#include <string>
 #include <unordered_map>
 
 #include "RCClass.hpp"
@@ -64,6 +68,9 @@ const u64 max_test_iterations = (1 << 4);
 using kinara::containers::UnifiedUnorderedMap;
 using kinara::containers::RestrictedUnorderedMap;
 using kinara::containers::SegregatedUnorderedMap;
+using kinara::containers::SwissUnorderedMap;
+using kinara::containers::CompactUnorderedMap;
+using kinara::containers::CuckooUnorderedMap;
 using kinara::containers::Vector;
 using kinara::containers::u64Vector;
 
@@ -318,15 +325,402 @@ TEST(StdUnorderedMapTest, Performance)
     }
 }
 
+TYPED_TEST_P(UnorderedMapTest, LookupPerformance)
+{
+    typedef TypeParam MapType;
+
+    MapType kinara_map;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 32 * max_insertion_value - 1);
+
+    for (u64 i = 0; i < 16 * max_insertion_value; ++i) {
+        kinara_map[distribution(generator)] = i;
+    }
+
+    u64 num_found = 0;
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        for (u64 i = 0; i < 16 * max_insertion_value; ++i) {
+            if (kinara_map.find(distribution(generator)) != kinara_map.end()) {
+                ++num_found;
+            }
+        }
+    }
+
+    EXPECT_GT(num_found, (u64)0);
+}
+
+TEST(StdUnorderedMapTest, LookupPerformance)
+{
+    std::unordered_map<u64, u64> std_map;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 32 * max_insertion_value - 1);
+
+    for (u64 i = 0; i < 16 * max_insertion_value; ++i) {
+        std_map[distribution(generator)] = i;
+    }
+
+    u64 num_found = 0;
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        for (u64 i = 0; i < 16 * max_insertion_value; ++i) {
+            if (std_map.find(distribution(generator)) != std_map.end()) {
+                ++num_found;
+            }
+        }
+    }
+
+    EXPECT_GT(num_found, (u64)0);
+}
+
+TEST(SwissUnorderedMapTest, IncrementalRehash)
+{
+    std::unordered_map<u64, u64> std_map;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 1);
+
+    bool saw_rehash = false;
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        // start afresh, clear() would keep the capacity
+        SwissUnorderedMap<u64, u64> kinara_map;
+        kinara_map.set_incremental_rehash(true);
+        std_map.clear();
+
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            std_map[j] = j + 42;
+            kinara_map[j] = j + 42;
+            saw_rehash = saw_rehash || kinara_map.is_rehashing();
+
+            // erase a random element from among the ones
+            // in both the old and the new table
+            if (kinara_map.is_rehashing() && distribution(generator) == 1) {
+                auto victim = j / 2;
+                EXPECT_EQ(std_map.erase(victim), kinara_map.erase(victim));
+            }
+            EXPECT_EQ(std_map.size(), kinara_map.size());
+        }
+
+        EXPECT_TRUE(test_equal(kinara_map, std_map));
+
+        // a copy made mid rehash has all the elements
+        while (!kinara_map.is_rehashing()) {
+            auto j = max_insertion_value + kinara_map.size();
+            std_map[j] = j + 42;
+            kinara_map[j] = j + 42;
+        }
+        SwissUnorderedMap<u64, u64> map_copy(kinara_map);
+        EXPECT_FALSE(map_copy.is_rehashing());
+        EXPECT_TRUE(test_equal(map_copy, std_map));
+        EXPECT_TRUE(test_equal(kinara_map, std_map));
+
+        // erasing through iterators visits both tables
+        for (auto it = kinara_map.begin(); it != kinara_map.end(); ) {
+            if (distribution(generator) == 1) {
+                std_map.erase(it->first);
+                it = kinara_map.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        EXPECT_TRUE(test_equal(kinara_map, std_map));
+    }
+    EXPECT_TRUE(saw_rehash);
+}
+
+// lookups must not move elements out from under references, and
+// erasing with a key that lives in the table must erase it
+TEST(SwissUnorderedMapTest, IncrementalRehashAliasing)
+{
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        SwissUnorderedMap<u64, u64> kinara_map;
+        kinara_map.set_incremental_rehash(true);
+
+        u64 j = 0;
+        while (!kinara_map.is_rehashing()) {
+            kinara_map[j] = j + 42;
+            ++j;
+        }
+
+        // a reference into the old table survives any number of finds
+        u64& value_ref = kinara_map.find(0)->second;
+        for (u64 k = 0; k < j; ++k) {
+            EXPECT_EQ(k + 42, kinara_map.find(k)->second);
+        }
+        EXPECT_TRUE(kinara_map.is_rehashing());
+        EXPECT_EQ(&value_ref, &(kinara_map.find(0)->second));
+        EXPECT_EQ((u64)42, value_ref);
+
+        // erase elements through dereferenced iterators, the
+        // first ones are in the old table while it is being drained
+        while (kinara_map.size() > 0) {
+            auto it = kinara_map.begin();
+            const u64 key = it->first;
+            const u64 expected_size = kinara_map.size() - 1;
+            EXPECT_EQ((u64)1, kinara_map.erase(it->first));
+            EXPECT_EQ(expected_size, kinara_map.size());
+            EXPECT_TRUE(kinara_map.find(key) == kinara_map.end());
+        }
+    }
+}
+
+TEST(SwissUnorderedMapTest, EmplaceAliasing)
+{
+    // the value is taken from an element that the growth
+    // of the table moves, with and without incremental rehashing
+    for (u64 i = 0; i < 2; ++i) {
+        SwissUnorderedMap<u64, std::string> kinara_map;
+        kinara_map.set_incremental_rehash(i == 1);
+        kinara_map[0] = std::string(64, 'x');
+
+        for (u64 j = 1; j < 4 * max_insertion_value; ++j) {
+            EXPECT_TRUE(kinara_map.emplace(j, kinara_map.find(j - 1)->second).second);
+        }
+        for (auto const& entry : kinara_map) {
+            EXPECT_EQ(std::string(64, 'x'), entry.second);
+        }
+    }
+}
+
+TEST(SwissUnorderedMapTest, NoReservedValues)
+{
+    // the deleted and nonused values are ignored, so they are keys
+    // like any other
+    SwissUnorderedMap<u64, u64> kinara_map((u64)0, (u64)1);
+    kinara_map.set_deleted_value(2);
+    kinara_map.set_nonused_value(3);
+
+    for (u64 key = 0; key < 4; ++key) {
+        kinara_map[key] = key + 42;
+    }
+    EXPECT_EQ((u64)4, kinara_map.size());
+    for (u64 key = 0; key < 4; ++key) {
+        EXPECT_EQ(key + 42, kinara_map.find(key)->second);
+    }
+    EXPECT_EQ((u64)1, kinara_map.erase(2));
+    EXPECT_TRUE(kinara_map.find(2) == kinara_map.end());
+    EXPECT_EQ((u64)3, kinara_map.size());
+}
+
+TEST(SwissUnorderedMapTest, IncrementalRehashPerformance)
+{
+    SwissUnorderedMap<u64, u64> kinara_map;
+    kinara_map.set_incremental_rehash(true);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 1);
+
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        kinara_map.clear();
+
+        for (u64 i = 0; i < 64 * max_insertion_value; ++i) {
+            kinara_map[i] = i + 42;
+        }
+
+        for (u64 i = 0; i < 64 * max_insertion_value; ++i) {
+            if (distribution(generator) == 1) {
+                kinara_map.erase(i);
+            }
+        }
+    }
+}
+
+TEST(CuckooUnorderedMapTest, EmplaceAliasing)
+{
+    // the value is taken from an element that the growth
+    // of the table moves
+    CuckooUnorderedMap<u64, std::string> kinara_map;
+    kinara_map[0] = std::string(64, 'x');
+
+    for (u64 j = 1; j < 4 * max_insertion_value; ++j) {
+        auto result = kinara_map.emplace(j, kinara_map.find(j - 1)->second);
+        EXPECT_TRUE(result.second);
+        EXPECT_EQ(j, result.first->first);
+    }
+    EXPECT_EQ(4 * max_insertion_value, kinara_map.size());
+    for (auto const& entry : kinara_map) {
+        EXPECT_EQ(std::string(64, 'x'), entry.second);
+    }
+}
+
+// scatters the keys, so that buckets overflow
+// well before the table is full
+class ScatteringHasher
+{
+public:
+    inline u64 operator () (u64 key) const
+    {
+        return (key * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+TEST(CuckooUnorderedMapTest, Displacement)
+{
+    // a miss in its first bucket only looks in the second bucket
+    // of a key if any element was displaced from the first one
+    CuckooUnorderedMap<u64, u64, ScatteringHasher> kinara_map;
+    std::unordered_map<u64, u64> std_map;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> key_distribution(0, max_insertion_value - 1);
+    std::uniform_int_distribution<u64> op_distribution(0, 3);
+
+    for (u64 i = 0; i < 16 * max_insertion_value; ++i) {
+        const u64 key = key_distribution(generator);
+        const u64 op = op_distribution(generator);
+        if (op == 0) {
+            EXPECT_EQ(std_map.erase(key), kinara_map.erase(key));
+        } else if (op == 1) {
+            auto it = kinara_map.find(key);
+            EXPECT_EQ(std_map.count(key), (u64)(it != kinara_map.end() ? 1 : 0));
+            if (it != kinara_map.end()) {
+                kinara_map.erase(it);
+                std_map.erase(key);
+            }
+        } else {
+            kinara_map[key] = i;
+            std_map[key] = i;
+        }
+    }
+    EXPECT_TRUE(test_equal(kinara_map, std_map));
+    for (u64 key = 0; key < max_insertion_value; ++key) {
+        EXPECT_EQ(std_map.count(key), kinara_map.count(key));
+    }
+}
+
+TEST(CompactUnorderedMapTest, Functional)
+{
+    CompactUnorderedMap<24, 20> kinara_map;
+    std::unordered_map<u64, u64> std_map;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 1);
+
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        std_map.clear();
+        kinara_map.clear();
+
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            if (distribution(generator) == 1) {
+                auto key = j * 131;
+                EXPECT_EQ(std_map.insert(std::make_pair(key, j)).second,
+                          kinara_map.insert(key, j));
+                EXPECT_EQ(std_map.size(), kinara_map.size());
+            }
+        }
+
+        // values are updated only through insert_or_assign
+        for (auto& entry : std_map) {
+            EXPECT_FALSE(kinara_map.insert(entry.first, entry.second + 1));
+            entry.second += 42;
+            EXPECT_FALSE(kinara_map.insert_or_assign(entry.first, entry.second));
+        }
+
+        u64 num_visited = 0;
+        for (auto it = kinara_map.begin(); it != kinara_map.end(); ++it) {
+            auto std_it = std_map.find(it.key());
+            EXPECT_TRUE(std_it != std_map.end());
+            EXPECT_EQ(std_it->second, it.value());
+            EXPECT_EQ(std::make_pair(it.key(), it.value()), *it);
+            ++num_visited;
+        }
+        EXPECT_EQ(std_map.size(), num_visited);
+
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            auto key = j * 131;
+            if (distribution(generator) == 1) {
+                EXPECT_EQ(std_map.erase(key), kinara_map.erase(key));
+            }
+        }
+        EXPECT_EQ(std_map.size(), kinara_map.size());
+
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            auto key = j * 131;
+            u64 value = 0;
+            auto std_it = std_map.find(key);
+            EXPECT_EQ(std_it != std_map.end(), kinara_map.find(key, value));
+            if (std_it != std_map.end()) {
+                EXPECT_EQ(std_it->second, value);
+                EXPECT_EQ(std_it->second, kinara_map.find(key).value());
+            } else {
+                EXPECT_TRUE(kinara_map.find(key) == kinara_map.end());
+            }
+        }
+    }
+
+    CompactUnorderedMap<24, 20> map_copy(kinara_map);
+    EXPECT_EQ(kinara_map.size(), map_copy.size());
+    for (auto it = kinara_map.begin(); it != kinara_map.end(); ++it) {
+        EXPECT_EQ(it.value(), map_copy.find(it.key()).value());
+    }
+
+    // keys and values that do not fit are rejected
+    EXPECT_THROW(map_copy.insert(1 << 24, 1), std::out_of_range);
+    EXPECT_THROW(map_copy.insert(1, 1 << 20), std::out_of_range);
+    EXPECT_TRUE(map_copy.find(1 << 24) == map_copy.end());
+    EXPECT_EQ(kinara_map.size(), map_copy.size());
+}
+
+TEST(CompactUnorderedMapTest, WideSlots)
+{
+    // the slots of a table with three bit keys and 56 bit values
+    // are a full 64 bits wide
+    CompactUnorderedMap<3, 56> kinara_map;
+    const u64 max_value = ((u64)1 << 56) - 1;
+
+    for (u64 key = 0; key < 8; ++key) {
+        EXPECT_TRUE(kinara_map.insert(key, max_value - key));
+    }
+    EXPECT_EQ((u64)8, kinara_map.size());
+    for (u64 key = 0; key < 8; ++key) {
+        EXPECT_EQ(max_value - key, kinara_map.find(key).value());
+    }
+    for (u64 key = 0; key < 8; key += 2) {
+        EXPECT_EQ((u64)1, kinara_map.erase(key));
+    }
+    for (u64 key = 0; key < 8; ++key) {
+        EXPECT_EQ(key % 2, kinara_map.count(key));
+        if (key % 2 == 1) {
+            EXPECT_EQ(max_value - key, kinara_map.find(key).value());
+        }
+    }
+    EXPECT_THROW(kinara_map.insert(8, 0), std::out_of_range);
+}
+
+TEST(CompactUnorderedMapTest, Performance)
+{
+    CompactUnorderedMap<32, 24> kinara_map;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 1);
+
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        kinara_map.clear();
+
+        for (u64 i = 0; i < 64 * max_insertion_value; ++i) {
+            kinara_map.insert_or_assign(i, i + 42);
+        }
+
+        for (u64 i = 0; i < 64 * max_insertion_value; ++i) {
+            if (distribution(generator) == 1) {
+                kinara_map.erase(i);
+            }
+        }
+    }
+}
+
 REGISTER_TYPED_TEST_CASE_P(UnorderedMapTest,
                            Constructor,
                            Assignment,
                            Functional,
-                           Performance);
+                           Performance,
+                           LookupPerformance);
 
 typedef Types<UnifiedUnorderedMap<u64, u64>,
               SegregatedUnorderedMap<u64, u64>,
-              RestrictedUnorderedMap<u64, u64> > UnorderedMapImplementations;
+              RestrictedUnorderedMap<u64, u64>,
+              SwissUnorderedMap<u64, u64>,
+              CuckooUnorderedMap<u64, u64> > UnorderedMapImplementations;
 
 INSTANTIATE_TYPED_TEST_CASE_P(UnorderedMapTemplateTests,
                               UnorderedMapTest, UnorderedMapImplementations);
@@ -38,12 +38,19 @@
 // Code:
 
 #include "../../projects/kinara-common/src/containers/UnorderedSet.hpp"
+#include "../../projects/kinara-common/src/containers/SwissUnorderedSet.hpp"
+#include "../../projects/kinara-common/src/containers/ConcurrentUnorderedSet.hpp"
+#include "../../projects/kinara-common/src/containers/CompactUnorderedSet.hpp"
 #include "../../projects/kinara-common/src/containers/BitSet.hpp"
 
 #include <utility>
 #include <random>
 #include <algorithm>
+#include <vector>
 #include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 #include "RCClass.hpp"
 
@@ -64,6 +71,9 @@ const u64 max_test_iterations = (1 << 4);
 using kinara::containers::UnifiedUnorderedSet;
 using kinara::containers::RestrictedUnorderedSet;
 using kinara::containers::SegregatedUnorderedSet;
+using kinara::containers::SwissUnorderedSet;
+using kinara::containers::ConcurrentUnorderedSet;
+using kinara::containers::CompactUnorderedSet;
 using kinara::containers::BitSet;
 
 using testing::Types;
@@ -317,15 +327,272 @@ TEST(StdUnorderedSetTest, Performance)
     }
 }
 
+TYPED_TEST_P(UnorderedSetTest, LookupPerformance)
+{
+    typedef TypeParam SetType;
+
+    SetType kinara_set;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 32 * max_insertion_value - 1);
+
+    for (u64 i = 0; i < 16 * max_insertion_value; ++i) {
+        kinara_set.insert(distribution(generator));
+    }
+
+    u64 num_found = 0;
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        for (u64 i = 0; i < 16 * max_insertion_value; ++i) {
+            if (kinara_set.find(distribution(generator)) != kinara_set.end()) {
+                ++num_found;
+            }
+        }
+    }
+
+    EXPECT_GT(num_found, (u64)0);
+}
+
+TEST(StdUnorderedSetTest, LookupPerformance)
+{
+    std::unordered_set<u64> std_set;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 32 * max_insertion_value - 1);
+
+    for (u64 i = 0; i < 16 * max_insertion_value; ++i) {
+        std_set.insert(distribution(generator));
+    }
+
+    u64 num_found = 0;
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        for (u64 i = 0; i < 16 * max_insertion_value; ++i) {
+            if (std_set.find(distribution(generator)) != std_set.end()) {
+                ++num_found;
+            }
+        }
+    }
+
+    EXPECT_GT(num_found, (u64)0);
+}
+
+static inline u64 get_num_test_threads()
+{
+    auto retval = std::thread::hardware_concurrency();
+    return (retval < 2 ? 2 : retval);
+}
+
+TEST(ConcurrentUnorderedSetTest, Functional)
+{
+    ConcurrentUnorderedSet<u64> kinara_set(gc_deleted_value, gc_nonused_value);
+    const u64 num_threads = get_num_test_threads();
+    std::atomic<u64> num_inserted(0);
+
+    // every thread tries to insert every value, in its own order
+    std::vector<std::thread> threads;
+    for (u64 t = 0; t < num_threads; ++t) {
+        threads.push_back(std::thread([&, t] () -> void
+                                      {
+                                          std::vector<u64> values(max_insertion_value);
+                                          for (u64 i = 0; i < max_insertion_value; ++i) {
+                                              values[i] = i;
+                                          }
+                                          std::default_random_engine generator(t);
+                                          std::shuffle(values.begin(), values.end(), generator);
+                                          for (auto value : values) {
+                                              if (kinara_set.insert(value)) {
+                                                  ++num_inserted;
+                                              }
+                                          }
+                                      }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(max_insertion_value, num_inserted.load());
+    EXPECT_EQ(max_insertion_value, kinara_set.size());
+    for (u64 i = 0; i < max_insertion_value; ++i) {
+        EXPECT_TRUE(kinara_set.contains(i));
+    }
+    EXPECT_FALSE(kinara_set.contains(max_insertion_value));
+
+    // the reserved values are never members, and cannot be inserted
+    EXPECT_FALSE(kinara_set.contains(gc_nonused_value));
+    EXPECT_FALSE(kinara_set.contains(gc_deleted_value));
+    EXPECT_THROW(kinara_set.insert(gc_nonused_value), std::invalid_argument);
+    EXPECT_THROW(kinara_set.insert(gc_deleted_value), std::invalid_argument);
+    EXPECT_EQ(max_insertion_value, kinara_set.size());
+
+    typedef ConcurrentUnorderedSet<u64> SetType;
+    EXPECT_THROW(SetType(gc_deleted_value, gc_deleted_value), std::invalid_argument);
+    EXPECT_THROW(kinara_set.set_deleted_value(gc_nonused_value), std::invalid_argument);
+}
+
+TEST(ConcurrentUnorderedSetTest, Growth)
+{
+    // values that all land on the same size stripe
+    // do not make the table grow any sooner
+    ConcurrentUnorderedSet<u64> strided_set(gc_deleted_value, gc_nonused_value);
+    for (u64 i = 0; i < 1024; ++i) {
+        EXPECT_TRUE(strided_set.insert(i * 64));
+    }
+    EXPECT_EQ((u64)1024, strided_set.size());
+    EXPECT_EQ((u64)2048, strided_set.capacity());
+
+    // the table grows once it is over half full
+    ConcurrentUnorderedSet<u64> kinara_set(gc_deleted_value, gc_nonused_value);
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, ((u64)1 << 62));
+    while (kinara_set.size() < 16 * max_insertion_value) {
+        kinara_set.insert(distribution(generator));
+    }
+    EXPECT_EQ(32 * max_insertion_value, kinara_set.capacity());
+}
+
+TEST(ConcurrentUnorderedSetTest, Performance)
+{
+    ConcurrentUnorderedSet<u64> kinara_set(gc_deleted_value, gc_nonused_value);
+    const u64 num_threads = get_num_test_threads();
+
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        kinara_set.clear();
+
+        std::vector<std::thread> threads;
+        for (u64 t = 0; t < num_threads; ++t) {
+            threads.push_back(std::thread([&, t] () -> void
+                                          {
+                                              for (u64 i = t; i < 64 * max_insertion_value;
+                                                   i += num_threads) {
+                                                  kinara_set.insert(i);
+                                              }
+                                          }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(64 * max_insertion_value, kinara_set.size());
+    }
+}
+
+TEST(LockedUnorderedSetTest, ConcurrentPerformance)
+{
+    UnifiedUnorderedSet<u64> kinara_set(gc_deleted_value, gc_nonused_value);
+    std::mutex set_mutex;
+    const u64 num_threads = get_num_test_threads();
+
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        kinara_set.clear();
+
+        std::vector<std::thread> threads;
+        for (u64 t = 0; t < num_threads; ++t) {
+            threads.push_back(std::thread([&, t] () -> void
+                                          {
+                                              for (u64 i = t; i < 64 * max_insertion_value;
+                                                   i += num_threads) {
+                                                  std::lock_guard<std::mutex> guard(set_mutex);
+                                                  kinara_set.insert(i);
+                                              }
+                                          }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(64 * max_insertion_value, kinara_set.size());
+    }
+}
+
+TEST(CompactUnorderedSetTest, Functional)
+{
+    CompactUnorderedSet<32> kinara_set;
+    std::unordered_set<u64> std_set;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> flip_distribution(0, 1);
+    std::uniform_int_distribution<u64> value_distribution(0, UINT32_MAX);
+
+    for (u64 i = 0; i < max_test_iterations; ++i) {
+        std_set.clear();
+        kinara_set.clear();
+
+        // clustered values in the first half, spread out ones in the second
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            auto value = (j % 2 == 0 ? j : value_distribution(generator));
+            EXPECT_EQ(std_set.insert(value).second, kinara_set.insert(value));
+            EXPECT_EQ(std_set.size(), kinara_set.size());
+        }
+
+        u64 num_visited = 0;
+        for (auto it = kinara_set.begin(); it != kinara_set.end(); ++it) {
+            EXPECT_EQ((u64)1, std_set.count(*it));
+            ++num_visited;
+        }
+        EXPECT_EQ(std_set.size(), num_visited);
+
+        for (u64 j = 0; j < max_insertion_value; ++j) {
+            auto value = (flip_distribution(generator) == 1 ? j : value_distribution(generator));
+            EXPECT_EQ(std_set.count(value), kinara_set.count(value));
+            if (flip_distribution(generator) == 1) {
+                EXPECT_EQ(std_set.erase(value), kinara_set.erase(value));
+            }
+        }
+        EXPECT_EQ(std_set.size(), kinara_set.size());
+        for (auto value : std_set) {
+            EXPECT_EQ((u64)1, kinara_set.count(value));
+        }
+    }
+
+    // narrow keys take up a fraction of a word each
+    CompactUnorderedSet<24> narrow_set;
+    for (u64 j = 0; j < max_insertion_value; ++j) {
+        narrow_set.insert(j * 97);
+    }
+    EXPECT_EQ(max_insertion_value, narrow_set.size());
+    EXPECT_GT(narrow_set.capacity() * sizeof(u64) / 2, narrow_set.storage_bytes());
+
+    // keys that do not fit are rejected, not truncated into others
+    EXPECT_THROW(narrow_set.insert((1 << 24) + 97), std::out_of_range);
+    EXPECT_EQ((u64)0, narrow_set.count((1 << 24) + 97));
+    EXPECT_EQ((u64)1, narrow_set.count(97));
+    EXPECT_EQ(max_insertion_value, narrow_set.size());
+
+    std::vector<u64> values = { 3, 1, 4, 1, 5 };
+    CompactUnorderedSet<24> range_set(values.begin(), values.end());
+    EXPECT_EQ((u64)4, range_set.size());
+}
+
+TEST(CompactUnorderedSetTest, Performance)
+{
+    CompactUnorderedSet<32> kinara_set;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u64> distribution(0, 1);
+
+    for (u64 j = 0; j < (1 << 4); ++j) {
+        kinara_set.clear();
+
+        for (u64 i = 0; i < 64 * max_insertion_value; ++i) {
+            kinara_set.insert(i);
+        }
+
+        for (u64 i = 0; i < 64 * max_insertion_value; ++i) {
+            if (distribution(generator) == 1) {
+                kinara_set.erase(i);
+            }
+        }
+    }
+}
+
 REGISTER_TYPED_TEST_CASE_P(UnorderedSetTest,
                            Constructor,
                            Assignment,
                            Functional,
-                           Performance);
+                           Performance,
+                           LookupPerformance);
 
 typedef Types<UnifiedUnorderedSet<u64>,
               SegregatedUnorderedSet<u64>,
-              RestrictedUnorderedSet<u64> > UnorderedSetImplementations;
+              RestrictedUnorderedSet<u64>,
+              SwissUnorderedSet<u64> > UnorderedSetImplementations;
 
 INSTANTIATE_TYPED_TEST_CASE_P(UnorderedSetTemplateTests,
                               UnorderedSetTest, UnorderedSetImplementations);
@@ -36,6 +36,7 @@
 // Code:
 
 #include "../../projects/kinara-common/src/containers/Vector.hpp"
+#include "../../projects/kinara-common/src/containers/SmallVector.hpp"
 #include <vector>
 #include <random>
 #include <cstdlib>
@@ -47,9 +48,12 @@
 
 using kinara::containers::u32Vector;
 using kinara::containers::MPtrVector;
+using kinara::containers::SmallVector;
+using kinara::containers::u32SmallVector;
 
 using kinara::u32;
 using kinara::u64;
+using kinara::i64;
 
 TEST(Vector, EmptyIntVector)
 {
@@ -263,5 +267,245 @@ TEST(Vector, Reverse)
     EXPECT_EQ(10u, i);
 }
 
+// Counts its live objects, and declares itself relocatable,
+// although it has user defined copies and destructor
+class RelocatableClass
+{
+public:
+    static i64 s_num_live;
+    u32 m_data;
+
+    RelocatableClass()
+        : m_data(0)
+    {
+        ++s_num_live;
+    }
+
+    RelocatableClass(u32 data)
+        : m_data(data)
+    {
+        ++s_num_live;
+    }
+
+    RelocatableClass(const RelocatableClass& other)
+        : m_data(other.m_data)
+    {
+        ++s_num_live;
+    }
+
+    RelocatableClass& operator = (const RelocatableClass& other) = default;
+
+    ~RelocatableClass()
+    {
+        --s_num_live;
+    }
+
+    bool operator == (const RelocatableClass& other) const
+    {
+        return (m_data == other.m_data);
+    }
+};
+
+i64 RelocatableClass::s_num_live = 0;
+
+namespace kinara {
+namespace containers {
+
+template <>
+class IsTriviallyRelocatable<RelocatableClass> : public std::true_type
+{
+    // Nothing here
+};
+
+} /* end namespace containers */
+} /* end namespace kinara */
+
+TEST(SmallVector, ShortIntVector)
+{
+    u32SmallVector<4> test_vector;
+    EXPECT_EQ((u64)0, test_vector.size());
+    EXPECT_TRUE(test_vector.is_small());
+
+    test_vector = {1, 2, 3};
+    u32SmallVector<4> test_vector2;
+    test_vector2 = test_vector;
+    test_vector.push_back(2);
+    EXPECT_TRUE(test_vector.is_small());
+
+    EXPECT_EQ((u64)3, test_vector2.size());
+    EXPECT_EQ((u32)3, test_vector2[2]);
+    EXPECT_EQ((u64)4, test_vector.size());
+    EXPECT_EQ((u32)2, test_vector[3]);
+
+    // one more goes to the heap, and shrinking brings it back
+    test_vector.push_back(5);
+    EXPECT_FALSE(test_vector.is_small());
+    test_vector.pop_back();
+    test_vector.shrink_to_fit();
+    EXPECT_TRUE(test_vector.is_small());
+    EXPECT_EQ((u32)2, test_vector.back());
+
+    u32SmallVector<4> test_vector3(std::move(test_vector));
+    EXPECT_EQ((u64)4, test_vector3.size());
+    EXPECT_EQ((u64)0, test_vector.size());
+    EXPECT_TRUE(test_vector3 > test_vector2);
+}
+
+// Random insertions and erasures, checked against std::vector, for a
+// trivially copyable type, a relocatable one, and one that is neither
+template <typename SmallVectorType, typename MakeValue>
+static inline void test_small_vector_against_std(const MakeValue& make_value)
+{
+    typedef typename SmallVectorType::ValueType ValueType;
+    SmallVectorType small_vector;
+    std::vector<ValueType> std_vector;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<u32> distribution(0, 1 << 30);
+
+    for (u32 i = 0; i < (1 << 12); ++i) {
+        const u32 op = distribution(generator) % 6;
+        const u64 position = distribution(generator) % (std_vector.size() + 1);
+        if (op <= 1) {
+            small_vector.push_back(make_value(i));
+            std_vector.push_back(make_value(i));
+        } else if (op == 2) {
+            std::vector<ValueType> values(distribution(generator) % 12, make_value(i));
+            small_vector.insert(small_vector.begin() + position, values.begin(), values.end());
+            std_vector.insert(std_vector.begin() + position, values.begin(), values.end());
+        } else if (op == 3 && !std_vector.empty()) {
+            // inserting elements of the vector itself
+            const u64 first = distribution(generator) % std_vector.size();
+            const u64 last = first + distribution(generator) % (std_vector.size() - first + 1);
+            std::vector<ValueType> values(std_vector.begin() + first, std_vector.begin() + last);
+            small_vector.insert(small_vector.begin() + position,
+                                small_vector.begin() + first, small_vector.begin() + last);
+            std_vector.insert(std_vector.begin() + position, values.begin(), values.end());
+        } else if (op == 4 && !std_vector.empty()) {
+            const u64 first = distribution(generator) % std_vector.size();
+            const u64 last = first + distribution(generator) % (std::min((u64)8, std_vector.size() - first) + 1);
+            small_vector.erase(small_vector.begin() + first, small_vector.begin() + last);
+            std_vector.erase(std_vector.begin() + first, std_vector.begin() + last);
+        } else if (op == 5) {
+            const u64 new_size = distribution(generator) % (std_vector.size() + 4);
+            small_vector.resize(new_size, make_value(i));
+            std_vector.resize(new_size, make_value(i));
+            if (distribution(generator) % 4 == 0) {
+                small_vector.shrink_to_fit();
+            }
+        }
+
+        EXPECT_EQ(std_vector.size(), small_vector.size());
+        EXPECT_TRUE(std::equal(std_vector.begin(), std_vector.end(), small_vector.begin()));
+        if (std_vector.size() > 64) {
+            small_vector.clear();
+            std_vector.clear();
+        }
+    }
+
+    SmallVectorType copy(small_vector);
+    EXPECT_TRUE(copy == small_vector);
+    SmallVectorType moved;
+    moved = std::move(copy);
+    EXPECT_TRUE(moved == small_vector);
+}
+
+TEST(SmallVector, Functional)
+{
+    test_small_vector_against_std<u32SmallVector<8> >([] (u32 i) -> u32 { return i; });
+
+    RelocatableClass::s_num_live = 0;
+    test_small_vector_against_std<SmallVector<RelocatableClass, 4> >(
+        [] (u32 i) -> RelocatableClass { return RelocatableClass(i); });
+    EXPECT_EQ((i64)0, RelocatableClass::s_num_live);
+
+    test_small_vector_against_std<SmallVector<std::vector<u32>, 4> >(
+        [] (u32 i) -> std::vector<u32> { return std::vector<u32>(i % 4, i); });
+}
+
+TEST(SmallVector, RefCountableObjects)
+{
+    SmallVector<RCClass, 8> vector1;
+
+    for (int i = 0; i < (1 << 10); ++i) {
+        vector1.push_back(RCClass(i));
+    }
+
+    SmallVector<RCClass, 8> vector2 = vector1;
+    for (int i = 0; i < (1 << 10); ++i) {
+        EXPECT_EQ(i, (int)vector2[i]);
+    }
+
+    vector1.clear();
+    EXPECT_EQ((u64)0, vector1.size());
+    EXPECT_EQ((u64)(1 << 10), vector2.size());
+}
+
+TEST(SmallVector, Algorithms)
+{
+    u32SmallVector<4> vec = { 9, 7, 10, 2, 4, 1, 3, 6, 8, 5 };
+    vec.sort();
+    for (u32 i = 0; i < 10; ++i) {
+        EXPECT_EQ(i + 1, vec[i]);
+    }
+    vec.reverse();
+    EXPECT_EQ(10u, vec.front());
+    EXPECT_EQ(3u, *(vec.find(3u)));
+    EXPECT_EQ(vec.end(), vec.find(42u));
+
+    u32SmallVector<4> vec1 = { 1, 2, 3, 4, 5 };
+    u32SmallVector<4> vec2 = { 9, 10 };
+    u32SmallVector<4> vec3 = { 1, 2, 3, 4, 5 };
+    EXPECT_LT(vec2, vec1);
+    EXPECT_EQ(vec1, vec3);
+    EXPECT_GE(vec1, vec3);
+}
+
+#define SMALL_VECTOR_PERF_ITERATIONS (1 << 22)
+
+// Successor generation: many short lived vectors of a few elements
+TEST(SmallVector, Performance)
+{
+    u64 total = 0;
+    for (u32 i = 0; i < SMALL_VECTOR_PERF_ITERATIONS; ++i) {
+        u32SmallVector<8> successors;
+        for (u32 j = 0; j < (i & 7); ++j) {
+            successors.push_back(i + j);
+        }
+        for (auto successor : successors) {
+            total += successor;
+        }
+    }
+    EXPECT_LT((u64)0, total);
+}
+
+TEST(StdVector, Performance)
+{
+    u64 total = 0;
+    for (u32 i = 0; i < SMALL_VECTOR_PERF_ITERATIONS; ++i) {
+        std::vector<u32> successors;
+        for (u32 j = 0; j < (i & 7); ++j) {
+            successors.push_back(i + j);
+        }
+        for (auto successor : successors) {
+            total += successor;
+        }
+    }
+    EXPECT_LT((u64)0, total);
+}
+
+// Growth of a relocatable type with a user defined copy constructor,
+// by realloc() rather than by copying every element
+TEST(SmallVector, RelocatableGrowthPerformance)
+{
+    for (u32 j = 0; j < 16; ++j) {
+        SmallVector<RelocatableClass, 8> vector1;
+        for (u32 i = 0; i < (1 << 20); ++i) {
+            vector1.push_back(RelocatableClass(i));
+        }
+        EXPECT_EQ((u64)(1 << 20), vector1.size());
+    }
+}
+
 //
 // VectorTests.cpp ends here